@@ -0,0 +1,134 @@
+<?php
+
+declare(strict_types = 1);
+
+require_once __DIR__ . '/corpus/input.php';
+require_once __DIR__ . '/corpus/sha256.php';
+require_once __DIR__ . '/corpus/json.php';
+require_once __DIR__ . '/corpus/blur.php';
+require_once __DIR__ . '/corpus/regex.php';
+require_once __DIR__ . '/corpus/compress.php';
+require_once __DIR__ . '/corpus/markdown.php';
+
+/**
+ * Measures realistic workloads from 1 KB to 10 MB: a Rust guest of
+ * `benchmarks/corpus/` against the same algorithm in pure PHP, and
+ * against the native PHP function when there is one. Compile the
+ * guests with `just compile-corpus`.
+ *
+ * Every guest exports `allocate`, `deallocate`, and `run(pointer,
+ * length): i32`; the pure PHP functions return the same result.
+ *
+ * @BeforeMethods({"initialize"})
+ * @ParamProviders({"provide_workloads", "provide_sizes"})
+ * @Warmup(1)
+ * @Revs(1)
+ * @Iterations(3)
+ * @OutputTimeUnit("milliseconds", precision=3)
+ * @OutputMode("time")
+ */
+class Corpus
+{
+    private $input = null;
+    private $wasmInstance = null;
+
+    public function provide_workloads()
+    {
+        foreach (['sha256', 'json', 'blur', 'regex', 'compress', 'markdown'] as $workload) {
+            yield $workload => ['workload' => $workload];
+        }
+    }
+
+    public function provide_native_workloads()
+    {
+        // `compress` is compared to `gzdeflate`, which is a different
+        // algorithm.
+        foreach (['sha256', 'json', 'regex', 'compress'] as $workload) {
+            yield $workload => ['workload' => $workload];
+        }
+    }
+
+    public function provide_sizes()
+    {
+        foreach (['1KB' => 1 << 10, '64KB' => 64 << 10, '1MB' => 1 << 20, '10MB' => 10 << 20] as $name => $size) {
+            yield $name => ['size' => $size];
+        }
+    }
+
+    public function initialize(array $parameters)
+    {
+        $workload = $parameters['workload'];
+        $filePath = __DIR__ . '/corpus/' . $workload . '.wasm';
+
+        if (false === file_exists($filePath)) {
+            throw new RuntimeException("The `$filePath` module does not exist. Run `just compile-corpus`.");
+        }
+
+        $this->input = self::input($workload, $parameters['size']);
+        $this->wasmInstance = new Wasm\Instance($filePath);
+    }
+
+    public function bench_wasm_extension(array $parameters)
+    {
+        $length = strlen($this->input);
+        $pointer = $this->wasmInstance->allocate($length);
+
+        // The memory may have grown, the buffer must be fetched after
+        // the allocation.
+        WasmArrayBuffer::fromString($this->input)->copyTo($this->wasmInstance->getMemoryBuffer(), 0, $pointer, $length);
+
+        $result = $this->wasmInstance->run($pointer, $length);
+        $this->wasmInstance->deallocate($pointer, $length);
+
+        return $result;
+    }
+
+    public function bench_pure_php(array $parameters)
+    {
+        return ('corpus_' . $parameters['workload'] . '_pure_php')($this->input);
+    }
+
+    /**
+     * @ParamProviders({"provide_native_workloads", "provide_sizes"})
+     */
+    public function bench_php_native(array $parameters)
+    {
+        return ('corpus_' . $parameters['workload'] . '_php_native')($this->input);
+    }
+
+    /**
+     * Generates, once, the input of a workload.
+     */
+    private static function input(string $workload, int $size): string
+    {
+        $filePath = sys_get_temp_dir() . '/php-ext-wasm-bench-corpus-' . $workload . '-' . $size;
+
+        if (true === file_exists($filePath)) {
+            return file_get_contents($filePath);
+        }
+
+        switch ($workload) {
+            case 'json':
+                $input = corpus_json_input($size);
+
+                break;
+
+            case 'blur':
+                $input = corpus_image_input($size);
+
+                break;
+
+            case 'markdown':
+                $input = corpus_markdown_input($size);
+
+                break;
+
+            default:
+                $input = corpus_text_input($size);
+        }
+
+        file_put_contents($filePath, $input);
+
+        return $input;
+    }
+}
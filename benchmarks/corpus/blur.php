@@ -0,0 +1,38 @@
+<?php
+
+declare(strict_types = 1);
+
+/**
+ * Blurs a grayscale image, 256 pixels wide, with a 3×3 box filter,
+ * like `blur.rs`. The result is the sum of the blurred pixels.
+ */
+function corpus_blur_pure_php(string $input): int
+{
+    $width = 256;
+    $height = intdiv(strlen($input), $width);
+    $output = str_repeat("\x00", $width * $height);
+    $checksum = 0;
+
+    for ($y = 0; $y < $height; ++$y) {
+        $top = $y > 0 ? $y - 1 : 0;
+        $bottom = $y + 1 < $height ? $y + 1 : $y;
+
+        for ($x = 0; $x < $width; ++$x) {
+            $left = $x > 0 ? $x - 1 : 0;
+            $right = $x + 1 < $width ? $x + 1 : $x;
+            $sum = 0;
+
+            for ($row = $top; $row <= $bottom; ++$row) {
+                for ($column = $left; $column <= $right; ++$column) {
+                    $sum += ord($input[$row * $width + $column]);
+                }
+            }
+
+            $pixel = intdiv($sum, ($bottom - $top + 1) * ($right - $left + 1));
+            $output[$y * $width + $x] = chr($pixel);
+            $checksum += $pixel;
+        }
+    }
+
+    return $checksum & 0x7fffffff;
+}
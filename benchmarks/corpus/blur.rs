@@ -0,0 +1,57 @@
+// Blurs a grayscale image, 256 pixels wide, with a 3×3 box filter.
+// The result is the sum of the blurred pixels, modulo 2^31.
+use std::mem;
+use std::os::raw::c_void;
+use std::slice;
+
+#[no_mangle]
+pub extern fn allocate(size: usize) -> *mut c_void {
+    let mut buffer = Vec::<u8>::with_capacity(size);
+    let pointer = buffer.as_mut_ptr();
+    mem::forget(buffer);
+
+    pointer as *mut c_void
+}
+
+#[no_mangle]
+pub extern fn deallocate(pointer: *mut c_void, capacity: usize) {
+    unsafe {
+        let _ = Vec::from_raw_parts(pointer as *mut u8, 0, capacity);
+    }
+}
+
+const WIDTH: usize = 256;
+
+#[no_mangle]
+pub extern fn run(pointer: *const u8, length: usize) -> i32 {
+    let input = unsafe { slice::from_raw_parts(pointer, length) };
+    let height = length / WIDTH;
+    let mut output = vec![0u8; WIDTH * height];
+
+    for y in 0..height {
+        let top = if y > 0 { y - 1 } else { 0 };
+        let bottom = if y + 1 < height { y + 1 } else { y };
+
+        for x in 0..WIDTH {
+            let left = if x > 0 { x - 1 } else { 0 };
+            let right = if x + 1 < WIDTH { x + 1 } else { x };
+            let mut sum = 0u32;
+
+            for row in top..=bottom {
+                for column in left..=right {
+                    sum += input[row * WIDTH + column] as u32;
+                }
+            }
+
+            output[y * WIDTH + x] = (sum / (((bottom - top + 1) * (right - left + 1)) as u32)) as u8;
+        }
+    }
+
+    let mut checksum = 0u32;
+
+    for pixel in output {
+        checksum = checksum.wrapping_add(pixel as u32);
+    }
+
+    (checksum & 0x7fffffff) as i32
+}
@@ -0,0 +1,87 @@
+<?php
+
+declare(strict_types = 1);
+
+/**
+ * Compresses the input with the LZ77 compressor of `compress.rs`. The
+ * result is the compressed length.
+ */
+function corpus_compress_pure_php(string $input): int
+{
+    $length = strlen($input);
+    $output = '';
+    // Positions plus one, 0 means empty.
+    $table = array_fill(0, 4096, 0);
+    $anchor = 0;
+    $position = 0;
+
+    while ($position + 4 <= $length) {
+        $sequence = unpack('V', $input, $position)[1];
+        $hash = ((($sequence ^ ($sequence >> 15)) * 40503) >> 12) & 0xfff;
+        $candidate = $table[$hash];
+        $table[$hash] = $position + 1;
+
+        if (
+            $candidate > 0 &&
+            $position - ($candidate - 1) < 65536 &&
+            substr($input, $candidate - 1, 4) === substr($input, $position, 4)
+        ) {
+            $candidate -= 1;
+            $matchLength = 4;
+
+            while ($position + $matchLength < $length && $input[$candidate + $matchLength] === $input[$position + $matchLength]) {
+                ++$matchLength;
+            }
+
+            $output .=
+                corpus_compress_literals(substr($input, $anchor, $position - $anchor)) .
+                "\x01" .
+                corpus_compress_integer($position - $candidate) .
+                corpus_compress_integer($matchLength);
+
+            $position += $matchLength;
+            $anchor = $position;
+        } else {
+            ++$position;
+        }
+    }
+
+    $output .= corpus_compress_literals((string) substr($input, $anchor));
+
+    return strlen($output);
+}
+
+/**
+ * `gzdeflate` is not the same algorithm, it is a reference point only.
+ */
+function corpus_compress_php_native(string $input): int
+{
+    return strlen(gzdeflate($input, 1));
+}
+
+function corpus_compress_literals(string $literals): string
+{
+    if ('' === $literals) {
+        return '';
+    }
+
+    return "\x00" . corpus_compress_integer(strlen($literals)) . $literals;
+}
+
+function corpus_compress_integer(int $value): string
+{
+    $out = '';
+
+    do {
+        $byte = $value & 0x7f;
+        $value >>= 7;
+
+        if (0 !== $value) {
+            $byte |= 0x80;
+        }
+
+        $out .= chr($byte);
+    } while (0 !== $value);
+
+    return $out;
+}
@@ -0,0 +1,95 @@
+// Compresses the input with a LZ77 compressor: a 4 KB hash table of
+// 4-byte sequences finds matches up to 64 KB behind. The output is a
+// sequence of literal runs (0, length, bytes) and matches (1, offset,
+// length), with LEB128 integers. The result is the compressed length.
+use std::mem;
+use std::os::raw::c_void;
+use std::slice;
+
+#[no_mangle]
+pub extern fn allocate(size: usize) -> *mut c_void {
+    let mut buffer = Vec::<u8>::with_capacity(size);
+    let pointer = buffer.as_mut_ptr();
+    mem::forget(buffer);
+
+    pointer as *mut c_void
+}
+
+#[no_mangle]
+pub extern fn deallocate(pointer: *mut c_void, capacity: usize) {
+    unsafe {
+        let _ = Vec::from_raw_parts(pointer as *mut u8, 0, capacity);
+    }
+}
+
+fn write_integer(output: &mut Vec<u8>, mut value: usize) {
+    loop {
+        let byte = (value & 0x7f) as u8;
+        value >>= 7;
+
+        if value == 0 {
+            output.push(byte);
+
+            return;
+        }
+
+        output.push(byte | 0x80);
+    }
+}
+
+fn write_literals(output: &mut Vec<u8>, literals: &[u8]) {
+    if !literals.is_empty() {
+        output.push(0);
+        write_integer(output, literals.len());
+        output.extend_from_slice(literals);
+    }
+}
+
+fn read_sequence(input: &[u8], position: usize) -> u64 {
+    u32::from_le_bytes([input[position], input[position + 1], input[position + 2], input[position + 3]]) as u64
+}
+
+fn compress(input: &[u8]) -> Vec<u8> {
+    let mut output = Vec::with_capacity(input.len());
+    // Positions plus one, 0 means empty.
+    let mut table = vec![0usize; 4096];
+    let mut anchor = 0;
+    let mut position = 0;
+
+    while position + 4 <= input.len() {
+        let sequence = read_sequence(input, position);
+        let hash = ((((sequence ^ (sequence >> 15)) * 40503) >> 12) & 0xfff) as usize;
+        let candidate = table[hash];
+        table[hash] = position + 1;
+
+        if candidate > 0 && position - (candidate - 1) < 65536 && read_sequence(input, candidate - 1) == sequence {
+            let candidate = candidate - 1;
+            let mut length = 4;
+
+            while position + length < input.len() && input[candidate + length] == input[position + length] {
+                length += 1;
+            }
+
+            write_literals(&mut output, &input[anchor..position]);
+            output.push(1);
+            write_integer(&mut output, position - candidate);
+            write_integer(&mut output, length);
+
+            position += length;
+            anchor = position;
+        } else {
+            position += 1;
+        }
+    }
+
+    write_literals(&mut output, &input[anchor..]);
+
+    output
+}
+
+#[no_mangle]
+pub extern fn run(pointer: *const u8, length: usize) -> i32 {
+    let input = unsafe { slice::from_raw_parts(pointer, length) };
+
+    compress(input).len() as i32
+}
@@ -0,0 +1,137 @@
+<?php
+
+declare(strict_types = 1);
+
+/**
+ * Deterministic inputs of the corpus workloads: the same size always
+ * gives the same bytes, so that the Wasm and the PHP implementations
+ * are compared on identical inputs.
+ */
+
+/**
+ * A linear congruential generator, returning integers in [0; 32768).
+ */
+function corpus_random(int &$state): int
+{
+    $state = ($state * 1103515245 + 12345) & 0x7fffffff;
+
+    return $state >> 16;
+}
+
+function corpus_word(int &$state): string
+{
+    static $words = [
+        'the', 'quick', 'brown', 'fox', 'jumps', 'over', 'lazy', 'dog',
+        'lorem', 'ipsum', 'dolor', 'sit', 'amet', 'queue', 'kiosk', 'wasm',
+        'php', 'module', 'memory', 'instance', 'buffer', 'stack', 'quorum', 'token',
+    ];
+
+    return $words[corpus_random($state) % count($words)];
+}
+
+function corpus_words(int &$state, int $minimum, int $maximum): string
+{
+    $count = $minimum + corpus_random($state) % ($maximum - $minimum + 1);
+    $words = [];
+
+    for ($nth = 0; $nth < $count; ++$nth) {
+        $words[] = corpus_word($state);
+    }
+
+    return implode(' ', $words);
+}
+
+/**
+ * Lines of 5 to 12 words, cut at `$size` bytes.
+ */
+function corpus_text_input(int $size): string
+{
+    $state = 42;
+    $text = '';
+
+    while (strlen($text) < $size) {
+        $text .= corpus_words($state, 5, 12) . "\n";
+    }
+
+    return substr($text, 0, $size);
+}
+
+/**
+ * A pretty-printed JSON array of objects, of at least `$size` bytes.
+ */
+function corpus_json_input(int $size): string
+{
+    $state = 42;
+    $items = [];
+    $length = 2;
+
+    for ($id = 1; $length < $size; ++$id) {
+        $item =
+            '{"id": ' . $id . ', ' .
+            '"name": "' . corpus_words($state, 1, 3) . '", ' .
+            '"tags": ["' . corpus_word($state) . '", "' . corpus_word($state) . '"], ' .
+            '"score": ' . corpus_random($state) . '.5, ' .
+            '"active": ' . (0 === corpus_random($state) % 2 ? 'true' : 'false') . ', ' .
+            '"parent": null}';
+
+        $items[] = $item;
+        $length += strlen($item) + 4;
+    }
+
+    return "[\n  " . implode(",\n  ", $items) . "\n]";
+}
+
+/**
+ * A grayscale image, 256 pixels wide, of `$size` bytes.
+ */
+function corpus_image_input(int $size): string
+{
+    $state = 42;
+    $image = '';
+
+    for ($nth = 0; $nth < $size; ++$nth) {
+        $image .= chr(corpus_random($state) & 0xff);
+    }
+
+    return $image;
+}
+
+/**
+ * A Markdown document of headings, paragraphs and lists, cut at
+ * `$size` bytes.
+ */
+function corpus_markdown_input(int $size): string
+{
+    $state = 42;
+    $document = '';
+
+    while (strlen($document) < $size) {
+        switch (corpus_random($state) % 3) {
+            case 0:
+                $document .= str_repeat('#', 1 + corpus_random($state) % 3) . ' ' . corpus_words($state, 2, 5) . "\n";
+
+                break;
+
+            case 1:
+                for ($nth = 2 + corpus_random($state) % 3; $nth > 0; --$nth) {
+                    $document .=
+                        corpus_words($state, 3, 8) . ' *' . corpus_word($state) . '* ' .
+                        corpus_words($state, 1, 4) . ' `' . corpus_word($state) . ' & <' . corpus_word($state) . '>` ' .
+                        corpus_words($state, 2, 6) . "\n";
+                }
+
+                break;
+
+            case 2:
+                for ($nth = 3 + corpus_random($state) % 3; $nth > 0; --$nth) {
+                    $document .= '- ' . corpus_words($state, 2, 6) . "\n";
+                }
+
+                break;
+        }
+
+        $document .= "\n";
+    }
+
+    return substr($document, 0, $size);
+}
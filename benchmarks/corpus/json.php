@@ -0,0 +1,327 @@
+<?php
+
+declare(strict_types = 1);
+
+/**
+ * Parses a JSON document, and serializes it back without whitespace,
+ * like `json.rs`. Values are `[type, content]` pairs. The result is the
+ * length of the serialized document, or -1 if the input is invalid.
+ */
+function corpus_json_pure_php(string $input): int
+{
+    $position = 0;
+    $value = corpus_json_parse_value($input, $position);
+
+    if (null === $value) {
+        return -1;
+    }
+
+    return strlen(corpus_json_serialize($value));
+}
+
+function corpus_json_php_native(string $input): int
+{
+    $value = json_decode($input);
+
+    if (null === $value) {
+        return -1;
+    }
+
+    return strlen(json_encode($value));
+}
+
+function corpus_json_parse_value(string $input, int &$position): ?array
+{
+    $position += strspn($input, " \t\n\r", $position);
+
+    if (!isset($input[$position])) {
+        return null;
+    }
+
+    switch ($input[$position]) {
+        case 'n':
+            return corpus_json_expect($input, $position, 'null') ? ['null', null] : null;
+
+        case 't':
+            return corpus_json_expect($input, $position, 'true') ? ['boolean', true] : null;
+
+        case 'f':
+            return corpus_json_expect($input, $position, 'false') ? ['boolean', false] : null;
+
+        case '"':
+            $string = corpus_json_parse_string($input, $position);
+
+            return null === $string ? null : ['string', $string];
+
+        case '[':
+            return corpus_json_parse_array($input, $position);
+
+        case '{':
+            return corpus_json_parse_object($input, $position);
+
+        default:
+            $length = strspn($input, '+-0123456789.eE', $position);
+
+            if (0 === $length) {
+                return null;
+            }
+
+            $position += $length;
+
+            return ['number', substr($input, $position - $length, $length)];
+    }
+}
+
+function corpus_json_expect(string $input, int &$position, string $literal): bool
+{
+    $length = strlen($literal);
+
+    if (substr($input, $position, $length) !== $literal) {
+        return false;
+    }
+
+    $position += $length;
+
+    return true;
+}
+
+function corpus_json_parse_string(string $input, int &$position): ?string
+{
+    ++$position;
+
+    $string = '';
+
+    while (true) {
+        // Copy the run of unescaped bytes at once.
+        $length = strcspn($input, "\"\\", $position);
+        $string .= substr($input, $position, $length);
+        $position += $length;
+
+        if (!isset($input[$position])) {
+            return null;
+        }
+
+        if ('"' === $input[$position++]) {
+            return $string;
+        }
+
+        if (!isset($input[$position])) {
+            return null;
+        }
+
+        $escaped = $input[$position++];
+
+        switch ($escaped) {
+            case 'b':
+                $string .= "\x08";
+
+                break;
+
+            case 'f':
+                $string .= "\x0c";
+
+                break;
+
+            case 'n':
+                $string .= "\n";
+
+                break;
+
+            case 'r':
+                $string .= "\r";
+
+                break;
+
+            case 't':
+                $string .= "\t";
+
+                break;
+
+            case 'u':
+                $hexadecimal = substr($input, $position, 4);
+
+                if (4 !== strlen($hexadecimal) || !ctype_xdigit($hexadecimal)) {
+                    return null;
+                }
+
+                $position += 4;
+                $code = hexdec($hexadecimal);
+
+                // Surrogates are not characters.
+                if ($code >= 0xd800 && $code <= 0xdfff) {
+                    return null;
+                }
+
+                if ($code < 0x80) {
+                    $string .= chr($code);
+                } elseif ($code < 0x800) {
+                    $string .= chr(0xc0 | ($code >> 6)) . chr(0x80 | ($code & 0x3f));
+                } else {
+                    $string .= chr(0xe0 | ($code >> 12)) . chr(0x80 | (($code >> 6) & 0x3f)) . chr(0x80 | ($code & 0x3f));
+                }
+
+                break;
+
+            default:
+                $string .= $escaped;
+        }
+    }
+}
+
+function corpus_json_parse_array(string $input, int &$position): ?array
+{
+    ++$position;
+
+    $items = [];
+    $position += strspn($input, " \t\n\r", $position);
+
+    if (!isset($input[$position])) {
+        return null;
+    }
+
+    if (']' === $input[$position]) {
+        ++$position;
+
+        return ['array', $items];
+    }
+
+    while (true) {
+        $item = corpus_json_parse_value($input, $position);
+
+        if (null === $item) {
+            return null;
+        }
+
+        $items[] = $item;
+        $position += strspn($input, " \t\n\r", $position);
+
+        if (!isset($input[$position])) {
+            return null;
+        }
+
+        switch ($input[$position++]) {
+            case ',':
+                break;
+
+            case ']':
+                return ['array', $items];
+
+            default:
+                return null;
+        }
+    }
+}
+
+function corpus_json_parse_object(string $input, int &$position): ?array
+{
+    ++$position;
+
+    $pairs = [];
+    $position += strspn($input, " \t\n\r", $position);
+
+    if (!isset($input[$position])) {
+        return null;
+    }
+
+    if ('}' === $input[$position]) {
+        ++$position;
+
+        return ['object', $pairs];
+    }
+
+    while (true) {
+        $position += strspn($input, " \t\n\r", $position);
+
+        if (!isset($input[$position]) || '"' !== $input[$position]) {
+            return null;
+        }
+
+        $key = corpus_json_parse_string($input, $position);
+
+        if (null === $key) {
+            return null;
+        }
+
+        $position += strspn($input, " \t\n\r", $position);
+
+        if (false === corpus_json_expect($input, $position, ':')) {
+            return null;
+        }
+
+        $item = corpus_json_parse_value($input, $position);
+
+        if (null === $item) {
+            return null;
+        }
+
+        $pairs[] = [$key, $item];
+        $position += strspn($input, " \t\n\r", $position);
+
+        if (!isset($input[$position])) {
+            return null;
+        }
+
+        switch ($input[$position++]) {
+            case ',':
+                break;
+
+            case '}':
+                return ['object', $pairs];
+
+            default:
+                return null;
+        }
+    }
+}
+
+function corpus_json_serialize_string(string $string): string
+{
+    static $escapes = null;
+
+    if (null === $escapes) {
+        $escapes = ['"' => '\\"', '\\' => '\\\\', "\n" => '\\n', "\r" => '\\r', "\t" => '\\t'];
+
+        for ($byte = 0; $byte < 0x20; ++$byte) {
+            $escapes += [chr($byte) => sprintf('\\u%04x', $byte)];
+        }
+    }
+
+    return '"' . strtr($string, $escapes) . '"';
+}
+
+function corpus_json_serialize(array $value): string
+{
+    list($type, $content) = $value;
+
+    switch ($type) {
+        case 'null':
+            return 'null';
+
+        case 'boolean':
+            return $content ? 'true' : 'false';
+
+        case 'number':
+            return $content;
+
+        case 'string':
+            return corpus_json_serialize_string($content);
+
+        case 'array':
+            $items = [];
+
+            foreach ($content as $item) {
+                $items[] = corpus_json_serialize($item);
+            }
+
+            return '[' . implode(',', $items) . ']';
+
+        case 'object':
+            $pairs = [];
+
+            foreach ($content as list($key, $item)) {
+                $pairs[] = corpus_json_serialize_string($key) . ':' . corpus_json_serialize($item);
+            }
+
+            return '{' . implode(',', $pairs) . '}';
+    }
+}
@@ -0,0 +1,260 @@
+// Parses a JSON document, and serializes it back without whitespace.
+// Numbers keep their source text. The result is the length of the
+// serialized document, or -1 if the input is invalid.
+use std::mem;
+use std::os::raw::c_void;
+use std::slice;
+
+#[no_mangle]
+pub extern fn allocate(size: usize) -> *mut c_void {
+    let mut buffer = Vec::<u8>::with_capacity(size);
+    let pointer = buffer.as_mut_ptr();
+    mem::forget(buffer);
+
+    pointer as *mut c_void
+}
+
+#[no_mangle]
+pub extern fn deallocate(pointer: *mut c_void, capacity: usize) {
+    unsafe {
+        let _ = Vec::from_raw_parts(pointer as *mut u8, 0, capacity);
+    }
+}
+
+enum Value {
+    Null,
+    Boolean(bool),
+    Number(Vec<u8>),
+    String(Vec<u8>),
+    Array(Vec<Value>),
+    Object(Vec<(Vec<u8>, Value)>),
+}
+
+struct Parser<'a> {
+    input: &'a [u8],
+    position: usize,
+}
+
+impl<'a> Parser<'a> {
+    fn skip_whitespace(&mut self) {
+        while self.position < self.input.len() && b" \t\n\r".contains(&self.input[self.position]) {
+            self.position += 1;
+        }
+    }
+
+    fn peek(&self) -> Option<u8> {
+        self.input.get(self.position).cloned()
+    }
+
+    fn expect(&mut self, literal: &[u8]) -> Option<()> {
+        if self.input[self.position..].starts_with(literal) {
+            self.position += literal.len();
+
+            Some(())
+        } else {
+            None
+        }
+    }
+
+    fn parse_value(&mut self) -> Option<Value> {
+        self.skip_whitespace();
+
+        match self.peek()? {
+            b'n' => self.expect(b"null").map(|_| Value::Null),
+            b't' => self.expect(b"true").map(|_| Value::Boolean(true)),
+            b'f' => self.expect(b"false").map(|_| Value::Boolean(false)),
+            b'"' => self.parse_string().map(Value::String),
+            b'[' => self.parse_array(),
+            b'{' => self.parse_object(),
+            _ => self.parse_number(),
+        }
+    }
+
+    fn parse_number(&mut self) -> Option<Value> {
+        let start = self.position;
+
+        while self.position < self.input.len() && b"+-0123456789.eE".contains(&self.input[self.position]) {
+            self.position += 1;
+        }
+
+        if start == self.position {
+            None
+        } else {
+            Some(Value::Number(self.input[start..self.position].to_vec()))
+        }
+    }
+
+    fn parse_string(&mut self) -> Option<Vec<u8>> {
+        self.position += 1;
+
+        let mut string = Vec::new();
+
+        loop {
+            let byte = self.peek()?;
+            self.position += 1;
+
+            match byte {
+                b'"' => return Some(string),
+                b'\\' => {
+                    let escaped = self.peek()?;
+                    self.position += 1;
+
+                    match escaped {
+                        b'b' => string.push(0x08),
+                        b'f' => string.push(0x0c),
+                        b'n' => string.push(b'\n'),
+                        b'r' => string.push(b'\r'),
+                        b't' => string.push(b'\t'),
+                        b'u' => {
+                            let hexadecimal = self.input.get(self.position..self.position + 4)?;
+                            let code = u32::from_str_radix(std::str::from_utf8(hexadecimal).ok()?, 16).ok()?;
+                            self.position += 4;
+
+                            let mut utf8 = [0u8; 4];
+                            string.extend_from_slice(std::char::from_u32(code)?.encode_utf8(&mut utf8).as_bytes());
+                        },
+                        _ => string.push(escaped),
+                    }
+                },
+                _ => string.push(byte),
+            }
+        }
+    }
+
+    fn parse_array(&mut self) -> Option<Value> {
+        self.position += 1;
+
+        let mut items = Vec::new();
+        self.skip_whitespace();
+
+        if self.peek()? == b']' {
+            self.position += 1;
+
+            return Some(Value::Array(items));
+        }
+
+        loop {
+            items.push(self.parse_value()?);
+            self.skip_whitespace();
+
+            match self.peek()? {
+                b',' => self.position += 1,
+                b']' => {
+                    self.position += 1;
+
+                    return Some(Value::Array(items));
+                },
+                _ => return None,
+            }
+        }
+    }
+
+    fn parse_object(&mut self) -> Option<Value> {
+        self.position += 1;
+
+        let mut pairs = Vec::new();
+        self.skip_whitespace();
+
+        if self.peek()? == b'}' {
+            self.position += 1;
+
+            return Some(Value::Object(pairs));
+        }
+
+        loop {
+            self.skip_whitespace();
+
+            if self.peek()? != b'"' {
+                return None;
+            }
+
+            let key = self.parse_string()?;
+            self.skip_whitespace();
+            self.expect(b":")?;
+            pairs.push((key, self.parse_value()?));
+            self.skip_whitespace();
+
+            match self.peek()? {
+                b',' => self.position += 1,
+                b'}' => {
+                    self.position += 1;
+
+                    return Some(Value::Object(pairs));
+                },
+                _ => return None,
+            }
+        }
+    }
+}
+
+fn serialize_string(string: &[u8], output: &mut Vec<u8>) {
+    output.push(b'"');
+
+    for &byte in string {
+        match byte {
+            b'"' => output.extend_from_slice(b"\\\""),
+            b'\\' => output.extend_from_slice(b"\\\\"),
+            b'\n' => output.extend_from_slice(b"\\n"),
+            b'\r' => output.extend_from_slice(b"\\r"),
+            b'\t' => output.extend_from_slice(b"\\t"),
+            0x00..=0x1f => output.extend_from_slice(format!("\\u{:04x}", byte).as_bytes()),
+            _ => output.push(byte),
+        }
+    }
+
+    output.push(b'"');
+}
+
+fn serialize(value: &Value, output: &mut Vec<u8>) {
+    match value {
+        Value::Null => output.extend_from_slice(b"null"),
+        Value::Boolean(true) => output.extend_from_slice(b"true"),
+        Value::Boolean(false) => output.extend_from_slice(b"false"),
+        Value::Number(number) => output.extend_from_slice(number),
+        Value::String(string) => serialize_string(string, output),
+        Value::Array(items) => {
+            output.push(b'[');
+
+            for (nth, item) in items.iter().enumerate() {
+                if nth > 0 {
+                    output.push(b',');
+                }
+
+                serialize(item, output);
+            }
+
+            output.push(b']');
+        },
+        Value::Object(pairs) => {
+            output.push(b'{');
+
+            for (nth, (key, item)) in pairs.iter().enumerate() {
+                if nth > 0 {
+                    output.push(b',');
+                }
+
+                serialize_string(key, output);
+                output.push(b':');
+                serialize(item, output);
+            }
+
+            output.push(b'}');
+        },
+    }
+}
+
+#[no_mangle]
+pub extern fn run(pointer: *const u8, length: usize) -> i32 {
+    let input = unsafe { slice::from_raw_parts(pointer, length) };
+    let mut parser = Parser { input: input, position: 0 };
+
+    match parser.parse_value() {
+        Some(value) => {
+            let mut output = Vec::with_capacity(length);
+            serialize(&value, &mut output);
+
+            output.len() as i32
+        },
+        None => -1,
+    }
+}
@@ -0,0 +1,96 @@
+<?php
+
+declare(strict_types = 1);
+
+/**
+ * Renders a subset of Markdown to HTML, like `markdown.rs`. The result
+ * is the length of the HTML document.
+ */
+function corpus_markdown_pure_php(string $input): int
+{
+    $output = '';
+    $paragraph = '';
+    $inList = false;
+
+    foreach (explode("\n", $input) as $line) {
+        $level = strspn($line, '#');
+        $isHeading = $level >= 1 && $level <= 6 && isset($line[$level]) && ' ' === $line[$level];
+        $isItem = 0 === strncmp($line, '- ', 2);
+
+        // A heading, an item or a blank line ends the paragraph.
+        if ('' !== $paragraph && ($isHeading || $isItem || '' === $line)) {
+            $output .= '<p>' . corpus_markdown_render_inline($paragraph) . "</p>\n";
+            $paragraph = '';
+        }
+
+        if ($inList && !$isItem) {
+            $output .= "</ul>\n";
+            $inList = false;
+        }
+
+        if ($isHeading) {
+            $output .= '<h' . $level . '>' . corpus_markdown_render_inline((string) substr($line, $level + 1)) . '</h' . $level . ">\n";
+        } elseif ($isItem) {
+            if (!$inList) {
+                $output .= "<ul>\n";
+                $inList = true;
+            }
+
+            $output .= '<li>' . corpus_markdown_render_inline((string) substr($line, 2)) . "</li>\n";
+        } elseif ('' !== $line) {
+            if ('' !== $paragraph) {
+                $paragraph .= "\n";
+            }
+
+            $paragraph .= $line;
+        }
+    }
+
+    if ('' !== $paragraph) {
+        $output .= '<p>' . corpus_markdown_render_inline($paragraph) . "</p>\n";
+    }
+
+    if ($inList) {
+        $output .= "</ul>\n";
+    }
+
+    return strlen($output);
+}
+
+function corpus_markdown_render_inline(string $text): string
+{
+    $output = '';
+    $emphasis = false;
+    $code = false;
+    $length = strlen($text);
+
+    for ($nth = 0; $nth < $length; ++$nth) {
+        $byte = $text[$nth];
+
+        if ('`' === $byte) {
+            $output .= $code ? '</code>' : '<code>';
+            $code = !$code;
+        } elseif ('*' === $byte && !$code) {
+            $output .= $emphasis ? '</em>' : '<em>';
+            $emphasis = !$emphasis;
+        } elseif ('&' === $byte) {
+            $output .= '&amp;';
+        } elseif ('<' === $byte) {
+            $output .= '&lt;';
+        } elseif ('>' === $byte) {
+            $output .= '&gt;';
+        } else {
+            $output .= $byte;
+        }
+    }
+
+    if ($code) {
+        $output .= '</code>';
+    }
+
+    if ($emphasis) {
+        $output .= '</em>';
+    }
+
+    return $output;
+}
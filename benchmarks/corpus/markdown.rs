@@ -0,0 +1,117 @@
+// Renders a subset of Markdown to HTML: headings, bullet lists,
+// paragraphs, `*emphasis*` and `` `code` ``. The result is the length
+// of the HTML document.
+use std::mem;
+use std::os::raw::c_void;
+use std::slice;
+
+#[no_mangle]
+pub extern fn allocate(size: usize) -> *mut c_void {
+    let mut buffer = Vec::<u8>::with_capacity(size);
+    let pointer = buffer.as_mut_ptr();
+    mem::forget(buffer);
+
+    pointer as *mut c_void
+}
+
+#[no_mangle]
+pub extern fn deallocate(pointer: *mut c_void, capacity: usize) {
+    unsafe {
+        let _ = Vec::from_raw_parts(pointer as *mut u8, 0, capacity);
+    }
+}
+
+fn render_inline(text: &[u8], output: &mut Vec<u8>) {
+    let mut emphasis = false;
+    let mut code = false;
+
+    for &byte in text {
+        match byte {
+            b'`' => {
+                output.extend_from_slice(if code { b"</code>" as &[u8] } else { b"<code>" });
+                code = !code;
+            },
+            b'*' if !code => {
+                output.extend_from_slice(if emphasis { b"</em>" as &[u8] } else { b"<em>" });
+                emphasis = !emphasis;
+            },
+            b'&' => output.extend_from_slice(b"&amp;"),
+            b'<' => output.extend_from_slice(b"&lt;"),
+            b'>' => output.extend_from_slice(b"&gt;"),
+            _ => output.push(byte),
+        }
+    }
+
+    if code {
+        output.extend_from_slice(b"</code>");
+    }
+
+    if emphasis {
+        output.extend_from_slice(b"</em>");
+    }
+}
+
+fn render(input: &[u8]) -> Vec<u8> {
+    let mut output = Vec::with_capacity(input.len() * 2);
+    let mut paragraph: Vec<u8> = Vec::new();
+    let mut in_list = false;
+
+    for line in input.split(|&byte| byte == b'\n') {
+        let level = line.iter().take_while(|&&byte| byte == b'#').count();
+        let is_heading = level >= 1 && level <= 6 && line.get(level) == Some(&b' ');
+        let is_item = line.starts_with(b"- ");
+
+        // A heading, an item or a blank line ends the paragraph.
+        if !paragraph.is_empty() && (is_heading || is_item || line.is_empty()) {
+            output.extend_from_slice(b"<p>");
+            render_inline(&paragraph, &mut output);
+            output.extend_from_slice(b"</p>\n");
+            paragraph.clear();
+        }
+
+        if in_list && !is_item {
+            output.extend_from_slice(b"</ul>\n");
+            in_list = false;
+        }
+
+        if is_heading {
+            output.extend_from_slice(format!("<h{}>", level).as_bytes());
+            render_inline(&line[level + 1..], &mut output);
+            output.extend_from_slice(format!("</h{}>\n", level).as_bytes());
+        } else if is_item {
+            if !in_list {
+                output.extend_from_slice(b"<ul>\n");
+                in_list = true;
+            }
+
+            output.extend_from_slice(b"<li>");
+            render_inline(&line[2..], &mut output);
+            output.extend_from_slice(b"</li>\n");
+        } else if !line.is_empty() {
+            if !paragraph.is_empty() {
+                paragraph.push(b'\n');
+            }
+
+            paragraph.extend_from_slice(line);
+        }
+    }
+
+    if !paragraph.is_empty() {
+        output.extend_from_slice(b"<p>");
+        render_inline(&paragraph, &mut output);
+        output.extend_from_slice(b"</p>\n");
+    }
+
+    if in_list {
+        output.extend_from_slice(b"</ul>\n");
+    }
+
+    output
+}
+
+#[no_mangle]
+pub extern fn run(pointer: *const u8, length: usize) -> i32 {
+    let input = unsafe { slice::from_raw_parts(pointer, length) };
+
+    render(input).len() as i32
+}
@@ -0,0 +1,82 @@
+<?php
+
+declare(strict_types = 1);
+
+/**
+ * Counts the lines matching the `qu.*k.*o` regular expression, with
+ * the matcher of Rob Pike, like `regex.rs`.
+ */
+function corpus_regex_pure_php(string $input): int
+{
+    $count = 0;
+
+    foreach (explode("\n", $input) as $line) {
+        if (corpus_regex_is_match('qu.*k.*o', $line)) {
+            ++$count;
+        }
+    }
+
+    return $count;
+}
+
+function corpus_regex_php_native(string $input): int
+{
+    return preg_match_all('/qu.*k.*o/', $input);
+}
+
+function corpus_regex_is_match(string $pattern, string $text): bool
+{
+    if ('' !== $pattern && '^' === $pattern[0]) {
+        return corpus_regex_match_here($pattern, 1, $text, 0);
+    }
+
+    $textLength = strlen($text);
+
+    for ($t = 0; ; ++$t) {
+        if (corpus_regex_match_here($pattern, 0, $text, $t)) {
+            return true;
+        }
+
+        if ($t === $textLength) {
+            return false;
+        }
+    }
+}
+
+function corpus_regex_match_here(string $pattern, int $p, string $text, int $t): bool
+{
+    $patternLength = strlen($pattern);
+
+    if ($p === $patternLength) {
+        return true;
+    }
+
+    if ($p + 1 < $patternLength && '*' === $pattern[$p + 1]) {
+        return corpus_regex_match_star($pattern[$p], $pattern, $p + 2, $text, $t);
+    }
+
+    if ('$' === $pattern[$p] && $p + 1 === $patternLength) {
+        return $t === strlen($text);
+    }
+
+    if (isset($text[$t]) && ('.' === $pattern[$p] || $pattern[$p] === $text[$t])) {
+        return corpus_regex_match_here($pattern, $p + 1, $text, $t + 1);
+    }
+
+    return false;
+}
+
+function corpus_regex_match_star(string $character, string $pattern, int $p, string $text, int $t): bool
+{
+    while (true) {
+        if (corpus_regex_match_here($pattern, $p, $text, $t)) {
+            return true;
+        }
+
+        if (!isset($text[$t]) || ('.' !== $character && $character !== $text[$t])) {
+            return false;
+        }
+
+        ++$t;
+    }
+}
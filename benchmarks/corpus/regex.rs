@@ -0,0 +1,82 @@
+// Counts the lines matching the `qu.*k.*o` regular expression, with
+// the matcher of Rob Pike (`c`, `.`, `^`, `$` and `*`).
+use std::mem;
+use std::os::raw::c_void;
+use std::slice;
+
+#[no_mangle]
+pub extern fn allocate(size: usize) -> *mut c_void {
+    let mut buffer = Vec::<u8>::with_capacity(size);
+    let pointer = buffer.as_mut_ptr();
+    mem::forget(buffer);
+
+    pointer as *mut c_void
+}
+
+#[no_mangle]
+pub extern fn deallocate(pointer: *mut c_void, capacity: usize) {
+    unsafe {
+        let _ = Vec::from_raw_parts(pointer as *mut u8, 0, capacity);
+    }
+}
+
+const PATTERN: &[u8] = b"qu.*k.*o";
+
+fn match_here(pattern: &[u8], text: &[u8]) -> bool {
+    if pattern.is_empty() {
+        return true;
+    }
+
+    if pattern.len() >= 2 && pattern[1] == b'*' {
+        return match_star(pattern[0], &pattern[2..], text);
+    }
+
+    if pattern == b"$" {
+        return text.is_empty();
+    }
+
+    if !text.is_empty() && (pattern[0] == b'.' || pattern[0] == text[0]) {
+        return match_here(&pattern[1..], &text[1..]);
+    }
+
+    false
+}
+
+fn match_star(character: u8, pattern: &[u8], mut text: &[u8]) -> bool {
+    loop {
+        if match_here(pattern, text) {
+            return true;
+        }
+
+        if text.is_empty() || (character != b'.' && character != text[0]) {
+            return false;
+        }
+
+        text = &text[1..];
+    }
+}
+
+fn is_match(pattern: &[u8], mut text: &[u8]) -> bool {
+    if !pattern.is_empty() && pattern[0] == b'^' {
+        return match_here(&pattern[1..], text);
+    }
+
+    loop {
+        if match_here(pattern, text) {
+            return true;
+        }
+
+        if text.is_empty() {
+            return false;
+        }
+
+        text = &text[1..];
+    }
+}
+
+#[no_mangle]
+pub extern fn run(pointer: *const u8, length: usize) -> i32 {
+    let input = unsafe { slice::from_raw_parts(pointer, length) };
+
+    input.split(|&byte| byte == b'\n').filter(|line| is_match(PATTERN, line)).count() as i32
+}
@@ -0,0 +1,78 @@
+<?php
+
+declare(strict_types = 1);
+
+/**
+ * The SHA-256 digest of the input, like `sha256.rs`. The result is its
+ * first 3 bytes.
+ */
+function corpus_sha256_pure_php(string $input): int
+{
+    static $k = [
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    ];
+
+    $state = [0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19];
+    $length = strlen($input);
+
+    // Pad with 0x80, zeros, and the bit length.
+    $input .= "\x80" . str_repeat("\x00", (55 - $length) & 63) . pack('J', $length * 8);
+    $paddedLength = strlen($input);
+
+    for ($offset = 0; $offset < $paddedLength; $offset += 64) {
+        $w = array_values(unpack('N16', $input, $offset));
+
+        for ($t = 16; $t < 64; ++$t) {
+            $x = $w[$t - 15];
+            $y = $w[$t - 2];
+            $s0 = ((($x >> 7) | ($x << 25)) ^ (($x >> 18) | ($x << 14)) ^ ($x >> 3)) & 0xffffffff;
+            $s1 = ((($y >> 17) | ($y << 15)) ^ (($y >> 19) | ($y << 13)) ^ ($y >> 10)) & 0xffffffff;
+            $w[$t] = ($w[$t - 16] + $s0 + $w[$t - 7] + $s1) & 0xffffffff;
+        }
+
+        list($a, $b, $c, $d, $e, $f, $g, $h) = $state;
+
+        for ($t = 0; $t < 64; ++$t) {
+            $s1 = ((($e >> 6) | ($e << 26)) ^ (($e >> 11) | ($e << 21)) ^ (($e >> 25) | ($e << 7))) & 0xffffffff;
+            $choice = ($e & $f) ^ (~$e & $g);
+            $t1 = ($h + $s1 + $choice + $k[$t] + $w[$t]) & 0xffffffff;
+            $s0 = ((($a >> 2) | ($a << 30)) ^ (($a >> 13) | ($a << 19)) ^ (($a >> 22) | ($a << 10))) & 0xffffffff;
+            $majority = ($a & $b) ^ ($a & $c) ^ ($b & $c);
+            $t2 = ($s0 + $majority) & 0xffffffff;
+
+            $h = $g;
+            $g = $f;
+            $f = $e;
+            $e = ($d + $t1) & 0xffffffff;
+            $d = $c;
+            $c = $b;
+            $b = $a;
+            $a = ($t1 + $t2) & 0xffffffff;
+        }
+
+        $state[0] = ($state[0] + $a) & 0xffffffff;
+        $state[1] = ($state[1] + $b) & 0xffffffff;
+        $state[2] = ($state[2] + $c) & 0xffffffff;
+        $state[3] = ($state[3] + $d) & 0xffffffff;
+        $state[4] = ($state[4] + $e) & 0xffffffff;
+        $state[5] = ($state[5] + $f) & 0xffffffff;
+        $state[6] = ($state[6] + $g) & 0xffffffff;
+        $state[7] = ($state[7] + $h) & 0xffffffff;
+    }
+
+    return $state[0] >> 8;
+}
+
+function corpus_sha256_php_native(string $input): int
+{
+    $digest = hash('sha256', $input, true);
+
+    return (ord($digest[0]) << 16) | (ord($digest[1]) << 8) | ord($digest[2]);
+}
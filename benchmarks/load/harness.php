@@ -0,0 +1,126 @@
+<?php
+
+declare(strict_types = 1);
+
+/**
+ * A load test simulating a FPM pool: it spawns `workers` PHP CLI
+ * processes that start at the same time, each running `requests`
+ * requests of `request.php`. It reports the throughput, the latency
+ * percentiles, the resident memory of each worker, and how many times
+ * the module has been compiled.
+ *
+ * This is what the phpbench subjects, running in one process, cannot
+ * show: cache stampedes when the workers start, the growth of the
+ * persistent resources, and the memory per worker.
+ *
+ * Usage:
+ *
+ * ```sh
+ * $ php benchmarks/load/harness.php --workers=8 --requests=500 --strategy=filesystem
+ * ```
+ */
+
+$options = getopt('', ['workers:', 'requests:', 'strategy:', 'module:', 'php:']) + [
+    'workers' => 4,
+    'requests' => 200,
+    'strategy' => 'persistent',
+    'module' => dirname(__DIR__, 2) . '/examples/greet.wasm',
+    'php' => PHP_BINARY,
+];
+
+$numberOfWorkers = max(1, (int) $options['workers']);
+$numberOfRequests = max(1, (int) $options['requests']);
+$strategy = $options['strategy'];
+
+if (false === in_array($strategy, ['compile', 'persistent', 'filesystem'], true)) {
+    fwrite(STDERR, "The strategy `$strategy` is unknown, expected `compile`, `persistent` or `filesystem`.\n");
+
+    exit(1);
+}
+
+$cacheDirectory = sys_get_temp_dir() . '/php-ext-wasm-load-' . getmypid();
+@mkdir($cacheDirectory);
+
+// Give the workers the time to boot, so that they all start together.
+$startTime = microtime(true) + 0.5 + 0.05 * $numberOfWorkers;
+$workers = [];
+
+for ($nth = 0; $nth < $numberOfWorkers; ++$nth) {
+    $command = implode(' ', array_map('escapeshellarg', [
+        $options['php'],
+        '-d', 'extension=wasm',
+        __DIR__ . '/worker.php',
+        $strategy,
+        (string) $numberOfRequests,
+        sprintf('%.6f', $startTime),
+        $options['module'],
+        $cacheDirectory,
+    ]));
+
+    $process = proc_open($command, [1 => ['pipe', 'w'], 2 => STDERR], $pipes);
+
+    if (false === is_resource($process)) {
+        fwrite(STDERR, "Cannot spawn the worker #$nth.\n");
+
+        exit(1);
+    }
+
+    $workers[] = [$process, $pipes[1]];
+}
+
+$reports = [];
+
+foreach ($workers as $nth => list($process, $output)) {
+    $report = json_decode(stream_get_contents($output), true);
+    fclose($output);
+
+    if (0 !== proc_close($process) || null === $report) {
+        fwrite(STDERR, "The worker #$nth has failed.\n");
+
+        exit(1);
+    }
+
+    $reports[] = $report;
+}
+
+array_map('unlink', glob($cacheDirectory . '/*') ?: []);
+@rmdir($cacheDirectory);
+
+$latencies = array_merge(...array_column($reports, 'latencies'));
+sort($latencies);
+
+$duration = max(array_column($reports, 'end')) - min(array_column($reports, 'start'));
+$numberOfLatencies = count($latencies);
+
+$percentile = function (float $percent) use ($latencies, $numberOfLatencies): float {
+    return $latencies[min($numberOfLatencies - 1, (int) ceil($percent / 100 * $numberOfLatencies) - 1)];
+};
+
+$rss = function (?int $kilobytes): string {
+    return null === $kilobytes ? 'n/a' : sprintf('%.1f MB', $kilobytes / 1024);
+};
+
+printf("strategy     %s\n", $strategy);
+printf("workers      %d\n", $numberOfWorkers);
+printf("requests     %d (%d per worker)\n", $numberOfLatencies, $numberOfRequests);
+printf("duration     %.3f s\n", $duration);
+printf("throughput   %.1f requests/s\n", $numberOfLatencies / $duration);
+printf("compiles     %d\n", array_sum(array_column($reports, 'compiles')));
+printf("\nlatency (µs)\n");
+printf("  min        %.1f\n", $latencies[0]);
+printf("  p50        %.1f\n", $percentile(50));
+printf("  p90        %.1f\n", $percentile(90));
+printf("  p99        %.1f\n", $percentile(99));
+printf("  max        %.1f\n", $latencies[$numberOfLatencies - 1]);
+printf("\n%-8s %10s %18s %18s %14s\n", 'worker', 'compiles', 'rss first request', 'rss last request', 'php peak');
+
+foreach ($reports as $report) {
+    printf(
+        "%-8d %10d %18s %18s %11.1f MB\n",
+        $report['pid'],
+        $report['compiles'],
+        $rss($report['rss_after_first_request']),
+        $rss($report['rss_after_last_request']),
+        $report['memory_peak_usage'] / (1024 * 1024)
+    );
+}
@@ -0,0 +1,78 @@
+<?php
+
+declare(strict_types = 1);
+
+/**
+ * A representative request: it gets the module of `examples/greet.wasm`
+ * with the given strategy, instantiates it, writes a subject into the
+ * memory, calls `greet`, and reads the greeting back from the memory.
+ *
+ * The strategies are:
+ *
+ *   * `compile`, the module is compiled by every request,
+ *   * `persistent`, the module is a persistent resource, compiled once
+ *     per worker,
+ *   * `filesystem`, the module is fetched from a `Wasm\Cache\Filesystem`
+ *     cache shared by the workers, and compiled on a miss.
+ *
+ * It returns whether the request compiled the module.
+ */
+function wasm_load_request(string $strategy, string $filePath, ?Wasm\Cache\Filesystem $cache): bool
+{
+    // Persistent resources live as long as the worker process, so
+    // only its first request compiles.
+    static $persistentModuleCompiled = false;
+
+    $compiled = false;
+
+    switch ($strategy) {
+        case 'compile':
+            $module = new Wasm\Module($filePath);
+            $compiled = true;
+
+            break;
+
+        case 'persistent':
+            $module = new Wasm\Module($filePath, Wasm\Module::PERSISTENT);
+            $compiled = false === $persistentModuleCompiled;
+            $persistentModuleCompiled = true;
+
+            break;
+
+        case 'filesystem':
+            $module = $cache->get('load');
+
+            if (null === $module) {
+                $module = new Wasm\Module($filePath);
+                $cache->set('load', $module);
+                $compiled = true;
+            }
+
+            break;
+
+        default:
+            throw new InvalidArgumentException("The strategy `$strategy` is unknown, expected `compile`, `persistent` or `filesystem`.");
+    }
+
+    $instance = $module->instantiate();
+
+    $subject = 'worker ' . getmypid() . ', request ' . mt_rand();
+    $length = strlen($subject);
+
+    // C-string terminates by NULL.
+    $inputPointer = $instance->allocate($length + 1);
+    WasmArrayBuffer::fromString($subject . "\0")->copyTo($instance->getMemoryBuffer(), 0, $inputPointer, $length + 1);
+
+    $outputPointer = $instance->greet($inputPointer);
+    $outputLength = $length + 8;
+    $output = stream_get_contents($instance->getMemoryBuffer()->openStream($outputPointer, $outputLength));
+
+    if ('Hello, ' . $subject . '!' !== $output) {
+        throw new RuntimeException('The greeting read from the memory is invalid.');
+    }
+
+    $instance->deallocate($inputPointer, $length + 1);
+    $instance->deallocate($outputPointer, $outputLength);
+
+    return $compiled;
+}
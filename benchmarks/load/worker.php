@@ -0,0 +1,66 @@
+<?php
+
+declare(strict_types = 1);
+
+/**
+ * A worker of `harness.php`, like a child of a FPM pool: it waits for
+ * the start time shared by all the workers, runs the requests one after
+ * the other, and prints its measures as JSON.
+ *
+ * Usage: php -d extension=wasm worker.php <strategy> <requests> <start time> <module> <cache directory>
+ */
+
+require_once dirname(__DIR__, 2) . '/vendor/autoload.php';
+require_once __DIR__ . '/request.php';
+
+list(, $strategy, $numberOfRequests, $startTime, $filePath, $cacheDirectory) = $argv;
+
+/**
+ * The resident set size of the process in KB, `null` where `/proc` is
+ * not available.
+ */
+function wasm_load_rss(): ?int
+{
+    $status = @file_get_contents('/proc/self/status');
+
+    if (false === $status || 0 === preg_match('/^VmRSS:\s+(\d+)/m', $status, $matches)) {
+        return null;
+    }
+
+    return (int) $matches[1];
+}
+
+$cache = 'filesystem' === $strategy ? new Wasm\Cache\Filesystem($cacheDirectory) : null;
+$latencies = [];
+$compiles = 0;
+
+if ((float) $startTime > microtime(true)) {
+    time_sleep_until((float) $startTime);
+}
+
+$start = microtime(true);
+
+for ($nth = 0; $nth < (int) $numberOfRequests; ++$nth) {
+    $requestStart = hrtime(true);
+
+    if (true === wasm_load_request($strategy, $filePath, $cache)) {
+        ++$compiles;
+    }
+
+    $latencies[] = (hrtime(true) - $requestStart) / 1000;
+
+    if (0 === $nth) {
+        $firstRss = wasm_load_rss();
+    }
+}
+
+echo json_encode([
+    'pid' => getmypid(),
+    'start' => $start,
+    'end' => microtime(true),
+    'latencies' => $latencies,
+    'compiles' => $compiles,
+    'rss_after_first_request' => $firstRss ?? null,
+    'rss_after_last_request' => wasm_load_rss(),
+    'memory_peak_usage' => memory_get_peak_usage(),
+]), "\n";
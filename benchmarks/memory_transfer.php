@@ -0,0 +1,63 @@
+<?php
+
+declare(strict_types = 1);
+
+/**
+ * Measures the data path between PHP strings and buffers, from 1 KB
+ * to 100 MB.
+ *
+ * @BeforeMethods({"initialize"})
+ * @ParamProviders({"provide_sizes"})
+ * @Warmup(1)
+ * @Revs(10)
+ * @Iterations(5)
+ * @OutputTimeUnit("microseconds", precision=3)
+ * @OutputMode("time")
+ */
+class MemoryTransfer
+{
+    private $payload = null;
+    private $buffer = null;
+    private $view = null;
+
+    public function provide_sizes()
+    {
+        foreach (['1KB' => 1 << 10, '64KB' => 64 << 10, '1MB' => 1 << 20, '16MB' => 16 << 20, '100MB' => 100 << 20] as $name => $size) {
+            yield $name => ['size' => $size];
+        }
+    }
+
+    public function initialize(array $parameters)
+    {
+        $this->payload = str_repeat("\x2a", $parameters['size']);
+        $this->buffer = new WasmArrayBuffer($parameters['size']);
+        $this->view = new WasmUint8Array($this->buffer);
+    }
+
+    public function bench_write_string(array $parameters)
+    {
+        WasmArrayBuffer::fromString($this->payload)->copyTo($this->buffer, 0, 0, $parameters['size']);
+    }
+
+    public function bench_read_string(array $parameters)
+    {
+        return stream_get_contents($this->buffer->openStream());
+    }
+
+    public function bench_typed_array_fill(array $parameters)
+    {
+        $this->view->fill(42);
+    }
+
+    public function bench_typed_array_sum(array $parameters)
+    {
+        return $this->view->sum();
+    }
+
+    public function bench_typed_array_copy_within(array $parameters)
+    {
+        $half = $parameters['size'] >> 1;
+
+        $this->view->copyWithin(0, $half);
+    }
+}
@@ -0,0 +1,156 @@
+<?php
+
+declare(strict_types = 1);
+
+/**
+ * Measures the cold-start path of a module, from its bytes to an
+ * instance, for small, medium and large modules.
+ *
+ * @BeforeMethods({"initialize"})
+ * @AfterMethods({"clean_up"})
+ * @ParamProviders({"provide_modules"})
+ * @Warmup(1)
+ * @Revs(20)
+ * @Iterations(5)
+ * @OutputTimeUnit("milliseconds", precision=3)
+ * @OutputMode("time")
+ */
+class ModuleLifecycle
+{
+    private $filePath = null;
+    private $wasmModule = null;
+    private $serializedWasmModule = null;
+    private $cacheDirectory = null;
+    private $cache = null;
+
+    public function provide_modules()
+    {
+        // 338 bytes.
+        yield 'small' => ['module' => 'small', 'file_path' => __DIR__ . '/../tests/units/tests.wasm'];
+
+        // 19 KB.
+        yield 'medium' => ['module' => 'medium', 'file_path' => __DIR__ . '/nbody.wasm'];
+
+        // 1.2 MB.
+        yield 'large' => ['module' => 'large', 'file_path' => self::large_module_file_path()];
+    }
+
+    public function initialize(array $parameters)
+    {
+        $this->filePath = $parameters['file_path'];
+        $this->wasmModule = wasm_compile(wasm_fetch_bytes($this->filePath));
+        $this->serializedWasmModule = wasm_module_serialize($this->wasmModule);
+
+        // Warm the persistent module up.
+        wasm_compile(wasm_fetch_bytes($this->filePath), $this->persistent_identifier($parameters));
+
+        // Warm the cache up.
+        $this->cacheDirectory = sys_get_temp_dir() . '/php-ext-wasm-bench-' . getmypid();
+        @mkdir($this->cacheDirectory);
+        $this->cache = new Wasm\Cache\Filesystem($this->cacheDirectory);
+        $this->cache->set($parameters['module'], new Wasm\Module($this->filePath));
+    }
+
+    public function clean_up(array $parameters)
+    {
+        $this->cache->clear();
+        @rmdir($this->cacheDirectory);
+    }
+
+    public function bench_compile(array $parameters)
+    {
+        return wasm_compile(wasm_fetch_bytes($this->filePath));
+    }
+
+    public function bench_compile_persistent_hit(array $parameters)
+    {
+        return wasm_compile(wasm_fetch_bytes($this->filePath), $this->persistent_identifier($parameters));
+    }
+
+    public function bench_serialize(array $parameters)
+    {
+        return wasm_module_serialize($this->wasmModule);
+    }
+
+    public function bench_deserialize(array $parameters)
+    {
+        return wasm_module_deserialize($this->serializedWasmModule);
+    }
+
+    public function bench_cache_filesystem_hit(array $parameters)
+    {
+        return $this->cache->get($parameters['module']);
+    }
+
+    public function bench_module_new_instance(array $parameters)
+    {
+        return wasm_module_new_instance($this->wasmModule);
+    }
+
+    public function bench_new_instance(array $parameters)
+    {
+        return wasm_new_instance(wasm_fetch_bytes($this->filePath));
+    }
+
+    private function persistent_identifier(array $parameters): string
+    {
+        return 'bench-module-lifecycle-' . $parameters['module'];
+    }
+
+    /**
+     * Generates, once, a module of 4000 functions that each add 100
+     * constants to their argument.
+     */
+    private static function large_module_file_path(): string
+    {
+        $filePath = sys_get_temp_dir() . '/php-ext-wasm-bench-large.wasm';
+
+        if (true === file_exists($filePath)) {
+            return $filePath;
+        }
+
+        $numberOfFunctions = 4000;
+        $functionBody = "\x00" . "\x20\x00" . str_repeat("\x41\x01\x6a", 100) . "\x0b";
+        $function = self::leb128(strlen($functionBody)) . $functionBody;
+
+        file_put_contents(
+            $filePath,
+            "\x00asm\x01\x00\x00\x00" .
+            // Type: `(i32) -> i32`.
+            self::section(1, "\x01\x60\x01\x7f\x01\x7f") .
+            // Functions.
+            self::section(3, self::leb128($numberOfFunctions) . str_repeat("\x00", $numberOfFunctions)) .
+            // Memory: 1 page.
+            self::section(5, "\x01\x00\x01") .
+            // Exports: `memory` and `run`.
+            self::section(7, "\x02" . "\x06memory\x02\x00" . "\x03run\x00\x00") .
+            // Code.
+            self::section(10, self::leb128($numberOfFunctions) . str_repeat($function, $numberOfFunctions))
+        );
+
+        return $filePath;
+    }
+
+    private static function section(int $identifier, string $content): string
+    {
+        return chr($identifier) . self::leb128(strlen($content)) . $content;
+    }
+
+    private static function leb128(int $value): string
+    {
+        $out = '';
+
+        do {
+            $byte = $value & 0x7f;
+            $value >>= 7;
+
+            if (0 !== $value) {
+                $byte |= 0x80;
+            }
+
+            $out .= chr($byte);
+        } while (0 !== $value);
+
+        return $out;
+    }
+}
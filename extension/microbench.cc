@@ -0,0 +1,275 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2019 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Ivan Enderlin                                                |
+  +----------------------------------------------------------------------+
+*/
+
+// Microbenchmarks of the invocation path of the extension, without a
+// PHP interpreter: the export lookup and the value conversion of
+// `wasm_invoke.hh`, and the Wasmer calls. Run them with `just
+// microbench`.
+//
+// Each benchmark runs some iterations of `revs` operations, and reports
+// the duration of one operation in nanoseconds.
+
+#include "wasm_invoke.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Read by the benchmarks so that the compiler keeps their operations.
+static volatile int64_t wasm_microbench_sink = 0;
+
+/**
+ * Statistics of the durations of one operation, in nanoseconds.
+ */
+typedef struct {
+    double minimum;
+    double median;
+    double mean;
+    double maximum;
+    double relative_standard_deviation;
+} wasm_microbench_statistics;
+
+/**
+ * Run `iterations` times `revs` operations, after a warmup iteration.
+ */
+template<typename Operation>
+static wasm_microbench_statistics wasm_microbench_run(size_t iterations, size_t revs, Operation operation)
+{
+    std::vector<double> durations;
+    durations.reserve(iterations);
+
+    for (size_t iteration = 0; iteration <= iterations; ++iteration) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        for (size_t rev = 0; rev < revs; ++rev) {
+            operation();
+        }
+
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        // The first iteration warms up.
+        if (iteration > 0) {
+            durations.push_back(std::chrono::duration<double, std::nano>(end - start).count() / revs);
+        }
+    }
+
+    std::sort(durations.begin(), durations.end());
+
+    double sum = 0;
+
+    for (double duration : durations) {
+        sum += duration;
+    }
+
+    double mean = sum / durations.size();
+    double variance = 0;
+
+    for (double duration : durations) {
+        variance += (duration - mean) * (duration - mean);
+    }
+
+    wasm_microbench_statistics statistics;
+    statistics.minimum = durations.front();
+    statistics.median = durations[durations.size() / 2];
+    statistics.mean = mean;
+    statistics.maximum = durations.back();
+    statistics.relative_standard_deviation = 100 * std::sqrt(variance / durations.size()) / mean;
+
+    return statistics;
+}
+
+static void wasm_microbench_report(const char *subject, const wasm_microbench_statistics &statistics)
+{
+    printf(
+        "%-32s %12.1f %12.1f %12.1f %12.1f %9.2f%%\n",
+        subject,
+        statistics.minimum,
+        statistics.median,
+        statistics.mean,
+        statistics.maximum,
+        statistics.relative_standard_deviation
+    );
+}
+
+static void wasm_microbench_fail(const char *message)
+{
+    int error_length = wasmer_last_error_length();
+    std::vector<char> error(error_length > 0 ? error_length : 1, '\0');
+
+    if (error_length > 0) {
+        wasmer_last_error_message(error.data(), error_length);
+    }
+
+    fprintf(stderr, "%s %s\n", message, error.data());
+
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <file.wasm> [function] [iterations] [revs]\n", argv[0]);
+
+        return 1;
+    }
+
+    // The function must have 2 `i32` parameters and one `i32` result,
+    // like `sum` in `tests/units/tests.wasm`.
+    const char *function_name = argc > 2 ? argv[2] : "sum";
+    size_t function_name_length = strlen(function_name);
+    size_t iterations = argc > 3 ? strtoul(argv[3], NULL, 10) : 20;
+    size_t revs = argc > 4 ? strtoul(argv[4], NULL, 10) : 100000;
+
+    // Read the module.
+    FILE *file = fopen(argv[1], "rb");
+
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open `%s`.\n", argv[1]);
+
+        return 1;
+    }
+
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[8192];
+    size_t chunk_length;
+
+    while ((chunk_length = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + chunk_length);
+    }
+
+    fclose(file);
+
+    wasmer_instance_t *wasm_instance = NULL;
+
+    if (wasmer_instantiate(&wasm_instance, bytes.data(), (uint32_t) bytes.size(), NULL, 0) != wasmer_result_t::WASMER_OK) {
+        wasm_microbench_fail("Cannot instantiate the module:");
+    }
+
+    wasmer_exports_t *wasm_exports = NULL;
+    wasmer_instance_exports(wasm_instance, &wasm_exports);
+
+    const wasmer_export_func_t *wasm_function = wasm_exports_find_function(wasm_exports, function_name, function_name_length);
+
+    if (wasm_function == NULL) {
+        fprintf(stderr, "The module has no exported function named `%s`.\n", function_name);
+
+        return 1;
+    }
+
+    wasmer_value_t inputs[2];
+    wasmer_value_t outputs[1];
+
+    wasm_value_from_integer(wasmer_value_tag::WASM_I32, 1, &inputs[0]);
+    wasm_value_from_integer(wasmer_value_tag::WASM_I32, 2, &inputs[1]);
+
+    printf("%zu iterations of %zu revs, in nanoseconds per operation.\n\n", iterations, revs);
+    printf("%-32s %12s %12s %12s %12s %10s\n", "subject", "min", "median", "mean", "max", "rstdev");
+
+    wasm_microbench_report(
+        "instance_exports",
+        wasm_microbench_run(iterations, revs, [&]() {
+            wasmer_exports_t *exports = NULL;
+            wasmer_instance_exports(wasm_instance, &exports);
+            wasm_microbench_sink += wasmer_exports_len(exports);
+            wasmer_exports_destroy(exports);
+        })
+    );
+
+    wasm_microbench_report(
+        "exports_find_function",
+        wasm_microbench_run(iterations, revs, [&]() {
+            wasm_microbench_sink += (intptr_t) wasm_exports_find_function(wasm_exports, function_name, function_name_length);
+        })
+    );
+
+    wasm_microbench_report(
+        "export_func_signature",
+        wasm_microbench_run(iterations, revs, [&]() {
+            uint32_t inputs_arity = 0;
+            uint32_t outputs_arity = 0;
+            wasmer_value_tag input_types[2];
+
+            wasmer_export_func_params_arity(wasm_function, &inputs_arity);
+            wasmer_export_func_params(wasm_function, input_types, (int) std::min<uint32_t>(inputs_arity, 2));
+            wasmer_export_func_returns_arity(wasm_function, &outputs_arity);
+            wasm_microbench_sink += inputs_arity + outputs_arity;
+        })
+    );
+
+    wasm_microbench_report(
+        "value_conversion",
+        wasm_microbench_run(iterations, revs, [&]() {
+            wasmer_value_t value;
+            wasm_value_from_integer(wasmer_value_tag::WASM_I32, wasm_microbench_sink, &value);
+            wasm_microbench_sink += wasm_value_to_integer(&value);
+            wasm_value_from_float(wasmer_value_tag::WASM_F64, 1.5, &value);
+            wasm_microbench_sink += (int64_t) wasm_value_to_float(&value);
+        })
+    );
+
+    wasm_microbench_report(
+        "export_func_call",
+        wasm_microbench_run(iterations, revs, [&]() {
+            wasmer_export_func_call(wasm_function, inputs, 2, outputs, 1);
+            wasm_microbench_sink += outputs[0].value.I32;
+        })
+    );
+
+    wasm_microbench_report(
+        "instance_call",
+        wasm_microbench_run(iterations, revs, [&]() {
+            wasmer_instance_call(wasm_instance, function_name, inputs, 2, outputs, 1);
+            wasm_microbench_sink += outputs[0].value.I32;
+        })
+    );
+
+    // What `wasm_invoke_function` does, except the PHP values.
+    wasm_microbench_report(
+        "invoke_path",
+        wasm_microbench_run(iterations, revs, [&]() {
+            wasmer_exports_t *exports = NULL;
+            wasmer_instance_exports(wasm_instance, &exports);
+
+            const wasmer_export_func_t *function = wasm_exports_find_function(exports, function_name, function_name_length);
+            uint32_t inputs_arity = 0;
+            uint32_t outputs_arity = 0;
+            wasmer_value_tag input_types[2];
+
+            wasmer_export_func_params_arity(function, &inputs_arity);
+            wasmer_export_func_params(function, input_types, (int) std::min<uint32_t>(inputs_arity, 2));
+            wasmer_export_func_returns_arity(function, &outputs_arity);
+            wasmer_exports_destroy(exports);
+
+            wasmer_value_t call_inputs[2];
+            wasm_value_from_integer(input_types[0], 1, &call_inputs[0]);
+            wasm_value_from_integer(input_types[1], 2, &call_inputs[1]);
+
+            wasmer_value_t call_outputs[1];
+            wasmer_instance_call(wasm_instance, function_name, call_inputs, 2, call_outputs, 1);
+            wasm_microbench_sink += wasm_value_to_integer(&call_outputs[0]);
+        })
+    );
+
+    wasmer_exports_destroy(wasm_exports);
+    wasmer_instance_destroy(wasm_instance);
+
+    return 0;
+}
@@ -24,6 +24,37 @@ extern zend_module_entry wasm_module_entry;
 
 # define PHP_WASM_VERSION "0.2.0"
 
+ZEND_BEGIN_MODULE_GLOBALS(wasm)
+    // Size of the chunks of the request arena backing the
+    // `WasmArrayBuffer` storage, in bytes (`wasm.array_buffer_arena_size`).
+    // The arena is disabled when it is zero.
+    zend_long array_buffer_arena_size;
+
+    // The current chunk of the request arena, `NULL` if none.
+    void *array_buffer_arena;
+
+    // Number of bytes a guest writes through the `php_write` host
+    // function before the output is flushed (`wasm.output_chunk_size`).
+    // The output is never flushed explicitly when it is zero.
+    zend_long output_chunk_size;
+
+    // The key-value store of the `php_kv_*` host functions, shared by
+    // all the instances of the process (of the thread with ZTS), `NULL`
+    // until it is used. It is a persistent table of persistent strings.
+    HashTable *host_key_value_store;
+
+    // Number of bytes of the keys and the values of the key-value store.
+    size_t host_key_value_store_size;
+
+    // Maximum number of bytes of the keys and the values of the
+    // key-value store (`wasm.kv_store_max_size`).
+    zend_long kv_store_max_size;
+ZEND_END_MODULE_GLOBALS(wasm)
+
+ZEND_EXTERN_MODULE_GLOBALS(wasm)
+
+# define WASM_G(v) ZEND_MODULE_GLOBALS_ACCESSOR(wasm, v)
+
 # if defined(ZTS) && defined(COMPILE_DL_WASM)
 ZEND_TSRMLS_CACHE_EXTERN()
 # endif
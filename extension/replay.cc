@@ -0,0 +1,376 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2019 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Ivan Enderlin                                                |
+  +----------------------------------------------------------------------+
+*/
+
+// Replays a trace recorded by `wasm_instance_set_trace_stream` against
+// a module, without a PHP interpreter, and reports the duration of the
+// calls per function. Run it with `just replay`.
+//
+// Each iteration replays the whole trace on a new instance: before
+// each call, the recorded regions are written in the memory, so that
+// the guest reads what it read when the trace was recorded. The
+// results are compared to the recorded ones, to detect a module or an
+// engine that behaves differently. Modules with imports are not
+// supported.
+
+#include "wasm_invoke.hh"
+#include "wasm_trace.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * A region of the memory written before a call.
+ */
+typedef struct {
+    uint32_t offset;
+    uint32_t length;
+    const uint8_t *bytes;
+} wasm_replay_region;
+
+/**
+ * A recorded call.
+ */
+typedef struct {
+    std::string function_name;
+    std::vector<wasmer_value_t> inputs;
+    std::vector<wasm_replay_region> regions;
+    uint8_t status;
+    wasmer_value_t result;
+} wasm_replay_call;
+
+/**
+ * Reads a trace, and checks its bounds.
+ */
+class wasm_replay_reader {
+    public:
+        wasm_replay_reader(const std::vector<uint8_t> &bytes) : bytes(bytes), position(0) {}
+
+        bool at_end() const
+        {
+            return position == bytes.size();
+        }
+
+        const uint8_t *read(size_t length)
+        {
+            if (bytes.size() - position < length) {
+                fprintf(stderr, "The trace is truncated at byte %zu.\n", position);
+
+                exit(1);
+            }
+
+            const uint8_t *data = bytes.data() + position;
+            position += length;
+
+            return data;
+        }
+
+        uint8_t read_u8()
+        {
+            return *read(1);
+        }
+
+        uint32_t read_u32()
+        {
+            return wasm_trace_decode_u32(read(4));
+        }
+
+        wasmer_value_t read_value()
+        {
+            uint8_t type = read_u8();
+            uint64_t bits = wasm_trace_decode_u64(read(8));
+            wasmer_value_t value;
+
+            if (!wasm_trace_value_from_bits(type, bits, &value)) {
+                fprintf(stderr, "The trace has a value of unknown type %d.\n", type);
+
+                exit(1);
+            }
+
+            return value;
+        }
+
+    private:
+        const std::vector<uint8_t> &bytes;
+        size_t position;
+};
+
+static std::vector<uint8_t> wasm_replay_read_file(const char *file_path)
+{
+    FILE *file = fopen(file_path, "rb");
+
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open `%s`.\n", file_path);
+
+        exit(1);
+    }
+
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[8192];
+    size_t chunk_length;
+
+    while ((chunk_length = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + chunk_length);
+    }
+
+    fclose(file);
+
+    return bytes;
+}
+
+static std::vector<wasm_replay_call> wasm_replay_parse(const std::vector<uint8_t> &trace)
+{
+    wasm_replay_reader reader(trace);
+
+    if (memcmp(reader.read(WASM_TRACE_MAGIC_LENGTH), WASM_TRACE_MAGIC, WASM_TRACE_MAGIC_LENGTH) != 0) {
+        fprintf(stderr, "The file is not a trace.\n");
+
+        exit(1);
+    }
+
+    uint32_t version = reader.read_u32();
+
+    if (version != WASM_TRACE_VERSION) {
+        fprintf(stderr, "The trace version %u is not supported, expected %d.\n", version, WASM_TRACE_VERSION);
+
+        exit(1);
+    }
+
+    std::vector<wasm_replay_call> calls;
+
+    while (!reader.at_end()) {
+        wasm_replay_call call;
+
+        uint32_t function_name_length = reader.read_u32();
+        call.function_name.assign((const char *) reader.read(function_name_length), function_name_length);
+
+        uint8_t number_of_inputs = reader.read_u8();
+
+        for (uint8_t nth = 0; nth < number_of_inputs; ++nth) {
+            call.inputs.push_back(reader.read_value());
+        }
+
+        uint32_t number_of_regions = reader.read_u32();
+
+        for (uint32_t nth = 0; nth < number_of_regions; ++nth) {
+            wasm_replay_region region;
+            region.offset = reader.read_u32();
+            region.length = reader.read_u32();
+            region.bytes = reader.read(region.length);
+            call.regions.push_back(region);
+        }
+
+        call.status = reader.read_u8();
+
+        if (call.status == WASM_TRACE_RESULT) {
+            call.result = reader.read_value();
+        }
+
+        calls.push_back(call);
+    }
+
+    return calls;
+}
+
+static void wasm_replay_fail(const char *message)
+{
+    int error_length = wasmer_last_error_length();
+    std::vector<char> error(error_length > 0 ? error_length : 1, '\0');
+
+    if (error_length > 0) {
+        wasmer_last_error_message(error.data(), error_length);
+    }
+
+    fprintf(stderr, "%s %s\n", message, error.data());
+
+    exit(1);
+}
+
+/**
+ * Find the memory exported by the instance, `NULL` if there is none.
+ */
+static wasmer_memory_t *wasm_replay_find_memory(wasmer_exports_t *wasm_exports)
+{
+    int number_of_exports = wasmer_exports_len(wasm_exports);
+
+    for (int nth = 0; nth < number_of_exports; ++nth) {
+        wasmer_export_t *wasm_export = wasmer_exports_get(wasm_exports, nth);
+        wasmer_memory_t *wasm_memory = NULL;
+
+        if (
+            wasmer_export_kind(wasm_export) == wasmer_import_export_kind::WASM_MEMORY &&
+            wasmer_export_to_memory(wasm_export, &wasm_memory) == wasmer_result_t::WASMER_OK
+        ) {
+            return wasm_memory;
+        }
+    }
+
+    return NULL;
+}
+
+static bool wasm_replay_same_value(const wasmer_value_t *left, const wasmer_value_t *right)
+{
+    return left->tag == right->tag && wasm_trace_value_to_bits(left) == wasm_trace_value_to_bits(right);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <file.wasm> <file.trace> [iterations]\n", argv[0]);
+
+        return 1;
+    }
+
+    std::vector<uint8_t> module_bytes = wasm_replay_read_file(argv[1]);
+    std::vector<uint8_t> trace = wasm_replay_read_file(argv[2]);
+    std::vector<wasm_replay_call> calls = wasm_replay_parse(trace);
+    size_t iterations = argc > 3 ? strtoul(argv[3], NULL, 10) : 10;
+
+    // The durations of the calls in nanoseconds, per function name.
+    std::map<std::string, std::vector<double>> durations;
+    std::vector<double> iteration_durations;
+    size_t mismatches = 0;
+
+    for (size_t iteration = 0; iteration < iterations; ++iteration) {
+        wasmer_instance_t *wasm_instance = NULL;
+
+        if (wasmer_instantiate(&wasm_instance, module_bytes.data(), (uint32_t) module_bytes.size(), NULL, 0) != wasmer_result_t::WASMER_OK) {
+            wasm_replay_fail("Cannot instantiate the module:");
+        }
+
+        wasmer_exports_t *wasm_exports = NULL;
+        wasmer_instance_exports(wasm_instance, &wasm_exports);
+
+        wasmer_memory_t *wasm_memory = wasm_replay_find_memory(wasm_exports);
+        double iteration_duration = 0;
+
+        for (const wasm_replay_call &call : calls) {
+            for (const wasm_replay_region &region : call.regions) {
+                uint64_t region_end = (uint64_t) region.offset + region.length;
+
+                if (wasm_memory == NULL) {
+                    fprintf(stderr, "The trace writes in the memory, but the module has none.\n");
+
+                    return 1;
+                }
+
+                // Grow the memory if the host has written past it.
+                uint32_t memory_length = wasmer_memory_data_length(wasm_memory);
+
+                if (region_end > memory_length) {
+                    uint32_t missing_pages = (uint32_t) ((region_end - memory_length + 65535) / 65536);
+
+                    if (wasmer_memory_grow(wasm_memory, missing_pages) != wasmer_result_t::WASMER_OK) {
+                        wasm_replay_fail("Cannot grow the memory:");
+                    }
+                }
+
+                memcpy(wasmer_memory_data(wasm_memory) + region.offset, region.bytes, region.length);
+            }
+
+            const wasmer_export_func_t *wasm_function = wasm_exports_find_function(wasm_exports, call.function_name.data(), call.function_name.size());
+
+            if (wasm_function == NULL) {
+                fprintf(stderr, "The module has no exported function named `%s`.\n", call.function_name.c_str());
+
+                return 1;
+            }
+
+            // The arity comes from the module: the recorded status says
+            // nothing about a failed call.
+            uint32_t outputs_length = 0;
+
+            if (wasmer_export_func_returns_arity(wasm_function, &outputs_length) != wasmer_result_t::WASMER_OK) {
+                wasm_replay_fail("Cannot read the arity of the outputs:");
+            }
+
+            std::vector<wasmer_value_t> outputs(std::max<uint32_t>(outputs_length, 1));
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            wasmer_result_t call_result = wasmer_export_func_call(
+                wasm_function,
+                call.inputs.data(),
+                (uint32_t) call.inputs.size(),
+                outputs.data(),
+                outputs_length
+            );
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+            double duration = std::chrono::duration<double, std::nano>(end - start).count();
+            durations[call.function_name].push_back(duration);
+            iteration_duration += duration;
+
+            bool failed = call_result != wasmer_result_t::WASMER_OK;
+
+            if (
+                failed != (call.status == WASM_TRACE_FAILED) ||
+                (!failed && (outputs_length > 0) != (call.status == WASM_TRACE_RESULT)) ||
+                (!failed && outputs_length > 0 && !wasm_replay_same_value(&outputs[0], &call.result))
+            ) {
+                ++mismatches;
+            }
+        }
+
+        iteration_durations.push_back(iteration_duration);
+
+        wasmer_exports_destroy(wasm_exports);
+        wasmer_instance_destroy(wasm_instance);
+    }
+
+    std::sort(iteration_durations.begin(), iteration_durations.end());
+
+    printf("%zu calls, %zu iterations, in nanoseconds per call.\n\n", calls.size(), iterations);
+    printf("%-32s %8s %12s %12s %12s %12s\n", "function", "calls", "min", "median", "mean", "max");
+
+    for (auto &entry : durations) {
+        std::vector<double> &function_durations = entry.second;
+        std::sort(function_durations.begin(), function_durations.end());
+
+        double sum = 0;
+
+        for (double duration : function_durations) {
+            sum += duration;
+        }
+
+        printf(
+            "%-32s %8zu %12.1f %12.1f %12.1f %12.1f\n",
+            entry.first.c_str(),
+            function_durations.size() / std::max<size_t>(iterations, 1),
+            function_durations.front(),
+            function_durations[function_durations.size() / 2],
+            sum / function_durations.size(),
+            function_durations.back()
+        );
+    }
+
+    if (!iteration_durations.empty()) {
+        printf("\nmedian replay: %.3f ms\n", iteration_durations[iteration_durations.size() / 2] / 1e6);
+    }
+
+    if (mismatches > 0) {
+        printf("%zu call(s) did not return the recorded result.\n", mismatches);
+
+        return 2;
+    }
+
+    return 0;
+}
@@ -18,6 +18,15 @@
 
 #include "wasm.hh"
 
+ZEND_DECLARE_MODULE_GLOBALS(wasm)
+
+// Declare the INI entries.
+PHP_INI_BEGIN()
+    STD_PHP_INI_ENTRY("wasm.array_buffer_arena_size", "0", PHP_INI_ALL, OnUpdateLong, array_buffer_arena_size, zend_wasm_globals, wasm_globals)
+    STD_PHP_INI_ENTRY("wasm.output_chunk_size", "8192", PHP_INI_ALL, OnUpdateLong, output_chunk_size, zend_wasm_globals, wasm_globals)
+    STD_PHP_INI_ENTRY("wasm.kv_store_max_size", "16M", PHP_INI_SYSTEM, OnUpdateLong, kv_store_max_size, zend_wasm_globals, wasm_globals)
+PHP_INI_END()
+
 /**
  * Gets the `wasm_array_buffer_object` pointer from a `zend_object` pointer.
  */
@@ -26,6 +35,69 @@ static inline wasm_array_buffer_object *wasm_array_buffer_object_from_zend_objec
 	return (wasm_array_buffer_object *) ((char *)(object) - XtOffsetOf(wasm_array_buffer_object, instance));
 }
 
+/**
+ * Allocates the storage of a `WasmArrayBuffer`.
+ *
+ * By default, the storage comes from the Zend memory manager: it is
+ * served from its size-class bins or page runs, and it is accounted
+ * by `memory_limit`. When `wasm.array_buffer_arena_size` is positive,
+ * buffers that fit in a chunk are carved out of a request arena
+ * instead. Allocating is then a pointer bump, freeing is a no-op, and
+ * the whole arena is released at the end of the request.
+ */
+static int8_t *wasm_array_buffer_allocate(size_t byte_length, bool *allocated_buffer)
+{
+    zend_long arena_size = WASM_G(array_buffer_arena_size);
+
+    if (arena_size <= 0 || byte_length > (size_t) arena_size) {
+        *allocated_buffer = true;
+
+        return (int8_t *) ecalloc(1, byte_length);
+    }
+
+    size_t aligned_byte_length = ZEND_MM_ALIGNED_SIZE_EX(byte_length, 16);
+    wasm_array_buffer_arena_chunk *chunk = (wasm_array_buffer_arena_chunk *) WASM_G(array_buffer_arena);
+
+    // Open a new chunk when the current one is full. The remaining
+    // bytes of the previous chunk are lost until the end of the request.
+    if (chunk == NULL || chunk->size - chunk->used < aligned_byte_length) {
+        size_t chunk_size = ZEND_MM_ALIGNED_SIZE_EX((size_t) arena_size, 16);
+        wasm_array_buffer_arena_chunk *next_chunk = (wasm_array_buffer_arena_chunk *) emalloc(
+            WASM_ARRAY_BUFFER_ARENA_CHUNK_HEADER_SIZE + chunk_size
+        );
+        next_chunk->previous = chunk;
+        next_chunk->size = chunk_size;
+        next_chunk->used = 0;
+
+        chunk = next_chunk;
+        WASM_G(array_buffer_arena) = chunk;
+    }
+
+    int8_t *buffer = (int8_t *) chunk + WASM_ARRAY_BUFFER_ARENA_CHUNK_HEADER_SIZE + chunk->used;
+    chunk->used += aligned_byte_length;
+    memset(buffer, 0, byte_length);
+
+    *allocated_buffer = false;
+
+    return buffer;
+}
+
+/**
+ * Frees all the chunks of the request arena, if any.
+ */
+static void wasm_array_buffer_arena_release()
+{
+    wasm_array_buffer_arena_chunk *chunk = (wasm_array_buffer_arena_chunk *) WASM_G(array_buffer_arena);
+
+    while (chunk != NULL) {
+        wasm_array_buffer_arena_chunk *previous_chunk = chunk->previous;
+        efree(chunk);
+        chunk = previous_chunk;
+    }
+
+    WASM_G(array_buffer_arena) = NULL;
+}
+
 /**
  * Function for a `zend_class_entry` to create a `WasmArrayBuffer` object.
  */
@@ -38,6 +110,7 @@ static zend_object *create_wasm_array_buffer_object(zend_class_entry *class_entr
     wasm_array_buffer->buffer = NULL;
     wasm_array_buffer->buffer_length = 0;
     wasm_array_buffer->allocated_buffer = true;
+    wasm_array_buffer->string = NULL;
 
     zend_object_std_init(&wasm_array_buffer->instance, class_entry);
     object_properties_init(&wasm_array_buffer->instance, class_entry);
@@ -65,12 +138,47 @@ static void free_wasm_array_buffer_object(zend_object *object)
 
     if (wasm_array_buffer_object->allocated_buffer &&
         wasm_array_buffer_object->buffer != NULL) {
-        free(wasm_array_buffer_object->buffer);
+        efree(wasm_array_buffer_object->buffer);
+    }
+
+    if (wasm_array_buffer_object->string != NULL) {
+        zend_string_release(wasm_array_buffer_object->string);
     }
 
     zend_object_std_dtor(object);
 }
 
+/**
+ * Makes the storage of a `WasmArrayBuffer` writable.
+ *
+ * A buffer built by `fromString` shares the bytes of a PHP string.
+ * When the buffer holds the only reference to it, the string is
+ * written in place. Otherwise its bytes are copied into a storage of
+ * the buffer's own, and the string is released.
+ */
+static inline void wasm_array_buffer_detach(wasm_array_buffer_object *wasm_array_buffer_object)
+{
+    zend_string *string = wasm_array_buffer_object->string;
+
+    if (EXPECTED(string == NULL)) {
+        return;
+    }
+
+    if (!ZSTR_IS_INTERNED(string) && GC_REFCOUNT(string) == 1) {
+        zend_string_forget_hash_val(string);
+
+        return;
+    }
+
+    int8_t *buffer = wasm_array_buffer_allocate(wasm_array_buffer_object->buffer_length, &wasm_array_buffer_object->allocated_buffer);
+    memcpy(buffer, ZSTR_VAL(string), wasm_array_buffer_object->buffer_length);
+
+    wasm_array_buffer_object->buffer = buffer;
+    wasm_array_buffer_object->string = NULL;
+
+    zend_string_release(string);
+}
+
 /**
  * Declare the parameter information for the
  * `WasmArrayBuffer::__construct` method.
@@ -103,9 +211,9 @@ PHP_METHOD(WasmArrayBuffer, __construct)
     }
 
     // Allocate a new buffer, and assign it the `wasm_array_buffer_object`.
-    // This new buffer is initialized with zero-bytes (see `calloc`).
+    // This new buffer is initialized with zero-bytes.
     wasm_array_buffer_object *wasm_array_buffer_object = WASM_ARRAY_BUFFER_OBJECT_THIS();
-    wasm_array_buffer_object->buffer = (int8_t *) calloc(byte_length, byte_length);
+    wasm_array_buffer_object->buffer = wasm_array_buffer_allocate((size_t) byte_length, &wasm_array_buffer_object->allocated_buffer);
     wasm_array_buffer_object->buffer_length = (size_t) byte_length;
 }
 
@@ -136,1829 +244,8932 @@ PHP_METHOD(WasmArrayBuffer, getByteLength)
     RETURN_LONG(wasm_array_buffer_object->buffer_length);
 }
 
-// Declare the methods of the `WasmArrayBuffer` class with their information.
-static const zend_function_entry wasm_array_buffer_methods[] = {
-    PHP_ME(WasmArrayBuffer, __construct,	arginfo_wasmarraybuffer___construct, ZEND_ACC_PUBLIC)
-    PHP_ME(WasmArrayBuffer, getByteLength,	arginfo_wasmarraybuffer_get_byte_length, ZEND_ACC_PUBLIC)
-    PHP_FE_END
-};
+/**
+ * Declare the parameter information for the
+ * `WasmArrayBuffer::fromString` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(arginfo_wasmarraybuffer_from_string, ZEND_RETURN_VALUE, ARITY(1), WasmArrayBuffer, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, string, IS_STRING, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
 
 /**
- * Utils.
+ * Declare the `WasmArrayBuffer::fromString` method.
+ *
+ * The new buffer views the bytes of the string directly; it holds a
+ * reference to the string instead of copying it. The first write
+ * through the buffer or one of its views detaches the buffer from
+ * the string, so the string itself is never modified.
+ *
+ * # Usage
+ *
+ * ```php
+ * $buffer = WasmArrayBuffer::fromString(file_get_contents('payload.bin'));
+ * $view = new WasmUint8Array($buffer);
+ * ```
  */
-wasmer_value_tag from_zend_long_to_wasmer_value_tag(zend_long x)
+PHP_METHOD(WasmArrayBuffer, fromString)
 {
-    if (x > 0) {
-        return (wasmer_value_tag) (uint32_t) x;
-    } else {
-        return wasmer_value_tag::WASM_I32;
-    }
-}
+    zend_string *string;
 
-// Represents a `wasmer_byte_array` that is filled lazily. The bytes
-// are read from `file_path`.
-typedef struct wasm_lazy_byte_array_t wasm_lazy_byte_array;
-struct wasm_lazy_byte_array_t {
-private:
-    char* file_path;
-    wasmer_byte_array *byte_array;
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
+        Z_PARAM_STR(string)
+    ZEND_PARSE_PARAMETERS_END();
 
-public:
-    wasm_lazy_byte_array_t(char* file_path) :
-        file_path(file_path),
-        byte_array(NULL)
-    {}
+    if (ZSTR_LEN(string) == 0) {
+        zend_throw_exception(zend_ce_exception, "Buffer length must be positive; given 0.", 0);
 
-    ~wasm_lazy_byte_array_t()
-    {
-        efree((uint8_t *) byte_array->bytes);
+        return;
     }
 
-    wasmer_byte_array *get_bytes()
-    {
-        if (byte_array == NULL) {
-            // Open the file.
-            FILE *wasm_file = fopen(file_path, "r");
-
-            if (wasm_file == NULL) {
-                return NULL;
-            }
-
-            // Read the file content.
-            fseek(wasm_file, 0, SEEK_END);
-
-            size_t wasm_file_length = ftell(wasm_file);
-            const uint8_t *wasm_bytes = (const uint8_t *) emalloc(wasm_file_length);
-            fseek(wasm_file, 0, SEEK_SET);
-
-            fread((uint8_t *) wasm_bytes, 1, wasm_file_length, wasm_file);
-
-            // Close the file.
-            fclose(wasm_file);
-
-            // Store the bytes of the Wasm file into a `wasmer_byte_array` structure.
-            byte_array = (wasmer_byte_array *) emalloc(sizeof(wasmer_byte_array));
-            byte_array->bytes = wasm_bytes;
-            byte_array->bytes_len = (uint32_t) wasm_file_length;
-        }
+    object_init_ex(return_value, wasm_array_buffer_class_entry);
 
-        return byte_array;
-    }
-};
+    wasm_array_buffer_object *wasm_array_buffer_object = wasm_array_buffer_object_from_zend_object(Z_OBJ_P(return_value));
+    wasm_array_buffer_object->buffer = (int8_t *) ZSTR_VAL(string);
+    wasm_array_buffer_object->buffer_length = ZSTR_LEN(string);
+    wasm_array_buffer_object->allocated_buffer = false;
+    wasm_array_buffer_object->string = zend_string_copy(string);
+}
 
 /**
- * Extract the data structure inside the `wasm_bytes` resource.
+ * Write a big-endian unsigned integer of `size` bytes at `cursor`.
  */
-wasmer_byte_array *wasm_bytes_from_resource(zend_resource *wasm_bytes_resource)
+static inline void wasm_message_pack_store_big_endian(uint8_t *cursor, uint64_t value, size_t size)
 {
-    wasm_lazy_byte_array *lazy_byte_array = (wasm_lazy_byte_array *) zend_fetch_resource(
-        wasm_bytes_resource,
-        wasm_bytes_resource_name,
-        wasm_bytes_resource_number
-    );
-
-    return lazy_byte_array->get_bytes();
+    for (size_t nth = size; nth > 0; --nth) {
+        cursor[nth - 1] = (uint8_t) (value & 0xff);
+        value >>= 8;
+    }
 }
 
 /**
- * Destructor for the `wasm_bytes` resource.
+ * Read a big-endian unsigned integer of `size` bytes from `cursor`.
  */
-static void wasm_bytes_destructor(zend_resource *resource)
+static inline uint64_t wasm_message_pack_load_big_endian(const uint8_t *cursor, size_t size)
 {
-    wasm_lazy_byte_array *lazy_byte_array = (wasm_lazy_byte_array *) zend_fetch_resource(
-        resource,
-        wasm_bytes_resource_name,
-        wasm_bytes_resource_number
-    );
-    free(lazy_byte_array);
-}
+    uint64_t value = 0;
 
-/**
- * Declare the parameter information for the `wasm_fetch_bytes` function.
- */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_fetch_bytes, ZEND_RETURN_VALUE, ARITY(1), IS_RESOURCE, NOT_NULLABLE)
-    ZEND_ARG_TYPE_INFO(0, file_path, IS_STRING, NOT_NULLABLE)
-ZEND_END_ARG_INFO()
+    for (size_t nth = 0; nth < size; ++nth) {
+        value = (value << 8) | cursor[nth];
+    }
+
+    return value;
+}
 
 /**
- * Declare the `wasm_fetch_bytes` function.
- *
- * # Usage
- *
- * ```php
- * $bytes = wasm_fetch_bytes('my_program.wasm');
- * // `$bytes` is of type `resource of type (wasm_bytes)`.
- * ```
- *
- * Important note: The bytes are fetched, not read, when the function
- * is called. It means that the bytes are lazily read when other
- * functions need it, like `wasm_validate`, `wasm_compile` and
- * `wasm_new_instance`.
+ * Writes a header byte followed by a big-endian unsigned integer of
+ * `size` bytes. Returns `false` if the writer has not enough room.
  */
-PHP_FUNCTION(wasm_fetch_bytes)
+static inline bool wasm_message_pack_write_header(wasm_message_pack_writer *writer, uint8_t header, uint64_t value, size_t size)
 {
-    char *file_path;
-    size_t file_path_length;
-
-    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
-        Z_PARAM_PATH(file_path, file_path_length)
-    ZEND_PARSE_PARAMETERS_END();
+    if ((size_t) (writer->end - writer->cursor) < size + 1) {
+        writer->error = wasm_message_pack_error::BUFFER_TOO_SMALL;
 
-    wasm_lazy_byte_array *wasm_lazy_byte_array = new ::wasm_lazy_byte_array(file_path);
+        return false;
+    }
 
-    // Store in and return the result as a resource.
-    zend_resource *resource = zend_register_resource((void *) wasm_lazy_byte_array, wasm_bytes_resource_number);
+    *writer->cursor++ = header;
+    wasm_message_pack_store_big_endian(writer->cursor, value, size);
+    writer->cursor += size;
 
-    RETURN_RES(resource);
+    return true;
 }
 
 /**
- * Declare the parameter information for the `wasm_validate`
- * function.
+ * Writes an integer with the most compact MessagePack representation.
  */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_validate, ZEND_RETURN_VALUE, ARITY(1), _IS_BOOL, NOT_NULLABLE)
-    ZEND_ARG_TYPE_INFO(0, wasm_bytes, IS_RESOURCE, NOT_NULLABLE)
-ZEND_END_ARG_INFO()
+static bool wasm_message_pack_write_long(wasm_message_pack_writer *writer, zend_long value)
+{
+    if (value >= 0) {
+        if (value < 0x80) {
+            return wasm_message_pack_write_header(writer, (uint8_t) value, 0, 0);
+        } else if (value <= 0xff) {
+            return wasm_message_pack_write_header(writer, 0xcc, (uint64_t) value, 1);
+        } else if (value <= 0xffff) {
+            return wasm_message_pack_write_header(writer, 0xcd, (uint64_t) value, 2);
+        } else if (value <= 0xffffffff) {
+            return wasm_message_pack_write_header(writer, 0xce, (uint64_t) value, 4);
+        }
+
+        return wasm_message_pack_write_header(writer, 0xcf, (uint64_t) value, 8);
+    }
+
+    if (value >= -32) {
+        return wasm_message_pack_write_header(writer, (uint8_t) (int8_t) value, 0, 0);
+    } else if (value >= INT8_MIN) {
+        return wasm_message_pack_write_header(writer, 0xd0, (uint8_t) (int8_t) value, 1);
+    } else if (value >= INT16_MIN) {
+        return wasm_message_pack_write_header(writer, 0xd1, (uint16_t) (int16_t) value, 2);
+    } else if (value >= INT32_MIN) {
+        return wasm_message_pack_write_header(writer, 0xd2, (uint32_t) (int32_t) value, 4);
+    }
+
+    return wasm_message_pack_write_header(writer, 0xd3, (uint64_t) (int64_t) value, 8);
+}
 
 /**
- * Declare the `wasm_validate` function.
- *
- * # Usage
- *
- * ```php
- * $bytes = wasm_fetch_bytes('my_program.wasm');
- * $valid = wasm_validate($bytes);
- * ```
+ * Writes a string (header and bytes).
  */
-PHP_FUNCTION(wasm_validate)
+static bool wasm_message_pack_write_string(wasm_message_pack_writer *writer, const char *string, size_t string_length)
 {
-    zval *wasm_bytes_resource;
+    bool written;
+
+    if (string_length < 32) {
+        written = wasm_message_pack_write_header(writer, 0xa0 | (uint8_t) string_length, 0, 0);
+    } else if (string_length <= 0xff) {
+        written = wasm_message_pack_write_header(writer, 0xd9, string_length, 1);
+    } else if (string_length <= 0xffff) {
+        written = wasm_message_pack_write_header(writer, 0xda, string_length, 2);
+    } else if (string_length <= 0xffffffff) {
+        written = wasm_message_pack_write_header(writer, 0xdb, string_length, 4);
+    } else {
+        writer->error = wasm_message_pack_error::BUFFER_TOO_SMALL;
 
-    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
-        Z_PARAM_RESOURCE(wasm_bytes_resource)
-    ZEND_PARSE_PARAMETERS_END();
+        return false;
+    }
 
-    // Extract the bytes from the resource.
-    wasmer_byte_array *wasm_byte_array = wasm_bytes_from_resource(Z_RES_P(wasm_bytes_resource));
+    if (!written) {
+        return false;
+    }
 
-    if (NULL == wasm_byte_array) {
-        RETURN_FALSE;
+    if ((size_t) (writer->end - writer->cursor) < string_length) {
+        writer->error = wasm_message_pack_error::BUFFER_TOO_SMALL;
+
+        return false;
     }
 
-    // Check whether the bytes are valid or not.
-    bool is_valid = wasmer_validate(wasm_byte_array->bytes, wasm_byte_array->bytes_len);
+    memcpy(writer->cursor, string, string_length);
+    writer->cursor += string_length;
 
-    RETURN_BOOL(is_valid);
+    return true;
 }
 
 /**
- * Extract the data structure inside the `wasm_module` resource.
+ * Encodes a PHP value as MessagePack, directly into the writer
+ * buffer. Arrays with consecutive integer keys starting at 0 are
+ * encoded as MessagePack arrays, all other arrays are encoded as
+ * maps.
  */
-wasmer_module_t *wasm_module_from_resource(zend_resource *wasm_module_resource)
+static bool wasm_message_pack_encode(wasm_message_pack_writer *writer, zval *value, uint32_t depth)
 {
-    return (wasmer_module_t *) zend_fetch_resource(
-        wasm_module_resource,
-        wasm_module_resource_name,
-        wasm_module_resource_number
-    );
+    if (depth > WASM_MESSAGE_PACK_MAXIMUM_DEPTH) {
+        writer->error = wasm_message_pack_error::TOO_DEEP;
+
+        return false;
+    }
+
+    ZVAL_DEREF(value);
+
+    switch (Z_TYPE_P(value)) {
+        case IS_NULL:
+            return wasm_message_pack_write_header(writer, 0xc0, 0, 0);
+
+        case IS_FALSE:
+            return wasm_message_pack_write_header(writer, 0xc2, 0, 0);
+
+        case IS_TRUE:
+            return wasm_message_pack_write_header(writer, 0xc3, 0, 0);
+
+        case IS_LONG:
+            return wasm_message_pack_write_long(writer, Z_LVAL_P(value));
+
+        case IS_DOUBLE:
+        {
+            double double_value = Z_DVAL_P(value);
+            uint64_t bits;
+
+            memcpy(&bits, &double_value, sizeof(bits));
+
+            return wasm_message_pack_write_header(writer, 0xcb, bits, 8);
+        }
+
+        case IS_STRING:
+            return wasm_message_pack_write_string(writer, Z_STRVAL_P(value), Z_STRLEN_P(value));
+
+        case IS_ARRAY:
+        {
+            HashTable *array = Z_ARRVAL_P(value);
+            uint32_t number_of_elements = zend_hash_num_elements(array);
+            bool is_list = true;
+
+            {
+                zend_ulong expected_index = 0;
+                zend_ulong index;
+                zend_string *key;
+
+                ZEND_HASH_FOREACH_KEY(array, index, key)
+                    if (key != NULL || index != expected_index) {
+                        is_list = false;
+
+                        break;
+                    }
+
+                    ++expected_index;
+                ZEND_HASH_FOREACH_END();
+            }
+
+            bool written;
+
+            if (number_of_elements < 16) {
+                written = wasm_message_pack_write_header(writer, (is_list ? 0x90 : 0x80) | (uint8_t) number_of_elements, 0, 0);
+            } else if (number_of_elements <= 0xffff) {
+                written = wasm_message_pack_write_header(writer, is_list ? 0xdc : 0xde, number_of_elements, 2);
+            } else {
+                written = wasm_message_pack_write_header(writer, is_list ? 0xdd : 0xdf, number_of_elements, 4);
+            }
+
+            if (!written) {
+                return false;
+            }
+
+            zend_ulong index;
+            zend_string *key;
+            zval *item;
+
+            ZEND_HASH_FOREACH_KEY_VAL(array, index, key, item)
+                if (!is_list) {
+                    if (key != NULL) {
+                        written = wasm_message_pack_write_string(writer, ZSTR_VAL(key), ZSTR_LEN(key));
+                    } else {
+                        written = wasm_message_pack_write_long(writer, (zend_long) index);
+                    }
+
+                    if (!written) {
+                        return false;
+                    }
+                }
+
+                if (!wasm_message_pack_encode(writer, item, depth + 1)) {
+                    return false;
+                }
+            ZEND_HASH_FOREACH_END();
+
+            return true;
+        }
+
+        default:
+            writer->error = wasm_message_pack_error::UNSUPPORTED_TYPE;
+
+            return false;
+    }
 }
 
 /**
- * Destructor for the `wasm_module` resource.
+ * Decodes the length of a string, a binary, an array or a map
+ * encoded on `size` bytes after the header.
  */
-static void wasm_module_destructor(zend_resource *resource)
+static inline bool wasm_message_pack_read_length(wasm_message_pack_reader *reader, size_t size, uint64_t *length)
 {
-    wasmer_module_t *wasm_module = wasm_module_from_resource(resource);
+    if ((size_t) (reader->end - reader->cursor) < size) {
+        reader->error = wasm_message_pack_error::TRUNCATED;
 
-    if (wasm_module == NULL) {
-        return;
+        return false;
     }
 
-    wasmer_module_destroy(wasm_module);
+    *length = wasm_message_pack_load_big_endian(reader->cursor, size);
+    reader->cursor += size;
+
+    return true;
 }
 
 /**
- * Declare the parameter information for the `wasm_compile`
- * function.
+ * Decodes one MessagePack value from the reader buffer into `value`.
+ * On failure, `value` is left undefined and everything that was
+ * allocated is released.
  */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_compile, ZEND_RETURN_VALUE, ARITY(1), IS_RESOURCE, NULLABLE)
-    ZEND_ARG_TYPE_INFO(0, wasm_bytes, IS_RESOURCE, NOT_NULLABLE)
-    ZEND_ARG_TYPE_INFO(0, wasm_module_unique_identifier, IS_STRING, NULLABLE)
-ZEND_END_ARG_INFO()
-
-/**
- * Declare the `wasm_compile` function.
- *
- * # Usage
- *
- * Classical usage:
- *
- * ```php
- * $bytes = wasm_fetch_bytes('my_program.wasm');
- * $module = wasm_compile($bytes);
- * // `$module` is of type `resource of type (wasm_module)`.
- * ```
- *
- * If one wants to avoid to recompile the module each time, it is
- * possible to compute a persistent resource by passing a module
- * unique identifier string, e.g.:
- *
- * ```php
- * $bytes = wasm_fetch_bytes('my_program.wasm');
- * $module = wasm_compile($bytes, 'foo');
- * // `$module` is of type `resource of type (wasm_module)`, and persistent.
- * ```
- *
- * In the case above, further execution will **not** fetch the bytes
- * nor compile the module. Indeed, bytes are not fetched because they
- * are lazily fetch on-demand, and the module will not be re-compiled
- * because the resource is persistent.
- */
-PHP_FUNCTION(wasm_compile)
+static bool wasm_message_pack_decode(wasm_message_pack_reader *reader, zval *value, uint32_t depth)
 {
-    zval *wasm_bytes_resource;
-    zend_string *wasm_module_unique_identifier = NULL;
+    ZVAL_UNDEF(value);
 
-    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 2)
-        Z_PARAM_RESOURCE(wasm_bytes_resource)
-        Z_PARAM_OPTIONAL
-        Z_PARAM_STR_EX(wasm_module_unique_identifier, NULLABLE, 0);
-    ZEND_PARSE_PARAMETERS_END();
+    if (depth > WASM_MESSAGE_PACK_MAXIMUM_DEPTH) {
+        reader->error = wasm_message_pack_error::TOO_DEEP;
 
-    zend_string *resource_key = NULL;
-    bool persistent_wasm_module = false;
+        return false;
+    }
 
-    // The Wasm module resource will be persistent if there is a unique identifier.
-    if (wasm_module_unique_identifier != NULL) {
-        resource_key = zend_string_copy(wasm_module_unique_identifier);
-        persistent_wasm_module = true;
+    if (reader->cursor >= reader->end) {
+        reader->error = wasm_message_pack_error::TRUNCATED;
+
+        return false;
     }
 
-    zend_resource *resource = NULL;
+    uint8_t header = *reader->cursor++;
+    uint64_t length;
+    bool is_map;
 
-    // Wasm module persistent resource look up.
-    if (persistent_wasm_module) {
-        resource = (zend_resource *) zend_hash_find_ptr(&EG(persistent_list), resource_key);
+    // Positive fixint.
+    if (header <= 0x7f) {
+        ZVAL_LONG(value, header);
+
+        return true;
     }
+    // Negative fixint.
+    else if (header >= 0xe0) {
+        ZVAL_LONG(value, (int8_t) header);
 
-    // Wasm module persistent resource is disabled, or it is not
-    // registered in the persistent resource registry.
-    if (resource == NULL) {
-        // Extract the bytes from the resource.
-        wasmer_byte_array *wasm_byte_array = wasm_bytes_from_resource(Z_RES_P(wasm_bytes_resource));
+        return true;
+    }
+    // Fixmap.
+    else if (header <= 0x8f) {
+        length = header & 0x0f;
+        is_map = true;
 
-        if (NULL == wasm_byte_array) {
-            RETURN_NULL();
-        }
+        goto decode_collection;
+    }
+    // Fixarray.
+    else if (header <= 0x9f) {
+        length = header & 0x0f;
+        is_map = false;
 
-        // Create a new Wasm module.
-        wasmer_module_t *wasm_module = NULL;
-        wasmer_result_t wasm_compilation_result = wasmer_compile(
-            &wasm_module,
-            // Bytes.
-            (uint8_t *) wasm_byte_array->bytes,
-            // Bytes length.
-            wasm_byte_array->bytes_len
-        );
+        goto decode_collection;
+    }
+    // Fixstr.
+    else if (header <= 0xbf) {
+        length = header & 0x1f;
 
-        // Compilation failed.
-        if (wasm_compilation_result != wasmer_result_t::WASMER_OK) {
-            free(wasm_module);
+        goto decode_string;
+    }
 
-            RETURN_NULL();
+    switch (header) {
+        case 0xc0:
+            ZVAL_NULL(value);
+
+            return true;
+
+        case 0xc2:
+            ZVAL_FALSE(value);
+
+            return true;
+
+        case 0xc3:
+            ZVAL_TRUE(value);
+
+            return true;
+
+        // str 8, bin 8.
+        case 0xd9:
+        case 0xc4:
+            if (!wasm_message_pack_read_length(reader, 1, &length)) {
+                return false;
+            }
+
+            goto decode_string;
+
+        // str 16, bin 16.
+        case 0xda:
+        case 0xc5:
+            if (!wasm_message_pack_read_length(reader, 2, &length)) {
+                return false;
+            }
+
+            goto decode_string;
+
+        // str 32, bin 32.
+        case 0xdb:
+        case 0xc6:
+            if (!wasm_message_pack_read_length(reader, 4, &length)) {
+                return false;
+            }
+
+            goto decode_string;
+
+        // float 32.
+        case 0xca:
+        {
+            uint64_t bits;
+            float float_value;
+
+            if (!wasm_message_pack_read_length(reader, 4, &bits)) {
+                return false;
+            }
+
+            uint32_t narrow_bits = (uint32_t) bits;
+            memcpy(&float_value, &narrow_bits, sizeof(float_value));
+            ZVAL_DOUBLE(value, (double) float_value);
+
+            return true;
         }
 
-        // Store the module in a persistent resource.
-        if (persistent_wasm_module) {
-            resource = zend_register_persistent_resource_ex(
-                resource_key,
-                (void *) wasm_module,
-                wasm_module_resource_number
-            );
+        // float 64.
+        case 0xcb:
+        {
+            uint64_t bits;
+            double double_value;
+
+            if (!wasm_message_pack_read_length(reader, 8, &bits)) {
+                return false;
+            }
+
+            memcpy(&double_value, &bits, sizeof(double_value));
+            ZVAL_DOUBLE(value, double_value);
+
+            return true;
         }
-        // Store the module in a regular resource.
-        else {
-            resource = zend_register_resource((void *) wasm_module, wasm_module_resource_number);
+
+        // uint 8, 16, 32, 64.
+        case 0xcc:
+        case 0xcd:
+        case 0xce:
+        case 0xcf:
+        {
+            uint64_t unsigned_value;
+
+            if (!wasm_message_pack_read_length(reader, (size_t) 1 << (header - 0xcc), &unsigned_value)) {
+                return false;
+            }
+
+            // Too large for a PHP integer, fallback to a float.
+            if (unsigned_value > (uint64_t) ZEND_LONG_MAX) {
+                ZVAL_DOUBLE(value, (double) unsigned_value);
+            } else {
+                ZVAL_LONG(value, (zend_long) unsigned_value);
+            }
+
+            return true;
         }
 
-        if (resource == NULL) {
-            RETURN_NULL();
+        // int 8, 16, 32, 64.
+        case 0xd0:
+        case 0xd1:
+        case 0xd2:
+        case 0xd3:
+        {
+            size_t size = (size_t) 1 << (header - 0xd0);
+            uint64_t bits;
+
+            if (!wasm_message_pack_read_length(reader, size, &bits)) {
+                return false;
+            }
+
+            // Sign-extend.
+            if (size < 8 && (bits & ((uint64_t) 1 << (size * 8 - 1)))) {
+                bits |= ~(uint64_t) 0 << (size * 8);
+            }
+
+            ZVAL_LONG(value, (zend_long) (int64_t) bits);
+
+            return true;
         }
+
+        // array 16, map 16.
+        case 0xdc:
+        case 0xde:
+            if (!wasm_message_pack_read_length(reader, 2, &length)) {
+                return false;
+            }
+
+            is_map = header == 0xde;
+
+            goto decode_collection;
+
+        // array 32, map 32.
+        case 0xdd:
+        case 0xdf:
+            if (!wasm_message_pack_read_length(reader, 4, &length)) {
+                return false;
+            }
+
+            is_map = header == 0xdf;
+
+            goto decode_collection;
+
+        // Extensions, and the never used `0xc1`.
+        default:
+            reader->error = wasm_message_pack_error::UNSUPPORTED_TYPE;
+
+            return false;
     }
-    // The resource is already registered.
-    else {}
 
-    RETURN_RES(resource);
-}
+decode_string:
+    if ((uint64_t) (reader->end - reader->cursor) < length) {
+        reader->error = wasm_message_pack_error::TRUNCATED;
 
-/**
- * Clean up all persistent resources registered by this module.
- */
-static int clean_up_persistent_resources(zval *hashmap_item)
-{
-    zend_resource *resource = Z_RES_P(hashmap_item);
+        return false;
+    }
 
-    if (resource->type == wasm_module_resource_number) {
-        wasm_module_destructor(resource);
-        return ZEND_HASH_APPLY_REMOVE;
+    ZVAL_STRINGL(value, (const char *) reader->cursor, (size_t) length);
+    reader->cursor += length;
+
+    return true;
+
+decode_collection:
+    // Every item is encoded on at least one byte, do not trust a
+    // length that cannot fit in the remaining bytes.
+    if ((uint64_t) (reader->end - reader->cursor) < length * (is_map ? 2 : 1)) {
+        reader->error = wasm_message_pack_error::TRUNCATED;
+
+        return false;
     }
 
-    return ZEND_HASH_APPLY_KEEP;
+    array_init_size(value, (uint32_t) length);
+
+    for (uint64_t nth = 0; nth < length; ++nth) {
+        zval key;
+        zval item;
+
+        if (is_map) {
+            if (!wasm_message_pack_decode(reader, &key, depth + 1)) {
+                zval_ptr_dtor(value);
+                ZVAL_UNDEF(value);
+
+                return false;
+            }
+
+            if (Z_TYPE(key) != IS_LONG && Z_TYPE(key) != IS_STRING) {
+                zval_ptr_dtor(&key);
+                zval_ptr_dtor(value);
+                ZVAL_UNDEF(value);
+                reader->error = wasm_message_pack_error::UNSUPPORTED_KEY;
+
+                return false;
+            }
+        }
+
+        if (!wasm_message_pack_decode(reader, &item, depth + 1)) {
+            if (is_map) {
+                zval_ptr_dtor(&key);
+            }
+
+            zval_ptr_dtor(value);
+            ZVAL_UNDEF(value);
+
+            return false;
+        }
+
+        if (!is_map) {
+            zend_hash_next_index_insert_new(Z_ARRVAL_P(value), &item);
+        } else if (Z_TYPE(key) == IS_LONG) {
+            zend_hash_index_update(Z_ARRVAL_P(value), Z_LVAL(key), &item);
+        } else {
+            zend_symtable_update(Z_ARRVAL_P(value), Z_STR(key), &item);
+            zval_ptr_dtor(&key);
+        }
+    }
+
+    return true;
 }
 
 /**
- * Iterate over the persistent resources list to clean up Wasm
- * persistent resources.
+ * Returns a human readable message for a MessagePack error.
  */
-static void php_wasm_module_clean_up_persistent_resources()
+static const char *wasm_message_pack_error_message(wasm_message_pack_error error)
 {
-    zend_hash_apply(&EG(persistent_list), (apply_func_t) clean_up_persistent_resources);
+    switch (error) {
+        case wasm_message_pack_error::BUFFER_TOO_SMALL:
+            return "The buffer is too small to hold the encoded value";
+
+        case wasm_message_pack_error::UNSUPPORTED_TYPE:
+            return "The value has a type that cannot be encoded or decoded";
+
+        case wasm_message_pack_error::UNSUPPORTED_KEY:
+            return "Map keys must be integers or strings";
+
+        case wasm_message_pack_error::TOO_DEEP:
+            return "The value is nested too deeply";
+
+        case wasm_message_pack_error::TRUNCATED:
+            return "The encoded value is truncated";
+
+        default:
+            return "Unknown error";
+    }
 }
 
 /**
- * Declare the parameter information for the `wasm_module_clean_up_persistent_resources`
- * function.
+ * Declare the parameter information for the
+ * `WasmArrayBuffer::writeMessagePack` method.
  */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_module_clean_up_persistent_resources, ZEND_RETURN_VALUE, ARITY(0), IS_VOID, NOT_NULLABLE)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmarraybuffer_write_message_pack, ZEND_RETURN_VALUE, ARITY(2), IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, offset, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_INFO(0, value)
 ZEND_END_ARG_INFO()
 
 /**
- * Declare the `wasm_module_clean_up_persistent_resources` function.
+ * Declare the `WasmArrayBuffer::writeMessagePack` method.
+ *
+ * Encodes a PHP value (null, boolean, integer, float, string, or
+ * array of those) as MessagePack, directly into the buffer at the
+ * given offset. It returns the number of written bytes.
  *
  * # Usage
  *
  * ```php
- * $bytes = wasm_fetch_bytes('my_program.wasm');
- * $module = wasm_compile($bytes, 'foo');
- * // The module is registered as a persistent resource.
- *
- * wasm_module_clean_up_persistent_resource();
- *
- * $module = wasm_compile($bytes, 'foo');
- * // The module is registered as a persistent resource, again.
+ * $buffer = new WasmArrayBuffer(256);
+ * $length = $buffer->writeMessagePack(0, ['foo' => [1, 2.5, true]]);
  * ```
  */
-PHP_FUNCTION(wasm_module_clean_up_persistent_resources)
+PHP_METHOD(WasmArrayBuffer, writeMessagePack)
 {
-    ZEND_PARSE_PARAMETERS_NONE();
+    zend_long offset;
+    zval *value;
 
-    // Clean up persistent resources.
-    php_wasm_module_clean_up_persistent_resources();
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 2, 2)
+        Z_PARAM_LONG(offset)
+        Z_PARAM_ZVAL(value)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_array_buffer_object *wasm_array_buffer_object = WASM_ARRAY_BUFFER_OBJECT_THIS();
+
+    if (offset < 0 || offset > wasm_array_buffer_object->buffer_length) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            0,
+            "Offset is outside the buffer range [0; %zu]; given %lld.",
+            wasm_array_buffer_object->buffer_length,
+            offset
+        );
+
+        return;
+    }
+
+    wasm_array_buffer_detach(wasm_array_buffer_object);
+
+    uint8_t *buffer = (uint8_t *) wasm_array_buffer_object->buffer;
+    wasm_message_pack_writer writer = {
+        buffer + offset,
+        buffer + wasm_array_buffer_object->buffer_length,
+        wasm_message_pack_error::NONE
+    };
+
+    if (!wasm_message_pack_encode(&writer, value, 0)) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            1,
+            "%s.",
+            wasm_message_pack_error_message(writer.error)
+        );
+
+        return;
+    }
+
+    RETURN_LONG(writer.cursor - (buffer + offset));
 }
 
 /**
- * Declare the parameter information for the `wasm_module_serialize`
- * function.
+ * Declare the parameter information for the
+ * `WasmArrayBuffer::readMessagePack` method.
  */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_module_serialize, ZEND_RETURN_VALUE, ARITY(1), IS_STRING, NULLABLE)
-    ZEND_ARG_TYPE_INFO(0, wasm_module, IS_RESOURCE, NOT_NULLABLE)
+ZEND_BEGIN_ARG_INFO_EX(arginfo_wasmarraybuffer_read_message_pack, 0, ZEND_RETURN_VALUE, ARITY(1))
+    ZEND_ARG_TYPE_INFO(0, offset, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, length, IS_LONG, NOT_NULLABLE)
 ZEND_END_ARG_INFO()
 
 /**
- * Declare the `wasm_module_serialize` function.
+ * Declare the `WasmArrayBuffer::readMessagePack` method.
+ *
+ * Decodes one MessagePack value read directly from the buffer at the
+ * given offset. The optional length bounds the number of bytes that
+ * can be read; 0 means up to the end of the buffer.
  *
  * # Usage
  *
  * ```php
- * $bytes = wasm_fetch_bytes('my_program.wasm');
- * $module = wasm_compile($bytes);
- * $serialized_module = wasm_module_serialize($module);
- * // `$serialized_module` is of type `string`.
+ * $buffer = new WasmArrayBuffer(256);
+ * $buffer->writeMessagePack(0, ['foo' => [1, 2.5, true]]);
+ * $value = $buffer->readMessagePack(0);
  * ```
  */
-PHP_FUNCTION(wasm_module_serialize)
+PHP_METHOD(WasmArrayBuffer, readMessagePack)
 {
-    zval *wasm_module_resource;
+    zend_long offset;
+    zend_long length = 0;
 
-    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
-        Z_PARAM_RESOURCE(wasm_module_resource)
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 2)
+        Z_PARAM_LONG(offset)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(length)
     ZEND_PARSE_PARAMETERS_END();
 
-    // Extract the module from the resource.
-    wasmer_module_t *wasm_module = wasm_module_from_resource(Z_RES_P(wasm_module_resource));
-
-    if (wasm_module == NULL) {
-        RETURN_NULL();
-    }
+    wasm_array_buffer_object *wasm_array_buffer_object = WASM_ARRAY_BUFFER_OBJECT_THIS();
 
-    // Let's serialize the module.
-    wasmer_serialized_module_t *wasm_serialized_module = NULL;
+    if (offset < 0 || offset > wasm_array_buffer_object->buffer_length) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            0,
+            "Offset is outside the buffer range [0; %zu]; given %lld.",
+            wasm_array_buffer_object->buffer_length,
+            offset
+        );
 
-    if (wasmer_module_serialize(&wasm_serialized_module, wasm_module) != wasmer_result_t::WASMER_OK) {
-        RETURN_NULL();
+        return;
     }
 
-    // Extract the bytes from the serialized module.
-    wasmer_byte_array wasm_serialized_module_bytes = wasmer_serialized_module_bytes(wasm_serialized_module);
+    size_t maximum_length = wasm_array_buffer_object->buffer_length - offset;
 
-    ZVAL_STRINGL(
-        return_value,
-        (char *) (uint8_t *) wasm_serialized_module_bytes.bytes,
-        wasm_serialized_module_bytes.bytes_len
-    );
+    if (length < 0 || length > maximum_length) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            1,
+            "Length must be in the range [0; %zu]; given %lld.",
+            maximum_length,
+            length
+        );
+
+        return;
+    }
+
+    if (length == 0) {
+        length = maximum_length;
+    }
+
+    const uint8_t *buffer = (const uint8_t *) wasm_array_buffer_object->buffer + offset;
+    wasm_message_pack_reader reader = {
+        buffer,
+        buffer + length,
+        wasm_message_pack_error::NONE
+    };
+
+    if (!wasm_message_pack_decode(&reader, return_value, 0)) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            2,
+            "%s.",
+            wasm_message_pack_error_message(reader.error)
+        );
+
+        return;
+    }
 }
 
 /**
- * Declare the parameter information for the `wasm_module_deserialize`
- * function.
+ * Reads a little-endian 32-bit integer at an arbitrary address.
  */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_module_deserialize, ZEND_RETURN_VALUE, ARITY(1), IS_RESOURCE, NULLABLE)
-    ZEND_ARG_TYPE_INFO(0, wasm_serialized_module, IS_STRING, NOT_NULLABLE)
-ZEND_END_ARG_INFO()
+static inline uint32_t wasm_hash_read_32(const uint8_t *data)
+{
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+
+    return WASM_HOST_IS_LITTLE_ENDIAN ? value : wasm_byte_swap_32(value);
+}
 
 /**
- * Declare the `wasm_module_deserialize` function.
- *
- * # Usage
- *
- * ```php
- * $bytes = wasm_fetch_bytes('my_program.wasm');
- * $module = wasm_compile($bytes);
- * $serialized_module = wasm_module_serialize($module);
- * $module = wasm_module_deserialize($serialized_module);
- * ```
+ * Reads a little-endian 64-bit integer at an arbitrary address.
  */
-PHP_FUNCTION(wasm_module_deserialize)
+static inline uint64_t wasm_hash_read_64(const uint8_t *data)
 {
-    char *wasm_serialized_module_bytes;
-    size_t wasm_serialized_module_bytes_length;
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
 
-    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
-        Z_PARAM_STRING(wasm_serialized_module_bytes, wasm_serialized_module_bytes_length)
-    ZEND_PARSE_PARAMETERS_END();
+    return WASM_HOST_IS_LITTLE_ENDIAN ? value : wasm_byte_swap_64(value);
+}
 
-    wasmer_serialized_module_t *wasm_serialized_module = NULL;
+/**
+ * Lookup tables for CRC-32C (Castagnoli, reflected polynomial
+ * `0x82f63b78`), sliced by 8. Computed by `MINIT`.
+ */
+static uint32_t wasm_crc32c_table[8][256];
 
-    if (wasmer_serialized_module_from_bytes(&wasm_serialized_module, (const uint8_t *) wasm_serialized_module_bytes, wasm_serialized_module_bytes_length) != wasmer_result_t::WASMER_OK) {
-        RETURN_NULL();
-    }
+/**
+ * Whether the CRC-32C can use the SSE 4.2 `crc32` instruction. Set
+ * once by `MINIT`.
+ */
+static bool wasm_crc32c_has_sse42 = false;
 
-    wasmer_module_t *wasm_module = NULL;
+/**
+ * Computes the CRC-32C lookup tables.
+ */
+static void wasm_crc32c_initialize()
+{
+    for (uint32_t byte = 0; byte < 256; ++byte) {
+        uint32_t crc = byte;
 
-    if (wasmer_module_deserialize(&wasm_module, wasm_serialized_module) != wasmer_result_t::WASMER_OK) {
-        RETURN_NULL();
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0x82f63b78 & (0 - (crc & 1)));
+        }
+
+        wasm_crc32c_table[0][byte] = crc;
     }
 
-    // Store in and return the result as a resource.
-    zend_resource *resource = zend_register_resource((void *) wasm_module, wasm_module_resource_number);
+    for (uint32_t byte = 0; byte < 256; ++byte) {
+        for (int slice = 1; slice < 8; ++slice) {
+            uint32_t previous = wasm_crc32c_table[slice - 1][byte];
 
-    RETURN_RES(resource);
+            wasm_crc32c_table[slice][byte] = (previous >> 8) ^ wasm_crc32c_table[0][previous & 0xff];
+        }
+    }
 }
 
 /**
- * Extract the data structure inside the `wasm_instance` resource.
+ * Updates a CRC-32C with the lookup tables, 8 bytes at a time.
  */
-wasmer_instance_t *wasm_instance_from_resource(zend_resource *wasm_instance_resource)
+static uint32_t wasm_crc32c_update_table(uint32_t crc, const uint8_t *data, size_t length)
 {
-    return (wasmer_instance_t *) zend_fetch_resource(
-        wasm_instance_resource,
-        wasm_instance_resource_name,
-        wasm_instance_resource_number
-    );
-}
+    while (length >= 8) {
+        uint32_t low = crc ^ wasm_hash_read_32(data);
+        uint32_t high = wasm_hash_read_32(data + 4);
+
+        crc =
+            wasm_crc32c_table[7][low & 0xff] ^
+            wasm_crc32c_table[6][(low >> 8) & 0xff] ^
+            wasm_crc32c_table[5][(low >> 16) & 0xff] ^
+            wasm_crc32c_table[4][low >> 24] ^
+            wasm_crc32c_table[3][high & 0xff] ^
+            wasm_crc32c_table[2][(high >> 8) & 0xff] ^
+            wasm_crc32c_table[1][(high >> 16) & 0xff] ^
+            wasm_crc32c_table[0][high >> 24];
+
+        data += 8;
+        length -= 8;
+    }
 
-/**
- * Destructor for the `wasm_instance` resource.
- */
-static void wasm_instance_destructor(zend_resource *resource)
-{
-    wasmer_instance_t *wasm_instance = wasm_instance_from_resource(resource);
+    while (length > 0) {
+        crc = (crc >> 8) ^ wasm_crc32c_table[0][(crc ^ *data) & 0xff];
 
-    if (wasm_instance == NULL) {
-        return;
+        ++data;
+        --length;
     }
 
-    wasmer_instance_destroy(wasm_instance);
+    return crc;
 }
 
-/**
- * Declare the parameter information for the
- * `wasm_module_new_instance` function.
- */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_module_new_instance, ZEND_RETURN_VALUE, ARITY(1), IS_RESOURCE, NULLABLE)
-    ZEND_ARG_TYPE_INFO(0, wasm_module, IS_RESOURCE, NOT_NULLABLE)
-ZEND_END_ARG_INFO()
+#if defined(WASM_BULK_X86_64)
 
 /**
- * Declare the `wasm_module_new_instance` function.
- *
- * # Usage
- *
- * ```php
- * $bytes = wasm_fetch_bytes('my_program.wasm');
- * $module = wasm_compile($bytes);
- * $instance = wasm_module_new_instance($module);
- * // `$instance` is of type `resource of type (wasm_instance)`.
- * ```
- *
- * It is similar to running:
- *
- * ```php
- * $bytes = wasm_fetch_bytes('my_program.wasm');
- * $instance = wasm_new_instance($bytes);
- * ```
+ * Updates a CRC-32C with the SSE 4.2 `crc32` instruction, 8 bytes at
+ * a time.
  */
-PHP_FUNCTION(wasm_module_new_instance)
+static WASM_TARGET_SSE42 uint32_t wasm_crc32c_update_sse42(uint32_t crc, const uint8_t *data, size_t length)
 {
-    zval *wasm_module_resource;
+    uint64_t crc64 = crc;
 
-    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
-        Z_PARAM_RESOURCE(wasm_module_resource)
-    ZEND_PARSE_PARAMETERS_END();
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
 
-    // Extract the module from the resource.
-    wasmer_module_t *wasm_module = wasm_module_from_resource(Z_RES_P(wasm_module_resource));
+        crc64 = _mm_crc32_u64(crc64, word);
 
-    if (wasm_module == NULL) {
-        RETURN_NULL();
+        data += 8;
+        length -= 8;
     }
 
-    // Create a new Wasm instance.
-    wasmer_instance_t *wasm_instance = NULL;
-    wasmer_result_t wasm_instantiation_result = wasmer_module_instantiate(
-        // Module.
-        wasm_module,
-        // Instance.
-        &wasm_instance,
-        // Imports.
-        {},
-        // Imports length.
-        0
-    );
+    crc = (uint32_t) crc64;
 
-    // Instantiation failed.
-    if (wasm_instantiation_result != wasmer_result_t::WASMER_OK) {
-        free(wasm_instance);
+    while (length > 0) {
+        crc = _mm_crc32_u8(crc, *data);
 
-        RETURN_NULL();
+        ++data;
+        --length;
     }
 
-    // Store in and return the result as a resource.
-    zend_resource *resource = zend_register_resource((void *) wasm_instance, wasm_instance_resource_number);
-
-    RETURN_RES(resource);
+    return crc;
 }
 
-/**
- * Declare the parameter information for the `wasm_new_instance`
- * function.
- */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_new_instance, ZEND_RETURN_VALUE, ARITY(1), IS_RESOURCE, NULLABLE)
-    ZEND_ARG_TYPE_INFO(0, wasm_bytes, IS_RESOURCE, NOT_NULLABLE)
-ZEND_END_ARG_INFO()
+#endif
 
 /**
- * Declare the `wasm_new_instance` function.
- *
- * # Usage
- *
- * ```php
- * $bytes = wasm_fetch_bytes('my_program.wasm');
- * $instance = wasm_new_instance($bytes);
- * // `$instance` is of type `resource of type (wasm_instance)`.
- * ```
- *
- * This function is a shortcut of `wasm_compile` +
- * `wasm_module_new_instance`. It “hides” the module compilation step.
+ * Computes the CRC-32C of `length` bytes.
  */
-PHP_FUNCTION(wasm_new_instance)
+static uint32_t wasm_crc32c(const uint8_t *data, size_t length)
 {
-    zval *wasm_bytes_resource;
+#if defined(WASM_BULK_X86_64)
+    if (wasm_crc32c_has_sse42) {
+        return ~wasm_crc32c_update_sse42(0xffffffff, data, length);
+    }
+#endif
 
-    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
-        Z_PARAM_RESOURCE(wasm_bytes_resource)
-    ZEND_PARSE_PARAMETERS_END();
+    return ~wasm_crc32c_update_table(0xffffffff, data, length);
+}
 
-    // Extract the bytes from the resource.
-    wasmer_byte_array *wasm_byte_array = wasm_bytes_from_resource(Z_RES_P(wasm_bytes_resource));
+// Constants of XXH3.
+#define WASM_XXH_PRIME32_1 0x9e3779b1U
+#define WASM_XXH_PRIME32_2 0x85ebca77U
+#define WASM_XXH_PRIME32_3 0xc2b2ae3dU
+#define WASM_XXH_PRIME64_1 0x9e3779b185ebca87ULL
+#define WASM_XXH_PRIME64_2 0xc2b2ae3d27d4eb4fULL
+#define WASM_XXH_PRIME64_3 0x165667b19e3779f9ULL
+#define WASM_XXH_PRIME64_4 0x85ebca77c2b2ae63ULL
+#define WASM_XXH_PRIME64_5 0x27d4eb2f165667c5ULL
+#define WASM_XXH_PRIME_MX1 0x165667919e3779f9ULL
+#define WASM_XXH_PRIME_MX2 0x9fb21c651e98df25ULL
+#define WASM_XXH3_STRIPE_LENGTH 64
+#define WASM_XXH3_SECRET_SIZE 192
 
-    if (NULL == wasm_byte_array) {
-        RETURN_NULL();
-    }
+/**
+ * Default secret of XXH3.
+ */
+static const uint8_t wasm_xxh3_secret[WASM_XXH3_SECRET_SIZE] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
 
-    // Create a new Wasm instance.
-    wasmer_instance_t *wasm_instance = NULL;
-    wasmer_result_t wasm_instantiation_result = wasmer_instantiate(
-        &wasm_instance,
-        // Bytes.
-        (uint8_t *) wasm_byte_array->bytes,
-        // Bytes length.
-        wasm_byte_array->bytes_len,
-        // Imports.
-        {},
-        // Imports length.
-        0
-    );
+/**
+ * Multiplies two 64-bit integers to 128 bits, and folds the result
+ * by xoring its halves.
+ */
+static inline uint64_t wasm_xxh3_multiply_fold(uint64_t left, uint64_t right)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t product = (__uint128_t) left * right;
+
+    return (uint64_t) product ^ (uint64_t) (product >> 64);
+#else
+    uint64_t low_low = (left & 0xffffffff) * (right & 0xffffffff);
+    uint64_t high_low = (left >> 32) * (right & 0xffffffff);
+    uint64_t low_high = (left & 0xffffffff) * (right >> 32);
+    uint64_t high_high = (left >> 32) * (right >> 32);
+    uint64_t cross = (low_low >> 32) + (high_low & 0xffffffff) + low_high;
+    uint64_t upper = (high_low >> 32) + (cross >> 32) + high_high;
+    uint64_t lower = (cross << 32) | (low_low & 0xffffffff);
+
+    return lower ^ upper;
+#endif
+}
 
-    // Instantiation failed.
-    if (wasm_instantiation_result != wasmer_result_t::WASMER_OK) {
-        free(wasm_instance);
+/**
+ * Rotates a 64-bit integer to the left.
+ */
+static inline uint64_t wasm_xxh3_rotate_left(uint64_t value, int shift)
+{
+    return (value << shift) | (value >> (64 - shift));
+}
 
-        RETURN_NULL();
-    }
+/**
+ * Final mix of XXH64, used by XXH3 for inputs of 0 to 3 bytes.
+ */
+static inline uint64_t wasm_xxh64_avalanche(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= WASM_XXH_PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= WASM_XXH_PRIME64_3;
+    hash ^= hash >> 32;
 
-    // Store in and return the result as a resource.
-    zend_resource *resource = zend_register_resource((void *) wasm_instance, wasm_instance_resource_number);
+    return hash;
+}
 
-    RETURN_RES(resource);
+/**
+ * Final mix of XXH3.
+ */
+static inline uint64_t wasm_xxh3_avalanche(uint64_t hash)
+{
+    hash ^= hash >> 37;
+    hash *= WASM_XXH_PRIME_MX1;
+    hash ^= hash >> 32;
+
+    return hash;
 }
 
 /**
- * Extract the data structure inside the `wasm_value` resource.
+ * Mixes 16 bytes of input with 16 bytes of secret.
  */
-wasmer_value_t *wasm_value_from_resource(zend_resource *wasm_value_resource)
+static inline uint64_t wasm_xxh3_mix_16(const uint8_t *data, const uint8_t *secret)
 {
-    return (wasmer_value_t *) zend_fetch_resource(
-        wasm_value_resource,
-        wasm_value_resource_name,
-        wasm_value_resource_number
+    return wasm_xxh3_multiply_fold(
+        wasm_hash_read_64(data) ^ wasm_hash_read_64(secret),
+        wasm_hash_read_64(data + 8) ^ wasm_hash_read_64(secret + 8)
     );
 }
 
 /**
- * Destructor for the `wasm_value` resource.
+ * Accumulates one 64-byte stripe.
  */
-static void wasm_value_destructor(zend_resource *resource)
+static inline void wasm_xxh3_accumulate_stripe(uint64_t *accumulators, const uint8_t *data, const uint8_t *secret)
 {
-    wasmer_value_t *wasm_value = wasm_value_from_resource(resource);
+    for (int nth = 0; nth < 8; ++nth) {
+        uint64_t value = wasm_hash_read_64(data + 8 * nth);
+        uint64_t key = value ^ wasm_hash_read_64(secret + 8 * nth);
 
-    if (wasm_value == NULL) {
-        return;
+        accumulators[nth ^ 1] += value;
+        accumulators[nth] += (key & 0xffffffff) * (key >> 32);
     }
-
-    efree(wasm_value);
 }
 
 /**
- * Declare the parameter information for the `wasm_value` function.
+ * Scrambles the accumulators at the end of a block.
  */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_value, ZEND_RETURN_VALUE, ARITY(2), IS_RESOURCE, NULLABLE)
-    ZEND_ARG_TYPE_INFO(0, type, IS_LONG, NOT_NULLABLE)
-    ZEND_ARG_INFO(0, value)
-ZEND_END_ARG_INFO()
+static inline void wasm_xxh3_scramble(uint64_t *accumulators, const uint8_t *secret)
+{
+    for (int nth = 0; nth < 8; ++nth) {
+        uint64_t accumulator = accumulators[nth];
+
+        accumulator ^= accumulator >> 47;
+        accumulator ^= wasm_hash_read_64(secret + 8 * nth);
+        accumulator *= WASM_XXH_PRIME32_1;
+
+        accumulators[nth] = accumulator;
+    }
+}
 
 /**
- * Declare the `wasm_value` function.
- *
- * # Usage
- *
- * ```php
- * $value = wasm_value(WASM_TYPE_I32, 7);
- * // `$value` is of type `resource of type (wasm_value)`.
- * ```
+ * Hashes more than 240 bytes with XXH3: the input is consumed by
+ * blocks of 16 stripes, and each stripe is accumulated in 8 lanes.
  */
-PHP_FUNCTION(wasm_value)
+static uint64_t wasm_xxh3_64_long(const uint8_t *data, size_t length)
 {
-    zend_long value_type;
-    zval *value;
-
-    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 2, 2)
-        Z_PARAM_LONG(value_type)
-        Z_PARAM_ZVAL(value)
-    ZEND_PARSE_PARAMETERS_END();
+    uint64_t accumulators[8] = {
+        WASM_XXH_PRIME32_3, WASM_XXH_PRIME64_1, WASM_XXH_PRIME64_2, WASM_XXH_PRIME64_3,
+        WASM_XXH_PRIME64_4, WASM_XXH_PRIME32_2, WASM_XXH_PRIME64_5, WASM_XXH_PRIME32_1
+    };
+    const size_t stripes_per_block = (WASM_XXH3_SECRET_SIZE - WASM_XXH3_STRIPE_LENGTH) / 8;
+    const size_t block_length = WASM_XXH3_STRIPE_LENGTH * stripes_per_block;
+    const size_t number_of_blocks = (length - 1) / block_length;
+
+    for (size_t block = 0; block < number_of_blocks; ++block) {
+        for (size_t stripe = 0; stripe < stripes_per_block; ++stripe) {
+            wasm_xxh3_accumulate_stripe(
+                accumulators,
+                data + block * block_length + stripe * WASM_XXH3_STRIPE_LENGTH,
+                wasm_xxh3_secret + stripe * 8
+            );
+        }
 
-    if (value_type < 0) {
-        RETURN_NULL();
+        wasm_xxh3_scramble(accumulators, wasm_xxh3_secret + WASM_XXH3_SECRET_SIZE - WASM_XXH3_STRIPE_LENGTH);
     }
 
-    // Convert the value to a `wasmer_value_tag`. It is expected to
-    // receive a `WASM_TYPE_*` constant.
-    wasmer_value_tag type = (wasmer_value_tag) (uint32_t) value_type;
-    wasmer_value_t *wasm_value = (wasmer_value_t *) emalloc(sizeof(wasmer_value_t));
+    const size_t number_of_stripes = ((length - 1) - block_length * number_of_blocks) / WASM_XXH3_STRIPE_LENGTH;
 
-    // Convert the PHP value to a `wasm_value_t`.
-    if (type == wasmer_value_tag::WASM_I32) {
-        wasm_value->tag = type;
-        wasm_value->value.I32 = (int32_t) value->value.lval;
-    } else if (type == wasmer_value_tag::WASM_I64) {
-        wasm_value->tag = type;
-        wasm_value->value.I64 = (int64_t) value->value.lval;
-    } else if (type == wasmer_value_tag::WASM_F32) {
-        wasm_value->tag = type;
-        wasm_value->value.F32 = (float) value->value.dval;
-    } else if (type == wasmer_value_tag::WASM_F64) {
-        wasm_value->tag = type;
-        wasm_value->value.F64 = (double) value->value.dval;
+    for (size_t stripe = 0; stripe < number_of_stripes; ++stripe) {
+        wasm_xxh3_accumulate_stripe(
+            accumulators,
+            data + number_of_blocks * block_length + stripe * WASM_XXH3_STRIPE_LENGTH,
+            wasm_xxh3_secret + stripe * 8
+        );
     }
-    // Invalid value type provided.
-    else {
-        efree(wasm_value);
 
-        RETURN_NULL();
+    wasm_xxh3_accumulate_stripe(
+        accumulators,
+        data + length - WASM_XXH3_STRIPE_LENGTH,
+        wasm_xxh3_secret + WASM_XXH3_SECRET_SIZE - WASM_XXH3_STRIPE_LENGTH - 7
+    );
+
+    uint64_t hash = length * WASM_XXH_PRIME64_1;
+
+    for (int nth = 0; nth < 4; ++nth) {
+        hash += wasm_xxh3_multiply_fold(
+            accumulators[2 * nth] ^ wasm_hash_read_64(wasm_xxh3_secret + 11 + 16 * nth),
+            accumulators[2 * nth + 1] ^ wasm_hash_read_64(wasm_xxh3_secret + 11 + 16 * nth + 8)
+        );
     }
 
-    // Store in and return the result as a resource.
-    zend_resource *resource = zend_register_resource((void *) wasm_value, wasm_value_resource_number);
+    return wasm_xxh3_avalanche(hash);
+}
 
-    RETURN_RES(resource);
+/**
+ * Computes the 64-bit XXH3 hash of `length` bytes, with the default
+ * secret and a seed of 0.
+ */
+static uint64_t wasm_xxh3_64(const uint8_t *data, size_t length)
+{
+    const uint8_t *secret = wasm_xxh3_secret;
+
+    if (length == 0) {
+        return wasm_xxh64_avalanche(wasm_hash_read_64(secret + 56) ^ wasm_hash_read_64(secret + 64));
+    }
+
+    if (length <= 3) {
+        uint32_t combined =
+            ((uint32_t) data[0] << 16) |
+            ((uint32_t) data[length >> 1] << 24) |
+            (uint32_t) data[length - 1] |
+            ((uint32_t) length << 8);
+        uint64_t flip = wasm_hash_read_32(secret) ^ wasm_hash_read_32(secret + 4);
+
+        return wasm_xxh64_avalanche((uint64_t) combined ^ flip);
+    }
+
+    if (length <= 8) {
+        uint64_t input = wasm_hash_read_32(data + length - 4) + ((uint64_t) wasm_hash_read_32(data) << 32);
+        uint64_t hash = input ^ (wasm_hash_read_64(secret + 8) ^ wasm_hash_read_64(secret + 16));
+
+        hash ^= wasm_xxh3_rotate_left(hash, 49) ^ wasm_xxh3_rotate_left(hash, 24);
+        hash *= WASM_XXH_PRIME_MX2;
+        hash ^= (hash >> 35) + length;
+        hash *= WASM_XXH_PRIME_MX2;
+        hash ^= hash >> 28;
+
+        return hash;
+    }
+
+    if (length <= 16) {
+        uint64_t low = wasm_hash_read_64(data) ^ (wasm_hash_read_64(secret + 24) ^ wasm_hash_read_64(secret + 32));
+        uint64_t high = wasm_hash_read_64(data + length - 8) ^ (wasm_hash_read_64(secret + 40) ^ wasm_hash_read_64(secret + 48));
+
+        return wasm_xxh3_avalanche(length + wasm_byte_swap_64(low) + high + wasm_xxh3_multiply_fold(low, high));
+    }
+
+    if (length <= 128) {
+        uint64_t hash = length * WASM_XXH_PRIME64_1;
+
+        if (length > 32) {
+            if (length > 64) {
+                if (length > 96) {
+                    hash += wasm_xxh3_mix_16(data + 48, secret + 96);
+                    hash += wasm_xxh3_mix_16(data + length - 64, secret + 112);
+                }
+
+                hash += wasm_xxh3_mix_16(data + 32, secret + 64);
+                hash += wasm_xxh3_mix_16(data + length - 48, secret + 80);
+            }
+
+            hash += wasm_xxh3_mix_16(data + 16, secret + 32);
+            hash += wasm_xxh3_mix_16(data + length - 32, secret + 48);
+        }
+
+        hash += wasm_xxh3_mix_16(data, secret);
+        hash += wasm_xxh3_mix_16(data + length - 16, secret + 16);
+
+        return wasm_xxh3_avalanche(hash);
+    }
+
+    if (length <= 240) {
+        uint64_t hash = length * WASM_XXH_PRIME64_1;
+        const size_t number_of_rounds = length / 16;
+
+        for (size_t round = 0; round < 8; ++round) {
+            hash += wasm_xxh3_mix_16(data + 16 * round, secret + 16 * round);
+        }
+
+        hash = wasm_xxh3_avalanche(hash);
+
+        for (size_t round = 8; round < number_of_rounds; ++round) {
+            hash += wasm_xxh3_mix_16(data + 16 * round, secret + 16 * (round - 8) + 3);
+        }
+
+        hash += wasm_xxh3_mix_16(data + length - 16, secret + 136 - 17);
+
+        return wasm_xxh3_avalanche(hash);
+    }
+
+    return wasm_xxh3_64_long(data, length);
 }
 
 /**
- * Declare the parameter information for the `wasm_invoke_function`
- * function.
+ * Round constants of SHA-256.
  */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_invoke_function, ZEND_RETURN_VALUE, ARITY(3), _IS_NUMBER, NULLABLE)
-    ZEND_ARG_TYPE_INFO(0, wasm_instance, IS_RESOURCE, NOT_NULLABLE)
-    ZEND_ARG_TYPE_INFO(0, function_name, IS_STRING, NOT_NULLABLE)
-    ZEND_ARG_ARRAY_INFO(0, inputs, NOT_NULLABLE)
+static const uint32_t wasm_sha256_constants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+/**
+ * Rotates a 32-bit integer to the right.
+ */
+static inline uint32_t wasm_sha256_rotate_right(uint32_t value, int shift)
+{
+    return (value >> shift) | (value << (32 - shift));
+}
+
+/**
+ * Compresses one 64-byte block into the SHA-256 state.
+ */
+static void wasm_sha256_compress(uint32_t *state, const uint8_t *block)
+{
+    uint32_t schedule[64];
+
+    for (int nth = 0; nth < 16; ++nth) {
+        schedule[nth] =
+            ((uint32_t) block[4 * nth] << 24) |
+            ((uint32_t) block[4 * nth + 1] << 16) |
+            ((uint32_t) block[4 * nth + 2] << 8) |
+            (uint32_t) block[4 * nth + 3];
+    }
+
+    for (int nth = 16; nth < 64; ++nth) {
+        uint32_t s0 = wasm_sha256_rotate_right(schedule[nth - 15], 7) ^ wasm_sha256_rotate_right(schedule[nth - 15], 18) ^ (schedule[nth - 15] >> 3);
+        uint32_t s1 = wasm_sha256_rotate_right(schedule[nth - 2], 17) ^ wasm_sha256_rotate_right(schedule[nth - 2], 19) ^ (schedule[nth - 2] >> 10);
+
+        schedule[nth] = schedule[nth - 16] + s0 + schedule[nth - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int nth = 0; nth < 64; ++nth) {
+        uint32_t s1 = wasm_sha256_rotate_right(e, 6) ^ wasm_sha256_rotate_right(e, 11) ^ wasm_sha256_rotate_right(e, 25);
+        uint32_t choice = (e & f) ^ (~e & g);
+        uint32_t first = h + s1 + choice + wasm_sha256_constants[nth] + schedule[nth];
+        uint32_t s0 = wasm_sha256_rotate_right(a, 2) ^ wasm_sha256_rotate_right(a, 13) ^ wasm_sha256_rotate_right(a, 22);
+        uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t second = s0 + majority;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + first;
+        d = c;
+        c = b;
+        b = a;
+        a = first + second;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+/**
+ * Computes the SHA-256 digest of `length` bytes. Full blocks are
+ * compressed in place; only the padded tail is copied.
+ */
+static void wasm_sha256(const uint8_t *data, size_t length, uint8_t *digest)
+{
+    uint32_t state[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    size_t full_length = length - length % 64;
+
+    for (size_t offset = 0; offset < full_length; offset += 64) {
+        wasm_sha256_compress(state, data + offset);
+    }
+
+    uint8_t tail[128] = {0};
+    size_t tail_length = length - full_length;
+    size_t padded_length = tail_length < 56 ? 64 : 128;
+    uint64_t bit_length = (uint64_t) length * 8;
+
+    if (tail_length > 0) {
+        memcpy(tail, data + full_length, tail_length);
+    }
+
+    tail[tail_length] = 0x80;
+
+    for (int nth = 0; nth < 8; ++nth) {
+        tail[padded_length - 1 - nth] = (uint8_t) (bit_length >> (8 * nth));
+    }
+
+    wasm_sha256_compress(state, tail);
+
+    if (padded_length == 128) {
+        wasm_sha256_compress(state, tail + 64);
+    }
+
+    for (int nth = 0; nth < 8; ++nth) {
+        digest[4 * nth] = (uint8_t) (state[nth] >> 24);
+        digest[4 * nth + 1] = (uint8_t) (state[nth] >> 16);
+        digest[4 * nth + 2] = (uint8_t) (state[nth] >> 8);
+        digest[4 * nth + 3] = (uint8_t) state[nth];
+    }
+}
+
+/**
+ * Encodes `length` bytes in lowercase hexadecimal, directly into a
+ * new string of the final size. Each byte is translated by a single
+ * lookup of its two digits.
+ */
+static zend_string *wasm_hexadecimal_encode(const uint8_t *data, size_t length)
+{
+    static const char digits[] =
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+        "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+        "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+        "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+        "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+        "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+        "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+        "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+    zend_string *encoded = zend_string_alloc(2 * length, 0);
+    char *cursor = ZSTR_VAL(encoded);
+
+    for (size_t nth = 0; nth < length; ++nth) {
+        memcpy(cursor, digits + 2 * data[nth], 2);
+        cursor += 2;
+    }
+
+    *cursor = '\0';
+
+    return encoded;
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmArrayBuffer::hash` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmarraybuffer_hash, ZEND_RETURN_VALUE, ARITY(1), IS_STRING, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, algorithm, IS_STRING, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, offset, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, length, IS_LONG, NOT_NULLABLE)
 ZEND_END_ARG_INFO()
 
 /**
- * Declare the `wasm_invoke_function` function.
+ * Declare the `WasmArrayBuffer::hash` method.
+ *
+ * Hashes a region of the buffer in place, and returns the digest in
+ * lowercase hexadecimal, like `hash()` does. The algorithm is one of
+ * `crc32c`, `xxh3` (64 bits) or `sha256`. The optional length bounds
+ * the region; 0 means up to the end of the buffer.
  *
  * # Usage
  *
  * ```php
- * $bytes = wasm_fetch_bytes('my_program.wasm');
- * $instance = wasm_new_instance($bytes);
- *
- * // sum(1, 2)
- * $result = wasm_invoke_function(
- *     $instance,
- *     'sum',
- *     [
- *         // with a Wasm value directly
- *         wasm_value(WASM_TYPE_I32, 1),
- *
- *         // with a PHP value, the Wasm type will be infered
- *         2,
- *     ]
- * );
+ * $buffer = $instance->getMemoryBuffer();
+ * $digest = $buffer->hash('xxh3', $output_pointer, $output_length);
  * ```
  */
-PHP_FUNCTION(wasm_invoke_function)
+PHP_METHOD(WasmArrayBuffer, hash)
 {
-    zval *wasm_instance_resource;
-    char *function_name;
-    size_t function_name_length;
-    HashTable *inputs;
+    zend_string *algorithm;
+    zend_long offset = 0;
+    zend_long length = 0;
 
-    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 3, 3)
-        Z_PARAM_RESOURCE(wasm_instance_resource)
-        Z_PARAM_STRING(function_name, function_name_length)
-        Z_PARAM_ARRAY_HT(inputs)
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 3)
+        Z_PARAM_STR(algorithm)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(offset)
+        Z_PARAM_LONG(length)
     ZEND_PARSE_PARAMETERS_END();
 
-    // Extract the Wasm instance from the resource.
-    wasmer_instance_t *wasm_instance = wasm_instance_from_resource(Z_RES_P(wasm_instance_resource));
-
-    if (NULL == wasm_instance) {
-        RETURN_NULL();
-    }
+    wasm_array_buffer_object *wasm_array_buffer_object = WASM_ARRAY_BUFFER_OBJECT_THIS();
 
-    // Be sure the invoked function exists.
-    // Read all the export definitions (of all kinds).
-    wasmer_exports_t *wasm_exports = NULL;
-    wasmer_instance_exports(wasm_instance, &wasm_exports);
+    if (offset < 0 || offset > wasm_array_buffer_object->buffer_length) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            0,
+            "Offset is outside the buffer range [0; %zu]; given %lld.",
+            wasm_array_buffer_object->buffer_length,
+            offset
+        );
 
-    int number_of_exports = wasmer_exports_len(wasm_exports);
+        return;
+    }
 
-    // There is no export definition.
-    if (number_of_exports == 0) {
-        wasmer_exports_destroy(wasm_exports);
+    size_t maximum_length = wasm_array_buffer_object->buffer_length - offset;
 
+    if (length < 0 || length > maximum_length) {
         zend_throw_exception_ex(
             zend_ce_exception,
-            0,
-            "The instance has no exports, cannot call the function `%.*s`.",
-            (int) function_name_length,
-            function_name
+            1,
+            "Length must be in the range [0; %zu]; given %lld.",
+            maximum_length,
+            length
         );
 
         return;
     }
 
-    // Look for a function of the given name in the export definitions.
-    const wasmer_export_func_t *wasm_function = NULL;
-
-    for (uint32_t nth = 0; nth < number_of_exports; ++nth) {
-        wasmer_export_t *wasm_export = wasmer_exports_get(wasm_exports, nth);
-        wasmer_import_export_kind wasm_export_kind = wasmer_export_kind(wasm_export);
+    if (length == 0) {
+        length = maximum_length;
+    }
 
-        // Not a function definition, let's continue.
-        if (wasm_export_kind != wasmer_import_export_kind::WASM_FUNCTION) {
-            continue;
-        }
+    const uint8_t *data = (const uint8_t *) wasm_array_buffer_object->buffer + offset;
+    uint8_t digest[32];
+    size_t digest_length;
 
-        // Read the export name.
-        wasmer_byte_array wasm_export_name = wasmer_export_name(wasm_export);
+    if (zend_string_equals_literal(algorithm, "crc32c")) {
+        uint32_t crc = wasm_crc32c(data, (size_t) length);
 
-        if (wasm_export_name.bytes_len != function_name_length) {
-            continue;
+        for (int nth = 0; nth < 4; ++nth) {
+            digest[nth] = (uint8_t) (crc >> (24 - 8 * nth));
         }
 
-        // Gotcha?
-        if (strncmp(function_name, (const char *) wasm_export_name.bytes, wasm_export_name.bytes_len) == 0) {
-            wasm_function = wasmer_export_to_func(wasm_export);
+        digest_length = 4;
+    } else if (zend_string_equals_literal(algorithm, "xxh3")) {
+        uint64_t hash = wasm_xxh3_64(data, (size_t) length);
 
-            break;
+        for (int nth = 0; nth < 8; ++nth) {
+            digest[nth] = (uint8_t) (hash >> (56 - 8 * nth));
         }
-    }
 
-    // No function with the given name has been found.
-    if (wasm_function == NULL) {
-        wasmer_exports_destroy(wasm_exports);
+        digest_length = 8;
+    } else if (zend_string_equals_literal(algorithm, "sha256")) {
+        wasm_sha256(data, (size_t) length, digest);
 
+        digest_length = 32;
+    } else {
         zend_throw_exception_ex(
             zend_ce_exception,
-            0,
-            "The instance has no exported function named `%.*s`.",
-            (int) function_name_length,
-            function_name
+            2,
+            "Unknown hash algorithm `%s`; expect one of crc32c, xxh3, or sha256.",
+            ZSTR_VAL(algorithm)
         );
 
         return;
     }
 
-    // Read the number of inputs.
-    uint32_t wasm_function_inputs_arity;
+    RETURN_NEW_STR(wasm_hexadecimal_encode(digest, digest_length));
+}
 
-    if (wasmer_export_func_params_arity(wasm_function, &wasm_function_inputs_arity) != wasmer_result_t::WASMER_OK) {
-        wasmer_exports_destroy(wasm_exports);
-        
-        zend_throw_exception_ex(
-            zend_ce_exception,
-            0,
-            "Failed to read the input arity of the `%.*s` exported function.",
-            (int) function_name_length,
-            function_name
-        );
-        
-        return;
-    }
+/**
+ * Declare the parameter information for the
+ * `WasmArrayBuffer::copyTo` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmarraybuffer_copy_to, ZEND_RETURN_VALUE, ARITY(4), IS_VOID, NOT_NULLABLE)
+    ZEND_ARG_OBJ_INFO(0, destination, WasmArrayBuffer, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, source_offset, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, destination_offset, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, length, IS_LONG, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
 
-    // Read the input types.
-    wasmer_value_tag *wasm_function_input_signatures = (wasmer_value_tag *) malloc(sizeof(wasmer_value_tag) * wasm_function_inputs_arity);
+/**
+ * Declare the `WasmArrayBuffer::copyTo` method.
+ *
+ * Copies `length` bytes from this buffer at `source_offset` to the
+ * `destination` buffer at `destination_offset`, with a single
+ * `memmove`. Both buffers can be the memories of two instances, and
+ * they can be the same buffer: overlapping regions are copied as if
+ * through an intermediate buffer.
+ *
+ * # Usage
+ *
+ * ```php
+ * $source = wasm_get_memory_buffer($producer);
+ * $destination = wasm_get_memory_buffer($consumer);
+ * $source->copyTo($destination, $output_pointer, $input_pointer, $length);
+ * ```
+ */
+PHP_METHOD(WasmArrayBuffer, copyTo)
+{
+    zval *destination;
+    zend_long source_offset;
+    zend_long destination_offset;
+    zend_long length;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 4, 4)
+        Z_PARAM_OBJECT_OF_CLASS(destination, wasm_array_buffer_class_entry)
+        Z_PARAM_LONG(source_offset)
+        Z_PARAM_LONG(destination_offset)
+        Z_PARAM_LONG(length)
+    ZEND_PARSE_PARAMETERS_END();
 
-    if (wasmer_export_func_params(wasm_function, wasm_function_input_signatures, wasm_function_inputs_arity) != wasmer_result_t::WASMER_OK) {
-        free(wasm_function_input_signatures);
-        wasmer_exports_destroy(wasm_exports);
+    wasm_array_buffer_object *source_object = WASM_ARRAY_BUFFER_OBJECT_THIS();
+    wasm_array_buffer_object *destination_object = wasm_array_buffer_object_from_zend_object(Z_OBJ_P(destination));
+
+    if (length < 0) {
+        zend_throw_exception_ex(zend_ce_exception, 2, "Length must be non-negative; given %lld.", length);
 
+        return;
+    }
+
+    if (source_offset < 0 ||
+        (size_t) source_offset > source_object->buffer_length ||
+        (size_t) length > source_object->buffer_length - (size_t) source_offset) {
         zend_throw_exception_ex(
             zend_ce_exception,
             0,
-            "Failed to read the signature of the `%.*s` exported function.",
-            (int) function_name_length,
-            function_name
+            "Source range must be within the buffer range [0; %zu]; given [%lld; %lld[.",
+            source_object->buffer_length,
+            source_offset,
+            source_offset + length
         );
-        
+
         return;
     }
 
-    // Read the number of outputs.
-    uint32_t wasm_function_outputs_arity;
-
-    if (wasmer_export_func_returns_arity(wasm_function, &wasm_function_outputs_arity) != wasmer_result_t::WASMER_OK) {
-        free(wasm_function_input_signatures);
-        wasmer_exports_destroy(wasm_exports);
-
+    if (destination_offset < 0 ||
+        (size_t) destination_offset > destination_object->buffer_length ||
+        (size_t) length > destination_object->buffer_length - (size_t) destination_offset) {
         zend_throw_exception_ex(
             zend_ce_exception,
-            0,
-            "Failed to read the output arity of the `%.*s` exported function.",
-            (int) function_name_length,
-            function_name
+            1,
+            "Destination range must be within the buffer range [0; %zu]; given [%lld; %lld[.",
+            destination_object->buffer_length,
+            destination_offset,
+            destination_offset + length
         );
 
         return;
     }
 
-    wasmer_exports_destroy(wasm_exports);
-
-    {
-        // Check the given signature matches the expected signature.
-        int32_t number_of_expected_arguments = (int32_t) wasm_function_inputs_arity;
-        int32_t number_of_given_arguments = (int32_t) zend_hash_num_elements(inputs);
-        int32_t diff = number_of_expected_arguments - number_of_given_arguments;
+    if (length == 0) {
+        return;
+    }
 
-        if (diff > 0) {
-            free(wasm_function_input_signatures);
+    // Detach the destination first: if both buffers share the same
+    // string, the source keeps reading the original bytes.
+    wasm_array_buffer_detach(destination_object);
 
-            zend_throw_exception_ex(
-                zend_ce_exception,
-                0,
-                "Missing %d argument(s) when calling the `%.*s` exported function; Expect %d argument(s), given %d.",
-                diff,
-                (int) function_name_length,
-                function_name,
-                number_of_expected_arguments,
-                number_of_given_arguments
-            );
+    memmove(
+        destination_object->buffer + destination_offset,
+        source_object->buffer + source_offset,
+        (size_t) length
+    );
+}
 
-            return;
-        } else if (diff < 0) {
-            free(wasm_function_input_signatures);
+/**
+ * Stream operation: writes `count` bytes at the current position.
+ * Writes stop at the end of the region.
+ */
+static wasm_stream_size_t wasm_array_buffer_stream_write(php_stream *stream, const char *buffer, size_t count)
+{
+    wasm_array_buffer_stream *wasm_stream = (wasm_array_buffer_stream *) stream->abstract;
+    wasm_array_buffer_object *wasm_array_buffer_object = wasm_array_buffer_object_from_zend_object(wasm_stream->wasm_array_buffer);
+    size_t number_of_written_bytes = std::min(count, wasm_stream->length - wasm_stream->position);
 
-            zend_throw_exception_ex(
-                zend_ce_exception,
-                0,
-                "Given %d extra argument(s) when calling the `%.*s` exported function; Expect %d argument(s), given %d.",
-                -diff,
-                (int) function_name_length,
-                function_name,
-                number_of_expected_arguments,
-                number_of_given_arguments
-            );
+    if (number_of_written_bytes > 0) {
+        wasm_array_buffer_detach(wasm_array_buffer_object);
 
-            return;
-        }
+        memcpy(wasm_array_buffer_object->buffer + wasm_stream->offset + wasm_stream->position, buffer, number_of_written_bytes);
+        wasm_stream->position += number_of_written_bytes;
     }
 
-    // Convert the inputs as Wasm values, or extract the inputs values
-    // from the `wasm_value` resources.
-    size_t function_input_length = wasm_function_inputs_arity;
-    wasmer_value_t *function_inputs = (wasmer_value_t *) emalloc(sizeof(wasmer_value_t) * function_input_length);
-
-    {
-        zend_ulong nth = 0;
-        zval *value;
+    return number_of_written_bytes;
+}
 
-        ZEND_HASH_FOREACH_VAL(inputs, value)
-            zend_uchar php_type = Z_TYPE_P(value);
-            wasmer_value_tag wasm_type = wasm_function_input_signatures[nth];
+/**
+ * Stream operation: reads up to `count` bytes from the current
+ * position.
+ */
+static wasm_stream_size_t wasm_array_buffer_stream_read(php_stream *stream, char *buffer, size_t count)
+{
+    wasm_array_buffer_stream *wasm_stream = (wasm_array_buffer_stream *) stream->abstract;
+    wasm_array_buffer_object *wasm_array_buffer_object = wasm_array_buffer_object_from_zend_object(wasm_stream->wasm_array_buffer);
+    size_t number_of_read_bytes = std::min(count, wasm_stream->length - wasm_stream->position);
 
-            // The value is a resource. We expect it to be a `wasm_value` resource.
-            if (php_type == IS_RESOURCE) {
-                function_inputs[nth] = *wasm_value_from_resource(Z_RES_P(value));
-            }
-            // Convert PHP integer to Wasm i32.
-            else if (wasm_type == wasmer_value_tag::WASM_I32) {
-                if (php_type != IS_LONG) {
-                    free(wasm_function_input_signatures);
+    memcpy(buffer, wasm_array_buffer_object->buffer + wasm_stream->offset + wasm_stream->position, number_of_read_bytes);
+    wasm_stream->position += number_of_read_bytes;
 
-                    zend_throw_exception_ex(
-                        zend_ce_exception,
-                        0,
-                        "Argument #%d of `%.*s` must be an `i32` (integer).",
-                        (int) nth + 1,
-                        (int) function_name_length,
-                        function_name
-                    );
+    if (wasm_stream->position == wasm_stream->length) {
+        stream->eof = 1;
+    }
 
-                    return;
-                }
+    return number_of_read_bytes;
+}
 
-                function_inputs[nth].tag = wasmer_value_tag::WASM_I32;
-                function_inputs[nth].value.I32 = (int32_t) value->value.lval;
-            }
-            // Convert PHP integer to Wasm i64.
-            else if (wasm_type == wasmer_value_tag::WASM_I64) {
-                if (php_type != IS_LONG) {
-                    free(wasm_function_input_signatures);
+/**
+ * Stream operation: releases the buffer.
+ */
+static int wasm_array_buffer_stream_close(php_stream *stream, int close_handle)
+{
+    wasm_array_buffer_stream *wasm_stream = (wasm_array_buffer_stream *) stream->abstract;
 
-                    zend_throw_exception_ex(
-                        zend_ce_exception,
-                        0,
-                        "Argument #%d of `%.*s` must be an `i64` (integer).",
-                        (int) nth + 1,
-                        (int) function_name_length,
-                        function_name
-                    );
+    OBJ_RELEASE(wasm_stream->wasm_array_buffer);
+    efree(wasm_stream);
 
-                    return;
-                }
+    return 0;
+}
 
-                function_inputs[nth].tag = wasmer_value_tag::WASM_I64;
-                function_inputs[nth].value.I64 = (int64_t) value->value.lval;
-            }
-            // Convert PHP integer to Wasm f32.
-            else if (wasm_type == wasmer_value_tag::WASM_F32) {
-                if (php_type != IS_DOUBLE) {
-                    free(wasm_function_input_signatures);
+/**
+ * Stream operation: nothing to flush, writes go straight to the
+ * buffer.
+ */
+static int wasm_array_buffer_stream_flush(php_stream *stream)
+{
+    return 0;
+}
 
-                    zend_throw_exception_ex(
-                        zend_ce_exception,
-                        0,
-                        "Argument #%d of `%.*s` must be an `f32` (float).",
-                        (int) nth + 1,
-                        (int) function_name_length,
-                        function_name
-                    );
+/**
+ * Stream operation: moves the position within the region.
+ */
+static int wasm_array_buffer_stream_seek(php_stream *stream, zend_off_t offset, int whence, zend_off_t *new_offset)
+{
+    wasm_array_buffer_stream *wasm_stream = (wasm_array_buffer_stream *) stream->abstract;
+    zend_off_t base;
 
-                    return;
-                }
+    switch (whence) {
+        case SEEK_SET:
+            base = 0;
 
-                function_inputs[nth].tag = wasmer_value_tag::WASM_F32;
-                function_inputs[nth].value.F32 = (float) value->value.dval;
-            }
-            // Convert PHP integer to Wasm f64.
-            else if (wasm_type == wasmer_value_tag::WASM_F64) {
-                if (php_type != IS_DOUBLE) {
-                    free(wasm_function_input_signatures);
+            break;
 
-                    zend_throw_exception_ex(
-                        zend_ce_exception,
-                        0,
-                        "Argument #%d of `%.*s` must be an `f64` (float).",
-                        (int) nth + 1,
-                        (int) function_name_length,
-                        function_name
-                    );
+        case SEEK_CUR:
+            base = (zend_off_t) wasm_stream->position;
 
-                    return;
-                }
+            break;
 
-                function_inputs[nth].tag = wasmer_value_tag::WASM_F64;
-                function_inputs[nth].value.F64 = (double) value->value.dval;
-            }
-            // Unreacheable.
-            else {
-                free(wasm_function_input_signatures);
+        case SEEK_END:
+            base = (zend_off_t) wasm_stream->length;
 
-                zend_throw_exception_ex(
-                    zend_ce_exception,
-                    0,
-                    "Invalid argument type at position #%d when calling the `%.*s` exported function: Only i32, i64, f32, and f64 are supported.",
-                    (int) nth + 1,
-                    (int) function_name_length,
-                    function_name
-                );
+            break;
 
-                return;
-            }
+        default:
+            return -1;
+    }
 
-            ++nth;
-        ZEND_HASH_FOREACH_END();
+    if ((offset < 0 && -offset > base) || (offset > 0 && (size_t) offset > wasm_stream->length - (size_t) base)) {
+        return -1;
     }
 
-    free(wasm_function_input_signatures);
+    wasm_stream->position = (size_t) (base + offset);
+    stream->eof = 0;
+    *new_offset = (zend_off_t) wasm_stream->position;
 
-    // PHP expects at most one output.
-    size_t function_output_length = wasm_function_outputs_arity;
-    wasmer_value_t *function_outputs = NULL;
+    return 0;
+}
 
-    if (function_output_length > 0) {
-        function_output_length = 1;
-        function_outputs = (wasmer_value_t *) emalloc(sizeof(wasmer_value_t) * function_output_length);
-    }
+/**
+ * Stream operation: the region looks like a regular file of its
+ * length, e.g. for `fstat`.
+ */
+static int wasm_array_buffer_stream_stat(php_stream *stream, php_stream_statbuf *stat_buffer)
+{
+    wasm_array_buffer_stream *wasm_stream = (wasm_array_buffer_stream *) stream->abstract;
 
-    // Call the Wasm function.
-    wasmer_result_t function_call_result = wasmer_instance_call(
-        // Instance.
-        wasm_instance,
-        // Function name.
-        function_name,
-        // Inputs.
-        function_inputs,
-        function_input_length,
-        // Outputs.
-        function_outputs,
-        function_output_length
-    );
+    memset(stat_buffer, 0, sizeof(php_stream_statbuf));
+    stat_buffer->sb.st_mode = S_IFREG | 0666;
+    stat_buffer->sb.st_size = (zend_off_t) wasm_stream->length;
 
-    efree(function_inputs);
+    return 0;
+}
 
-    // Failed to call the Wasm function.
-    if (function_call_result != wasmer_result_t::WASMER_OK) {
-        efree(function_outputs);
+/**
+ * Stream operations over a region of a `WasmArrayBuffer`.
+ */
+static const php_stream_ops wasm_array_buffer_stream_ops = {
+    wasm_array_buffer_stream_write,
+    wasm_array_buffer_stream_read,
+    wasm_array_buffer_stream_close,
+    wasm_array_buffer_stream_flush,
+    "wasm-memory",
+    wasm_array_buffer_stream_seek,
+    NULL, /* cast */
+    wasm_array_buffer_stream_stat,
+    NULL  /* set_option */
+};
+
+/**
+ * Declare the parameter information for the
+ * `WasmArrayBuffer::openStream` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmarraybuffer_open_stream, ZEND_RETURN_VALUE, ARITY(0), IS_RESOURCE, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, offset, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, length, IS_LONG, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmArrayBuffer::openStream` method.
+ *
+ * Opens a readable and writable stream over `length` bytes of the
+ * buffer at `offset`; a length of 0 means up to the end of the
+ * buffer. The stream reads and writes the buffer directly, so
+ * functions like `stream_copy_to_stream`, `fpassthru`,
+ * `hash_update_stream` or stream filters work on the memory of an
+ * instance without an intermediate string. The stream holds a
+ * reference to the buffer.
+ *
+ * # Usage
+ *
+ * ```php
+ * $memory = wasm_get_memory_buffer($instance);
+ * $stream = $memory->openStream($document_pointer, $document_length);
+ * fpassthru($stream);
+ * ```
+ */
+PHP_METHOD(WasmArrayBuffer, openStream)
+{
+    zend_long offset = 0;
+    zend_long length = 0;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 0, 2)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(offset)
+        Z_PARAM_LONG(length)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_array_buffer_object *wasm_array_buffer_object = WASM_ARRAY_BUFFER_OBJECT_THIS();
 
+    if (offset < 0 || offset > wasm_array_buffer_object->buffer_length) {
         zend_throw_exception_ex(
             zend_ce_exception,
             0,
-            "Failed to call the `%.*s` exported function.",
-            (int) function_name_length,
-            function_name
+            "Offset is outside the buffer range [0; %zu]; given %lld.",
+            wasm_array_buffer_object->buffer_length,
+            offset
         );
 
         return;
     }
 
-    if (function_output_length > 0) {
-        // Read the first output, because PHP expects at most one
-        // output, as said above.
-        wasmer_value_t function_output = function_outputs[0];
+    size_t maximum_length = wasm_array_buffer_object->buffer_length - offset;
 
-        // Convert the Wasm value to a PHP value.
-        if (function_output.tag == wasmer_value_tag::WASM_I32) {
-            efree(function_outputs);
+    if (length < 0 || length > maximum_length) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            1,
+            "Length must be in the range [0; %zu]; given %lld.",
+            maximum_length,
+            length
+        );
 
-            RETURN_LONG(function_output.value.I32);
-        } else if (function_output.tag == wasmer_value_tag::WASM_I64) {
-            efree(function_outputs);
+        return;
+    }
 
-            RETURN_LONG(function_output.value.I64);
-        } else if (function_output.tag == wasmer_value_tag::WASM_F32) {
-            efree(function_outputs);
+    if (length == 0) {
+        length = maximum_length;
+    }
 
-            RETURN_DOUBLE(function_output.value.F32);
-        } else if (function_output.tag == wasmer_value_tag::WASM_F64) {
-            efree(function_outputs);
+    wasm_array_buffer_stream *wasm_stream = (wasm_array_buffer_stream *) emalloc(sizeof(wasm_array_buffer_stream));
+    wasm_stream->wasm_array_buffer = &wasm_array_buffer_object->instance;
+    wasm_stream->offset = (size_t) offset;
+    wasm_stream->length = (size_t) length;
+    wasm_stream->position = 0;
 
-            RETURN_DOUBLE(function_output.value.F64);
-        } else {
-            efree(function_outputs);
+    GC_ADDREF(wasm_stream->wasm_array_buffer);
 
-            zend_throw_exception_ex(
-                zend_ce_exception,
-                0,
-                "The exported function `%.*s` has returned a value of unknown type.",
-                (int) function_name_length,
-                function_name
-            );
+    php_stream *stream = php_stream_alloc(&wasm_array_buffer_stream_ops, wasm_stream, NULL, "r+b");
 
-            return;
-        }
-    }
-    // No output, `void` is similar to `null` in PHP.
-    else {
-        efree(function_outputs);
+    if (stream == NULL) {
+        OBJ_RELEASE(wasm_stream->wasm_array_buffer);
+        efree(wasm_stream);
 
-        RETURN_NULL();
+        zend_throw_exception(zend_ce_exception, "Failed to open the stream.", 2);
+
+        return;
     }
+
+    // Read straight from the buffer: the stream read buffer would be
+    // an extra copy, and could miss writes made through the views.
+    stream->flags |= PHP_STREAM_FLAG_NO_BUFFER;
+
+    php_stream_to_zval(stream, return_value);
+}
+
+// Declare the methods of the `WasmArrayBuffer` class with their information.
+static const zend_function_entry wasm_array_buffer_methods[] = {
+    PHP_ME(WasmArrayBuffer, __construct,		arginfo_wasmarraybuffer___construct, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmArrayBuffer, getByteLength,		arginfo_wasmarraybuffer_get_byte_length, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmArrayBuffer, writeMessagePack,	arginfo_wasmarraybuffer_write_message_pack, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmArrayBuffer, readMessagePack,	arginfo_wasmarraybuffer_read_message_pack, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmArrayBuffer, hash,				arginfo_wasmarraybuffer_hash, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmArrayBuffer, fromString,			arginfo_wasmarraybuffer_from_string, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(WasmArrayBuffer, copyTo,				arginfo_wasmarraybuffer_copy_to, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmArrayBuffer, openStream,			arginfo_wasmarraybuffer_open_stream, ZEND_ACC_PUBLIC)
+    PHP_FE_END
+};
+
+/**
+ * Utils.
+ */
+wasmer_value_tag from_zend_long_to_wasmer_value_tag(zend_long x)
+{
+    if (x > 0) {
+        return (wasmer_value_tag) (uint32_t) x;
+    } else {
+        return wasmer_value_tag::WASM_I32;
+    }
+}
+
+// Represents a `wasmer_byte_array` that is filled lazily. The bytes
+// are read from `file_path`.
+typedef struct wasm_lazy_byte_array_t wasm_lazy_byte_array;
+struct wasm_lazy_byte_array_t {
+private:
+    char* file_path;
+    wasmer_byte_array *byte_array;
+
+public:
+    wasm_lazy_byte_array_t(char* file_path) :
+        file_path(file_path),
+        byte_array(NULL)
+    {}
+
+    ~wasm_lazy_byte_array_t()
+    {
+        efree((uint8_t *) byte_array->bytes);
+    }
+
+    wasmer_byte_array *get_bytes()
+    {
+        if (byte_array == NULL) {
+            // Open the file.
+            FILE *wasm_file = fopen(file_path, "r");
+
+            if (wasm_file == NULL) {
+                return NULL;
+            }
+
+            // Read the file content.
+            fseek(wasm_file, 0, SEEK_END);
+
+            size_t wasm_file_length = ftell(wasm_file);
+            const uint8_t *wasm_bytes = (const uint8_t *) emalloc(wasm_file_length);
+            fseek(wasm_file, 0, SEEK_SET);
+
+            fread((uint8_t *) wasm_bytes, 1, wasm_file_length, wasm_file);
+
+            // Close the file.
+            fclose(wasm_file);
+
+            // Store the bytes of the Wasm file into a `wasmer_byte_array` structure.
+            byte_array = (wasmer_byte_array *) emalloc(sizeof(wasmer_byte_array));
+            byte_array->bytes = wasm_bytes;
+            byte_array->bytes_len = (uint32_t) wasm_file_length;
+        }
+
+        return byte_array;
+    }
+};
+
+/**
+ * Extract the data structure inside the `wasm_bytes` resource.
+ */
+wasmer_byte_array *wasm_bytes_from_resource(zend_resource *wasm_bytes_resource)
+{
+    wasm_lazy_byte_array *lazy_byte_array = (wasm_lazy_byte_array *) zend_fetch_resource(
+        wasm_bytes_resource,
+        wasm_bytes_resource_name,
+        wasm_bytes_resource_number
+    );
+
+    return lazy_byte_array->get_bytes();
+}
+
+/**
+ * Destructor for the `wasm_bytes` resource.
+ */
+static void wasm_bytes_destructor(zend_resource *resource)
+{
+    wasm_lazy_byte_array *lazy_byte_array = (wasm_lazy_byte_array *) zend_fetch_resource(
+        resource,
+        wasm_bytes_resource_name,
+        wasm_bytes_resource_number
+    );
+    free(lazy_byte_array);
+}
+
+/**
+ * Declare the parameter information for the `wasm_fetch_bytes` function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_fetch_bytes, ZEND_RETURN_VALUE, ARITY(1), IS_RESOURCE, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, file_path, IS_STRING, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_fetch_bytes` function.
+ *
+ * # Usage
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * // `$bytes` is of type `resource of type (wasm_bytes)`.
+ * ```
+ *
+ * Important note: The bytes are fetched, not read, when the function
+ * is called. It means that the bytes are lazily read when other
+ * functions need it, like `wasm_validate`, `wasm_compile` and
+ * `wasm_new_instance`.
+ */
+PHP_FUNCTION(wasm_fetch_bytes)
+{
+    char *file_path;
+    size_t file_path_length;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
+        Z_PARAM_PATH(file_path, file_path_length)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_lazy_byte_array *wasm_lazy_byte_array = new ::wasm_lazy_byte_array(file_path);
+
+    // Store in and return the result as a resource.
+    zend_resource *resource = zend_register_resource((void *) wasm_lazy_byte_array, wasm_bytes_resource_number);
+
+    RETURN_RES(resource);
+}
+
+/**
+ * Declare the parameter information for the `wasm_validate`
+ * function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_validate, ZEND_RETURN_VALUE, ARITY(1), _IS_BOOL, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_bytes, IS_RESOURCE, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_validate` function.
+ *
+ * # Usage
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $valid = wasm_validate($bytes);
+ * ```
+ */
+PHP_FUNCTION(wasm_validate)
+{
+    zval *wasm_bytes_resource;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
+        Z_PARAM_RESOURCE(wasm_bytes_resource)
+    ZEND_PARSE_PARAMETERS_END();
+
+    // Extract the bytes from the resource.
+    wasmer_byte_array *wasm_byte_array = wasm_bytes_from_resource(Z_RES_P(wasm_bytes_resource));
+
+    if (NULL == wasm_byte_array) {
+        RETURN_FALSE;
+    }
+
+    // Check whether the bytes are valid or not.
+    bool is_valid = wasmer_validate(wasm_byte_array->bytes, wasm_byte_array->bytes_len);
+
+    RETURN_BOOL(is_valid);
+}
+
+/**
+ * Extract the data structure inside the `wasm_module` resource.
+ */
+wasmer_module_t *wasm_module_from_resource(zend_resource *wasm_module_resource)
+{
+    return (wasmer_module_t *) zend_fetch_resource(
+        wasm_module_resource,
+        wasm_module_resource_name,
+        wasm_module_resource_number
+    );
+}
+
+/**
+ * Destructor for the `wasm_module` resource.
+ */
+static void wasm_module_destructor(zend_resource *resource)
+{
+    wasmer_module_t *wasm_module = wasm_module_from_resource(resource);
+
+    if (wasm_module == NULL) {
+        return;
+    }
+
+    wasmer_module_destroy(wasm_module);
+}
+
+/**
+ * Find the persistent `wasm_module` resource registered with a module
+ * unique identifier, `NULL` if there is none. An entry of another
+ * type with the same key is ignored.
+ */
+static zend_resource *wasm_module_find_persistent_resource(zend_string *wasm_module_unique_identifier)
+{
+    zend_resource *resource = (zend_resource *) zend_hash_find_ptr(&EG(persistent_list), wasm_module_unique_identifier);
+
+    if (resource == NULL || resource->type != wasm_module_resource_number) {
+        return NULL;
+    }
+
+    return resource;
+}
+
+/**
+ * Register a module in a persistent resource, with a module unique
+ * identifier. The identifier is allocated for the request, so the
+ * persistent list gets its own persistent copy of the key. If the key
+ * is taken by an entry of another type, the module is registered in a
+ * regular resource instead.
+ */
+static zend_resource *wasm_module_register_persistent_resource(zend_string *wasm_module_unique_identifier, wasmer_module_t *wasm_module)
+{
+    if (zend_hash_exists(&EG(persistent_list), wasm_module_unique_identifier)) {
+        return zend_register_resource((void *) wasm_module, wasm_module_resource_number);
+    }
+
+    return zend_register_persistent_resource(
+        ZSTR_VAL(wasm_module_unique_identifier),
+        ZSTR_LEN(wasm_module_unique_identifier),
+        (void *) wasm_module,
+        wasm_module_resource_number
+    );
+}
+
+/**
+ * Declare the parameter information for the `wasm_compile`
+ * function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_compile, ZEND_RETURN_VALUE, ARITY(1), IS_RESOURCE, NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_bytes, IS_RESOURCE, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_module_unique_identifier, IS_STRING, NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_compile` function.
+ *
+ * # Usage
+ *
+ * Classical usage:
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $module = wasm_compile($bytes);
+ * // `$module` is of type `resource of type (wasm_module)`.
+ * ```
+ *
+ * If one wants to avoid to recompile the module each time, it is
+ * possible to compute a persistent resource by passing a module
+ * unique identifier string, e.g.:
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $module = wasm_compile($bytes, 'foo');
+ * // `$module` is of type `resource of type (wasm_module)`, and persistent.
+ * ```
+ *
+ * In the case above, further execution will **not** fetch the bytes
+ * nor compile the module. Indeed, bytes are not fetched because they
+ * are lazily fetch on-demand, and the module will not be re-compiled
+ * because the resource is persistent.
+ */
+PHP_FUNCTION(wasm_compile)
+{
+    zval *wasm_bytes_resource;
+    zend_string *wasm_module_unique_identifier = NULL;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 2)
+        Z_PARAM_RESOURCE(wasm_bytes_resource)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_STR_EX(wasm_module_unique_identifier, NULLABLE, 0);
+    ZEND_PARSE_PARAMETERS_END();
+
+    // The Wasm module resource will be persistent if there is a unique identifier.
+    bool persistent_wasm_module = wasm_module_unique_identifier != NULL;
+    zend_resource *resource = NULL;
+
+    // Wasm module persistent resource look up.
+    if (persistent_wasm_module) {
+        resource = wasm_module_find_persistent_resource(wasm_module_unique_identifier);
+    }
+
+    // Wasm module persistent resource is disabled, or it is not
+    // registered in the persistent resource registry.
+    if (resource == NULL) {
+        // Extract the bytes from the resource.
+        wasmer_byte_array *wasm_byte_array = wasm_bytes_from_resource(Z_RES_P(wasm_bytes_resource));
+
+        if (NULL == wasm_byte_array) {
+            RETURN_NULL();
+        }
+
+        // Create a new Wasm module.
+        wasmer_module_t *wasm_module = NULL;
+        wasmer_result_t wasm_compilation_result = wasmer_compile(
+            &wasm_module,
+            // Bytes.
+            (uint8_t *) wasm_byte_array->bytes,
+            // Bytes length.
+            wasm_byte_array->bytes_len
+        );
+
+        // Compilation failed.
+        if (wasm_compilation_result != wasmer_result_t::WASMER_OK) {
+            free(wasm_module);
+
+            RETURN_NULL();
+        }
+
+        // Store the module in a persistent resource.
+        if (persistent_wasm_module) {
+            resource = wasm_module_register_persistent_resource(wasm_module_unique_identifier, wasm_module);
+        }
+        // Store the module in a regular resource.
+        else {
+            resource = zend_register_resource((void *) wasm_module, wasm_module_resource_number);
+        }
+
+        if (resource == NULL) {
+            RETURN_NULL();
+        }
+    }
+    // The resource is already registered.
+    else {}
+
+    RETURN_RES(resource);
+}
+
+/**
+ * Clean up all persistent resources registered by this module.
+ */
+static int clean_up_persistent_resources(zval *hashmap_item)
+{
+    zend_resource *resource = Z_RES_P(hashmap_item);
+
+    if (resource->type == wasm_module_resource_number) {
+        wasm_module_destructor(resource);
+        return ZEND_HASH_APPLY_REMOVE;
+    }
+
+    return ZEND_HASH_APPLY_KEEP;
+}
+
+/**
+ * Iterate over the persistent resources list to clean up Wasm
+ * persistent resources.
+ */
+static void php_wasm_module_clean_up_persistent_resources()
+{
+    zend_hash_apply(&EG(persistent_list), (apply_func_t) clean_up_persistent_resources);
+}
+
+/**
+ * Declare the parameter information for the `wasm_module_clean_up_persistent_resources`
+ * function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_module_clean_up_persistent_resources, ZEND_RETURN_VALUE, ARITY(0), IS_VOID, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_module_clean_up_persistent_resources` function.
+ *
+ * # Usage
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $module = wasm_compile($bytes, 'foo');
+ * // The module is registered as a persistent resource.
+ *
+ * wasm_module_clean_up_persistent_resource();
+ *
+ * $module = wasm_compile($bytes, 'foo');
+ * // The module is registered as a persistent resource, again.
+ * ```
+ */
+PHP_FUNCTION(wasm_module_clean_up_persistent_resources)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    // Clean up persistent resources.
+    php_wasm_module_clean_up_persistent_resources();
+}
+
+/**
+ * Declare the parameter information for the `wasm_module_serialize`
+ * function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_module_serialize, ZEND_RETURN_VALUE, ARITY(1), IS_STRING, NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_module, IS_RESOURCE, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_module_serialize` function.
+ *
+ * # Usage
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $module = wasm_compile($bytes);
+ * $serialized_module = wasm_module_serialize($module);
+ * // `$serialized_module` is of type `string`.
+ * ```
+ */
+PHP_FUNCTION(wasm_module_serialize)
+{
+    zval *wasm_module_resource;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
+        Z_PARAM_RESOURCE(wasm_module_resource)
+    ZEND_PARSE_PARAMETERS_END();
+
+    // Extract the module from the resource.
+    wasmer_module_t *wasm_module = wasm_module_from_resource(Z_RES_P(wasm_module_resource));
+
+    if (wasm_module == NULL) {
+        RETURN_NULL();
+    }
+
+    // Let's serialize the module.
+    wasmer_serialized_module_t *wasm_serialized_module = NULL;
+
+    if (wasmer_module_serialize(&wasm_serialized_module, wasm_module) != wasmer_result_t::WASMER_OK) {
+        RETURN_NULL();
+    }
+
+    // Extract the bytes from the serialized module.
+    wasmer_byte_array wasm_serialized_module_bytes = wasmer_serialized_module_bytes(wasm_serialized_module);
+
+    ZVAL_STRINGL(
+        return_value,
+        (char *) (uint8_t *) wasm_serialized_module_bytes.bytes,
+        wasm_serialized_module_bytes.bytes_len
+    );
+
+    wasmer_serialized_module_destroy(wasm_serialized_module);
+}
+
+/**
+ * Declare the parameter information for the `wasm_module_deserialize`
+ * function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_module_deserialize, ZEND_RETURN_VALUE, ARITY(1), IS_RESOURCE, NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_serialized_module, IS_STRING, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_module_unique_identifier, IS_STRING, NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_module_deserialize` function.
+ *
+ * # Usage
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $module = wasm_compile($bytes);
+ * $serialized_module = wasm_module_serialize($module);
+ * $module = wasm_module_deserialize($serialized_module);
+ * ```
+ *
+ * Like for `wasm_compile`, passing a module unique identifier string
+ * registers the module as a persistent resource. Further calls with
+ * the same identifier return it directly: the serialized bytes are
+ * neither parsed nor deserialized again, so the cold-start cost is
+ * paid once per process, e.g.:
+ *
+ * ```php
+ * $module = wasm_module_deserialize($serialized_module, 'foo');
+ * // `$module` is of type `resource of type (wasm_module)`, and persistent.
+ * ```
+ */
+PHP_FUNCTION(wasm_module_deserialize)
+{
+    char *wasm_serialized_module_bytes;
+    size_t wasm_serialized_module_bytes_length;
+    zend_string *wasm_module_unique_identifier = NULL;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 2)
+        Z_PARAM_STRING(wasm_serialized_module_bytes, wasm_serialized_module_bytes_length)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_STR_EX(wasm_module_unique_identifier, NULLABLE, 0);
+    ZEND_PARSE_PARAMETERS_END();
+
+    zend_resource *resource = NULL;
+
+    // Wasm module persistent resource look up.
+    if (wasm_module_unique_identifier != NULL) {
+        resource = wasm_module_find_persistent_resource(wasm_module_unique_identifier);
+
+        if (resource != NULL) {
+            RETURN_RES(resource);
+        }
+    }
+
+    wasmer_serialized_module_t *wasm_serialized_module = NULL;
+
+    if (wasmer_serialized_module_from_bytes(&wasm_serialized_module, (const uint8_t *) wasm_serialized_module_bytes, wasm_serialized_module_bytes_length) != wasmer_result_t::WASMER_OK) {
+        RETURN_NULL();
+    }
+
+    wasmer_module_t *wasm_module = NULL;
+    wasmer_result_t wasm_deserialization_result = wasmer_module_deserialize(&wasm_module, wasm_serialized_module);
+
+    // The module owns its own copy of the code, the serialized module
+    // is not needed anymore.
+    wasmer_serialized_module_destroy(wasm_serialized_module);
+
+    if (wasm_deserialization_result != wasmer_result_t::WASMER_OK) {
+        RETURN_NULL();
+    }
+
+    // Store the module in a persistent resource.
+    if (wasm_module_unique_identifier != NULL) {
+        resource = wasm_module_register_persistent_resource(wasm_module_unique_identifier, wasm_module);
+    }
+    // Store the module in a regular resource.
+    else {
+        resource = zend_register_resource((void *) wasm_module, wasm_module_resource_number);
+    }
+
+    if (resource == NULL) {
+        RETURN_NULL();
+    }
+
+    RETURN_RES(resource);
+}
+
+// Declare the host functions. A guest imports them from the `env`
+// namespace, and imports that a guest does not declare are ignored
+// at instantiation.
+static const wasm_host_function wasm_host_functions[] = {
+    {
+        "php_write",
+        (void (*)(void *)) wasm_host_php_write,
+        {wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32}, 2,
+        {wasmer_value_tag::WASM_I32}, 1
+    },
+    {
+        "php_read",
+        (void (*)(void *)) wasm_host_php_read,
+        {wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32}, 2,
+        {wasmer_value_tag::WASM_I32}, 1
+    },
+    {
+        "php_clock_ns",
+        (void (*)(void *)) wasm_host_php_clock_ns,
+        {}, 0,
+        {wasmer_value_tag::WASM_I64}, 1
+    },
+    {
+        "php_random_fill",
+        (void (*)(void *)) wasm_host_php_random_fill,
+        {wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32}, 2,
+        {wasmer_value_tag::WASM_I32}, 1
+    },
+    {
+        "php_sha256",
+        (void (*)(void *)) wasm_host_php_sha256,
+        {wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32}, 3,
+        {wasmer_value_tag::WASM_I32}, 1
+    },
+    {
+        "php_xxh3",
+        (void (*)(void *)) wasm_host_php_xxh3,
+        {wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32}, 2,
+        {wasmer_value_tag::WASM_I64}, 1
+    },
+    {
+        "php_kv_get",
+        (void (*)(void *)) wasm_host_php_kv_get,
+        {wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32}, 4,
+        {wasmer_value_tag::WASM_I32}, 1
+    },
+    {
+        "php_kv_set",
+        (void (*)(void *)) wasm_host_php_kv_set,
+        {wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32}, 4,
+        {wasmer_value_tag::WASM_I32}, 1
+    },
+    {
+        "php_kv_delete",
+        (void (*)(void *)) wasm_host_php_kv_delete,
+        {wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32}, 2,
+        {wasmer_value_tag::WASM_I32}, 1
+    },
+    {
+        "php_queue_register",
+        (void (*)(void *)) wasm_host_php_queue_register,
+        {wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32}, 2,
+        {wasmer_value_tag::WASM_I32}, 1
+    },
+    {
+        "php_queue_flush",
+        (void (*)(void *)) wasm_host_php_queue_flush,
+        {}, 0,
+        {wasmer_value_tag::WASM_I32}, 1
+    },
+    {
+        "php_async_register",
+        (void (*)(void *)) wasm_host_php_async_register,
+        {wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32}, 2,
+        {wasmer_value_tag::WASM_I32}, 1
+    },
+    {
+        "php_await",
+        (void (*)(void *)) wasm_host_php_await,
+        {wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32, wasmer_value_tag::WASM_I32}, 4,
+        {wasmer_value_tag::WASM_I32}, 1
+    },
+};
+
+#define WASM_HOST_FUNCTIONS_LENGTH (sizeof(wasm_host_functions) / sizeof(wasm_host_functions[0]))
+
+// The imports of the host functions, shared by all the instances.
+static wasmer_import_t wasm_host_imports[WASM_HOST_FUNCTIONS_LENGTH];
+
+/**
+ * Create the imports of all the host functions.
+ */
+static void wasm_host_imports_initialize()
+{
+    static const char module_name[] = "env";
+
+    for (size_t nth = 0; nth < WASM_HOST_FUNCTIONS_LENGTH; ++nth) {
+        const wasm_host_function *host_function = &wasm_host_functions[nth];
+        wasmer_import_t *import = &wasm_host_imports[nth];
+
+        import->module_name.bytes = (const uint8_t *) module_name;
+        import->module_name.bytes_len = (uint32_t) (sizeof(module_name) - 1);
+        import->import_name.bytes = (const uint8_t *) host_function->name;
+        import->import_name.bytes_len = (uint32_t) strlen(host_function->name);
+        import->tag = wasmer_import_export_kind::WASM_FUNCTION;
+        import->value.func = wasmer_import_func_new(
+            host_function->function,
+            host_function->parameters,
+            host_function->parameters_length,
+            host_function->results,
+            host_function->results_length
+        );
+    }
+}
+
+/**
+ * Destroy the imports of all the host functions.
+ */
+static void wasm_host_imports_destroy()
+{
+    for (size_t nth = 0; nth < WASM_HOST_FUNCTIONS_LENGTH; ++nth) {
+        wasmer_import_t *import = &wasm_host_imports[nth];
+
+        if (import->value.func != NULL) {
+            wasmer_import_func_destroy((wasmer_import_func_t *) import->value.func);
+            import->value.func = NULL;
+        }
+    }
+}
+
+/**
+ * Get the region `[pointer, pointer + length)` of the memory of the
+ * instance owning the given context, `NULL` if it is out of bounds.
+ */
+static inline uint8_t *wasm_host_memory_region(wasmer_instance_context_t *context, uint32_t pointer, uint32_t length)
+{
+    wasmer_memory_t *wasm_memory = (wasmer_memory_t *) wasmer_instance_context_memory(context, 0);
+
+    if (UNEXPECTED(wasm_memory == NULL)) {
+        return NULL;
+    }
+
+    if (UNEXPECTED((uint64_t) pointer + length > (uint64_t) wasmer_memory_data_length(wasm_memory))) {
+        return NULL;
+    }
+
+    return wasmer_memory_data(wasm_memory) + pointer;
+}
+
+/**
+ * Get the stream held by the given zval, `NULL` if there is none or
+ * if it has been closed.
+ */
+static inline php_stream *wasm_host_stream(zval *stream_resource)
+{
+    if (Z_TYPE_P(stream_resource) != IS_RESOURCE) {
+        return NULL;
+    }
+
+    return (php_stream *) zend_fetch_resource2(
+        Z_RES_P(stream_resource),
+        NULL,
+        php_file_le_stream(),
+        php_file_le_pstream()
+    );
+}
+
+/**
+ * The `env.php_write(pointer: i32, length: i32) -> i32` host function.
+ *
+ * Writes `length` bytes of the guest memory at `pointer` to the output
+ * stream of the instance, or to the PHP output layer if there is none.
+ * Every `wasm.output_chunk_size` bytes, the output is flushed, so that
+ * it reaches the client while the guest keeps producing it. The PHP
+ * output layer is flushed only when no output buffer is active.
+ *
+ * It returns the number of written bytes, or -1 if the region is out
+ * of bounds or if the stream is not usable.
+ */
+static int32_t wasm_host_php_write(wasmer_instance_context_t *context, int32_t pointer, int32_t length)
+{
+    wasm_instance_state *instance_state = (wasm_instance_state *) wasmer_instance_context_data_get(context);
+
+    if (UNEXPECTED(instance_state == NULL || length < 0)) {
+        return -1;
+    }
+
+    uint8_t *bytes = wasm_host_memory_region(context, (uint32_t) pointer, (uint32_t) length);
+
+    if (UNEXPECTED(bytes == NULL)) {
+        return -1;
+    }
+
+    if (length == 0) {
+        return 0;
+    }
+
+    zend_long chunk_size = WASM_G(output_chunk_size);
+    php_stream *stream = NULL;
+
+    // Write to the output stream.
+    if (Z_TYPE(instance_state->output_stream) == IS_RESOURCE) {
+        stream = wasm_host_stream(&instance_state->output_stream);
+
+        // The stream has been closed meanwhile.
+        if (stream == NULL) {
+            return -1;
+        }
+
+        wasm_stream_size_t written = php_stream_write(stream, (const char *) bytes, (size_t) length);
+
+        if ((ssize_t) written < 0 || (size_t) written != (size_t) length) {
+            return -1;
+        }
+    }
+    // Write to the PHP output layer.
+    else {
+        php_output_write((const char *) bytes, (size_t) length);
+    }
+
+    instance_state->unflushed_output_length += (size_t) length;
+
+    // Flush the chunk.
+    if (chunk_size > 0 && instance_state->unflushed_output_length >= (size_t) chunk_size) {
+        instance_state->unflushed_output_length = 0;
+
+        if (stream != NULL) {
+            php_stream_flush(stream);
+        } else if (php_output_get_level() == 0) {
+            sapi_flush();
+        }
+    }
+
+    return length;
+}
+
+/**
+ * The `env.php_read(pointer: i32, capacity: i32) -> i32` host function.
+ *
+ * Reads at most `capacity` bytes from the input stream of the instance
+ * into the guest memory at `pointer`. The guest pulls its input chunk
+ * by chunk, so the input never has to be held entirely in a PHP string
+ * nor in the guest memory.
+ *
+ * It returns the number of read bytes, 0 at the end of the stream, or
+ * -1 if the region is out of bounds, if the instance has no input, or
+ * if the stream is not readable.
+ */
+static int32_t wasm_host_php_read(wasmer_instance_context_t *context, int32_t pointer, int32_t capacity)
+{
+    wasm_instance_state *instance_state = (wasm_instance_state *) wasmer_instance_context_data_get(context);
+
+    if (UNEXPECTED(instance_state == NULL || capacity < 0)) {
+        return -1;
+    }
+
+    uint8_t *bytes = wasm_host_memory_region(context, (uint32_t) pointer, (uint32_t) capacity);
+
+    if (UNEXPECTED(bytes == NULL)) {
+        return -1;
+    }
+
+    php_stream *stream = wasm_host_stream(&instance_state->input_stream);
+
+    if (stream == NULL) {
+        return -1;
+    }
+
+    if (capacity == 0) {
+        return 0;
+    }
+
+    wasm_stream_size_t read = php_stream_read(stream, (char *) bytes, (size_t) capacity);
+
+    // Before PHP 7.4, the count is unsigned and a failure reads 0
+    // bytes; the cast keeps the check meaningful for both types.
+    if ((ssize_t) read < 0) {
+        return -1;
+    }
+
+    return (int32_t) read;
+}
+
+/**
+ * The `env.php_clock_ns() -> i64` host function.
+ *
+ * Returns the time of a monotonic clock, in nanoseconds. Only the
+ * difference between two times is meaningful.
+ */
+static int64_t wasm_host_php_clock_ns(wasmer_instance_context_t *context)
+{
+    return (int64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+/**
+ * The `env.php_random_fill(pointer: i32, length: i32) -> i32` host
+ * function.
+ *
+ * Fills `length` bytes of the guest memory at `pointer` with bytes of
+ * the CSPRNG of PHP, the one of `random_bytes()`.
+ *
+ * It returns 0, or -1 if the region is out of bounds or if there is
+ * not enough entropy.
+ */
+static int32_t wasm_host_php_random_fill(wasmer_instance_context_t *context, int32_t pointer, int32_t length)
+{
+    if (UNEXPECTED(length < 0)) {
+        return -1;
+    }
+
+    uint8_t *bytes = wasm_host_memory_region(context, (uint32_t) pointer, (uint32_t) length);
+
+    if (UNEXPECTED(bytes == NULL)) {
+        return -1;
+    }
+
+    if (length > 0 && php_random_bytes_silent(bytes, (size_t) length) == FAILURE) {
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * The `env.php_sha256(pointer: i32, length: i32, digest_pointer: i32)
+ * -> i32` host function.
+ *
+ * Hashes `length` bytes of the guest memory at `pointer` with SHA-256,
+ * and writes the 32 bytes of the digest at `digest_pointer`.
+ *
+ * It returns 0, or -1 if a region is out of bounds.
+ */
+static int32_t wasm_host_php_sha256(wasmer_instance_context_t *context, int32_t pointer, int32_t length, int32_t digest_pointer)
+{
+    if (UNEXPECTED(length < 0)) {
+        return -1;
+    }
+
+    const uint8_t *data = wasm_host_memory_region(context, (uint32_t) pointer, (uint32_t) length);
+    uint8_t *digest = wasm_host_memory_region(context, (uint32_t) digest_pointer, 32);
+
+    if (UNEXPECTED(data == NULL || digest == NULL)) {
+        return -1;
+    }
+
+    // The digest and the data may overlap.
+    uint8_t computed_digest[32];
+    wasm_sha256(data, (size_t) length, computed_digest);
+    memcpy(digest, computed_digest, 32);
+
+    return 0;
+}
+
+/**
+ * The `env.php_xxh3(pointer: i32, length: i32) -> i64` host function.
+ *
+ * Hashes `length` bytes of the guest memory at `pointer` with the
+ * 64 bits variant of XXH3.
+ *
+ * It returns the hash, or 0 if the region is out of bounds.
+ */
+static int64_t wasm_host_php_xxh3(wasmer_instance_context_t *context, int32_t pointer, int32_t length)
+{
+    if (UNEXPECTED(length < 0)) {
+        return 0;
+    }
+
+    const uint8_t *data = wasm_host_memory_region(context, (uint32_t) pointer, (uint32_t) length);
+
+    if (UNEXPECTED(data == NULL)) {
+        return 0;
+    }
+
+    return (int64_t) wasm_xxh3_64(data, (size_t) length);
+}
+
+/**
+ * Destructor of the values of the key-value store.
+ */
+static void wasm_host_key_value_store_value_destructor(zval *value)
+{
+    zend_string_release((zend_string *) Z_PTR_P(value));
+}
+
+/**
+ * Get the key-value store of the `php_kv_*` host functions, and
+ * create it if needed.
+ */
+static HashTable *wasm_host_key_value_store()
+{
+    HashTable *store = WASM_G(host_key_value_store);
+
+    if (UNEXPECTED(store == NULL)) {
+        store = (HashTable *) pemalloc(sizeof(HashTable), 1);
+        zend_hash_init(store, 8, NULL, wasm_host_key_value_store_value_destructor, 1);
+
+        WASM_G(host_key_value_store) = store;
+    }
+
+    return store;
+}
+
+/**
+ * The `env.php_kv_get(key_pointer: i32, key_length: i32,
+ * value_pointer: i32, value_capacity: i32) -> i32` host function.
+ *
+ * Reads the value of the key of `key_length` bytes at `key_pointer`
+ * from the key-value store. At most `value_capacity` bytes of the
+ * value are written at `value_pointer`.
+ *
+ * The store lives as long as the process, and it is shared by all the
+ * instances, across requests. It is not shared between processes, nor
+ * between threads with ZTS.
+ *
+ * It returns the length of the value, which is larger than the
+ * capacity when the value is truncated, or -1 if the key does not
+ * exist or if a region is out of bounds.
+ */
+static int32_t wasm_host_php_kv_get(wasmer_instance_context_t *context, int32_t key_pointer, int32_t key_length, int32_t value_pointer, int32_t value_capacity)
+{
+    if (UNEXPECTED(key_length < 0 || value_capacity < 0)) {
+        return -1;
+    }
+
+    const uint8_t *key = wasm_host_memory_region(context, (uint32_t) key_pointer, (uint32_t) key_length);
+    uint8_t *value_bytes = wasm_host_memory_region(context, (uint32_t) value_pointer, (uint32_t) value_capacity);
+
+    if (UNEXPECTED(key == NULL || value_bytes == NULL)) {
+        return -1;
+    }
+
+    zend_string *value = (zend_string *) zend_hash_str_find_ptr(wasm_host_key_value_store(), (const char *) key, (size_t) key_length);
+
+    if (value == NULL) {
+        return -1;
+    }
+
+    memcpy(value_bytes, ZSTR_VAL(value), std::min(ZSTR_LEN(value), (size_t) value_capacity));
+
+    return (int32_t) ZSTR_LEN(value);
+}
+
+/**
+ * The `env.php_kv_set(key_pointer: i32, key_length: i32,
+ * value_pointer: i32, value_length: i32) -> i32` host function.
+ *
+ * Sets the value of `value_length` bytes at `value_pointer` to the key
+ * of `key_length` bytes at `key_pointer` in the key-value store, see
+ * `php_kv_get`.
+ *
+ * The store is persistent, so `memory_limit` does not account for it:
+ * the keys and the values together are bounded by
+ * `wasm.kv_store_max_size` bytes instead, a system INI entry so that
+ * a script cannot raise it for the whole process.
+ *
+ * It returns 0, or -1 if a region is out of bounds or if the store
+ * would exceed its maximum size.
+ */
+static int32_t wasm_host_php_kv_set(wasmer_instance_context_t *context, int32_t key_pointer, int32_t key_length, int32_t value_pointer, int32_t value_length)
+{
+    if (UNEXPECTED(key_length < 0 || value_length < 0)) {
+        return -1;
+    }
+
+    const uint8_t *key = wasm_host_memory_region(context, (uint32_t) key_pointer, (uint32_t) key_length);
+    const uint8_t *value_bytes = wasm_host_memory_region(context, (uint32_t) value_pointer, (uint32_t) value_length);
+
+    if (UNEXPECTED(key == NULL || value_bytes == NULL)) {
+        return -1;
+    }
+
+    HashTable *store = wasm_host_key_value_store();
+    size_t store_size = WASM_G(host_key_value_store_size);
+
+    // The value replaces the previous one, if any.
+    zend_string *previous_value = (zend_string *) zend_hash_str_find_ptr(store, (const char *) key, (size_t) key_length);
+
+    if (previous_value != NULL) {
+        store_size -= (size_t) key_length + ZSTR_LEN(previous_value);
+    }
+
+    size_t entry_size = (size_t) key_length + (size_t) value_length;
+    zend_long maximum_size = WASM_G(kv_store_max_size);
+
+    if (UNEXPECTED(maximum_size < 0 || store_size + entry_size > (size_t) maximum_size)) {
+        return -1;
+    }
+
+    zend_string *value = zend_string_init((const char *) value_bytes, (size_t) value_length, 1);
+    zend_hash_str_update_ptr(store, (const char *) key, (size_t) key_length, value);
+    WASM_G(host_key_value_store_size) = store_size + entry_size;
+
+    return 0;
+}
+
+/**
+ * The `env.php_kv_delete(key_pointer: i32, key_length: i32) -> i32`
+ * host function.
+ *
+ * Deletes the key of `key_length` bytes at `key_pointer` from the
+ * key-value store, see `php_kv_get`.
+ *
+ * It returns 1 if the key has been deleted, 0 if it does not exist, or
+ * -1 if the region is out of bounds.
+ */
+static int32_t wasm_host_php_kv_delete(wasmer_instance_context_t *context, int32_t key_pointer, int32_t key_length)
+{
+    if (UNEXPECTED(key_length < 0)) {
+        return -1;
+    }
+
+    const uint8_t *key = wasm_host_memory_region(context, (uint32_t) key_pointer, (uint32_t) key_length);
+
+    if (UNEXPECTED(key == NULL)) {
+        return -1;
+    }
+
+    HashTable *store = wasm_host_key_value_store();
+    zend_string *value = (zend_string *) zend_hash_str_find_ptr(store, (const char *) key, (size_t) key_length);
+
+    if (value == NULL) {
+        return 0;
+    }
+
+    WASM_G(host_key_value_store_size) -= (size_t) key_length + ZSTR_LEN(value);
+    zend_hash_str_del(store, (const char *) key, (size_t) key_length);
+
+    return 1;
+}
+
+/**
+ * Drain the call queue of the instance, i.e. dispatch its records to
+ * the handler in one batch, and empty it.
+ *
+ * The call queue lets a guest batch many small host calls, like
+ * metric increments or log lines: the guest appends records to a
+ * buffer in its memory, and the extension drains it after the call
+ * returns, or when the guest calls `php_queue_flush` because the
+ * buffer is full. The handler is then called once per batch, instead
+ * of once per record.
+ *
+ * The queue starts with the length of its records in bytes, then come
+ * the records. A record is made of a tag, the length of the payload,
+ * both as `u32`, then the payload padded to a multiple of 4 bytes.
+ * Integers are little-endian, like the Wasm memory. The handler
+ * receives a list of `[int $tag, string $payload]` records.
+ *
+ * It returns the number of drained records, or -1 if the queue is
+ * malformed; it is emptied anyway.
+ */
+static int32_t wasm_call_queue_drain(wasm_instance_state *instance_state, wasmer_memory_t *wasm_memory)
+{
+    uint32_t capacity = instance_state->call_queue_capacity;
+
+    if (capacity == 0 || wasm_memory == NULL) {
+        return 0;
+    }
+
+    uint64_t queue_end = (uint64_t) instance_state->call_queue_pointer + 4 + capacity;
+
+    if (UNEXPECTED(queue_end > (uint64_t) wasmer_memory_data_length(wasm_memory))) {
+        return -1;
+    }
+
+    uint8_t *queue = wasmer_memory_data(wasm_memory) + instance_state->call_queue_pointer;
+    uint32_t length;
+    memcpy(&length, queue, 4);
+
+    if (length == 0) {
+        return 0;
+    }
+
+    // Empty the queue before dispatching, since the handler may call
+    // the guest, which may append new records.
+    memset(queue, 0, 4);
+
+    if (UNEXPECTED(length > capacity)) {
+        return -1;
+    }
+
+    const uint8_t *records = queue + 4;
+    uint64_t offset = 0;
+    int32_t number_of_records = 0;
+    zval batch;
+    array_init(&batch);
+
+    while (offset < length) {
+        uint32_t tag;
+        uint32_t payload_length;
+
+        if (UNEXPECTED(length - offset < 8)) {
+            zval_ptr_dtor(&batch);
+
+            return -1;
+        }
+
+        memcpy(&tag, records + offset, 4);
+        memcpy(&payload_length, records + offset + 4, 4);
+
+        if (UNEXPECTED(payload_length > length - offset - 8)) {
+            zval_ptr_dtor(&batch);
+
+            return -1;
+        }
+
+        zval record;
+        array_init_size(&record, 2);
+        add_next_index_long(&record, (zend_long) tag);
+        add_next_index_stringl(&record, (const char *) records + offset + 8, (size_t) payload_length);
+        add_next_index_zval(&batch, &record);
+
+        offset += 8 + (((uint64_t) payload_length + 3) & ~((uint64_t) 3));
+        ++number_of_records;
+    }
+
+    // Dispatch the batch. The handler is copied, since it may replace
+    // itself.
+    if (Z_TYPE(instance_state->call_queue_handler) != IS_UNDEF) {
+        zval handler;
+        zval result;
+
+        ZVAL_COPY(&handler, &instance_state->call_queue_handler);
+        ZVAL_UNDEF(&result);
+
+        call_user_function(NULL, NULL, &handler, &result, 1, &batch);
+
+        zval_ptr_dtor(&result);
+        zval_ptr_dtor(&handler);
+    }
+
+    zval_ptr_dtor(&batch);
+
+    return number_of_records;
+}
+
+/**
+ * The `env.php_queue_register(pointer: i32, capacity: i32) -> i32`
+ * host function.
+ *
+ * Registers the call queue of the guest, see `wasm_call_queue_drain`.
+ * The queue header is at `pointer`, which must be aligned on 4 bytes,
+ * and its records take at most `capacity` bytes after the header. A
+ * capacity of 0 unregisters the queue.
+ *
+ * It returns 0, or -1 if the region is out of bounds or misaligned.
+ */
+static int32_t wasm_host_php_queue_register(wasmer_instance_context_t *context, int32_t pointer, int32_t capacity)
+{
+    wasm_instance_state *instance_state = (wasm_instance_state *) wasmer_instance_context_data_get(context);
+
+    if (UNEXPECTED(instance_state == NULL || capacity < 0 || ((uint32_t) pointer & 3) != 0)) {
+        return -1;
+    }
+
+    if (UNEXPECTED(wasm_host_memory_region(context, (uint32_t) pointer, 4 + (uint32_t) capacity) == NULL)) {
+        return -1;
+    }
+
+    // Keep the memory of the guest, so that the queue can be drained
+    // after the call, even if the memory is not exported.
+    instance_state->call_queue_memory = (wasmer_memory_t *) wasmer_instance_context_memory(context, 0);
+
+    instance_state->call_queue_pointer = (uint32_t) pointer;
+    instance_state->call_queue_capacity = (uint32_t) capacity;
+
+    return 0;
+}
+
+/**
+ * The `env.php_queue_flush() -> i32` host function.
+ *
+ * Drains the call queue of the guest, typically when it is full, see
+ * `wasm_call_queue_drain`.
+ *
+ * The handler runs above the frames of Wasmer, which a bailout (e.g. a
+ * fatal error) must not unwind. The bailout is caught, the guest gets
+ * -1, and it is resumed by `wasm_instance_invoke_function` once the
+ * guest has returned.
+ *
+ * It returns the number of drained records, or -1 if the queue is
+ * malformed or if the handler has bailed out.
+ */
+static int32_t wasm_host_php_queue_flush(wasmer_instance_context_t *context)
+{
+    wasm_instance_state *instance_state = (wasm_instance_state *) wasmer_instance_context_data_get(context);
+
+    if (UNEXPECTED(instance_state == NULL || instance_state->call_queue_bailout)) {
+        return -1;
+    }
+
+    int32_t number_of_records = -1;
+
+    zend_try {
+        number_of_records = wasm_call_queue_drain(
+            instance_state,
+            (wasmer_memory_t *) wasmer_instance_context_memory(context, 0)
+        );
+    } zend_catch {
+        instance_state->call_queue_bailout = true;
+        number_of_records = -1;
+    } zend_end_try();
+
+    return number_of_records;
+}
+
+/**
+ * Extract the data structure inside the `wasm_instance` resource.
+ */
+wasm_instance_state *wasm_instance_from_resource(zend_resource *wasm_instance_resource)
+{
+    return (wasm_instance_state *) zend_fetch_resource(
+        wasm_instance_resource,
+        wasm_instance_resource_name,
+        wasm_instance_resource_number
+    );
+}
+
+/**
+ * The `env.php_async_register(pointer: i32, length: i32) -> i32` host
+ * function.
+ *
+ * Registers the asyncify data of the guest, see `php_await`: `length`
+ * bytes at `pointer`, aligned on 4 bytes, where the guest saves its
+ * stack when it is suspended. A length of 0 unregisters it.
+ *
+ * It returns 0, or -1 if the region is out of bounds, misaligned, or
+ * too small.
+ */
+static int32_t wasm_host_php_async_register(wasmer_instance_context_t *context, int32_t pointer, int32_t length)
+{
+    wasm_instance_state *instance_state = (wasm_instance_state *) wasmer_instance_context_data_get(context);
+
+    if (UNEXPECTED(instance_state == NULL || length < 0 || (length > 0 && length < 16) || ((uint32_t) pointer & 3) != 0)) {
+        return -1;
+    }
+
+    if (UNEXPECTED(wasm_host_memory_region(context, (uint32_t) pointer, (uint32_t) length) == NULL)) {
+        return -1;
+    }
+
+    instance_state->async_data_pointer = (uint32_t) pointer;
+    instance_state->async_data_length = (uint32_t) length;
+
+    return 0;
+}
+
+/**
+ * The `env.php_await(request_pointer: i32, request_length: i32,
+ * response_pointer: i32, response_capacity: i32) -> i32` host
+ * function.
+ *
+ * Suspends the guest until PHP provides the response to the request of
+ * `request_length` bytes at `request_pointer`, like the result of a
+ * database query or of an HTTP call. At most `response_capacity` bytes
+ * of the response are written at `response_pointer`.
+ *
+ * Wasmer cannot switch stacks, so the guest follows the asyncify
+ * protocol: it is transformed by `wasm-opt --asyncify`, it exports the
+ * `asyncify_{start,stop}_{unwind,rewind}` functions, and it registers
+ * its asyncify data with `php_async_register`. When called for the
+ * first time, this function starts unwinding the guest stack, which
+ * returns from the call to `wasm_async_invoke_function`. When the call
+ * is resumed by `wasm_async_resume`, the guest rewinds its stack up to
+ * this function again, which then returns the response.
+ *
+ * It returns the length of the response, which is larger than the
+ * capacity when the response is truncated, or -1 if the call is not
+ * asynchronous or if a region is out of bounds.
+ */
+static int32_t wasm_host_php_await(wasmer_instance_context_t *context, int32_t request_pointer, int32_t request_length, int32_t response_pointer, int32_t response_capacity)
+{
+    wasm_instance_state *instance_state = (wasm_instance_state *) wasmer_instance_context_data_get(context);
+
+    if (UNEXPECTED(instance_state == NULL || request_length < 0 || response_capacity < 0)) {
+        return -1;
+    }
+
+    const uint8_t *request = wasm_host_memory_region(context, (uint32_t) request_pointer, (uint32_t) request_length);
+    uint8_t *response = wasm_host_memory_region(context, (uint32_t) response_pointer, (uint32_t) response_capacity);
+
+    if (UNEXPECTED(request == NULL || response == NULL)) {
+        return -1;
+    }
+
+    // The guest has rewound its stack: return the response.
+    if (instance_state->async_status == WASM_ASYNC_REWINDING) {
+        if (!wasm_async_call_export(instance_state, "asyncify_stop_rewind", NULL)) {
+            return -1;
+        }
+
+        instance_state->async_status = WASM_ASYNC_RUNNING;
+
+        zend_string *async_response = instance_state->async_response;
+        instance_state->async_response = NULL;
+
+        if (async_response == NULL) {
+            return -1;
+        }
+
+        int32_t async_response_length = (int32_t) ZSTR_LEN(async_response);
+        memcpy(response, ZSTR_VAL(async_response), std::min(ZSTR_LEN(async_response), (size_t) response_capacity));
+        zend_string_release(async_response);
+
+        return async_response_length;
+    }
+
+    // Only an asynchronous call of a guest with asyncify data can be
+    // suspended.
+    if (instance_state->async_status != WASM_ASYNC_RUNNING || instance_state->async_data_length == 0) {
+        return -1;
+    }
+
+    // Initialize the asyncify data: the guest saves its stack between
+    // the two addresses.
+    uint8_t *async_data = wasm_host_memory_region(context, instance_state->async_data_pointer, instance_state->async_data_length);
+
+    if (UNEXPECTED(async_data == NULL)) {
+        return -1;
+    }
+
+    uint32_t async_data_bounds[2] = {
+        instance_state->async_data_pointer + 8,
+        instance_state->async_data_pointer + instance_state->async_data_length
+    };
+    memcpy(async_data, async_data_bounds, sizeof(async_data_bounds));
+
+    // Start unwinding the guest stack.
+    int32_t async_data_pointer = (int32_t) instance_state->async_data_pointer;
+
+    if (!wasm_async_call_export(instance_state, "asyncify_start_unwind", &async_data_pointer)) {
+        return -1;
+    }
+
+    if (instance_state->async_request != NULL) {
+        zend_string_release(instance_state->async_request);
+    }
+
+    instance_state->async_request = zend_string_init((const char *) request, (size_t) request_length, 0);
+    instance_state->async_status = WASM_ASYNC_UNWINDING;
+
+    // The value is ignored by the unwinding guest.
+    return 0;
+}
+
+/**
+ * Get the memory exported by the instance, or else the memory it
+ * imports from a linked instance, `NULL` if there is none. The
+ * exported memory is looked up once, then it is kept in the state.
+ */
+static wasmer_memory_t *wasm_instance_memory(wasm_instance_state *instance_state)
+{
+    if (instance_state->memory != NULL) {
+        return instance_state->memory;
+    }
+
+    // Read all the export definitions (of all kinds).
+    wasmer_exports_t *wasm_exports = NULL;
+    wasmer_instance_exports(instance_state->instance, &wasm_exports);
+
+    int number_of_exports = wasmer_exports_len(wasm_exports);
+
+    // Look for a memory in the export definitions.
+    wasmer_memory_t *wasm_memory = NULL;
+
+    for (uint32_t nth = 0; nth < number_of_exports; ++nth) {
+        wasmer_export_t *wasm_export = wasmer_exports_get(wasm_exports, nth);
+        wasmer_import_export_kind wasm_export_kind = wasmer_export_kind(wasm_export);
+
+        // Not a memory definition, let's continue.
+        if (wasm_export_kind != wasmer_import_export_kind::WASM_MEMORY) {
+            continue;
+        }
+
+        // Get the memory instance from the export.
+        if (wasmer_export_to_memory(wasm_export, &wasm_memory) == wasmer_result_t::WASMER_OK) {
+            break;
+        }
+    }
+
+    wasmer_exports_destroy(wasm_exports);
+
+    if (wasm_memory == NULL) {
+        return instance_state->linked_memory;
+    }
+
+    instance_state->memory = wasm_memory;
+
+    return wasm_memory;
+}
+
+/**
+ * Attach a new Wasmer instance to a new `wasm_instance` resource.
+ */
+static zend_resource *wasm_instance_register_resource(wasmer_instance_t *wasm_instance)
+{
+    wasm_instance_state *instance_state = (wasm_instance_state *) emalloc(sizeof(wasm_instance_state));
+    instance_state->instance = wasm_instance;
+    instance_state->memory = NULL;
+    ZVAL_UNDEF(&instance_state->output_stream);
+    instance_state->unflushed_output_length = 0;
+    ZVAL_UNDEF(&instance_state->input_stream);
+    instance_state->call_queue_pointer = 0;
+    instance_state->call_queue_capacity = 0;
+    instance_state->call_queue_memory = NULL;
+    ZVAL_UNDEF(&instance_state->call_queue_handler);
+    instance_state->call_queue_bailout = false;
+    instance_state->async_data_pointer = 0;
+    instance_state->async_data_length = 0;
+    instance_state->async_status = WASM_ASYNC_NONE;
+    instance_state->async_function_name = NULL;
+    ZVAL_UNDEF(&instance_state->async_inputs);
+    instance_state->async_request = NULL;
+    instance_state->async_response = NULL;
+    ZVAL_NULL(&instance_state->async_result);
+    ZVAL_UNDEF(&instance_state->linked_instances);
+    instance_state->linked_exports = NULL;
+    instance_state->linked_exports_length = 0;
+    instance_state->linked_functions_length = 0;
+    instance_state->linked_memory = NULL;
+    ZVAL_UNDEF(&instance_state->trace_stream);
+    instance_state->trace_shadow = NULL;
+    instance_state->trace_shadow_length = 0;
+
+    // Let the host functions reach the state.
+    wasmer_instance_context_data_set(wasm_instance, (void *) instance_state);
+
+    return zend_register_resource((void *) instance_state, wasm_instance_resource_number);
+}
+
+/**
+ * Destructor for the `wasm_instance` resource.
+ */
+static void wasm_instance_destructor(zend_resource *resource)
+{
+    wasm_instance_state *instance_state = wasm_instance_from_resource(resource);
+
+    if (instance_state == NULL) {
+        return;
+    }
+
+    zval_ptr_dtor(&instance_state->output_stream);
+    zval_ptr_dtor(&instance_state->input_stream);
+    zval_ptr_dtor(&instance_state->call_queue_handler);
+    wasm_async_reset(instance_state);
+    zval_ptr_dtor(&instance_state->async_result);
+    wasmer_instance_destroy(instance_state->instance);
+
+    // The linked instances can be released once this instance cannot
+    // call them anymore.
+    for (uint32_t nth = 0; nth < instance_state->linked_exports_length; ++nth) {
+        wasmer_exports_destroy(instance_state->linked_exports[nth]);
+    }
+
+    if (instance_state->linked_exports != NULL) {
+        efree(instance_state->linked_exports);
+    }
+
+    if (instance_state->linked_memory != NULL) {
+        wasmer_memory_destroy(instance_state->linked_memory);
+    }
+
+    zval_ptr_dtor(&instance_state->linked_instances);
+    zval_ptr_dtor(&instance_state->trace_stream);
+
+    if (instance_state->trace_shadow != NULL) {
+        efree(instance_state->trace_shadow);
+    }
+
+    efree(instance_state);
+}
+
+/**
+ * Declare the parameter information for the
+ * `wasm_module_new_instance` function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_module_new_instance, ZEND_RETURN_VALUE, ARITY(1), IS_RESOURCE, NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_module, IS_RESOURCE, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_module_new_instance` function.
+ *
+ * # Usage
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $module = wasm_compile($bytes);
+ * $instance = wasm_module_new_instance($module);
+ * // `$instance` is of type `resource of type (wasm_instance)`.
+ * ```
+ *
+ * It is similar to running:
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $instance = wasm_new_instance($bytes);
+ * ```
+ */
+PHP_FUNCTION(wasm_module_new_instance)
+{
+    zval *wasm_module_resource;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
+        Z_PARAM_RESOURCE(wasm_module_resource)
+    ZEND_PARSE_PARAMETERS_END();
+
+    // Extract the module from the resource.
+    wasmer_module_t *wasm_module = wasm_module_from_resource(Z_RES_P(wasm_module_resource));
+
+    if (wasm_module == NULL) {
+        RETURN_NULL();
+    }
+
+    // Create a new Wasm instance.
+    wasmer_instance_t *wasm_instance = NULL;
+    wasmer_result_t wasm_instantiation_result = wasmer_module_instantiate(
+        // Module.
+        wasm_module,
+        // Instance.
+        &wasm_instance,
+        // Imports.
+        wasm_host_imports,
+        // Imports length.
+        (int) WASM_HOST_FUNCTIONS_LENGTH
+    );
+
+    // Instantiation failed.
+    if (wasm_instantiation_result != wasmer_result_t::WASMER_OK) {
+        free(wasm_instance);
+
+        RETURN_NULL();
+    }
+
+    // Store in and return the result as a resource.
+    zend_resource *resource = wasm_instance_register_resource(wasm_instance);
+
+    RETURN_RES(resource);
+}
+
+/**
+ * Declare the parameter information for the `wasm_new_instance`
+ * function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_new_instance, ZEND_RETURN_VALUE, ARITY(1), IS_RESOURCE, NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_bytes, IS_RESOURCE, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_new_instance` function.
+ *
+ * # Usage
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $instance = wasm_new_instance($bytes);
+ * // `$instance` is of type `resource of type (wasm_instance)`.
+ * ```
+ *
+ * This function is a shortcut of `wasm_compile` +
+ * `wasm_module_new_instance`. It “hides” the module compilation step.
+ */
+PHP_FUNCTION(wasm_new_instance)
+{
+    zval *wasm_bytes_resource;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
+        Z_PARAM_RESOURCE(wasm_bytes_resource)
+    ZEND_PARSE_PARAMETERS_END();
+
+    // Extract the bytes from the resource.
+    wasmer_byte_array *wasm_byte_array = wasm_bytes_from_resource(Z_RES_P(wasm_bytes_resource));
+
+    if (NULL == wasm_byte_array) {
+        RETURN_NULL();
+    }
+
+    // Create a new Wasm instance.
+    wasmer_instance_t *wasm_instance = NULL;
+    wasmer_result_t wasm_instantiation_result = wasmer_instantiate(
+        &wasm_instance,
+        // Bytes.
+        (uint8_t *) wasm_byte_array->bytes,
+        // Bytes length.
+        wasm_byte_array->bytes_len,
+        // Imports.
+        wasm_host_imports,
+        // Imports length.
+        (int) WASM_HOST_FUNCTIONS_LENGTH
+    );
+
+    // Instantiation failed.
+    if (wasm_instantiation_result != wasmer_result_t::WASMER_OK) {
+        free(wasm_instance);
+
+        RETURN_NULL();
+    }
+
+    // Store in and return the result as a resource.
+    zend_resource *resource = wasm_instance_register_resource(wasm_instance);
+
+    RETURN_RES(resource);
+}
+
+/**
+ * Call the function of a linked instance imported in the given slot
+ * of the calling instance, see `wasm_module_new_linked_instance`. The
+ * call goes from one Wasmer instance to the other one directly: no
+ * PHP value is involved.
+ */
+static int32_t wasm_link_call(wasmer_instance_context_t *context, size_t slot, const int32_t *arguments, uint32_t arguments_length)
+{
+    wasm_instance_state *instance_state = (wasm_instance_state *) wasmer_instance_context_data_get(context);
+
+    // The instance is not registered yet, i.e. its start function is
+    // running, or a previous linked call has failed.
+    if (instance_state == NULL || EG(exception)) {
+        return 0;
+    }
+
+    const wasm_linked_function *linked_function = &instance_state->linked_functions[slot];
+    wasmer_value_t inputs[WASM_LINK_MAXIMUM_ARITY];
+
+    for (uint32_t nth = 0; nth < arguments_length; ++nth) {
+        inputs[nth].tag = wasmer_value_tag::WASM_I32;
+        inputs[nth].value.I32 = arguments[nth];
+    }
+
+    wasmer_value_t output;
+    output.tag = wasmer_value_tag::WASM_I32;
+    output.value.I32 = 0;
+
+    wasmer_result_t call_result = wasmer_export_func_call(
+        linked_function->function,
+        inputs,
+        (int) arguments_length,
+        &output,
+        (int) linked_function->results_length
+    );
+
+    if (call_result != wasmer_result_t::WASMER_OK) {
+        zend_throw_exception(zend_ce_exception, "Failed to call a function of a linked instance.", 0);
+
+        return 0;
+    }
+
+    return output.value.I32;
+}
+
+/**
+ * The native functions imported in place of the functions of the
+ * linked instances. Wasmer gives nothing but the instance context to
+ * a native function, so each slot has its own function, per arity,
+ * which knows the linked function to call.
+ */
+template<size_t slot>
+struct wasm_link_trampoline {
+    static int32_t call_0(wasmer_instance_context_t *context)
+    {
+        return wasm_link_call(context, slot, NULL, 0);
+    }
+
+    static int32_t call_1(wasmer_instance_context_t *context, int32_t a)
+    {
+        const int32_t arguments[] = {a};
+
+        return wasm_link_call(context, slot, arguments, 1);
+    }
+
+    static int32_t call_2(wasmer_instance_context_t *context, int32_t a, int32_t b)
+    {
+        const int32_t arguments[] = {a, b};
+
+        return wasm_link_call(context, slot, arguments, 2);
+    }
+
+    static int32_t call_3(wasmer_instance_context_t *context, int32_t a, int32_t b, int32_t c)
+    {
+        const int32_t arguments[] = {a, b, c};
+
+        return wasm_link_call(context, slot, arguments, 3);
+    }
+
+    static int32_t call_4(wasmer_instance_context_t *context, int32_t a, int32_t b, int32_t c, int32_t d)
+    {
+        const int32_t arguments[] = {a, b, c, d};
+
+        return wasm_link_call(context, slot, arguments, 4);
+    }
+};
+
+#define WASM_LINK_TRAMPOLINES(slot) \
+    { \
+        (void (*)(void *)) wasm_link_trampoline<slot>::call_0, \
+        (void (*)(void *)) wasm_link_trampoline<slot>::call_1, \
+        (void (*)(void *)) wasm_link_trampoline<slot>::call_2, \
+        (void (*)(void *)) wasm_link_trampoline<slot>::call_3, \
+        (void (*)(void *)) wasm_link_trampoline<slot>::call_4 \
+    }
+
+// The trampolines, indexed by slot, then by arity.
+static void (*const wasm_link_trampolines[WASM_LINK_MAXIMUM_FUNCTIONS][WASM_LINK_MAXIMUM_ARITY + 1])(void *) = {
+    WASM_LINK_TRAMPOLINES(0),
+    WASM_LINK_TRAMPOLINES(1),
+    WASM_LINK_TRAMPOLINES(2),
+    WASM_LINK_TRAMPOLINES(3),
+    WASM_LINK_TRAMPOLINES(4),
+    WASM_LINK_TRAMPOLINES(5),
+    WASM_LINK_TRAMPOLINES(6),
+    WASM_LINK_TRAMPOLINES(7),
+    WASM_LINK_TRAMPOLINES(8),
+    WASM_LINK_TRAMPOLINES(9),
+    WASM_LINK_TRAMPOLINES(10),
+    WASM_LINK_TRAMPOLINES(11),
+    WASM_LINK_TRAMPOLINES(12),
+    WASM_LINK_TRAMPOLINES(13),
+    WASM_LINK_TRAMPOLINES(14),
+    WASM_LINK_TRAMPOLINES(15),
+};
+
+#undef WASM_LINK_TRAMPOLINES
+
+/**
+ * Resolve the imports of a module from the linked instances: an
+ * import is resolved from the instance indexed by its namespace, with
+ * the export of the same name. Imports of other namespaces, like the
+ * host functions, are left untouched.
+ *
+ * A function is imported through a trampoline, which calls the export
+ * with `wasmer_export_func_call`; it must have at most 4 `i32`
+ * parameters, and at most one `i32` result. A memory is imported
+ * as is, so that both instances share it. Wasmer cannot export a
+ * table or a global, so they cannot be linked.
+ *
+ * It returns `false` and throws an exception if an import cannot be
+ * resolved.
+ */
+static bool wasm_link_resolve(wasm_link *link, const wasmer_module_t *wasm_module, HashTable *linked_instances)
+{
+    uint32_t number_of_linked_instances = zend_hash_num_elements(linked_instances);
+    bool resolved = true;
+
+    // Read the exports of the linked instances, indexed by namespace.
+    HashTable namespaces;
+    zend_hash_init(&namespaces, number_of_linked_instances, NULL, NULL, 0);
+
+    link->exports = (wasmer_exports_t **) ecalloc(number_of_linked_instances + 1, sizeof(wasmer_exports_t *));
+
+    zend_string *namespace_name;
+    zval *linked_instance;
+
+    ZEND_HASH_FOREACH_STR_KEY_VAL(linked_instances, namespace_name, linked_instance) {
+        if (
+            namespace_name == NULL ||
+            Z_TYPE_P(linked_instance) != IS_RESOURCE ||
+            Z_RES_P(linked_instance)->type != wasm_instance_resource_number
+        ) {
+            zend_throw_exception(
+                zend_ce_exception,
+                "The linked instances must be `wasm_instance` resources indexed by the namespace of the imports they resolve.",
+                0
+            );
+
+            resolved = false;
+
+            break;
+        }
+
+        wasm_instance_state *linked_instance_state = (wasm_instance_state *) Z_RES_P(linked_instance)->ptr;
+        wasmer_exports_t *wasm_exports = NULL;
+        wasmer_instance_exports(linked_instance_state->instance, &wasm_exports);
+
+        link->exports[link->exports_length++] = wasm_exports;
+        zend_hash_add_ptr(&namespaces, namespace_name, wasm_exports);
+    } ZEND_HASH_FOREACH_END();
+
+    // The host imports come first.
+    wasmer_import_descriptors(wasm_module, &link->import_descriptors);
+
+    int number_of_imports = wasmer_import_descriptors_len(link->import_descriptors);
+
+    link->imports = (wasmer_import_t *) emalloc(sizeof(wasmer_import_t) * (WASM_HOST_FUNCTIONS_LENGTH + number_of_imports));
+    memcpy(link->imports, wasm_host_imports, sizeof(wasm_host_imports));
+    link->imports_length = (uint32_t) WASM_HOST_FUNCTIONS_LENGTH;
+
+    for (int nth = 0; resolved && nth < number_of_imports; ++nth) {
+        wasmer_import_descriptor_t *import_descriptor = wasmer_import_descriptors_get(link->import_descriptors, nth);
+        wasmer_byte_array module_name = wasmer_import_descriptor_module_name(import_descriptor);
+        wasmer_byte_array import_name = wasmer_import_descriptor_name(import_descriptor);
+
+        wasmer_exports_t *wasm_exports = (wasmer_exports_t *) zend_hash_str_find_ptr(
+            &namespaces,
+            (const char *) module_name.bytes,
+            module_name.bytes_len
+        );
+
+        // Not a linked namespace.
+        if (wasm_exports == NULL) {
+            continue;
+        }
+
+        // Look for the export of the same name.
+        wasmer_export_t *wasm_export = NULL;
+        int number_of_exports = wasmer_exports_len(wasm_exports);
+
+        for (int export_nth = 0; export_nth < number_of_exports; ++export_nth) {
+            wasmer_export_t *candidate = wasmer_exports_get(wasm_exports, export_nth);
+            wasmer_byte_array export_name = wasmer_export_name(candidate);
+
+            if (
+                export_name.bytes_len == import_name.bytes_len &&
+                memcmp(export_name.bytes, import_name.bytes, import_name.bytes_len) == 0
+            ) {
+                wasm_export = candidate;
+
+                break;
+            }
+        }
+
+        wasmer_import_export_kind import_kind = wasmer_import_descriptor_kind(import_descriptor);
+
+        if (wasm_export == NULL || wasmer_export_kind(wasm_export) != import_kind) {
+            zend_throw_exception_ex(
+                zend_ce_exception,
+                0,
+                "The import `%.*s.%.*s` has no export of the same name and of the same kind in the linked instance.",
+                (int) module_name.bytes_len,
+                (const char *) module_name.bytes,
+                (int) import_name.bytes_len,
+                (const char *) import_name.bytes
+            );
+
+            resolved = false;
+
+            break;
+        }
+
+        wasmer_import_t *import = &link->imports[link->imports_length];
+        import->module_name = module_name;
+        import->import_name = import_name;
+        import->tag = import_kind;
+
+        if (import_kind == wasmer_import_export_kind::WASM_FUNCTION) {
+            const wasmer_export_func_t *function = wasmer_export_to_func(wasm_export);
+            wasmer_value_tag parameters[WASM_LINK_MAXIMUM_ARITY];
+            wasmer_value_tag results[1];
+            uint32_t parameters_length = 0;
+            uint32_t results_length = 0;
+
+            wasmer_export_func_params_arity(function, &parameters_length);
+            wasmer_export_func_returns_arity(function, &results_length);
+
+            bool supported = parameters_length <= WASM_LINK_MAXIMUM_ARITY && results_length <= 1;
+
+            if (supported) {
+                wasmer_export_func_params(function, parameters, (int) parameters_length);
+                wasmer_export_func_returns(function, results, (int) results_length);
+
+                for (uint32_t parameter_nth = 0; parameter_nth < parameters_length; ++parameter_nth) {
+                    supported = supported && parameters[parameter_nth] == wasmer_value_tag::WASM_I32;
+                }
+
+                supported = supported && (results_length == 0 || results[0] == wasmer_value_tag::WASM_I32);
+            }
+
+            if (!supported) {
+                zend_throw_exception_ex(
+                    zend_ce_exception,
+                    0,
+                    "The function `%.*s.%.*s` cannot be linked, only functions with at most %d `i32` parameters and at most one `i32` result can.",
+                    (int) module_name.bytes_len,
+                    (const char *) module_name.bytes,
+                    (int) import_name.bytes_len,
+                    (const char *) import_name.bytes,
+                    WASM_LINK_MAXIMUM_ARITY
+                );
+
+                resolved = false;
+
+                break;
+            }
+
+            if (link->functions_length == WASM_LINK_MAXIMUM_FUNCTIONS) {
+                zend_throw_exception_ex(
+                    zend_ce_exception,
+                    0,
+                    "An instance cannot import more than %d functions from linked instances.",
+                    WASM_LINK_MAXIMUM_FUNCTIONS
+                );
+
+                resolved = false;
+
+                break;
+            }
+
+            uint32_t slot = link->functions_length++;
+            link->functions[slot].function = function;
+            link->functions[slot].results_length = results_length;
+
+            import->value.func = wasmer_import_func_new(
+                wasm_link_trampolines[slot][parameters_length],
+                parameters,
+                (int) parameters_length,
+                results,
+                (int) results_length
+            );
+        } else if (import_kind == wasmer_import_export_kind::WASM_MEMORY) {
+            wasmer_memory_t *wasm_memory = NULL;
+
+            if (link->memory != NULL || wasmer_export_to_memory(wasm_export, &wasm_memory) != wasmer_result_t::WASMER_OK) {
+                zend_throw_exception_ex(
+                    zend_ce_exception,
+                    0,
+                    "The memory `%.*s.%.*s` cannot be linked.",
+                    (int) module_name.bytes_len,
+                    (const char *) module_name.bytes,
+                    (int) import_name.bytes_len,
+                    (const char *) import_name.bytes
+                );
+
+                resolved = false;
+
+                break;
+            }
+
+            link->memory = wasm_memory;
+            import->value.memory = wasm_memory;
+        } else {
+            zend_throw_exception_ex(
+                zend_ce_exception,
+                0,
+                "The import `%.*s.%.*s` cannot be linked, only functions and memories can.",
+                (int) module_name.bytes_len,
+                (const char *) module_name.bytes,
+                (int) import_name.bytes_len,
+                (const char *) import_name.bytes
+            );
+
+            resolved = false;
+
+            break;
+        }
+
+        ++link->imports_length;
+    }
+
+    zend_hash_destroy(&namespaces);
+
+    return resolved;
+}
+
+/**
+ * Release the imports of a link, once the instance is created: Wasmer
+ * has cloned them.
+ */
+static void wasm_link_release_imports(wasm_link *link)
+{
+    // The host imports are shared, they must not be destroyed.
+    for (uint32_t nth = (uint32_t) WASM_HOST_FUNCTIONS_LENGTH; nth < link->imports_length; ++nth) {
+        wasmer_import_t *import = &link->imports[nth];
+
+        if (import->tag == wasmer_import_export_kind::WASM_FUNCTION) {
+            wasmer_import_func_destroy((wasmer_import_func_t *) import->value.func);
+        }
+    }
+
+    if (link->imports != NULL) {
+        efree(link->imports);
+        link->imports = NULL;
+    }
+
+    link->imports_length = 0;
+
+    if (link->import_descriptors != NULL) {
+        wasmer_import_descriptors_destroy(link->import_descriptors);
+        link->import_descriptors = NULL;
+    }
+}
+
+/**
+ * Release the exports and the memory of a link, when the instance
+ * cannot be created. Otherwise, the instance owns them.
+ */
+static void wasm_link_release_exports(wasm_link *link)
+{
+    for (uint32_t nth = 0; nth < link->exports_length; ++nth) {
+        wasmer_exports_destroy(link->exports[nth]);
+    }
+
+    if (link->exports != NULL) {
+        efree(link->exports);
+        link->exports = NULL;
+    }
+
+    link->exports_length = 0;
+
+    if (link->memory != NULL) {
+        wasmer_memory_destroy(link->memory);
+        link->memory = NULL;
+    }
+}
+
+/**
+ * Declare the parameter information for the
+ * `wasm_module_new_linked_instance` function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_module_new_linked_instance, ZEND_RETURN_VALUE, ARITY(2), IS_RESOURCE, NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_module, IS_RESOURCE, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, linked_instances, IS_ARRAY, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_module_new_linked_instance` function.
+ *
+ * # Usage
+ *
+ * ```php
+ * $library = wasm_new_instance(wasm_fetch_bytes('library.wasm'));
+ * $module = wasm_compile(wasm_fetch_bytes('my_program.wasm'));
+ * $instance = wasm_module_new_linked_instance($module, ['library' => $library]);
+ * ```
+ *
+ * It is similar to `wasm_module_new_instance`, except that the imports
+ * of the `library` namespace are resolved from the exports of the
+ * `$library` instance: the calls from `$instance` to `$library` stay
+ * inside Wasmer, and both instances can share a memory.
+ */
+PHP_FUNCTION(wasm_module_new_linked_instance)
+{
+    zval *wasm_module_resource;
+    zval *linked_instances;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 2, 2)
+        Z_PARAM_RESOURCE(wasm_module_resource)
+        Z_PARAM_ARRAY(linked_instances)
+    ZEND_PARSE_PARAMETERS_END();
+
+    // Extract the module from the resource.
+    wasmer_module_t *wasm_module = wasm_module_from_resource(Z_RES_P(wasm_module_resource));
+
+    if (wasm_module == NULL) {
+        RETURN_NULL();
+    }
+
+    wasm_link link;
+    memset(&link, 0, sizeof(wasm_link));
+
+    if (!wasm_link_resolve(&link, wasm_module, Z_ARRVAL_P(linked_instances))) {
+        wasm_link_release_imports(&link);
+        wasm_link_release_exports(&link);
+
+        return;
+    }
+
+    // Create a new Wasm instance.
+    wasmer_instance_t *wasm_instance = NULL;
+    wasmer_result_t wasm_instantiation_result = wasmer_module_instantiate(
+        // Module.
+        wasm_module,
+        // Instance.
+        &wasm_instance,
+        // Imports.
+        link.imports,
+        // Imports length.
+        (int) link.imports_length
+    );
+
+    wasm_link_release_imports(&link);
+
+    // Instantiation failed.
+    if (wasm_instantiation_result != wasmer_result_t::WASMER_OK) {
+        free(wasm_instance);
+        wasm_link_release_exports(&link);
+
+        RETURN_NULL();
+    }
+
+    // Store in and return the result as a resource.
+    zend_resource *resource = wasm_instance_register_resource(wasm_instance);
+    wasm_instance_state *instance_state = (wasm_instance_state *) resource->ptr;
+
+    ZVAL_COPY(&instance_state->linked_instances, linked_instances);
+    instance_state->linked_exports = link.exports;
+    instance_state->linked_exports_length = link.exports_length;
+    memcpy(instance_state->linked_functions, link.functions, sizeof(link.functions));
+    instance_state->linked_functions_length = link.functions_length;
+
+    // The imported memory is not necessarily exported.
+    instance_state->linked_memory = link.memory;
+
+    RETURN_RES(resource);
+}
+
+/**
+ * Extract the data structure inside the `wasm_value` resource.
+ */
+wasmer_value_t *wasm_value_from_resource(zend_resource *wasm_value_resource)
+{
+    return (wasmer_value_t *) zend_fetch_resource(
+        wasm_value_resource,
+        wasm_value_resource_name,
+        wasm_value_resource_number
+    );
+}
+
+/**
+ * Destructor for the `wasm_value` resource.
+ */
+static void wasm_value_destructor(zend_resource *resource)
+{
+    wasmer_value_t *wasm_value = wasm_value_from_resource(resource);
+
+    if (wasm_value == NULL) {
+        return;
+    }
+
+    efree(wasm_value);
+}
+
+/**
+ * Declare the parameter information for the `wasm_value` function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_value, ZEND_RETURN_VALUE, ARITY(2), IS_RESOURCE, NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, type, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_INFO(0, value)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_value` function.
+ *
+ * # Usage
+ *
+ * ```php
+ * $value = wasm_value(WASM_TYPE_I32, 7);
+ * // `$value` is of type `resource of type (wasm_value)`.
+ * ```
+ */
+PHP_FUNCTION(wasm_value)
+{
+    zend_long value_type;
+    zval *value;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 2, 2)
+        Z_PARAM_LONG(value_type)
+        Z_PARAM_ZVAL(value)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (value_type < 0) {
+        RETURN_NULL();
+    }
+
+    // Convert the value to a `wasmer_value_tag`. It is expected to
+    // receive a `WASM_TYPE_*` constant.
+    wasmer_value_tag type = (wasmer_value_tag) (uint32_t) value_type;
+    wasmer_value_t *wasm_value = (wasmer_value_t *) emalloc(sizeof(wasmer_value_t));
+
+    // Convert the PHP value to a `wasm_value_t`.
+    if (type == wasmer_value_tag::WASM_I32) {
+        wasm_value->tag = type;
+        wasm_value->value.I32 = (int32_t) value->value.lval;
+    } else if (type == wasmer_value_tag::WASM_I64) {
+        wasm_value->tag = type;
+        wasm_value->value.I64 = (int64_t) value->value.lval;
+    } else if (type == wasmer_value_tag::WASM_F32) {
+        wasm_value->tag = type;
+        wasm_value->value.F32 = (float) value->value.dval;
+    } else if (type == wasmer_value_tag::WASM_F64) {
+        wasm_value->tag = type;
+        wasm_value->value.F64 = (double) value->value.dval;
+    }
+    // Invalid value type provided.
+    else {
+        efree(wasm_value);
+
+        RETURN_NULL();
+    }
+
+    // Store in and return the result as a resource.
+    zend_resource *resource = zend_register_resource((void *) wasm_value, wasm_value_resource_number);
+
+    RETURN_RES(resource);
+}
+
+/**
+ * Append an integer to a trace record.
+ */
+static inline void wasm_trace_append_u32(smart_str *record, uint32_t value)
+{
+    uint8_t bytes[4];
+    wasm_trace_encode_u32(value, bytes);
+    smart_str_appendl(record, (const char *) bytes, sizeof(bytes));
+}
+
+/**
+ * Append a Wasm value, its type and its bits, to a trace record.
+ */
+static inline void wasm_trace_append_value(smart_str *record, const wasmer_value_t *value)
+{
+    uint8_t bytes[8];
+    wasm_trace_encode_u64(wasm_trace_value_to_bits(value), bytes);
+    smart_str_appendc(record, (char) value->tag);
+    smart_str_appendl(record, (const char *) bytes, sizeof(bytes));
+}
+
+/**
+ * Start the trace record of a call: the function name, the inputs,
+ * and the regions of the memory the host has written since the
+ * previous recorded call.
+ *
+ * The regions are found by comparing the memory to the copy taken
+ * after the previous recorded call, by blocks of
+ * `WASM_TRACE_BLOCK_SIZE` bytes, and adjacent blocks are merged.
+ * Before the first recorded call, there is no copy: every block is a
+ * region, so that the first record holds the whole state of the
+ * memory, including the data segments and the bytes written by the
+ * start function. The pages grown since the copy are compared to
+ * zeros, since Wasm zero-initializes them.
+ */
+static void wasm_trace_record_call(wasm_instance_state *instance_state, smart_str *record, const char *function_name, size_t function_name_length, const wasmer_value_t *inputs, size_t inputs_length)
+{
+    static const uint8_t zeros[WASM_TRACE_BLOCK_SIZE] = {0};
+
+    wasm_trace_append_u32(record, (uint32_t) function_name_length);
+    smart_str_appendl(record, function_name, function_name_length);
+    smart_str_appendc(record, (char) inputs_length);
+
+    for (size_t nth = 0; nth < inputs_length; ++nth) {
+        wasm_trace_append_value(record, &inputs[nth]);
+    }
+
+    wasmer_memory_t *wasm_memory = wasm_instance_memory(instance_state);
+    const uint8_t *memory = NULL;
+    size_t memory_length = 0;
+
+    if (wasm_memory != NULL) {
+        memory = wasmer_memory_data(wasm_memory);
+        memory_length = wasmer_memory_data_length(wasm_memory);
+    }
+
+    const uint8_t *shadow = instance_state->trace_shadow;
+    size_t shadow_length = instance_state->trace_shadow_length;
+
+    // The number of regions is written once they are found.
+    size_t number_of_regions_offset = ZSTR_LEN(record->s);
+    uint32_t number_of_regions = 0;
+    wasm_trace_append_u32(record, 0);
+
+    size_t region_offset = 0;
+    bool in_region = false;
+
+    // One more block past the end closes the last region.
+    for (size_t offset = 0; offset < memory_length + WASM_TRACE_BLOCK_SIZE; offset += WASM_TRACE_BLOCK_SIZE) {
+        bool written = false;
+
+        if (offset < memory_length) {
+            size_t block_length = std::min((size_t) WASM_TRACE_BLOCK_SIZE, memory_length - offset);
+
+            if (shadow == NULL) {
+                written = true;
+            } else if (offset + block_length <= shadow_length) {
+                written = memcmp(memory + offset, shadow + offset, block_length) != 0;
+            } else if (offset >= shadow_length) {
+                written = memcmp(memory + offset, zeros, block_length) != 0;
+            } else {
+                written = true;
+            }
+        }
+
+        if (written && !in_region) {
+            region_offset = offset;
+            in_region = true;
+        } else if (!written && in_region) {
+            size_t region_length = std::min(offset, memory_length) - region_offset;
+
+            wasm_trace_append_u32(record, (uint32_t) region_offset);
+            wasm_trace_append_u32(record, (uint32_t) region_length);
+            smart_str_appendl(record, (const char *) memory + region_offset, region_length);
+
+            in_region = false;
+            ++number_of_regions;
+        }
+    }
+
+    wasm_trace_encode_u32(number_of_regions, (uint8_t *) ZSTR_VAL(record->s) + number_of_regions_offset);
+}
+
+/**
+ * Finish the trace record of a call with its status and its result,
+ * write it to the trace stream, and copy the memory to find the
+ * regions the host writes before the next call.
+ */
+static void wasm_trace_record_result(wasm_instance_state *instance_state, smart_str *record, wasmer_result_t call_result, const wasmer_value_t *outputs, size_t outputs_length)
+{
+    if (call_result != wasmer_result_t::WASMER_OK) {
+        smart_str_appendc(record, (char) WASM_TRACE_FAILED);
+    } else if (outputs_length == 0) {
+        smart_str_appendc(record, (char) WASM_TRACE_VOID);
+    } else {
+        smart_str_appendc(record, (char) WASM_TRACE_RESULT);
+        wasm_trace_append_value(record, &outputs[0]);
+    }
+
+    php_stream *stream = wasm_host_stream(&instance_state->trace_stream);
+
+    if (stream != NULL) {
+        php_stream_write(stream, ZSTR_VAL(record->s), ZSTR_LEN(record->s));
+    }
+
+    smart_str_free(record);
+
+    wasmer_memory_t *wasm_memory = wasm_instance_memory(instance_state);
+
+    if (wasm_memory == NULL) {
+        return;
+    }
+
+    size_t memory_length = wasmer_memory_data_length(wasm_memory);
+
+    // The memory only grows.
+    if (memory_length > instance_state->trace_shadow_length) {
+        instance_state->trace_shadow = (uint8_t *) erealloc(instance_state->trace_shadow, memory_length);
+        instance_state->trace_shadow_length = memory_length;
+    }
+
+    memcpy(instance_state->trace_shadow, wasmer_memory_data(wasm_memory), memory_length);
+}
+
+/**
+ * Invoke the exported function `function_name` of the instance with
+ * the given inputs, and write its result in `return_value`. It throws
+ * exceptions when errors happen.
+ */
+static void wasm_instance_invoke_function(wasm_instance_state *instance_state, const char *function_name, size_t function_name_length, HashTable *inputs, zval *return_value)
+{
+    wasmer_instance_t *wasm_instance = instance_state->instance;
+
+    // Be sure the invoked function exists.
+    // Read all the export definitions (of all kinds).
+    wasmer_exports_t *wasm_exports = NULL;
+    wasmer_instance_exports(wasm_instance, &wasm_exports);
+
+    int number_of_exports = wasmer_exports_len(wasm_exports);
+
+    // There is no export definition.
+    if (number_of_exports == 0) {
+        wasmer_exports_destroy(wasm_exports);
+
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            0,
+            "The instance has no exports, cannot call the function `%.*s`.",
+            (int) function_name_length,
+            function_name
+        );
+
+        return;
+    }
+
+    // Look for a function of the given name in the export definitions.
+    const wasmer_export_func_t *wasm_function = wasm_exports_find_function(wasm_exports, function_name, function_name_length);
+
+    // No function with the given name has been found.
+    if (wasm_function == NULL) {
+        wasmer_exports_destroy(wasm_exports);
+
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            0,
+            "The instance has no exported function named `%.*s`.",
+            (int) function_name_length,
+            function_name
+        );
+
+        return;
+    }
+
+    // Read the number of inputs.
+    uint32_t wasm_function_inputs_arity;
+
+    if (wasmer_export_func_params_arity(wasm_function, &wasm_function_inputs_arity) != wasmer_result_t::WASMER_OK) {
+        wasmer_exports_destroy(wasm_exports);
+        
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            0,
+            "Failed to read the input arity of the `%.*s` exported function.",
+            (int) function_name_length,
+            function_name
+        );
+        
+        return;
+    }
+
+    // Read the input types.
+    wasmer_value_tag *wasm_function_input_signatures = (wasmer_value_tag *) malloc(sizeof(wasmer_value_tag) * wasm_function_inputs_arity);
+
+    if (wasmer_export_func_params(wasm_function, wasm_function_input_signatures, wasm_function_inputs_arity) != wasmer_result_t::WASMER_OK) {
+        free(wasm_function_input_signatures);
+        wasmer_exports_destroy(wasm_exports);
+
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            0,
+            "Failed to read the signature of the `%.*s` exported function.",
+            (int) function_name_length,
+            function_name
+        );
+        
+        return;
+    }
+
+    // Read the number of outputs.
+    uint32_t wasm_function_outputs_arity;
+
+    if (wasmer_export_func_returns_arity(wasm_function, &wasm_function_outputs_arity) != wasmer_result_t::WASMER_OK) {
+        free(wasm_function_input_signatures);
+        wasmer_exports_destroy(wasm_exports);
+
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            0,
+            "Failed to read the output arity of the `%.*s` exported function.",
+            (int) function_name_length,
+            function_name
+        );
+
+        return;
+    }
+
+    wasmer_exports_destroy(wasm_exports);
+
+    {
+        // Check the given signature matches the expected signature.
+        int32_t number_of_expected_arguments = (int32_t) wasm_function_inputs_arity;
+        int32_t number_of_given_arguments = (int32_t) zend_hash_num_elements(inputs);
+        int32_t diff = number_of_expected_arguments - number_of_given_arguments;
+
+        if (diff > 0) {
+            free(wasm_function_input_signatures);
+
+            zend_throw_exception_ex(
+                zend_ce_exception,
+                0,
+                "Missing %d argument(s) when calling the `%.*s` exported function; Expect %d argument(s), given %d.",
+                diff,
+                (int) function_name_length,
+                function_name,
+                number_of_expected_arguments,
+                number_of_given_arguments
+            );
+
+            return;
+        } else if (diff < 0) {
+            free(wasm_function_input_signatures);
+
+            zend_throw_exception_ex(
+                zend_ce_exception,
+                0,
+                "Given %d extra argument(s) when calling the `%.*s` exported function; Expect %d argument(s), given %d.",
+                -diff,
+                (int) function_name_length,
+                function_name,
+                number_of_expected_arguments,
+                number_of_given_arguments
+            );
+
+            return;
+        }
+    }
+
+    // Convert the inputs as Wasm values, or extract the inputs values
+    // from the `wasm_value` resources.
+    size_t function_input_length = wasm_function_inputs_arity;
+    wasmer_value_t *function_inputs = (wasmer_value_t *) emalloc(sizeof(wasmer_value_t) * function_input_length);
+
+    {
+        zend_ulong nth = 0;
+        zval *value;
+
+        ZEND_HASH_FOREACH_VAL(inputs, value)
+            zend_uchar php_type = Z_TYPE_P(value);
+            wasmer_value_tag wasm_type = wasm_function_input_signatures[nth];
+
+            // The value is a resource. We expect it to be a `wasm_value` resource.
+            if (php_type == IS_RESOURCE) {
+                function_inputs[nth] = *wasm_value_from_resource(Z_RES_P(value));
+            }
+            // Convert PHP integer to Wasm i32.
+            else if (wasm_type == wasmer_value_tag::WASM_I32) {
+                if (php_type != IS_LONG) {
+                    free(wasm_function_input_signatures);
+
+                    zend_throw_exception_ex(
+                        zend_ce_exception,
+                        0,
+                        "Argument #%d of `%.*s` must be an `i32` (integer).",
+                        (int) nth + 1,
+                        (int) function_name_length,
+                        function_name
+                    );
+
+                    return;
+                }
+
+                wasm_value_from_integer(wasm_type, value->value.lval, &function_inputs[nth]);
+            }
+            // Convert PHP integer to Wasm i64.
+            else if (wasm_type == wasmer_value_tag::WASM_I64) {
+                if (php_type != IS_LONG) {
+                    free(wasm_function_input_signatures);
+
+                    zend_throw_exception_ex(
+                        zend_ce_exception,
+                        0,
+                        "Argument #%d of `%.*s` must be an `i64` (integer).",
+                        (int) nth + 1,
+                        (int) function_name_length,
+                        function_name
+                    );
+
+                    return;
+                }
+
+                wasm_value_from_integer(wasm_type, value->value.lval, &function_inputs[nth]);
+            }
+            // Convert PHP integer to Wasm f32.
+            else if (wasm_type == wasmer_value_tag::WASM_F32) {
+                if (php_type != IS_DOUBLE) {
+                    free(wasm_function_input_signatures);
+
+                    zend_throw_exception_ex(
+                        zend_ce_exception,
+                        0,
+                        "Argument #%d of `%.*s` must be an `f32` (float).",
+                        (int) nth + 1,
+                        (int) function_name_length,
+                        function_name
+                    );
+
+                    return;
+                }
+
+                wasm_value_from_float(wasm_type, value->value.dval, &function_inputs[nth]);
+            }
+            // Convert PHP integer to Wasm f64.
+            else if (wasm_type == wasmer_value_tag::WASM_F64) {
+                if (php_type != IS_DOUBLE) {
+                    free(wasm_function_input_signatures);
+
+                    zend_throw_exception_ex(
+                        zend_ce_exception,
+                        0,
+                        "Argument #%d of `%.*s` must be an `f64` (float).",
+                        (int) nth + 1,
+                        (int) function_name_length,
+                        function_name
+                    );
+
+                    return;
+                }
+
+                wasm_value_from_float(wasm_type, value->value.dval, &function_inputs[nth]);
+            }
+            // Unreacheable.
+            else {
+                free(wasm_function_input_signatures);
+
+                zend_throw_exception_ex(
+                    zend_ce_exception,
+                    0,
+                    "Invalid argument type at position #%d when calling the `%.*s` exported function: Only i32, i64, f32, and f64 are supported.",
+                    (int) nth + 1,
+                    (int) function_name_length,
+                    function_name
+                );
+
+                return;
+            }
+
+            ++nth;
+        ZEND_HASH_FOREACH_END();
+    }
+
+    free(wasm_function_input_signatures);
+
+    // PHP expects at most one output.
+    size_t function_output_length = wasm_function_outputs_arity;
+    wasmer_value_t *function_outputs = NULL;
+
+    if (function_output_length > 0) {
+        function_output_length = 1;
+        function_outputs = (wasmer_value_t *) emalloc(sizeof(wasmer_value_t) * function_output_length);
+    }
+
+    // Record the call when the instance has a trace stream, see
+    // `wasm_instance_set_trace_stream`. The calls running or resuming
+    // an asynchronous call are not recorded.
+    smart_str trace_record = {0};
+    bool trace =
+        instance_state->async_status == WASM_ASYNC_NONE &&
+        wasm_host_stream(&instance_state->trace_stream) != NULL;
+
+    if (trace) {
+        wasm_trace_record_call(instance_state, &trace_record, function_name, function_name_length, function_inputs, function_input_length);
+    }
+
+    // Call the Wasm function.
+    wasmer_result_t function_call_result = wasmer_instance_call(
+        // Instance.
+        wasm_instance,
+        // Function name.
+        function_name,
+        // Inputs.
+        function_inputs,
+        function_input_length,
+        // Outputs.
+        function_outputs,
+        function_output_length
+    );
+
+    if (trace) {
+        wasm_trace_record_result(instance_state, &trace_record, function_call_result, function_outputs, function_output_length);
+    }
+
+    efree(function_inputs);
+
+    // The handler of the call queue has bailed out while the guest was
+    // running, see `wasm_host_php_queue_flush`. Resume the bailout now
+    // that the frames of Wasmer are gone.
+    if (UNEXPECTED(instance_state->call_queue_bailout)) {
+        instance_state->call_queue_bailout = false;
+        efree(function_outputs);
+
+        zend_bailout();
+    }
+
+    // Drain the records the guest has appended to its call queue,
+    // even if the call has failed.
+    if (instance_state->call_queue_capacity > 0) {
+        wasm_call_queue_drain(instance_state, instance_state->call_queue_memory);
+
+        // The handler has thrown.
+        if (EG(exception)) {
+            efree(function_outputs);
+
+            return;
+        }
+    }
+
+    // Failed to call the Wasm function.
+    if (function_call_result != wasmer_result_t::WASMER_OK) {
+        efree(function_outputs);
+
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            0,
+            "Failed to call the `%.*s` exported function.",
+            (int) function_name_length,
+            function_name
+        );
+
+        return;
+    }
+
+    if (function_output_length > 0) {
+        // Read the first output, because PHP expects at most one
+        // output, as said above.
+        wasmer_value_t function_output = function_outputs[0];
+
+        // Convert the Wasm value to a PHP value.
+        if (wasm_value_is_integer(&function_output)) {
+            efree(function_outputs);
+
+            RETURN_LONG(wasm_value_to_integer(&function_output));
+        } else if (wasm_value_is_float(&function_output)) {
+            efree(function_outputs);
+
+            RETURN_DOUBLE(wasm_value_to_float(&function_output));
+        } else {
+            efree(function_outputs);
+
+            zend_throw_exception_ex(
+                zend_ce_exception,
+                0,
+                "The exported function `%.*s` has returned a value of unknown type.",
+                (int) function_name_length,
+                function_name
+            );
+
+            return;
+        }
+    }
+    // No output, `void` is similar to `null` in PHP.
+    else {
+        efree(function_outputs);
+
+        RETURN_NULL();
+    }
+}
+
+/**
+ * Declare the parameter information for the `wasm_invoke_function`
+ * function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_invoke_function, ZEND_RETURN_VALUE, ARITY(3), _IS_NUMBER, NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_instance, IS_RESOURCE, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, function_name, IS_STRING, NOT_NULLABLE)
+    ZEND_ARG_ARRAY_INFO(0, inputs, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_invoke_function` function.
+ *
+ * # Usage
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $instance = wasm_new_instance($bytes);
+ *
+ * // sum(1, 2)
+ * $result = wasm_invoke_function(
+ *     $instance,
+ *     'sum',
+ *     [
+ *         // with a Wasm value directly
+ *         wasm_value(WASM_TYPE_I32, 1),
+ *
+ *         // with a PHP value, the Wasm type will be infered
+ *         2,
+ *     ]
+ * );
+ * ```
+ */
+PHP_FUNCTION(wasm_invoke_function)
+{
+    zval *wasm_instance_resource;
+    char *function_name;
+    size_t function_name_length;
+    HashTable *inputs;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 3, 3)
+        Z_PARAM_RESOURCE(wasm_instance_resource)
+        Z_PARAM_STRING(function_name, function_name_length)
+        Z_PARAM_ARRAY_HT(inputs)
+    ZEND_PARSE_PARAMETERS_END();
+
+    // Extract the Wasm instance from the resource.
+    wasm_instance_state *instance_state = wasm_instance_from_resource(Z_RES_P(wasm_instance_resource));
+
+    if (NULL == instance_state) {
+        RETURN_NULL();
+    }
+
+    wasm_instance_invoke_function(instance_state, function_name, function_name_length, inputs, return_value);
+}
+
+/**
+ * Call an asyncify function exported by the guest, with an optional
+ * `i32` argument.
+ */
+static bool wasm_async_call_export(wasm_instance_state *instance_state, const char *function_name, const int32_t *argument)
+{
+    wasmer_value_t input;
+    input.tag = wasmer_value_tag::WASM_I32;
+    input.value.I32 = argument != NULL ? *argument : 0;
+
+    return wasmer_instance_call(
+        instance_state->instance,
+        function_name,
+        &input,
+        argument != NULL ? 1 : 0,
+        NULL,
+        0
+    ) == wasmer_result_t::WASMER_OK;
+}
+
+/**
+ * Forget the asynchronous call of the instance.
+ */
+static void wasm_async_reset(wasm_instance_state *instance_state)
+{
+    instance_state->async_status = WASM_ASYNC_NONE;
+
+    if (instance_state->async_function_name != NULL) {
+        zend_string_release(instance_state->async_function_name);
+        instance_state->async_function_name = NULL;
+    }
+
+    zval_ptr_dtor(&instance_state->async_inputs);
+    ZVAL_UNDEF(&instance_state->async_inputs);
+
+    if (instance_state->async_request != NULL) {
+        zend_string_release(instance_state->async_request);
+        instance_state->async_request = NULL;
+    }
+
+    if (instance_state->async_response != NULL) {
+        zend_string_release(instance_state->async_response);
+        instance_state->async_response = NULL;
+    }
+}
+
+/**
+ * Run, or resume, the asynchronous call of the instance.
+ *
+ * The function is called with its inputs again when the call is
+ * resumed: the guest rewinds its stack instead of starting over. It
+ * returns the request the guest awaits if it has been suspended, or
+ * `null` if the call has completed; its result is then kept.
+ */
+static void wasm_async_run(wasm_instance_state *instance_state, zval *return_value)
+{
+    if (instance_state->async_status != WASM_ASYNC_REWINDING) {
+        instance_state->async_status = WASM_ASYNC_RUNNING;
+    }
+
+    zval result;
+    ZVAL_NULL(&result);
+
+    wasm_instance_invoke_function(
+        instance_state,
+        ZSTR_VAL(instance_state->async_function_name),
+        ZSTR_LEN(instance_state->async_function_name),
+        Z_ARRVAL(instance_state->async_inputs),
+        &result
+    );
+
+    if (EG(exception)) {
+        zval_ptr_dtor(&result);
+
+        // Stop unwinding or rewinding, so that the instance is usable
+        // again.
+        if (instance_state->async_status == WASM_ASYNC_UNWINDING) {
+            wasm_async_call_export(instance_state, "asyncify_stop_unwind", NULL);
+        } else if (instance_state->async_status == WASM_ASYNC_REWINDING) {
+            wasm_async_call_export(instance_state, "asyncify_stop_rewind", NULL);
+        }
+
+        wasm_async_reset(instance_state);
+
+        return;
+    }
+
+    // The guest has unwound its stack: the call is suspended.
+    if (instance_state->async_status == WASM_ASYNC_UNWINDING) {
+        zval_ptr_dtor(&result);
+
+        if (!wasm_async_call_export(instance_state, "asyncify_stop_unwind", NULL)) {
+            wasm_async_reset(instance_state);
+
+            zend_throw_exception(zend_ce_exception, "Failed to suspend the asynchronous call.", 0);
+
+            return;
+        }
+
+        instance_state->async_status = WASM_ASYNC_SUSPENDED;
+
+        RETURN_STR_COPY(instance_state->async_request);
+    }
+
+    // The guest has not rewound its stack up to `php_await`.
+    if (instance_state->async_status == WASM_ASYNC_REWINDING) {
+        zval_ptr_dtor(&result);
+        wasm_async_call_export(instance_state, "asyncify_stop_rewind", NULL);
+        wasm_async_reset(instance_state);
+
+        zend_throw_exception(zend_ce_exception, "Failed to resume the asynchronous call.", 0);
+
+        return;
+    }
+
+    // The call has completed.
+    zval_ptr_dtor(&instance_state->async_result);
+    ZVAL_COPY_VALUE(&instance_state->async_result, &result);
+    wasm_async_reset(instance_state);
+
+    RETURN_NULL();
+}
+
+/**
+ * Declare the parameter information for the
+ * `wasm_async_invoke_function` function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_async_invoke_function, ZEND_RETURN_VALUE, ARITY(3), IS_STRING, NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_instance, IS_RESOURCE, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, function_name, IS_STRING, NOT_NULLABLE)
+    ZEND_ARG_ARRAY_INFO(0, inputs, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_async_invoke_function` function.
+ *
+ * Invoke an exported function that may await operations performed by
+ * PHP with the `env.php_await` host function. When the guest awaits,
+ * the call is suspended, and the request of the guest is returned.
+ * PHP performs the operation, possibly concurrently with the ones of
+ * other instances, then resumes the call with the response thanks to
+ * `wasm_async_resume`. When the call has completed, `null` is returned,
+ * and its result is read with `wasm_async_get_result`.
+ *
+ * # Usage
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $instance = wasm_new_instance($bytes);
+ *
+ * $request = wasm_async_invoke_function($instance, 'run', []);
+ *
+ * while (null !== $request) {
+ *     $request = wasm_async_resume($instance, perform($request));
+ * }
+ *
+ * $result = wasm_async_get_result($instance);
+ * ```
+ */
+PHP_FUNCTION(wasm_async_invoke_function)
+{
+    zval *wasm_instance_resource;
+    zend_string *function_name;
+    zval *inputs;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 3, 3)
+        Z_PARAM_RESOURCE(wasm_instance_resource)
+        Z_PARAM_STR(function_name)
+        Z_PARAM_ARRAY(inputs)
+    ZEND_PARSE_PARAMETERS_END();
+
+    // Extract the Wasm instance from the resource.
+    wasm_instance_state *instance_state = wasm_instance_from_resource(Z_RES_P(wasm_instance_resource));
+
+    if (NULL == instance_state) {
+        RETURN_NULL();
+    }
+
+    if (instance_state->async_status != WASM_ASYNC_NONE) {
+        zend_throw_exception(zend_ce_exception, "The instance already has an asynchronous call in progress.", 0);
+
+        return;
+    }
+
+    // Keep the call, to resume it later.
+    instance_state->async_function_name = zend_string_copy(function_name);
+    ZVAL_COPY(&instance_state->async_inputs, inputs);
+
+    wasm_async_run(instance_state, return_value);
+}
+
+/**
+ * Declare the parameter information for the `wasm_async_resume`
+ * function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_async_resume, ZEND_RETURN_VALUE, ARITY(2), IS_STRING, NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_instance, IS_RESOURCE, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, response, IS_STRING, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_async_resume` function.
+ *
+ * Resume the suspended asynchronous call of the instance with the
+ * response to the request of the guest, see
+ * `wasm_async_invoke_function`. It returns the next request of the
+ * guest, or `null` when the call has completed.
+ */
+PHP_FUNCTION(wasm_async_resume)
+{
+    zval *wasm_instance_resource;
+    zend_string *response;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 2, 2)
+        Z_PARAM_RESOURCE(wasm_instance_resource)
+        Z_PARAM_STR(response)
+    ZEND_PARSE_PARAMETERS_END();
+
+    // Extract the Wasm instance from the resource.
+    wasm_instance_state *instance_state = wasm_instance_from_resource(Z_RES_P(wasm_instance_resource));
+
+    if (NULL == instance_state) {
+        RETURN_NULL();
+    }
+
+    if (instance_state->async_status != WASM_ASYNC_SUSPENDED) {
+        zend_throw_exception(zend_ce_exception, "The instance has no suspended asynchronous call.", 0);
+
+        return;
+    }
+
+    // Start rewinding the guest stack.
+    int32_t async_data_pointer = (int32_t) instance_state->async_data_pointer;
+
+    if (!wasm_async_call_export(instance_state, "asyncify_start_rewind", &async_data_pointer)) {
+        wasm_async_reset(instance_state);
+
+        zend_throw_exception(zend_ce_exception, "Failed to resume the asynchronous call.", 0);
+
+        return;
+    }
+
+    instance_state->async_response = zend_string_copy(response);
+    instance_state->async_status = WASM_ASYNC_REWINDING;
+
+    wasm_async_run(instance_state, return_value);
+}
+
+/**
+ * Declare the parameter information for the `wasm_async_get_result`
+ * function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_async_get_result, ZEND_RETURN_VALUE, ARITY(1), _IS_NUMBER, NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_instance, IS_RESOURCE, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_async_get_result` function.
+ *
+ * Get the result of the last completed asynchronous call of the
+ * instance, see `wasm_async_invoke_function`.
+ */
+PHP_FUNCTION(wasm_async_get_result)
+{
+    zval *wasm_instance_resource;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
+        Z_PARAM_RESOURCE(wasm_instance_resource)
+    ZEND_PARSE_PARAMETERS_END();
+
+    // Extract the Wasm instance from the resource.
+    wasm_instance_state *instance_state = wasm_instance_from_resource(Z_RES_P(wasm_instance_resource));
+
+    if (NULL == instance_state) {
+        RETURN_NULL();
+    }
+
+    ZVAL_COPY(return_value, &instance_state->async_result);
+}
+
+/**
+ * Declare the parameter information for the
+ * `wasm_get_memory_buffer` function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(arginfo_wasm_get_memory_buffer, ZEND_RETURN_REFERENCE, ARITY(1), WasmArrayBuffer, NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_instance, IS_RESOURCE, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_get_memory_buffer` function.
+ *
+ * # Usage
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $instance = wasm_new_instance($bytes);
+ * $memory = wasm_get_memory_buffer($instance);
+ * $view = new WasmUint8Array($memory);
+ * // enjoy!
+ * ```
+ */
+PHP_FUNCTION(wasm_get_memory_buffer)
+{
+    zval *wasm_instance_resource;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
+        Z_PARAM_RESOURCE(wasm_instance_resource)
+    ZEND_PARSE_PARAMETERS_END();
+
+    // Extract the Wasm instance from the resource.
+    wasm_instance_state *instance_state = wasm_instance_from_resource(Z_RES_P(wasm_instance_resource));
+
+    if (NULL == instance_state) {
+        RETURN_NULL();
+    }
+
+    // Look for an exported memory.
+    wasmer_memory_t *wasm_memory = wasm_instance_memory(instance_state);
+
+    // Gotcha?
+    if (wasm_memory == NULL) {
+        RETURN_NULL();
+    }
+
+    // Get the memory data and its length.
+    uint8_t *wasm_memory_data = wasmer_memory_data(wasm_memory);
+    uint32_t wasm_memory_data_length = wasmer_memory_data_length(wasm_memory);
+
+    // Create a `WasmArrayBuffer` object.
+    zend_object *wasm_array_buffer = create_wasm_array_buffer_object(wasm_array_buffer_class_entry);
+    wasm_array_buffer_object *wasm_array_buffer_object = wasm_array_buffer_object_from_zend_object(wasm_array_buffer);
+
+    // Set the internal buffer of `WasmArrayBuffer`.
+    wasm_array_buffer_object->buffer = (int8_t *) wasm_memory_data;
+    wasm_array_buffer_object->buffer_length = (size_t) wasm_memory_data_length;
+
+    // Do not free the buffer, it's not allocated by PHP.
+    wasm_array_buffer_object->allocated_buffer = false;
+
+    // Return the `WasmArrayBuffer` instance.
+    ZVAL_OBJ(return_value, &wasm_array_buffer_object->instance);
+}
+
+/**
+ * Declare the parameter information for the
+ * `wasm_instance_set_output_stream` function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_instance_set_output_stream, ZEND_RETURN_VALUE, ARITY(1), IS_VOID, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_instance, IS_RESOURCE, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, stream, IS_RESOURCE, NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_instance_set_output_stream` function.
+ *
+ * Set the stream receiving the bytes the guest writes with the
+ * `env.php_write` host function. When the stream is `null`, which is
+ * the default, the bytes go to the PHP output layer.
+ *
+ * # Usage
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $instance = wasm_new_instance($bytes);
+ * $stream = fopen('php://temp', 'w+');
+ *
+ * wasm_instance_set_output_stream($instance, $stream);
+ * wasm_invoke_function($instance, 'render', []);
+ * ```
+ */
+PHP_FUNCTION(wasm_instance_set_output_stream)
+{
+    zval *wasm_instance_resource;
+    zval *stream_resource = NULL;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 2)
+        Z_PARAM_RESOURCE(wasm_instance_resource)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_RESOURCE_EX(stream_resource, 1, 0)
+    ZEND_PARSE_PARAMETERS_END();
+
+    // Extract the Wasm instance from the resource.
+    wasm_instance_state *instance_state = wasm_instance_from_resource(Z_RES_P(wasm_instance_resource));
+
+    if (NULL == instance_state) {
+        return;
+    }
+
+    // Be sure the resource is a stream.
+    if (stream_resource != NULL && wasm_host_stream(stream_resource) == NULL) {
+        zend_throw_exception(zend_ce_exception, "The output of an instance must be an open stream.", 0);
+
+        return;
+    }
+
+    zval_ptr_dtor(&instance_state->output_stream);
+    instance_state->unflushed_output_length = 0;
+
+    if (stream_resource != NULL) {
+        ZVAL_COPY(&instance_state->output_stream, stream_resource);
+    } else {
+        ZVAL_UNDEF(&instance_state->output_stream);
+    }
+}
+
+/**
+ * Declare the parameter information for the
+ * `wasm_instance_set_input_stream` function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_instance_set_input_stream, ZEND_RETURN_VALUE, ARITY(1), IS_VOID, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_instance, IS_RESOURCE, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, stream, IS_RESOURCE, NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_instance_set_input_stream` function.
+ *
+ * Set the stream the guest reads with the `env.php_read` host
+ * function. When the stream is `null`, which is the default, the
+ * guest has no input.
+ *
+ * # Usage
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $instance = wasm_new_instance($bytes);
+ *
+ * wasm_instance_set_input_stream($instance, fopen('php://input', 'r'));
+ * wasm_invoke_function($instance, 'parse', []);
+ * ```
+ */
+PHP_FUNCTION(wasm_instance_set_input_stream)
+{
+    zval *wasm_instance_resource;
+    zval *stream_resource = NULL;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 2)
+        Z_PARAM_RESOURCE(wasm_instance_resource)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_RESOURCE_EX(stream_resource, 1, 0)
+    ZEND_PARSE_PARAMETERS_END();
+
+    // Extract the Wasm instance from the resource.
+    wasm_instance_state *instance_state = wasm_instance_from_resource(Z_RES_P(wasm_instance_resource));
+
+    if (NULL == instance_state) {
+        return;
+    }
+
+    // Be sure the resource is a stream.
+    if (stream_resource != NULL && wasm_host_stream(stream_resource) == NULL) {
+        zend_throw_exception(zend_ce_exception, "The input of an instance must be an open stream.", 0);
+
+        return;
+    }
+
+    zval_ptr_dtor(&instance_state->input_stream);
+
+    if (stream_resource != NULL) {
+        ZVAL_COPY(&instance_state->input_stream, stream_resource);
+    } else {
+        ZVAL_UNDEF(&instance_state->input_stream);
+    }
+}
+
+/**
+ * Declare the parameter information for the
+ * `wasm_instance_set_call_queue_handler` function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_instance_set_call_queue_handler, ZEND_RETURN_VALUE, ARITY(1), IS_VOID, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_instance, IS_RESOURCE, NOT_NULLABLE)
+    ZEND_ARG_CALLABLE_INFO(0, handler, NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_instance_set_call_queue_handler` function.
+ *
+ * Set the handler receiving the records of the call queue of the
+ * guest. It is called once per batch of records, with a list of
+ * `[int $tag, string $payload]` records. When the handler is `null`,
+ * which is the default, the records are dropped.
+ *
+ * # Usage
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $instance = wasm_new_instance($bytes);
+ *
+ * wasm_instance_set_call_queue_handler(
+ *     $instance,
+ *     function (array $records) {
+ *         foreach ($records as [$tag, $payload]) {
+ *             // …
+ *         }
+ *     }
+ * );
+ * wasm_invoke_function($instance, 'run', []);
+ * ```
+ */
+PHP_FUNCTION(wasm_instance_set_call_queue_handler)
+{
+    zval *wasm_instance_resource;
+    zval *handler = NULL;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 2)
+        Z_PARAM_RESOURCE(wasm_instance_resource)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_ZVAL_EX(handler, 1, 0)
+    ZEND_PARSE_PARAMETERS_END();
+
+    // Extract the Wasm instance from the resource.
+    wasm_instance_state *instance_state = wasm_instance_from_resource(Z_RES_P(wasm_instance_resource));
+
+    if (NULL == instance_state) {
+        return;
+    }
+
+    // Be sure the handler is callable.
+    if (handler != NULL && !zend_is_callable(handler, 0, NULL)) {
+        zend_throw_exception(zend_ce_exception, "The call queue handler must be callable.", 0);
+
+        return;
+    }
+
+    zval_ptr_dtor(&instance_state->call_queue_handler);
+
+    if (handler != NULL) {
+        ZVAL_COPY(&instance_state->call_queue_handler, handler);
+    } else {
+        ZVAL_UNDEF(&instance_state->call_queue_handler);
+    }
+}
+
+/**
+ * Declare the parameter information for the
+ * `wasm_instance_set_trace_stream` function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_instance_set_trace_stream, ZEND_RETURN_VALUE, ARITY(1), IS_VOID, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, wasm_instance, IS_RESOURCE, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, stream, IS_RESOURCE, NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_instance_set_trace_stream` function.
+ *
+ * Record the calls to the exported functions of the instance in the
+ * given stream, until the stream is `null`, which is the default. Each
+ * call is recorded with its function name, its inputs, its result,
+ * and the regions of the memory written by PHP since the previous
+ * call, in the binary format of `wasm_trace.hh`. The `replay` tool of
+ * the extension runs such a trace against a module and measures it.
+ *
+ * To find the written regions, the memory is copied after each call
+ * and compared before the next one: recording costs as much memory as
+ * the instance, and time proportional to it.
+ *
+ * # Usage
+ *
+ * ```php
+ * $bytes = wasm_fetch_bytes('my_program.wasm');
+ * $instance = wasm_new_instance($bytes);
+ *
+ * wasm_instance_set_trace_stream($instance, fopen('my_program.trace', 'wb'));
+ * wasm_invoke_function($instance, 'run', [42]);
+ * ```
+ */
+PHP_FUNCTION(wasm_instance_set_trace_stream)
+{
+    zval *wasm_instance_resource;
+    zval *stream_resource = NULL;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 2)
+        Z_PARAM_RESOURCE(wasm_instance_resource)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_RESOURCE_EX(stream_resource, 1, 0)
+    ZEND_PARSE_PARAMETERS_END();
+
+    // Extract the Wasm instance from the resource.
+    wasm_instance_state *instance_state = wasm_instance_from_resource(Z_RES_P(wasm_instance_resource));
+
+    if (NULL == instance_state) {
+        return;
+    }
+
+    // Be sure the resource is a stream.
+    php_stream *stream = NULL;
+
+    if (stream_resource != NULL) {
+        stream = wasm_host_stream(stream_resource);
+
+        if (stream == NULL) {
+            zend_throw_exception(zend_ce_exception, "The trace of an instance must be an open stream.", 0);
+
+            return;
+        }
+    }
+
+    zval_ptr_dtor(&instance_state->trace_stream);
+
+    // A new trace starts from a memory of zeros.
+    if (instance_state->trace_shadow != NULL) {
+        efree(instance_state->trace_shadow);
+        instance_state->trace_shadow = NULL;
+        instance_state->trace_shadow_length = 0;
+    }
+
+    if (stream_resource == NULL) {
+        ZVAL_UNDEF(&instance_state->trace_stream);
+
+        return;
+    }
+
+    ZVAL_COPY(&instance_state->trace_stream, stream_resource);
+
+    uint8_t version[4];
+    wasm_trace_encode_u32(WASM_TRACE_VERSION, version);
+    php_stream_write(stream, WASM_TRACE_MAGIC, WASM_TRACE_MAGIC_LENGTH);
+    php_stream_write(stream, (const char *) version, sizeof(version));
+}
+
+/**
+ * Declare the parameter information for the `wasm_get_last_error`
+ * function.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_get_last_error, ZEND_RETURN_VALUE, ARITY(0), IS_STRING, NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `wasm_get_last_error` function.
+ *
+ * # Usage
+ *
+ * ```php
+ * $error = wasm_get_last_error();
+ * ```
+ */
+PHP_FUNCTION(wasm_get_last_error)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    int error_message_length = wasmer_last_error_length();
+
+    if (error_message_length == 0) {
+        RETURN_NULL();
+    }
+
+    char *error_message = (char *) emalloc(error_message_length);
+    wasmer_last_error_message(error_message, error_message_length);
+
+    ZVAL_STRINGL(return_value, error_message, error_message_length - 1);
+}
+
+// Declare the functions with their information.
+static const zend_function_entry wasm_functions[] = {
+    PHP_FE(wasm_fetch_bytes,							arginfo_wasm_fetch_bytes)
+    PHP_FE(wasm_validate,								arginfo_wasm_validate)
+    PHP_FE(wasm_compile,								arginfo_wasm_compile)
+    PHP_FE(wasm_module_clean_up_persistent_resources,	arginfo_wasm_module_clean_up_persistent_resources)
+    PHP_FE(wasm_module_new_instance,					arginfo_wasm_module_new_instance)
+    PHP_FE(wasm_module_new_linked_instance,				arginfo_wasm_module_new_linked_instance)
+    PHP_FE(wasm_module_serialize,						arginfo_wasm_module_serialize)
+    PHP_FE(wasm_module_deserialize,						arginfo_wasm_module_deserialize)
+    PHP_FE(wasm_new_instance,							arginfo_wasm_new_instance)
+    PHP_FE(wasm_value,									arginfo_wasm_value)
+    PHP_FE(wasm_invoke_function,						arginfo_wasm_invoke_function)
+    PHP_FE(wasm_async_invoke_function,					arginfo_wasm_async_invoke_function)
+    PHP_FE(wasm_async_resume,							arginfo_wasm_async_resume)
+    PHP_FE(wasm_async_get_result,						arginfo_wasm_async_get_result)
+    PHP_FE(wasm_get_memory_buffer,						arginfo_wasm_get_memory_buffer)
+    PHP_FE(wasm_instance_set_output_stream,				arginfo_wasm_instance_set_output_stream)
+    PHP_FE(wasm_instance_set_input_stream,				arginfo_wasm_instance_set_input_stream)
+    PHP_FE(wasm_instance_set_call_queue_handler,		arginfo_wasm_instance_set_call_queue_handler)
+    PHP_FE(wasm_instance_set_trace_stream,				arginfo_wasm_instance_set_trace_stream)
+    PHP_FE(wasm_get_last_error,							arginfo_wasm_get_last_error)
+    PHP_FE_END
+};
+
+/**
+ * Gets the `wasm_typed_array_object` pointer from a `zend_object` pointer.
+ */
+static inline wasm_typed_array_object *wasm_typed_array_object_from_zend_object(zend_object *object)
+{
+	return (wasm_typed_array_object *) ((char *)(object) - XtOffsetOf(wasm_typed_array_object, instance));
+}
+
+/**
+ * Gets the items of a `WasmTypedArray` object for reading. A view
+ * that is not constructed has no items.
+ */
+static inline wasm_typed_array_view wasm_typed_array_read_view(wasm_typed_array_object *wasm_typed_array_object)
+{
+    wasm_typed_array_view view;
+    view.as_int8 = NULL;
+
+    if (EXPECTED(wasm_typed_array_object->wasm_array_buffer != NULL)) {
+        view.as_int8 =
+            wasm_array_buffer_object_from_zend_object(wasm_typed_array_object->wasm_array_buffer)->buffer +
+            wasm_typed_array_object->offset;
+    }
+
+    return view;
+}
+
+/**
+ * Gets the items of a `WasmTypedArray` object for writing, detaching
+ * its buffer first if needed.
+ */
+static inline wasm_typed_array_view wasm_typed_array_write_view(wasm_typed_array_object *wasm_typed_array_object)
+{
+    if (EXPECTED(wasm_typed_array_object->wasm_array_buffer != NULL)) {
+        wasm_array_buffer_detach(wasm_array_buffer_object_from_zend_object(wasm_typed_array_object->wasm_array_buffer));
+    }
+
+    return wasm_typed_array_read_view(wasm_typed_array_object);
+}
+
+/**
+ * Checks whether a subclass of one of the `WasmTypedArray` classes
+ * overrides a method. `name` must be lowercase.
+ */
+static inline bool wasm_typed_array_overrides(zend_class_entry *class_entry, zend_class_entry *base_class_entry, const char *name, size_t name_length)
+{
+    zend_function *function = (zend_function *) zend_hash_str_find_ptr(&class_entry->function_table, name, name_length);
+
+    return function != NULL && function->common.scope != base_class_entry;
+}
+
+/**
+ * Function for a `zend_class_entry` to create one of the `WasmTypedArray` objects.
+ */
+static zend_object *create_wasm_typed_array_object(zend_class_entry *class_entry)
+{
+    wasm_typed_array_object *wasm_typed_array = (wasm_typed_array_object *) ecalloc(
+        1,
+        sizeof(wasm_typed_array_object) + zend_object_properties_size(class_entry)
+    );
+    wasm_typed_array->wasm_array_buffer = NULL;
+    wasm_typed_array->offset = 0;
+    wasm_typed_array->length = 0;
+
+    zend_object_std_init(&wasm_typed_array->instance, class_entry);
+    object_properties_init(&wasm_typed_array->instance, class_entry);
+
+    {
+        zend_class_entry *base_class_entry = class_entry;
+
+        while (base_class_entry->parent) {
+            base_class_entry = base_class_entry->parent;
+        }
+
+        if (base_class_entry == wasm_typed_array_int8_class_entry) {
+            wasm_typed_array->kind = wasm_typed_array_kind::INT8;
+        } else if (base_class_entry == wasm_typed_array_uint8_class_entry) {
+            wasm_typed_array->kind = wasm_typed_array_kind::UINT8;
+        } else if (base_class_entry == wasm_typed_array_int16_class_entry) {
+            wasm_typed_array->kind = wasm_typed_array_kind::INT16;
+        } else if (base_class_entry == wasm_typed_array_uint16_class_entry) {
+            wasm_typed_array->kind = wasm_typed_array_kind::UINT16;
+        } else if (base_class_entry == wasm_typed_array_int32_class_entry) {
+            wasm_typed_array->kind = wasm_typed_array_kind::INT32;
+        } else if (base_class_entry == wasm_typed_array_uint32_class_entry) {
+            wasm_typed_array->kind = wasm_typed_array_kind::UINT32;
+        } else {
+            zend_error(E_ERROR, "WebAssembly buffer view has an unknown type.");
+        }
+
+        wasm_typed_array->bytes_per_element = wasm_typed_array_bytes_per_element(wasm_typed_array->kind);
+
+        // Like `SplFixedArray`, the dimension handlers honor the
+        // `ArrayAccess` methods of a subclass.
+        if (class_entry != base_class_entry) {
+            wasm_typed_array->overrides_offset_get = wasm_typed_array_overrides(class_entry, base_class_entry, "offsetget", sizeof("offsetget") - 1);
+            wasm_typed_array->overrides_offset_set = wasm_typed_array_overrides(class_entry, base_class_entry, "offsetset", sizeof("offsetset") - 1);
+            wasm_typed_array->overrides_offset_exists = wasm_typed_array_overrides(class_entry, base_class_entry, "offsetexists", sizeof("offsetexists") - 1);
+            wasm_typed_array->overrides_offset_unset = wasm_typed_array_overrides(class_entry, base_class_entry, "offsetunset", sizeof("offsetunset") - 1);
+        }
+    }
+
+    wasm_typed_array->instance.handlers = &wasm_typed_array_class_entry_handlers;
+
+    return &wasm_typed_array->instance;
+}
+
+/**
+ * Handler for a `zend_class_entry` to destroy (i.e. call the
+ * destructor on the userland) of one of the `WasmTypedArray` objects.
+ */
+static void destroy_wasm_typed_array_object(zend_object *object)
+{
+    zend_objects_destroy_object(object);
+}
+
+/**
+ * Handler for a `zend_class_entry` to free one of the `WasmTypedArray` objects.
+ */
+static void free_wasm_typed_array_object(zend_object *object)
+{
+    wasm_typed_array_object *wasm_typed_array_object = wasm_typed_array_object_from_zend_object(object);
+
+    if (wasm_typed_array_object->wasm_array_buffer != NULL) {
+        OBJ_RELEASE(wasm_typed_array_object->wasm_array_buffer);
+    }
+
+    zend_object_std_dtor(object);
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmTypedArray::__construct` method.
+ */
+ZEND_BEGIN_ARG_INFO_EX(arginfo_wasmtypedarray___construct, 0, ZEND_RETURN_VALUE, ARITY(1))
+    ZEND_ARG_INFO(0, wasm_array_buffer)
+    ZEND_ARG_TYPE_INFO(0, offset, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, length, IS_LONG, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmTypedArray::__construct` method.
+ *
+ * The view is built over a `WasmArrayBuffer`, or over the bytes of
+ * another typed array of any kind, in which case the offset is
+ * relative to the start of that typed array. In both cases, the
+ * offset is in bytes, and the length is in items.
+ *
+ * # Usage
+ *
+ * ```php
+ * $buffer = new WasmArrayBuffer(256);
+ * $offset = 1;
+ * $length = 7;
+ * $uint8 = new WasmUint8Array($buffer, $offset, $length);
+ * $uint16 = new WasmUint16Array($uint8, 1, 3);
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray___construct)
+{
+    zval *source;
+    zend_long offset = 0;
+    zend_long length = 0;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 3)
+        Z_PARAM_OBJECT(source)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(offset)
+        Z_PARAM_LONG(length)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+    zend_object *wasm_array_buffer;
+    size_t source_offset;
+    size_t source_length;
+
+    if (instanceof_function(Z_OBJCE_P(source), wasm_array_buffer_class_entry)) {
+        wasm_array_buffer = Z_OBJ_P(source);
+        source_offset = 0;
+        source_length = wasm_array_buffer_object_from_zend_object(wasm_array_buffer)->buffer_length;
+    } else if (Z_OBJ_HT_P(source) == &wasm_typed_array_class_entry_handlers) {
+        wasm_typed_array_object *source_wasm_typed_array_object = wasm_typed_array_object_from_zend_object(Z_OBJ_P(source));
+
+        if (source_wasm_typed_array_object->wasm_array_buffer == NULL) {
+            zend_throw_exception(zend_ce_exception, "The given typed array is not constructed.", 5);
+
+            return;
+        }
+
+        wasm_array_buffer = source_wasm_typed_array_object->wasm_array_buffer;
+        source_offset = source_wasm_typed_array_object->offset;
+        source_length = source_wasm_typed_array_object->length * source_wasm_typed_array_object->bytes_per_element;
+    } else {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            5,
+            "The view must be built over a WasmArrayBuffer or a WebAssembly typed array; given an instance of `%s`.",
+            ZSTR_VAL(Z_OBJCE_P(source)->name)
+        );
+
+        return;
+    }
+
+    if (offset < 0) {
+        zend_throw_exception_ex(zend_ce_exception, 0, "Offset must be non-negative; given %lld.", offset);
+
+        return;
+    }
+
+    if (offset > source_length) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            1,
+            "Offset must be smaller than the array buffer length; given %lld, buffer length is %zu.",
+            offset,
+            source_length
+        );
+
+        return;
+    }
+
+    if (length < 0) {
+        zend_throw_exception_ex(zend_ce_exception, 2, "Length must be non-negative; given %lld.", length);
+
+        return;
+    }
+
+    // Assign the length.
+    size_t maximum_length = (source_length - offset) / wasm_typed_array_object->bytes_per_element;
+
+    if (length == 0) {
+        length = maximum_length;
+    } else if (length > maximum_length) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            4,
+            "Length must not be greater than the buffer length; given %lld, maximum length is %zu.",
+            length,
+            maximum_length
+        );
+
+        return;
+    }
+
+    // Release the buffer of a previous construction, if any.
+    if (wasm_typed_array_object->wasm_array_buffer != NULL) {
+        OBJ_RELEASE(wasm_typed_array_object->wasm_array_buffer);
+    }
+
+    // Assign the `WasmArrayBuffer` in the `WasmTypedArray`.
+    wasm_typed_array_object->wasm_array_buffer = wasm_array_buffer;
+    GC_ADDREF(wasm_array_buffer);
+
+    // Assign the offset and the length.
+    wasm_typed_array_object->offset = source_offset + (size_t) offset;
+    wasm_typed_array_object->length = (size_t) length;
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmTypedArray::getOffset` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_get_offset, ZEND_RETURN_VALUE, ARITY(0), IS_LONG, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmTypedArray::getOffset` method.
+ *
+ * # Usage
+ *
+ * ```php
+ * $buffer = new WasmArrayBuffer(42);
+ * $view = new WasmUint8Array($buffer, 3, 5);
+ * assert($view->getOffset() == 3);
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_get_offset)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+
+    RETURN_LONG(wasm_typed_array_object->offset);
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmTypedArray::getLength` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_get_length, ZEND_RETURN_VALUE, ARITY(0), IS_LONG, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmTypedArray::getLength` method.
+ *
+ * # Usage
+ *
+ * ```php
+ * $buffer = new WasmArrayBuffer(42);
+ * $view = new WasmUint8Array($buffer, 3, 5);
+ * assert($view->getLength() == 5);
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_get_length)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+
+    RETURN_LONG(wasm_typed_array_object->length);
+}
+
+/**
+ * Reads the item at `index`, which must be in the view range.
+ */
+static inline zend_long wasm_typed_array_read_item(wasm_typed_array_object *wasm_typed_array_object, size_t index)
+{
+    wasm_typed_array_view view = wasm_typed_array_read_view(wasm_typed_array_object);
+
+    switch (wasm_typed_array_object->kind) {
+        case wasm_typed_array_kind::INT8:
+            return view.as_int8[index];
+
+        case wasm_typed_array_kind::UINT8:
+            return view.as_uint8[index];
+
+        case wasm_typed_array_kind::INT16:
+            return view.as_int16[index];
+
+        case wasm_typed_array_kind::UINT16:
+            return view.as_uint16[index];
+
+        case wasm_typed_array_kind::INT32:
+            return view.as_int32[index];
+
+        case wasm_typed_array_kind::UINT32:
+            return view.as_uint32[index];
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Writes `value` at `index`, which must be in the view range. The
+ * value is truncated to the item type.
+ */
+static inline void wasm_typed_array_write_item(wasm_typed_array_object *wasm_typed_array_object, size_t index, zend_long value)
+{
+    wasm_typed_array_view view = wasm_typed_array_write_view(wasm_typed_array_object);
+
+    switch (wasm_typed_array_object->kind) {
+        case wasm_typed_array_kind::INT8:
+            view.as_int8[index] = value;
+
+            break;
+
+        case wasm_typed_array_kind::UINT8:
+            view.as_uint8[index] = value;
+
+            break;
+
+        case wasm_typed_array_kind::INT16:
+            view.as_int16[index] = value;
+
+            break;
+
+        case wasm_typed_array_kind::UINT16:
+            view.as_uint16[index] = value;
+
+            break;
+
+        case wasm_typed_array_kind::INT32:
+            view.as_int32[index] = value;
+
+            break;
+
+        case wasm_typed_array_kind::UINT32:
+            view.as_uint32[index] = value;
+
+            break;
+    }
+}
+
+/**
+ * Checks that `offset` is in the view range, throws otherwise.
+ */
+static inline bool wasm_typed_array_check_offset(wasm_typed_array_object *wasm_typed_array_object, zend_long offset)
+{
+    if (UNEXPECTED(offset < 0 || (size_t) offset >= wasm_typed_array_object->length)) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            0,
+            "Offset is outside the view range [0; %zu]; given %lld.",
+            wasm_typed_array_object->length,
+            offset
+        );
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmTypedArray::offsetGet` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_offset_get, ZEND_RETURN_VALUE, ARITY(1), _IS_NUMBER, NOT_NULLABLE)
+    ZEND_ARG_INFO(0, offset)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmTypedArray::offsetGet` method.
+ *
+ * # Usage
+ *
+ * ```php
+ * $buffer = new WasmArrayBuffer(42);
+ * $view = new WasmUint8Array($buffer, 3, 5);
+ * assert($view[1] == 0);
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_offset_get)
+{
+    zend_long offset;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
+        Z_PARAM_LONG(offset)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+
+    if (!wasm_typed_array_check_offset(wasm_typed_array_object, offset)) {
+        return;
+    }
+
+    RETURN_LONG(wasm_typed_array_read_item(wasm_typed_array_object, offset));
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmTypedArray::offsetSet` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_offset_set, ZEND_RETURN_VALUE, ARITY(2), IS_VOID, NOT_NULLABLE)
+    ZEND_ARG_INFO(0, offset)
+    ZEND_ARG_INFO(0, value)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmTypedArray::offsetSet` method.
+ *
+ * # Usage
+ *
+ * ```php
+ * $buffer = new WasmArrayBuffer(42);
+ * $view = new WasmUint8Array($buffer, 3, 5);
+ * $view[0] = 153;
+ * assert($view[0] == 153);
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_offset_set)
+{
+    zend_long offset;
+    zval *value;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 2, 2)
+        Z_PARAM_LONG(offset)
+        Z_PARAM_ZVAL(value)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+
+    if (!wasm_typed_array_check_offset(wasm_typed_array_object, offset)) {
+        return;
+    }
+
+    wasm_typed_array_write_item(wasm_typed_array_object, offset, zval_get_long(value));
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmTypedArray::offsetExists` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_offset_exists, ZEND_RETURN_VALUE, ARITY(1), _IS_BOOL, NOT_NULLABLE)
+    ZEND_ARG_INFO(0, offset)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmTypedArray::offsetExists` method.
+ *
+ * # Usage
+ *
+ * ```php
+ * $buffer = new WasmArrayBuffer(42);
+ * $view = new WasmUint8Array($buffer, 3, 5);
+ * assert($view[0]);
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_offset_exists)
+{
+    zend_long offset;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
+        Z_PARAM_LONG(offset)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+
+    if (offset < 0 || offset >= wasm_typed_array_object->length) {
+        RETURN_FALSE;
+    } else {
+        RETURN_TRUE;
+    }
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmTypedArray::offsetUnset` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_offset_unset, ZEND_RETURN_VALUE, ARITY(1), IS_VOID, NOT_NULLABLE)
+    ZEND_ARG_INFO(0, offset)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmTypedArray::offsetUnset` method.
+ *
+ * # Usage
+ *
+ * ```php
+ * $buffer = new WasmArrayBuffer(42);
+ * $view = new WasmUint8Array($buffer, 3, 5);
+ * $view[0] = 1;
+ * unset($view[0]);
+ * assert($view[0] == 0);
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_offset_unset)
+{
+    zend_long offset;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
+        Z_PARAM_LONG(offset)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+
+    if (!wasm_typed_array_check_offset(wasm_typed_array_object, offset)) {
+        return;
+    }
+
+    wasm_typed_array_write_item(wasm_typed_array_object, offset, 0);
+}
+
+/**
+ * Reads the offset given to one of the dimension handlers. Integers
+ * take the fast path; other scalars are converted like
+ * `Z_PARAM_LONG` would do in the weak mode, since offsets are not
+ * subject to `strict_types`, like for arrays. Anything else throws a
+ * `TypeError`, unless `silent` is true, e.g. for `isset()` and `??`.
+ */
+static inline bool wasm_typed_array_dimension_offset(zval *offset, zend_long *result, bool silent)
+{
+    if (UNEXPECTED(offset == NULL)) {
+        if (!silent) {
+            zend_throw_exception(zend_ce_exception, "Items cannot be appended to a WebAssembly typed array.", 0);
+        }
+
+        return false;
+    }
+
+    ZVAL_DEREF(offset);
+
+    if (EXPECTED(Z_TYPE_P(offset) == IS_LONG)) {
+        *result = Z_LVAL_P(offset);
+
+        return true;
+    }
+
+    if (!zend_parse_arg_long_weak(offset, result)) {
+        if (!silent) {
+            zend_type_error("Offset must be of type int, %s given.", zend_zval_type_name(offset));
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Handler for `$view[$offset]` on one of the `WasmTypedArray`
+ * objects. It bypasses the `offsetGet` method call, unless a subclass
+ * overrides it.
+ *
+ * Like `SplFixedArray`, reading an invalid offset in the `BP_VAR_IS`
+ * mode, i.e. for `$view[$offset] ?? $default` or
+ * `isset($view[$offset][…])`, does not throw but returns `null`.
+ */
+static zval *read_wasm_typed_array_dimension(zval *object, zval *offset, int type, zval *rv)
+{
+    wasm_typed_array_object *wasm_typed_array_object = wasm_typed_array_object_from_zend_object(Z_OBJ_P(object));
+    zend_long index;
+
+    if (UNEXPECTED(wasm_typed_array_object->overrides_offset_get)) {
+        return zend_std_read_dimension(object, offset, type, rv);
+    }
+
+    if (UNEXPECTED(type == BP_VAR_IS)) {
+        if (!wasm_typed_array_dimension_offset(offset, &index, true) ||
+            index < 0 || (size_t) index >= wasm_typed_array_object->length) {
+            return &EG(uninitialized_zval);
+        }
+    } else if (!wasm_typed_array_dimension_offset(offset, &index, false) ||
+        !wasm_typed_array_check_offset(wasm_typed_array_object, index)) {
+        return NULL;
+    }
+
+    ZVAL_LONG(rv, wasm_typed_array_read_item(wasm_typed_array_object, index));
+
+    return rv;
+}
+
+/**
+ * Handler for `$view[$offset] = $value` on one of the
+ * `WasmTypedArray` objects. It bypasses the `offsetSet` method call,
+ * unless a subclass overrides it.
+ */
+static void write_wasm_typed_array_dimension(zval *object, zval *offset, zval *value)
+{
+    wasm_typed_array_object *wasm_typed_array_object = wasm_typed_array_object_from_zend_object(Z_OBJ_P(object));
+    zend_long index;
+
+    if (UNEXPECTED(wasm_typed_array_object->overrides_offset_set)) {
+        zend_std_write_dimension(object, offset, value);
+
+        return;
+    }
+
+    if (!wasm_typed_array_dimension_offset(offset, &index, false) ||
+        !wasm_typed_array_check_offset(wasm_typed_array_object, index)) {
+        return;
+    }
+
+    wasm_typed_array_write_item(
+        wasm_typed_array_object,
+        index,
+        EXPECTED(Z_TYPE_P(value) == IS_LONG) ? Z_LVAL_P(value) : zval_get_long(value)
+    );
+}
+
+/**
+ * Handler for `isset($view[$offset])` and `empty($view[$offset])` on
+ * one of the `WasmTypedArray` objects. It bypasses the `offsetExists`
+ * method call, unless a subclass overrides it.
+ */
+static int has_wasm_typed_array_dimension(zval *object, zval *offset, int check_empty)
+{
+    wasm_typed_array_object *wasm_typed_array_object = wasm_typed_array_object_from_zend_object(Z_OBJ_P(object));
+    zend_long index;
+
+    // `empty()` also calls `offsetGet`.
+    if (UNEXPECTED(
+        wasm_typed_array_object->overrides_offset_exists ||
+        (check_empty && wasm_typed_array_object->overrides_offset_get)
+    )) {
+        return zend_std_has_dimension(object, offset, check_empty);
+    }
+
+    if (!wasm_typed_array_dimension_offset(offset, &index, true)) {
+        return 0;
+    }
+
+    if (index < 0 || (size_t) index >= wasm_typed_array_object->length) {
+        return 0;
+    }
+
+    if (check_empty) {
+        return wasm_typed_array_read_item(wasm_typed_array_object, index) != 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Handler for `unset($view[$offset])` on one of the `WasmTypedArray`
+ * objects. It bypasses the `offsetUnset` method call, unless a
+ * subclass overrides it.
+ */
+static void unset_wasm_typed_array_dimension(zval *object, zval *offset)
+{
+    wasm_typed_array_object *wasm_typed_array_object = wasm_typed_array_object_from_zend_object(Z_OBJ_P(object));
+    zend_long index;
+
+    if (UNEXPECTED(wasm_typed_array_object->overrides_offset_unset)) {
+        zend_std_unset_dimension(object, offset);
+
+        return;
+    }
+
+    if (!wasm_typed_array_dimension_offset(offset, &index, false) ||
+        !wasm_typed_array_check_offset(wasm_typed_array_object, index)) {
+        return;
+    }
+
+    wasm_typed_array_write_item(wasm_typed_array_object, index, 0);
+}
+
+/**
+ * Gets the size of one item of a typed array kind, in bytes.
+ */
+static inline size_t wasm_typed_array_bytes_per_element(wasm_typed_array_kind kind)
+{
+    switch (kind) {
+        case wasm_typed_array_kind::INT16:
+        case wasm_typed_array_kind::UINT16:
+            return 2;
+
+        case wasm_typed_array_kind::INT32:
+        case wasm_typed_array_kind::UINT32:
+            return 4;
+
+        default:
+            return 1;
+    }
+}
+
+/**
+ * Sums items one by one. Used on architectures without SIMD kernels,
+ * and for the items remaining after the last full vector.
+ */
+template <typename T>
+static inline int64_t wasm_bulk_sum_scalar(const T *data, size_t length)
+{
+    int64_t sum = 0;
+
+    for (size_t nth = 0; nth < length; ++nth) {
+        sum += data[nth];
+    }
+
+    return sum;
+}
+
+/**
+ * Narrows `minimum` and `maximum` with items one by one.
+ */
+template <typename T>
+static inline void wasm_bulk_min_max_scalar(const T *data, size_t length, T *minimum, T *maximum)
+{
+    for (size_t nth = 0; nth < length; ++nth) {
+        if (data[nth] < *minimum) {
+            *minimum = data[nth];
+        }
+
+        if (data[nth] > *maximum) {
+            *maximum = data[nth];
+        }
+    }
+}
+
+/**
+ * Finds the index of `needle` item by item. Returns `length` if
+ * `needle` is absent.
+ */
+template <typename T>
+static inline size_t wasm_bulk_index_of_scalar(const T *data, size_t length, T needle)
+{
+    for (size_t nth = 0; nth < length; ++nth) {
+        if (data[nth] == needle) {
+            return nth;
+        }
+    }
+
+    return length;
+}
+
+#if defined(WASM_BULK_X86_64)
+
+/*
+ * The SIMD kernels work on a canonical representation of the items,
+ * obtained by flipping the sign bit (`bias`) when needed, so that a
+ * single instruction handles both the signed and the unsigned
+ * kinds: 8-bit items are summed and compared as unsigned, 16-bit and
+ * 32-bit items are compared as signed, and 32-bit items are summed
+ * as unsigned. Flipping the sign bit back gives the original item.
+ */
+
+/**
+ * Sums 8-bit items, 16 at a time, with `psadbw`.
+ */
+template <typename T>
+static int64_t wasm_bulk_sum_8_sse2(const T *data, size_t length)
+{
+    const bool is_signed = std::is_signed<T>::value;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi8(is_signed ? -128 : 0);
+    __m128i accumulator = zero;
+    size_t nth = 0;
+
+    for (; nth + 16 <= length; nth += 16) {
+        __m128i items = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (data + nth)), bias);
+        accumulator = _mm_add_epi64(accumulator, _mm_sad_epu8(items, zero));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *) lanes, accumulator);
+
+    uint64_t sum = lanes[0] + lanes[1] - (is_signed ? 128 * (uint64_t) nth : 0);
+
+    return (int64_t) sum + wasm_bulk_sum_scalar(data + nth, length - nth);
+}
+
+/**
+ * Sums 8-bit items, 32 at a time, with `vpsadbw`.
+ */
+template <typename T>
+static WASM_TARGET_AVX2 int64_t wasm_bulk_sum_8_avx2(const T *data, size_t length)
+{
+    const bool is_signed = std::is_signed<T>::value;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i bias = _mm256_set1_epi8(is_signed ? -128 : 0);
+    __m256i accumulator = zero;
+    size_t nth = 0;
+
+    for (; nth + 32 <= length; nth += 32) {
+        __m256i items = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) (data + nth)), bias);
+        accumulator = _mm256_add_epi64(accumulator, _mm256_sad_epu8(items, zero));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *) lanes, accumulator);
+
+    uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3] - (is_signed ? 128 * (uint64_t) nth : 0);
+
+    return (int64_t) sum + wasm_bulk_sum_scalar(data + nth, length - nth);
+}
+
+/**
+ * Sums 16-bit items, 8 at a time, with `pmaddwd`. Pairs of items are
+ * accumulated in 32-bit lanes, which are widened to 64-bit before
+ * they can overflow: a pair is in `[-65536; 65534]`, so 16384
+ * iterations are safe.
+ */
+template <typename T>
+static int64_t wasm_bulk_sum_16_sse2(const T *data, size_t length)
+{
+    const bool is_signed = std::is_signed<T>::value;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i bias = _mm_set1_epi16(is_signed ? 0 : std::numeric_limits<int16_t>::min());
+    const size_t vector_length = length - length % 8;
+    __m128i accumulator = zero;
+    size_t nth = 0;
+
+    while (nth < vector_length) {
+        const size_t block_end = std::min(vector_length, nth + 8 * 16384);
+        __m128i block = zero;
+
+        for (; nth < block_end; nth += 8) {
+            __m128i items = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (data + nth)), bias);
+            block = _mm_add_epi32(block, _mm_madd_epi16(items, ones));
+        }
+
+        __m128i sign = _mm_srai_epi32(block, 31);
+        accumulator = _mm_add_epi64(accumulator, _mm_unpacklo_epi32(block, sign));
+        accumulator = _mm_add_epi64(accumulator, _mm_unpackhi_epi32(block, sign));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *) lanes, accumulator);
+
+    uint64_t sum = lanes[0] + lanes[1] + (is_signed ? 0 : 32768 * (uint64_t) nth);
+
+    return (int64_t) sum + wasm_bulk_sum_scalar(data + nth, length - nth);
+}
+
+/**
+ * Sums 16-bit items, 16 at a time, with `vpmaddwd`. See
+ * `wasm_bulk_sum_16_sse2`.
+ */
+template <typename T>
+static WASM_TARGET_AVX2 int64_t wasm_bulk_sum_16_avx2(const T *data, size_t length)
+{
+    const bool is_signed = std::is_signed<T>::value;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i bias = _mm256_set1_epi16(is_signed ? 0 : std::numeric_limits<int16_t>::min());
+    const size_t vector_length = length - length % 16;
+    __m256i accumulator = zero;
+    size_t nth = 0;
+
+    while (nth < vector_length) {
+        const size_t block_end = std::min(vector_length, nth + 16 * 16384);
+        __m256i block = zero;
+
+        for (; nth < block_end; nth += 16) {
+            __m256i items = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) (data + nth)), bias);
+            block = _mm256_add_epi32(block, _mm256_madd_epi16(items, ones));
+        }
+
+        __m256i sign = _mm256_srai_epi32(block, 31);
+        accumulator = _mm256_add_epi64(accumulator, _mm256_unpacklo_epi32(block, sign));
+        accumulator = _mm256_add_epi64(accumulator, _mm256_unpackhi_epi32(block, sign));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *) lanes, accumulator);
+
+    uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3] + (is_signed ? 0 : 32768 * (uint64_t) nth);
+
+    return (int64_t) sum + wasm_bulk_sum_scalar(data + nth, length - nth);
+}
+
+/**
+ * Sums 32-bit items, 4 at a time, zero-extended to 64-bit lanes.
+ */
+template <typename T>
+static int64_t wasm_bulk_sum_32_sse2(const T *data, size_t length)
+{
+    const bool is_signed = std::is_signed<T>::value;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi32(is_signed ? std::numeric_limits<int32_t>::min() : 0);
+    __m128i accumulator = zero;
+    size_t nth = 0;
+
+    for (; nth + 4 <= length; nth += 4) {
+        __m128i items = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (data + nth)), bias);
+        accumulator = _mm_add_epi64(accumulator, _mm_unpacklo_epi32(items, zero));
+        accumulator = _mm_add_epi64(accumulator, _mm_unpackhi_epi32(items, zero));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *) lanes, accumulator);
+
+    uint64_t sum = lanes[0] + lanes[1] - (is_signed ? 2147483648 * (uint64_t) nth : 0);
+
+    return (int64_t) sum + wasm_bulk_sum_scalar(data + nth, length - nth);
+}
+
+/**
+ * Sums 32-bit items, 8 at a time, zero-extended to 64-bit lanes.
+ */
+template <typename T>
+static WASM_TARGET_AVX2 int64_t wasm_bulk_sum_32_avx2(const T *data, size_t length)
+{
+    const bool is_signed = std::is_signed<T>::value;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i bias = _mm256_set1_epi32(is_signed ? std::numeric_limits<int32_t>::min() : 0);
+    __m256i accumulator = zero;
+    size_t nth = 0;
+
+    for (; nth + 8 <= length; nth += 8) {
+        __m256i items = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) (data + nth)), bias);
+        accumulator = _mm256_add_epi64(accumulator, _mm256_unpacklo_epi32(items, zero));
+        accumulator = _mm256_add_epi64(accumulator, _mm256_unpackhi_epi32(items, zero));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *) lanes, accumulator);
+
+    uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3] - (is_signed ? 2147483648 * (uint64_t) nth : 0);
+
+    return (int64_t) sum + wasm_bulk_sum_scalar(data + nth, length - nth);
+}
+
+/**
+ * Narrows `minimum` and `maximum` with 8-bit items, 16 at a time.
+ */
+template <typename T>
+static void wasm_bulk_min_max_8_sse2(const T *data, size_t length, T *minimum, T *maximum)
+{
+    size_t nth = 0;
+
+    if (length >= 16) {
+        const __m128i bias = _mm_set1_epi8(std::is_signed<T>::value ? -128 : 0);
+        __m128i minima = _mm_xor_si128(_mm_loadu_si128((const __m128i *) data), bias);
+        __m128i maxima = minima;
+
+        for (nth = 16; nth + 16 <= length; nth += 16) {
+            __m128i items = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (data + nth)), bias);
+            minima = _mm_min_epu8(minima, items);
+            maxima = _mm_max_epu8(maxima, items);
+        }
+
+        T lanes[16];
+        _mm_storeu_si128((__m128i *) lanes, _mm_xor_si128(minima, bias));
+        wasm_bulk_min_max_scalar(lanes, 16, minimum, maximum);
+        _mm_storeu_si128((__m128i *) lanes, _mm_xor_si128(maxima, bias));
+        wasm_bulk_min_max_scalar(lanes, 16, minimum, maximum);
+    }
+
+    wasm_bulk_min_max_scalar(data + nth, length - nth, minimum, maximum);
+}
+
+/**
+ * Narrows `minimum` and `maximum` with 8-bit items, 32 at a time.
+ */
+template <typename T>
+static WASM_TARGET_AVX2 void wasm_bulk_min_max_8_avx2(const T *data, size_t length, T *minimum, T *maximum)
+{
+    size_t nth = 0;
+
+    if (length >= 32) {
+        const __m256i bias = _mm256_set1_epi8(std::is_signed<T>::value ? -128 : 0);
+        __m256i minima = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) data), bias);
+        __m256i maxima = minima;
+
+        for (nth = 32; nth + 32 <= length; nth += 32) {
+            __m256i items = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) (data + nth)), bias);
+            minima = _mm256_min_epu8(minima, items);
+            maxima = _mm256_max_epu8(maxima, items);
+        }
+
+        T lanes[32];
+        _mm256_storeu_si256((__m256i *) lanes, _mm256_xor_si256(minima, bias));
+        wasm_bulk_min_max_scalar(lanes, 32, minimum, maximum);
+        _mm256_storeu_si256((__m256i *) lanes, _mm256_xor_si256(maxima, bias));
+        wasm_bulk_min_max_scalar(lanes, 32, minimum, maximum);
+    }
+
+    wasm_bulk_min_max_scalar(data + nth, length - nth, minimum, maximum);
+}
+
+/**
+ * Narrows `minimum` and `maximum` with 16-bit items, 8 at a time.
+ */
+template <typename T>
+static void wasm_bulk_min_max_16_sse2(const T *data, size_t length, T *minimum, T *maximum)
+{
+    size_t nth = 0;
+
+    if (length >= 8) {
+        const __m128i bias = _mm_set1_epi16(std::is_signed<T>::value ? 0 : std::numeric_limits<int16_t>::min());
+        __m128i minima = _mm_xor_si128(_mm_loadu_si128((const __m128i *) data), bias);
+        __m128i maxima = minima;
+
+        for (nth = 8; nth + 8 <= length; nth += 8) {
+            __m128i items = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (data + nth)), bias);
+            minima = _mm_min_epi16(minima, items);
+            maxima = _mm_max_epi16(maxima, items);
+        }
+
+        T lanes[8];
+        _mm_storeu_si128((__m128i *) lanes, _mm_xor_si128(minima, bias));
+        wasm_bulk_min_max_scalar(lanes, 8, minimum, maximum);
+        _mm_storeu_si128((__m128i *) lanes, _mm_xor_si128(maxima, bias));
+        wasm_bulk_min_max_scalar(lanes, 8, minimum, maximum);
+    }
+
+    wasm_bulk_min_max_scalar(data + nth, length - nth, minimum, maximum);
+}
+
+/**
+ * Narrows `minimum` and `maximum` with 16-bit items, 16 at a time.
+ */
+template <typename T>
+static WASM_TARGET_AVX2 void wasm_bulk_min_max_16_avx2(const T *data, size_t length, T *minimum, T *maximum)
+{
+    size_t nth = 0;
+
+    if (length >= 16) {
+        const __m256i bias = _mm256_set1_epi16(std::is_signed<T>::value ? 0 : std::numeric_limits<int16_t>::min());
+        __m256i minima = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) data), bias);
+        __m256i maxima = minima;
+
+        for (nth = 16; nth + 16 <= length; nth += 16) {
+            __m256i items = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) (data + nth)), bias);
+            minima = _mm256_min_epi16(minima, items);
+            maxima = _mm256_max_epi16(maxima, items);
+        }
+
+        T lanes[16];
+        _mm256_storeu_si256((__m256i *) lanes, _mm256_xor_si256(minima, bias));
+        wasm_bulk_min_max_scalar(lanes, 16, minimum, maximum);
+        _mm256_storeu_si256((__m256i *) lanes, _mm256_xor_si256(maxima, bias));
+        wasm_bulk_min_max_scalar(lanes, 16, minimum, maximum);
+    }
+
+    wasm_bulk_min_max_scalar(data + nth, length - nth, minimum, maximum);
+}
+
+/**
+ * Narrows `minimum` and `maximum` with 32-bit items, 4 at a time.
+ * SSE2 has no 32-bit `pminsd`, so it is emulated with a comparison
+ * and a blend.
+ */
+template <typename T>
+static void wasm_bulk_min_max_32_sse2(const T *data, size_t length, T *minimum, T *maximum)
+{
+    size_t nth = 0;
+
+    if (length >= 4) {
+        const __m128i bias = _mm_set1_epi32(std::is_signed<T>::value ? 0 : std::numeric_limits<int32_t>::min());
+        __m128i minima = _mm_xor_si128(_mm_loadu_si128((const __m128i *) data), bias);
+        __m128i maxima = minima;
+
+        for (nth = 4; nth + 4 <= length; nth += 4) {
+            __m128i items = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (data + nth)), bias);
+            __m128i smaller = _mm_cmpgt_epi32(minima, items);
+            __m128i greater = _mm_cmpgt_epi32(items, maxima);
+
+            minima = _mm_or_si128(_mm_and_si128(smaller, items), _mm_andnot_si128(smaller, minima));
+            maxima = _mm_or_si128(_mm_and_si128(greater, items), _mm_andnot_si128(greater, maxima));
+        }
+
+        T lanes[4];
+        _mm_storeu_si128((__m128i *) lanes, _mm_xor_si128(minima, bias));
+        wasm_bulk_min_max_scalar(lanes, 4, minimum, maximum);
+        _mm_storeu_si128((__m128i *) lanes, _mm_xor_si128(maxima, bias));
+        wasm_bulk_min_max_scalar(lanes, 4, minimum, maximum);
+    }
+
+    wasm_bulk_min_max_scalar(data + nth, length - nth, minimum, maximum);
+}
+
+/**
+ * Narrows `minimum` and `maximum` with 32-bit items, 8 at a time.
+ */
+template <typename T>
+static WASM_TARGET_AVX2 void wasm_bulk_min_max_32_avx2(const T *data, size_t length, T *minimum, T *maximum)
+{
+    size_t nth = 0;
+
+    if (length >= 8) {
+        const __m256i bias = _mm256_set1_epi32(std::is_signed<T>::value ? 0 : std::numeric_limits<int32_t>::min());
+        __m256i minima = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) data), bias);
+        __m256i maxima = minima;
+
+        for (nth = 8; nth + 8 <= length; nth += 8) {
+            __m256i items = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) (data + nth)), bias);
+            minima = _mm256_min_epi32(minima, items);
+            maxima = _mm256_max_epi32(maxima, items);
+        }
+
+        T lanes[8];
+        _mm256_storeu_si256((__m256i *) lanes, _mm256_xor_si256(minima, bias));
+        wasm_bulk_min_max_scalar(lanes, 8, minimum, maximum);
+        _mm256_storeu_si256((__m256i *) lanes, _mm256_xor_si256(maxima, bias));
+        wasm_bulk_min_max_scalar(lanes, 8, minimum, maximum);
+    }
+
+    wasm_bulk_min_max_scalar(data + nth, length - nth, minimum, maximum);
+}
+
+/**
+ * Finds the index of a 16-bit `needle`, 8 items at a time.
+ */
+template <typename T>
+static size_t wasm_bulk_index_of_16_sse2(const T *data, size_t length, T needle)
+{
+    const __m128i needles = _mm_set1_epi16((int16_t) needle);
+    size_t nth = 0;
+
+    for (; nth + 8 <= length; nth += 8) {
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *) (data + nth)), needles));
+
+        if (mask != 0) {
+            return nth + __builtin_ctz(mask) / 2;
+        }
+    }
+
+    return nth + wasm_bulk_index_of_scalar(data + nth, length - nth, needle);
+}
+
+/**
+ * Finds the index of a 16-bit `needle`, 16 items at a time.
+ */
+template <typename T>
+static WASM_TARGET_AVX2 size_t wasm_bulk_index_of_16_avx2(const T *data, size_t length, T needle)
+{
+    const __m256i needles = _mm256_set1_epi16((int16_t) needle);
+    size_t nth = 0;
+
+    for (; nth + 16 <= length; nth += 16) {
+        int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i *) (data + nth)), needles));
+
+        if (mask != 0) {
+            return nth + __builtin_ctz((unsigned int) mask) / 2;
+        }
+    }
+
+    return nth + wasm_bulk_index_of_scalar(data + nth, length - nth, needle);
+}
+
+/**
+ * Finds the index of a 32-bit `needle`, 4 items at a time.
+ */
+template <typename T>
+static size_t wasm_bulk_index_of_32_sse2(const T *data, size_t length, T needle)
+{
+    const __m128i needles = _mm_set1_epi32((int32_t) needle);
+    size_t nth = 0;
+
+    for (; nth + 4 <= length; nth += 4) {
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) (data + nth)), needles));
+
+        if (mask != 0) {
+            return nth + __builtin_ctz(mask) / 4;
+        }
+    }
+
+    return nth + wasm_bulk_index_of_scalar(data + nth, length - nth, needle);
+}
+
+/**
+ * Finds the index of a 32-bit `needle`, 8 items at a time.
+ */
+template <typename T>
+static WASM_TARGET_AVX2 size_t wasm_bulk_index_of_32_avx2(const T *data, size_t length, T needle)
+{
+    const __m256i needles = _mm256_set1_epi32((int32_t) needle);
+    size_t nth = 0;
+
+    for (; nth + 8 <= length; nth += 8) {
+        int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *) (data + nth)), needles));
+
+        if (mask != 0) {
+            return nth + __builtin_ctz((unsigned int) mask) / 4;
+        }
+    }
+
+    return nth + wasm_bulk_index_of_scalar(data + nth, length - nth, needle);
+}
+
+// Calls the AVX2 or the SSE2 variant of a kernel.
+#define WASM_BULK_DISPATCH(kernel, ...) \
+    (wasm_bulk_has_avx2 ? kernel##_avx2(__VA_ARGS__) : kernel##_sse2(__VA_ARGS__))
+
+#endif
+
+/**
+ * Sums `length` items with the fastest kernel available.
+ */
+template <typename T>
+static int64_t wasm_bulk_sum(const T *data, size_t length)
+{
+#if defined(WASM_BULK_X86_64)
+    switch (sizeof(T)) {
+        case 1:
+            return WASM_BULK_DISPATCH(wasm_bulk_sum_8, data, length);
+
+        case 2:
+            return WASM_BULK_DISPATCH(wasm_bulk_sum_16, data, length);
+
+        case 4:
+            return WASM_BULK_DISPATCH(wasm_bulk_sum_32, data, length);
+    }
+#endif
+
+    return wasm_bulk_sum_scalar(data, length);
+}
+
+/**
+ * Computes the minimum and the maximum of `length` items, with
+ * `length` greater than 0, with the fastest kernel available.
+ */
+template <typename T>
+static void wasm_bulk_min_max(const T *data, size_t length, T *minimum, T *maximum)
+{
+    *minimum = data[0];
+    *maximum = data[0];
+
+#if defined(WASM_BULK_X86_64)
+    switch (sizeof(T)) {
+        case 1:
+            WASM_BULK_DISPATCH(wasm_bulk_min_max_8, data, length, minimum, maximum);
+
+            return;
+
+        case 2:
+            WASM_BULK_DISPATCH(wasm_bulk_min_max_16, data, length, minimum, maximum);
+
+            return;
+
+        case 4:
+            WASM_BULK_DISPATCH(wasm_bulk_min_max_32, data, length, minimum, maximum);
+
+            return;
+    }
+#endif
+
+    wasm_bulk_min_max_scalar(data, length, minimum, maximum);
+}
+
+/**
+ * Finds the index of `needle` with the fastest kernel available.
+ * Returns `length` if `needle` is absent. 8-bit items are handled by
+ * `memchr`, which libc already vectorizes.
+ */
+template <typename T>
+static size_t wasm_bulk_index_of(const T *data, size_t length, T needle)
+{
+    if (sizeof(T) == 1) {
+        const void *found = memchr(data, (uint8_t) needle, length);
+
+        return found == NULL ? length : (size_t) ((const T *) found - data);
+    }
+
+#if defined(WASM_BULK_X86_64)
+    switch (sizeof(T)) {
+        case 2:
+            return WASM_BULK_DISPATCH(wasm_bulk_index_of_16, data, length, needle);
+
+        case 4:
+            return WASM_BULK_DISPATCH(wasm_bulk_index_of_32, data, length, needle);
+    }
+#endif
+
+    return wasm_bulk_index_of_scalar(data, length, needle);
+}
+
+/**
+ * Sets `length` items to `value`. Bytes and zeros are handled by
+ * `memset`. Other values are written once, doubled with `memcpy` up
+ * to a small block, and the block is then copied over the rest, so
+ * that the work is done by the vectorized libc routines.
+ */
+template <typename T>
+static void wasm_bulk_fill(T *data, size_t length, T value)
+{
+    if (length == 0) {
+        return;
+    }
+
+    if (sizeof(T) == 1 || value == 0) {
+        memset(data, (uint8_t) value, length * sizeof(T));
+
+        return;
+    }
+
+    const size_t block_length = std::min(length, (size_t) 4096 / sizeof(T));
+    size_t filled = 1;
+
+    data[0] = value;
+
+    while (filled < block_length) {
+        size_t chunk = std::min(filled, block_length - filled);
+
+        memcpy(data + filled, data, chunk * sizeof(T));
+        filled += chunk;
+    }
+
+    while (filled < length) {
+        size_t chunk = std::min(block_length, length - filled);
+
+        memcpy(data + filled, data, chunk * sizeof(T));
+        filled += chunk;
+    }
+}
+
+/**
+ * Resolves the `[start; end[` range of a bulk operation, in items,
+ * where a `null` end means the end of the view. Throws and returns
+ * `false` if the range does not fit in the view.
+ */
+static bool wasm_typed_array_range(
+    wasm_typed_array_object *wasm_typed_array_object,
+    zend_long start,
+    zend_long end,
+    bool end_is_null,
+    size_t *range_start,
+    size_t *range_length
+) {
+    if (end_is_null) {
+        end = (zend_long) wasm_typed_array_object->length;
+    }
+
+    if (start < 0 || end < start || (size_t) end > wasm_typed_array_object->length) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            0,
+            "Range must be within the view range [0; %zu]; given [%lld; %lld[.",
+            wasm_typed_array_object->length,
+            start,
+            end
+        );
+
+        return false;
+    }
+
+    *range_start = (size_t) start;
+    *range_length = (size_t) (end - start);
+
+    return true;
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmTypedArray::fill` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_fill, ZEND_RETURN_VALUE, ARITY(1), IS_VOID, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, value, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, start, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, end, IS_LONG, NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmTypedArray::fill` method.
+ *
+ * Sets all the items of `[$start; $end[` to `$value`, truncated to
+ * the type of the view like `offsetSet` does.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmUint16Array(new WasmArrayBuffer(42));
+ * $view->fill(7, 1, 4);
+ * assert($view[3] == 7);
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_fill)
+{
+    zend_long value;
+    zend_long start = 0;
+    zend_long end = 0;
+    zend_bool end_is_null = 1;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 3)
+        Z_PARAM_LONG(value)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(start)
+        Z_PARAM_LONG_EX(end, end_is_null, 1, 0)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+    size_t range_start;
+    size_t range_length;
+
+    if (!wasm_typed_array_range(wasm_typed_array_object, start, end, end_is_null, &range_start, &range_length)) {
+        return;
+    }
+
+    wasm_typed_array_view view = wasm_typed_array_write_view(wasm_typed_array_object);
+
+    switch (wasm_typed_array_object->kind) {
+        case wasm_typed_array_kind::INT8:
+            wasm_bulk_fill(view.as_int8 + range_start, range_length, (int8_t) value);
+
+            break;
+
+        case wasm_typed_array_kind::UINT8:
+            wasm_bulk_fill(view.as_uint8 + range_start, range_length, (uint8_t) value);
+
+            break;
+
+        case wasm_typed_array_kind::INT16:
+            wasm_bulk_fill(view.as_int16 + range_start, range_length, (int16_t) value);
+
+            break;
+
+        case wasm_typed_array_kind::UINT16:
+            wasm_bulk_fill(view.as_uint16 + range_start, range_length, (uint16_t) value);
+
+            break;
+
+        case wasm_typed_array_kind::INT32:
+            wasm_bulk_fill(view.as_int32 + range_start, range_length, (int32_t) value);
+
+            break;
+
+        case wasm_typed_array_kind::UINT32:
+            wasm_bulk_fill(view.as_uint32 + range_start, range_length, (uint32_t) value);
+
+            break;
+
+        default:
+            zend_throw_exception(zend_ce_exception, "Invalid WebAssembly typed array type.", 1);
+
+            return;
+    }
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmTypedArray::copyWithin` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_copy_within, ZEND_RETURN_VALUE, ARITY(1), IS_VOID, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, target, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, start, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, end, IS_LONG, NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmTypedArray::copyWithin` method.
+ *
+ * Copies the items of `[$start; $end[` to `$target`, like
+ * JavaScript's `TypedArray.prototype.copyWithin`. The ranges may
+ * overlap, and the copy is truncated at the end of the view.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmUint8Array(new WasmArrayBuffer(42));
+ * $view[0] = 1;
+ * $view->copyWithin(10, 0, 1);
+ * assert($view[10] == 1);
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_copy_within)
+{
+    zend_long target;
+    zend_long start = 0;
+    zend_long end = 0;
+    zend_bool end_is_null = 1;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 3)
+        Z_PARAM_LONG(target)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(start)
+        Z_PARAM_LONG_EX(end, end_is_null, 1, 0)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+    size_t range_start;
+    size_t range_length;
+
+    if (target < 0 || target > wasm_typed_array_object->length) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            0,
+            "Target is outside the view range [0; %zu]; given %lld.",
+            wasm_typed_array_object->length,
+            target
+        );
+
+        return;
+    }
+
+    if (!wasm_typed_array_range(wasm_typed_array_object, start, end, end_is_null, &range_start, &range_length)) {
+        return;
+    }
+
+    size_t bytes_per_element = wasm_typed_array_object->bytes_per_element;
+    size_t copied_length = std::min(range_length, wasm_typed_array_object->length - (size_t) target);
+
+    uint8_t *items = wasm_typed_array_write_view(wasm_typed_array_object).as_uint8;
+
+    memmove(
+        items + (size_t) target * bytes_per_element,
+        items + range_start * bytes_per_element,
+        copied_length * bytes_per_element
+    );
+}
+
+/**
+ * Returns the index of `value` in `[from; from + length[`, or -1 if
+ * it is absent, or if it cannot be represented by `T`.
+ */
+template <typename T>
+static zend_long wasm_typed_array_index_of(const T *data, size_t from, size_t length, zend_long value)
+{
+    if (value < (zend_long) std::numeric_limits<T>::min() || value > (zend_long) std::numeric_limits<T>::max()) {
+        return -1;
+    }
+
+    size_t index = wasm_bulk_index_of(data + from, length, (T) value);
+
+    return index == length ? -1 : (zend_long) (from + index);
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmTypedArray::indexOf` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_index_of, ZEND_RETURN_VALUE, ARITY(1), IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, value, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, from, IS_LONG, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmTypedArray::indexOf` method.
+ *
+ * Returns the index of the first item equal to `$value`, starting
+ * at `$from`, or -1 if there is none.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmUint8Array($instance->getMemoryBuffer(), $pointer, $length);
+ * $end_of_line = $view->indexOf(ord("\n"));
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_index_of)
+{
+    zend_long value;
+    zend_long from = 0;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 2)
+        Z_PARAM_LONG(value)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(from)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+    size_t range_start;
+    size_t range_length;
+
+    if (!wasm_typed_array_range(wasm_typed_array_object, from, 0, true, &range_start, &range_length)) {
+        return;
+    }
+
+    wasm_typed_array_view view = wasm_typed_array_read_view(wasm_typed_array_object);
+
+    switch (wasm_typed_array_object->kind) {
+        case wasm_typed_array_kind::INT8:
+            RETURN_LONG(wasm_typed_array_index_of(view.as_int8, range_start, range_length, value));
+
+        case wasm_typed_array_kind::UINT8:
+            RETURN_LONG(wasm_typed_array_index_of(view.as_uint8, range_start, range_length, value));
+
+        case wasm_typed_array_kind::INT16:
+            RETURN_LONG(wasm_typed_array_index_of(view.as_int16, range_start, range_length, value));
+
+        case wasm_typed_array_kind::UINT16:
+            RETURN_LONG(wasm_typed_array_index_of(view.as_uint16, range_start, range_length, value));
+
+        case wasm_typed_array_kind::INT32:
+            RETURN_LONG(wasm_typed_array_index_of(view.as_int32, range_start, range_length, value));
+
+        case wasm_typed_array_kind::UINT32:
+            RETURN_LONG(wasm_typed_array_index_of(view.as_uint32, range_start, range_length, value));
+
+        default:
+            zend_throw_exception(zend_ce_exception, "Invalid WebAssembly typed array type.", 1);
+
+            return;
+    }
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmTypedArray::sum` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_sum, ZEND_RETURN_VALUE, ARITY(0), IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, start, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, end, IS_LONG, NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmTypedArray::sum` method.
+ *
+ * Returns the sum of the items of `[$start; $end[`, computed on 64
+ * bits.
+ *
+ * # Usage
+ *
+ * ```php
+ * $counters = new WasmUint32Array($instance->getMemoryBuffer(), $pointer, $length);
+ * $total = $counters->sum();
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_sum)
+{
+    zend_long start = 0;
+    zend_long end = 0;
+    zend_bool end_is_null = 1;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 0, 2)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(start)
+        Z_PARAM_LONG_EX(end, end_is_null, 1, 0)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+    size_t range_start;
+    size_t range_length;
+
+    if (!wasm_typed_array_range(wasm_typed_array_object, start, end, end_is_null, &range_start, &range_length)) {
+        return;
+    }
+
+    wasm_typed_array_view view = wasm_typed_array_read_view(wasm_typed_array_object);
+
+    switch (wasm_typed_array_object->kind) {
+        case wasm_typed_array_kind::INT8:
+            RETURN_LONG(wasm_bulk_sum(view.as_int8 + range_start, range_length));
+
+        case wasm_typed_array_kind::UINT8:
+            RETURN_LONG(wasm_bulk_sum(view.as_uint8 + range_start, range_length));
+
+        case wasm_typed_array_kind::INT16:
+            RETURN_LONG(wasm_bulk_sum(view.as_int16 + range_start, range_length));
+
+        case wasm_typed_array_kind::UINT16:
+            RETURN_LONG(wasm_bulk_sum(view.as_uint16 + range_start, range_length));
+
+        case wasm_typed_array_kind::INT32:
+            RETURN_LONG(wasm_bulk_sum(view.as_int32 + range_start, range_length));
+
+        case wasm_typed_array_kind::UINT32:
+            RETURN_LONG(wasm_bulk_sum(view.as_uint32 + range_start, range_length));
+
+        default:
+            zend_throw_exception(zend_ce_exception, "Invalid WebAssembly typed array type.", 1);
+
+            return;
+    }
+}
+
+/**
+ * Returns the minimum or the maximum of the `[start; start + length[`
+ * items, with `length` greater than 0.
+ */
+template <typename T>
+static zend_long wasm_typed_array_min_max(const T *data, size_t start, size_t length, bool want_maximum)
+{
+    T minimum;
+    T maximum;
+
+    wasm_bulk_min_max(data + start, length, &minimum, &maximum);
+
+    return want_maximum ? (zend_long) maximum : (zend_long) minimum;
+}
+
+/**
+ * Implementation shared by the `WasmTypedArray::min` and
+ * `WasmTypedArray::max` methods.
+ */
+static void wasm_typed_array_min_max_method(INTERNAL_FUNCTION_PARAMETERS, bool want_maximum)
+{
+    zend_long start = 0;
+    zend_long end = 0;
+    zend_bool end_is_null = 1;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 0, 2)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(start)
+        Z_PARAM_LONG_EX(end, end_is_null, 1, 0)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+    size_t range_start;
+    size_t range_length;
+
+    if (!wasm_typed_array_range(wasm_typed_array_object, start, end, end_is_null, &range_start, &range_length)) {
+        return;
+    }
+
+    if (range_length == 0) {
+        RETURN_NULL();
+    }
+
+    wasm_typed_array_view view = wasm_typed_array_read_view(wasm_typed_array_object);
+
+    switch (wasm_typed_array_object->kind) {
+        case wasm_typed_array_kind::INT8:
+            RETURN_LONG(wasm_typed_array_min_max(view.as_int8, range_start, range_length, want_maximum));
+
+        case wasm_typed_array_kind::UINT8:
+            RETURN_LONG(wasm_typed_array_min_max(view.as_uint8, range_start, range_length, want_maximum));
+
+        case wasm_typed_array_kind::INT16:
+            RETURN_LONG(wasm_typed_array_min_max(view.as_int16, range_start, range_length, want_maximum));
+
+        case wasm_typed_array_kind::UINT16:
+            RETURN_LONG(wasm_typed_array_min_max(view.as_uint16, range_start, range_length, want_maximum));
+
+        case wasm_typed_array_kind::INT32:
+            RETURN_LONG(wasm_typed_array_min_max(view.as_int32, range_start, range_length, want_maximum));
+
+        case wasm_typed_array_kind::UINT32:
+            RETURN_LONG(wasm_typed_array_min_max(view.as_uint32, range_start, range_length, want_maximum));
+
+        default:
+            zend_throw_exception(zend_ce_exception, "Invalid WebAssembly typed array type.", 1);
+
+            return;
+    }
+}
+
+/**
+ * Declare the parameter information for the `WasmTypedArray::min`
+ * and `WasmTypedArray::max` methods.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_min_max, ZEND_RETURN_VALUE, ARITY(0), IS_LONG, NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, start, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, end, IS_LONG, NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmTypedArray::min` method.
+ *
+ * Returns the smallest item of `[$start; $end[`, or `null` if the
+ * range is empty.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmInt32Array($instance->getMemoryBuffer(), $pointer, $length);
+ * $lowest = $view->min();
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_min)
+{
+    wasm_typed_array_min_max_method(INTERNAL_FUNCTION_PARAM_PASSTHRU, false);
+}
+
+/**
+ * Declare the `WasmTypedArray::max` method.
+ *
+ * Returns the largest item of `[$start; $end[`, or `null` if the
+ * range is empty.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmInt32Array($instance->getMemoryBuffer(), $pointer, $length);
+ * $highest = $view->max();
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_max)
+{
+    wasm_typed_array_min_max_method(INTERNAL_FUNCTION_PARAM_PASSTHRU, true);
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmTypedArray::compare` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_compare, ZEND_RETURN_VALUE, ARITY(1), IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_INFO(0, other)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmTypedArray::compare` method.
+ *
+ * Compares the bytes of two typed arrays, of any kinds,
+ * lexicographically like `memcmp`; a view that is a prefix of the
+ * other is smaller. Returns -1, 0 or 1.
+ *
+ * # Usage
+ *
+ * ```php
+ * $left = new WasmUint8Array($buffer, 0, 16);
+ * $right = new WasmUint8Array($buffer, 16, 16);
+ * assert($left->compare($right) == 0);
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_compare)
+{
+    zval *other;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
+        Z_PARAM_OBJECT(other)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (Z_OBJ_HT_P(other) != &wasm_typed_array_class_entry_handlers) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            0,
+            "The argument must be a WebAssembly typed array; given an instance of `%s`.",
+            ZSTR_VAL(Z_OBJCE_P(other)->name)
+        );
+
+        return;
+    }
+
+    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+    wasm_typed_array_view view = wasm_typed_array_read_view(wasm_typed_array_object);
+    wasm_typed_array_object *other_wasm_typed_array_object = wasm_typed_array_object_from_zend_object(Z_OBJ_P(other));
+
+    size_t byte_length = wasm_typed_array_object->length * wasm_typed_array_object->bytes_per_element;
+    size_t other_byte_length = other_wasm_typed_array_object->length * other_wasm_typed_array_object->bytes_per_element;
+    int result = 0;
+
+    if (byte_length > 0 && other_byte_length > 0) {
+        result = memcmp(
+            view.as_uint8,
+            wasm_typed_array_read_view(other_wasm_typed_array_object).as_uint8,
+            std::min(byte_length, other_byte_length)
+        );
+    }
+
+    if (result == 0) {
+        result = byte_length < other_byte_length ? -1 : (byte_length > other_byte_length ? 1 : 0);
+    }
+
+    RETURN_LONG(result < 0 ? -1 : (result > 0 ? 1 : 0));
+}
+
+/**
+ * Declare the parameter information for the `WasmTypedArray::toBase64`
+ * and `WasmTypedArray::toHex` methods.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_encode, ZEND_RETURN_VALUE, ARITY(0), IS_STRING, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, start, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, end, IS_LONG, NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Implementation shared by the `WasmTypedArray::toBase64` and
+ * `WasmTypedArray::toHex` methods: resolves the bytes of the
+ * `[start; end[` items. Throws and returns `false` if the range does
+ * not fit in the view.
+ */
+static bool wasm_typed_array_encoding_range(INTERNAL_FUNCTION_PARAMETERS, const uint8_t **bytes, size_t *number_of_bytes)
+{
+    zend_long start = 0;
+    zend_long end = 0;
+    zend_bool end_is_null = 1;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 0, 2)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(start)
+        Z_PARAM_LONG_EX(end, end_is_null, 1, 0)
+    ZEND_PARSE_PARAMETERS_END_EX(return false);
+
+    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+    wasm_typed_array_view view = wasm_typed_array_read_view(wasm_typed_array_object);
+    size_t range_start;
+    size_t range_length;
+
+    if (!wasm_typed_array_range(wasm_typed_array_object, start, end, end_is_null, &range_start, &range_length)) {
+        return false;
+    }
+
+    size_t bytes_per_element = wasm_typed_array_object->bytes_per_element;
+
+    *bytes = view.as_uint8 + range_start * bytes_per_element;
+    *number_of_bytes = range_length * bytes_per_element;
+
+    return true;
+}
+
+/**
+ * Declare the `WasmTypedArray::toBase64` method.
+ *
+ * Encodes the bytes of the `[$start; $end[` items in base64, directly
+ * from the buffer into the resulting string.
+ *
+ * # Usage
+ *
+ * ```php
+ * $thumbnail = new WasmUint8Array($instance->getMemoryBuffer(), $pointer, $length);
+ * $response['thumbnail'] = $thumbnail->toBase64();
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_to_base64)
+{
+    const uint8_t *bytes;
+    size_t number_of_bytes;
+
+    if (!wasm_typed_array_encoding_range(INTERNAL_FUNCTION_PARAM_PASSTHRU, &bytes, &number_of_bytes)) {
+        return;
+    }
+
+    RETURN_NEW_STR(php_base64_encode(bytes, number_of_bytes));
+}
+
+/**
+ * Declare the `WasmTypedArray::toHex` method.
+ *
+ * Encodes the bytes of the `[$start; $end[` items in lowercase
+ * hexadecimal, directly from the buffer into the resulting string.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmUint8Array($instance->getMemoryBuffer(), $pointer, 4);
+ * assert($view->toHex() == 'deadbeef');
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_to_hex)
+{
+    const uint8_t *bytes;
+    size_t number_of_bytes;
+
+    if (!wasm_typed_array_encoding_range(INTERNAL_FUNCTION_PARAM_PASSTHRU, &bytes, &number_of_bytes)) {
+        return;
+    }
+
+    RETURN_NEW_STR(wasm_hexadecimal_encode(bytes, number_of_bytes));
+}
+
+/**
+ * Gets the `wasm_typed_array_object` an iterator walks through.
+ */
+static inline wasm_typed_array_object *wasm_typed_array_iterator_subject(zend_object_iterator *iterator)
+{
+    return wasm_typed_array_object_from_zend_object(Z_OBJ(iterator->data));
+}
+
+/**
+ * Iterator handler: releases the iterated typed array.
+ */
+static void wasm_typed_array_iterator_dtor(zend_object_iterator *iterator)
+{
+    zval_ptr_dtor(&iterator->data);
+}
+
+/**
+ * Iterator handler: checks whether the cursor is inside the view.
+ */
+static int wasm_typed_array_iterator_valid(zend_object_iterator *iterator)
+{
+    wasm_typed_array_iterator *wasm_typed_array_iterator = (wasm_typed_array_iterator *) iterator;
+
+    return wasm_typed_array_iterator->index < wasm_typed_array_iterator_subject(iterator)->length ? SUCCESS : FAILURE;
+}
+
+/**
+ * Iterator handler: reads the current item. The item is read from
+ * the buffer at each step, so writes made during the iteration, by
+ * PHP or by the guest, are always visible.
+ */
+static zval *wasm_typed_array_iterator_get_current_data(zend_object_iterator *iterator)
+{
+    wasm_typed_array_iterator *wasm_typed_array_iterator = (wasm_typed_array_iterator *) iterator;
+
+    ZVAL_LONG(
+        &wasm_typed_array_iterator->current,
+        wasm_typed_array_read_item(wasm_typed_array_iterator_subject(iterator), wasm_typed_array_iterator->index)
+    );
+
+    return &wasm_typed_array_iterator->current;
+}
+
+/**
+ * Iterator handler: gets the index of the current item.
+ */
+static void wasm_typed_array_iterator_get_current_key(zend_object_iterator *iterator, zval *key)
+{
+    ZVAL_LONG(key, ((wasm_typed_array_iterator *) iterator)->index);
+}
+
+/**
+ * Iterator handler: moves to the next item.
+ */
+static void wasm_typed_array_iterator_move_forward(zend_object_iterator *iterator)
+{
+    ++((wasm_typed_array_iterator *) iterator)->index;
+}
+
+/**
+ * Iterator handler: moves back to the first item.
+ */
+static void wasm_typed_array_iterator_rewind(zend_object_iterator *iterator)
+{
+    ((wasm_typed_array_iterator *) iterator)->index = 0;
+}
+
+// Handlers of the `WasmTypedArray` iterators.
+static zend_object_iterator_funcs wasm_typed_array_iterator_functions = {
+    wasm_typed_array_iterator_dtor,
+    wasm_typed_array_iterator_valid,
+    wasm_typed_array_iterator_get_current_data,
+    wasm_typed_array_iterator_get_current_key,
+    wasm_typed_array_iterator_move_forward,
+    wasm_typed_array_iterator_rewind,
+    NULL
+};
+
+/**
+ * Handler for a `zend_class_entry` to iterate over one of the
+ * `WasmTypedArray` objects with `foreach`, without calling any
+ * userland method.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmUint8Array($instance->getMemoryBuffer(), $pointer, $length);
+ *
+ * foreach ($view as $index => $item) {
+ *     // …
+ * }
+ * ```
+ */
+static zend_object_iterator *wasm_typed_array_get_iterator(zend_class_entry *class_entry, zval *object, int by_reference)
+{
+    if (by_reference) {
+        zend_throw_exception(zend_ce_exception, "A WebAssembly typed array cannot be iterated by reference.", 0);
+
+        return NULL;
+    }
+
+    wasm_typed_array_iterator *wasm_typed_array_iterator = (wasm_typed_array_iterator *) ecalloc(1, sizeof(wasm_typed_array_iterator));
+
+    zend_iterator_init(&wasm_typed_array_iterator->iterator);
+
+    ZVAL_COPY(&wasm_typed_array_iterator->iterator.data, object);
+    wasm_typed_array_iterator->iterator.funcs = &wasm_typed_array_iterator_functions;
+    wasm_typed_array_iterator->index = 0;
+    ZVAL_UNDEF(&wasm_typed_array_iterator->current);
+
+    return &wasm_typed_array_iterator->iterator;
+}
+
+/**
+ * Handler for a `zend_class_entry` to count the items of one of the
+ * `WasmTypedArray` objects, used by `count()`.
+ */
+static int count_wasm_typed_array_elements(zval *object, zend_long *count)
+{
+    *count = (zend_long) wasm_typed_array_object_from_zend_object(Z_OBJ_P(object))->length;
+
+    return SUCCESS;
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmTypedArray::count` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_count, ZEND_RETURN_VALUE, ARITY(0), IS_LONG, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmTypedArray::count` method, required by
+ * `Countable`. It is an alias of `getLength`.
+ *
+ * # Usage
+ *
+ * ```php
+ * $buffer = new WasmArrayBuffer(42);
+ * $view = new WasmUint16Array($buffer);
+ * assert(count($view) == 21);
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_count)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(WASM_TYPED_ARRAY_OBJECT_THIS()->length);
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmTypedArray::subarray` method.
+ */
+ZEND_BEGIN_ARG_INFO_EX(arginfo_wasmtypedarray_subarray, 0, ZEND_RETURN_VALUE, ARITY(0))
+    ZEND_ARG_TYPE_INFO(0, begin, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, end, IS_LONG, NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmTypedArray::subarray` method.
+ *
+ * Returns a new view of the same class over the `[$begin; $end[`
+ * items, sharing the same buffer. Only the range is checked: the
+ * offset, the length and the buffer of the new view are derived from
+ * this view.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmUint8Array(new WasmArrayBuffer(42));
+ * $view[3] = 7;
+ * $subview = $view->subarray(3, 10);
+ * assert($subview[0] == 7);
+ * ```
+ */
+PHP_FUNCTION(WasmTypedArray_subarray)
+{
+    zend_long begin = 0;
+    zend_long end = 0;
+    zend_bool end_is_null = 1;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 0, 2)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(begin)
+        Z_PARAM_LONG_EX(end, end_is_null, 1, 0)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+    size_t range_start;
+    size_t range_length;
+
+    if (!wasm_typed_array_range(wasm_typed_array_object, begin, end, end_is_null, &range_start, &range_length)) {
+        return;
+    }
+
+    object_init_ex(return_value, Z_OBJCE_P(getThis()));
+
+    wasm_typed_array_object *subarray_object = wasm_typed_array_object_from_zend_object(Z_OBJ_P(return_value));
+    size_t byte_offset = range_start * wasm_typed_array_object->bytes_per_element;
+
+    if (wasm_typed_array_object->wasm_array_buffer != NULL) {
+        subarray_object->wasm_array_buffer = wasm_typed_array_object->wasm_array_buffer;
+        GC_ADDREF(subarray_object->wasm_array_buffer);
+    }
+
+    subarray_object->offset = wasm_typed_array_object->offset + byte_offset;
+    subarray_object->length = range_length;
+}
+
+// Declare the methods of the `WasmTypedArray` classes with their information.
+static const zend_function_entry wasm_typed_array_methods[] = {
+    PHP_ME_MAPPING(__construct,		WasmTypedArray___construct,		arginfo_wasmtypedarray___construct, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(getOffset,		WasmTypedArray_get_offset,		arginfo_wasmtypedarray_get_offset, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(getLength,		WasmTypedArray_get_length,		arginfo_wasmtypedarray_get_length, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(offsetGet,		WasmTypedArray_offset_get,		arginfo_wasmtypedarray_offset_get, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(offsetSet,		WasmTypedArray_offset_set,		arginfo_wasmtypedarray_offset_set, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(offsetExists,	WasmTypedArray_offset_exists,	arginfo_wasmtypedarray_offset_exists, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(offsetUnset,		WasmTypedArray_offset_unset,	arginfo_wasmtypedarray_offset_unset, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(fill,			WasmTypedArray_fill,			arginfo_wasmtypedarray_fill, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(copyWithin,		WasmTypedArray_copy_within,		arginfo_wasmtypedarray_copy_within, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(indexOf,			WasmTypedArray_index_of,		arginfo_wasmtypedarray_index_of, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(sum,				WasmTypedArray_sum,				arginfo_wasmtypedarray_sum, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(min,				WasmTypedArray_min,				arginfo_wasmtypedarray_min_max, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(max,				WasmTypedArray_max,				arginfo_wasmtypedarray_min_max, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(compare,			WasmTypedArray_compare,			arginfo_wasmtypedarray_compare, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(toBase64,		WasmTypedArray_to_base64,		arginfo_wasmtypedarray_encode, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(toHex,			WasmTypedArray_to_hex,			arginfo_wasmtypedarray_encode, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(count,			WasmTypedArray_count,			arginfo_wasmtypedarray_count, ZEND_ACC_PUBLIC)
+    PHP_ME_MAPPING(subarray,		WasmTypedArray_subarray,		arginfo_wasmtypedarray_subarray, ZEND_ACC_PUBLIC)
+    PHP_FE_END
+};
+
+/**
+ * Reverses the bytes of a 16-bit integer.
+ */
+static inline uint16_t wasm_byte_swap_16(uint16_t value)
+{
+    return (uint16_t) ((value >> 8) | (value << 8));
+}
+
+/**
+ * Reverses the bytes of a 32-bit integer.
+ */
+static inline uint32_t wasm_byte_swap_32(uint32_t value)
+{
+    return ((value & 0x000000ff) << 24) |
+           ((value & 0x0000ff00) << 8) |
+           ((value & 0x00ff0000) >> 8) |
+           ((value & 0xff000000) >> 24);
+}
+
+/**
+ * Reverses the bytes of a 64-bit integer.
+ */
+static inline uint64_t wasm_byte_swap_64(uint64_t value)
+{
+    return ((uint64_t) wasm_byte_swap_32((uint32_t) value) << 32) | wasm_byte_swap_32((uint32_t) (value >> 32));
+}
+
+/**
+ * Reads the scalar kind from its userland name. Returns `false` if
+ * the name is unknown.
+ */
+static bool wasm_scalar_kind_from_name(const char *name, size_t name_length, wasm_scalar_kind *kind)
+{
+    static const struct {
+        const char *name;
+        wasm_scalar_kind kind;
+    } names[] = {
+        {"i8",	wasm_scalar_kind::INT8},
+        {"u8",	wasm_scalar_kind::UINT8},
+        {"i16",	wasm_scalar_kind::INT16},
+        {"u16",	wasm_scalar_kind::UINT16},
+        {"i32",	wasm_scalar_kind::INT32},
+        {"u32",	wasm_scalar_kind::UINT32},
+        {"i64",	wasm_scalar_kind::INT64},
+        {"f32",	wasm_scalar_kind::FLOAT32},
+        {"f64",	wasm_scalar_kind::FLOAT64},
+    };
+
+    for (size_t nth = 0; nth < sizeof(names) / sizeof(names[0]); ++nth) {
+        if (strlen(names[nth].name) == name_length && memcmp(names[nth].name, name, name_length) == 0) {
+            *kind = names[nth].kind;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Gets the size in bytes of a scalar kind.
+ */
+static inline size_t wasm_scalar_kind_size(wasm_scalar_kind kind)
+{
+    switch (kind) {
+        case wasm_scalar_kind::INT8:
+        case wasm_scalar_kind::UINT8:
+            return 1;
+
+        case wasm_scalar_kind::INT16:
+        case wasm_scalar_kind::UINT16:
+            return 2;
+
+        case wasm_scalar_kind::INT32:
+        case wasm_scalar_kind::UINT32:
+        case wasm_scalar_kind::FLOAT32:
+            return 4;
+
+        case wasm_scalar_kind::INT64:
+        case wasm_scalar_kind::FLOAT64:
+        default:
+            return 8;
+    }
+}
+
+/**
+ * Reads a scalar at an arbitrary byte address into a PHP value.
+ */
+static inline void wasm_scalar_load(const uint8_t *source, wasm_scalar_kind kind, bool little_endian, zval *value)
+{
+    bool swap = little_endian != WASM_HOST_IS_LITTLE_ENDIAN;
+
+    switch (kind) {
+        case wasm_scalar_kind::INT8:
+            ZVAL_LONG(value, (int8_t) *source);
+
+            break;
+
+        case wasm_scalar_kind::UINT8:
+            ZVAL_LONG(value, *source);
+
+            break;
+
+        case wasm_scalar_kind::INT16:
+        case wasm_scalar_kind::UINT16:
+        {
+            uint16_t bits;
+            memcpy(&bits, source, sizeof(bits));
+
+            if (swap) {
+                bits = wasm_byte_swap_16(bits);
+            }
+
+            if (kind == wasm_scalar_kind::INT16) {
+                ZVAL_LONG(value, (int16_t) bits);
+            } else {
+                ZVAL_LONG(value, bits);
+            }
+
+            break;
+        }
+
+        case wasm_scalar_kind::INT32:
+        case wasm_scalar_kind::UINT32:
+        case wasm_scalar_kind::FLOAT32:
+        {
+            uint32_t bits;
+            memcpy(&bits, source, sizeof(bits));
+
+            if (swap) {
+                bits = wasm_byte_swap_32(bits);
+            }
+
+            if (kind == wasm_scalar_kind::INT32) {
+                ZVAL_LONG(value, (int32_t) bits);
+            } else if (kind == wasm_scalar_kind::UINT32) {
+                ZVAL_LONG(value, bits);
+            } else {
+                float float_value;
+                memcpy(&float_value, &bits, sizeof(float_value));
+                ZVAL_DOUBLE(value, (double) float_value);
+            }
+
+            break;
+        }
+
+        case wasm_scalar_kind::INT64:
+        case wasm_scalar_kind::FLOAT64:
+        {
+            uint64_t bits;
+            memcpy(&bits, source, sizeof(bits));
+
+            if (swap) {
+                bits = wasm_byte_swap_64(bits);
+            }
+
+            if (kind == wasm_scalar_kind::INT64) {
+                ZVAL_LONG(value, (zend_long) (int64_t) bits);
+            } else {
+                double double_value;
+                memcpy(&double_value, &bits, sizeof(double_value));
+                ZVAL_DOUBLE(value, double_value);
+            }
+
+            break;
+        }
+    }
+}
+
+/**
+ * Writes a PHP value as a scalar at an arbitrary byte address.
+ * Integers are truncated to the size of the scalar.
+ */
+static inline void wasm_scalar_store(uint8_t *destination, wasm_scalar_kind kind, bool little_endian, zval *value)
+{
+    bool swap = little_endian != WASM_HOST_IS_LITTLE_ENDIAN;
+
+    switch (kind) {
+        case wasm_scalar_kind::INT8:
+        case wasm_scalar_kind::UINT8:
+            *destination = (uint8_t) zval_get_long(value);
+
+            break;
+
+        case wasm_scalar_kind::INT16:
+        case wasm_scalar_kind::UINT16:
+        {
+            uint16_t bits = (uint16_t) zval_get_long(value);
+
+            if (swap) {
+                bits = wasm_byte_swap_16(bits);
+            }
+
+            memcpy(destination, &bits, sizeof(bits));
+
+            break;
+        }
+
+        case wasm_scalar_kind::INT32:
+        case wasm_scalar_kind::UINT32:
+        case wasm_scalar_kind::FLOAT32:
+        {
+            uint32_t bits;
+
+            if (kind == wasm_scalar_kind::FLOAT32) {
+                float float_value = (float) zval_get_double(value);
+                memcpy(&bits, &float_value, sizeof(bits));
+            } else {
+                bits = (uint32_t) zval_get_long(value);
+            }
+
+            if (swap) {
+                bits = wasm_byte_swap_32(bits);
+            }
+
+            memcpy(destination, &bits, sizeof(bits));
+
+            break;
+        }
+
+        case wasm_scalar_kind::INT64:
+        case wasm_scalar_kind::FLOAT64:
+        {
+            uint64_t bits;
+
+            if (kind == wasm_scalar_kind::FLOAT64) {
+                double double_value = zval_get_double(value);
+                memcpy(&bits, &double_value, sizeof(bits));
+            } else {
+                bits = (uint64_t) zval_get_long(value);
+            }
+
+            if (swap) {
+                bits = wasm_byte_swap_64(bits);
+            }
+
+            memcpy(destination, &bits, sizeof(bits));
+
+            break;
+        }
+    }
+}
+
+/**
+ * Gets the `wasm_struct_view_object` pointer from a `zend_object` pointer.
+ */
+static inline wasm_struct_view_object *wasm_struct_view_object_from_zend_object(zend_object *object)
+{
+	return (wasm_struct_view_object *) ((char *)(object) - XtOffsetOf(wasm_struct_view_object, instance));
+}
+
+/**
+ * Function for a `zend_class_entry` to create a `WasmStructView` object.
+ */
+static zend_object *create_wasm_struct_view_object(zend_class_entry *class_entry)
+{
+    wasm_struct_view_object *wasm_struct_view = (wasm_struct_view_object *) ecalloc(
+        1,
+        sizeof(wasm_struct_view_object) + zend_object_properties_size(class_entry)
+    );
+    wasm_struct_view->wasm_array_buffer = NULL;
+    wasm_struct_view->layout = NULL;
+    wasm_struct_view->offset = 0;
+    wasm_struct_view->count = 0;
+
+    zend_object_std_init(&wasm_struct_view->instance, class_entry);
+    object_properties_init(&wasm_struct_view->instance, class_entry);
+
+    wasm_struct_view->instance.handlers = &wasm_struct_view_class_entry_handlers;
+
+    return &wasm_struct_view->instance;
+}
+
+/**
+ * Releases a compiled structure layout.
+ */
+static void wasm_struct_layout_release(wasm_struct_layout *layout)
+{
+    if (--layout->reference_count > 0) {
+        return;
+    }
+
+    for (uint32_t nth = 0; nth < layout->number_of_fields; ++nth) {
+        zend_string_release(layout->fields[nth].name);
+    }
+
+    efree(layout->fields);
+    efree(layout);
+}
+
+/**
+ * Handler for a `zend_class_entry` to free a `WasmStructView` object.
+ */
+static void free_wasm_struct_view_object(zend_object *object)
+{
+    wasm_struct_view_object *wasm_struct_view_object = wasm_struct_view_object_from_zend_object(object);
+
+    if (wasm_struct_view_object->layout != NULL) {
+        wasm_struct_layout_release(wasm_struct_view_object->layout);
+    }
+
+    if (wasm_struct_view_object->wasm_array_buffer != NULL) {
+        OBJ_RELEASE(wasm_struct_view_object->wasm_array_buffer);
+    }
+
+    zend_object_std_dtor(object);
+}
+
+/**
+ * Compiles a userland structure layout. Each item of the layout maps
+ * a field name to either a type name, e.g. `'i32'`, in which case
+ * the field is packed right after the previous field, or to a pair
+ * `[type name, offset]`. Throws and returns `NULL` if the layout is
+ * invalid.
+ */
+static wasm_struct_layout *wasm_struct_layout_compile(HashTable *description, zend_long stride)
+{
+    uint32_t number_of_fields = zend_hash_num_elements(description);
+
+    if (number_of_fields == 0) {
+        zend_throw_exception(zend_ce_exception, "The layout must contain at least one field.", 0);
+
+        return NULL;
+    }
+
+    wasm_struct_layout *layout = (wasm_struct_layout *) emalloc(sizeof(wasm_struct_layout));
+    layout->reference_count = 1;
+    layout->fields = (wasm_struct_field *) emalloc(sizeof(wasm_struct_field) * number_of_fields);
+    layout->number_of_fields = 0;
+    layout->stride = 0;
+
+    size_t packed_offset = 0;
+    zend_string *name;
+    zval *item;
+
+    ZEND_HASH_FOREACH_STR_KEY_VAL(description, name, item)
+        zval *type = item;
+        size_t offset = packed_offset;
+
+        ZVAL_DEREF(item);
+
+        if (name == NULL) {
+            zend_throw_exception(zend_ce_exception, "Field names must be strings.", 1);
+            wasm_struct_layout_release(layout);
+
+            return NULL;
+        }
+
+        // `[type name, offset]`.
+        if (Z_TYPE_P(item) == IS_ARRAY) {
+            zval *field_offset = zend_hash_index_find(Z_ARRVAL_P(item), 1);
+            type = zend_hash_index_find(Z_ARRVAL_P(item), 0);
+
+            if (type == NULL || field_offset == NULL || Z_TYPE_P(field_offset) != IS_LONG || Z_LVAL_P(field_offset) < 0) {
+                zend_throw_exception_ex(
+                    zend_ce_exception,
+                    2,
+                    "Field `%s` must be described by a type name, or a pair of a type name and a non-negative offset.",
+                    ZSTR_VAL(name)
+                );
+                wasm_struct_layout_release(layout);
+
+                return NULL;
+            }
+
+            offset = (size_t) Z_LVAL_P(field_offset);
+        }
+
+        ZVAL_DEREF(type);
+
+        wasm_scalar_kind kind;
+
+        if (Z_TYPE_P(type) != IS_STRING || !wasm_scalar_kind_from_name(Z_STRVAL_P(type), Z_STRLEN_P(type), &kind)) {
+            zend_throw_exception_ex(
+                zend_ce_exception,
+                3,
+                "Field `%s` has an unknown type; expect one of i8, u8, i16, u16, i32, u32, i64, f32, or f64.",
+                ZSTR_VAL(name)
+            );
+            wasm_struct_layout_release(layout);
+
+            return NULL;
+        }
+
+        wasm_struct_field *field = &layout->fields[layout->number_of_fields++];
+        field->name = zend_string_copy(name);
+        field->kind = kind;
+        field->offset = offset;
+
+        packed_offset = offset + wasm_scalar_kind_size(kind);
+
+        if (packed_offset > layout->stride) {
+            layout->stride = packed_offset;
+        }
+    ZEND_HASH_FOREACH_END();
+
+    if (stride < 0 || (stride > 0 && (size_t) stride < layout->stride)) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            4,
+            "Stride must be 0, or at least the size of a record; given %lld, record size is %zu.",
+            stride,
+            layout->stride
+        );
+        wasm_struct_layout_release(layout);
+
+        return NULL;
+    }
+
+    if (stride > 0) {
+        layout->stride = (size_t) stride;
+    }
+
+    return layout;
+}
+
+/**
+ * Binds a compiled layout to a region of a `WasmArrayBuffer`. Throws
+ * and returns `false` if the records do not fit in the buffer.
+ */
+static bool wasm_struct_view_bind(wasm_struct_view_object *wasm_struct_view_object, zend_object *wasm_array_buffer, wasm_struct_layout *layout, zend_long offset, zend_long count)
+{
+    wasm_array_buffer_object *wasm_array_buffer_object = wasm_array_buffer_object_from_zend_object(wasm_array_buffer);
+
+    if (offset < 0 || offset > wasm_array_buffer_object->buffer_length) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            5,
+            "Offset is outside the buffer range [0; %zu]; given %lld.",
+            wasm_array_buffer_object->buffer_length,
+            offset
+        );
+
+        return false;
+    }
+
+    size_t maximum_count = (wasm_array_buffer_object->buffer_length - offset) / layout->stride;
+
+    if (count < 0 || count > maximum_count) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            6,
+            "Count must be in the range [0; %zu]; given %lld.",
+            maximum_count,
+            count
+        );
+
+        return false;
+    }
+
+    wasm_struct_view_object->wasm_array_buffer = wasm_array_buffer;
+    GC_ADDREF(wasm_array_buffer);
+
+    wasm_struct_view_object->layout = layout;
+    ++layout->reference_count;
+
+    wasm_struct_view_object->offset = (size_t) offset;
+    wasm_struct_view_object->count = (size_t) count;
+
+    return true;
+}
+
+/**
+ * Gets the address of a record, or throws and returns `NULL` if the
+ * index is out of range. This is the only bound check of a record
+ * access.
+ */
+static inline uint8_t *wasm_struct_view_record(wasm_struct_view_object *wasm_struct_view_object, zend_long index, bool writable)
+{
+    if (index < 0 || index >= wasm_struct_view_object->count) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            0,
+            "Index is outside the view range [0; %zu[; given %lld.",
+            wasm_struct_view_object->count,
+            index
+        );
+
+        return NULL;
+    }
+
+    wasm_array_buffer_object *wasm_array_buffer_object = wasm_array_buffer_object_from_zend_object(wasm_struct_view_object->wasm_array_buffer);
+
+    if (writable) {
+        wasm_array_buffer_detach(wasm_array_buffer_object);
+    }
+
+    return
+        (uint8_t *) wasm_array_buffer_object->buffer +
+        wasm_struct_view_object->offset +
+        (size_t) index * wasm_struct_view_object->layout->stride;
+}
+
+/**
+ * Reads all the fields of a record into a new PHP array.
+ */
+static void wasm_struct_view_read_record(wasm_struct_layout *layout, const uint8_t *record, zval *array)
+{
+    array_init_size(array, layout->number_of_fields);
+
+    for (uint32_t nth = 0; nth < layout->number_of_fields; ++nth) {
+        wasm_struct_field *field = &layout->fields[nth];
+        zval value;
+
+        wasm_scalar_load(record + field->offset, field->kind, true, &value);
+        zend_hash_update(Z_ARRVAL_P(array), field->name, &value);
+    }
+}
+
+/**
+ * Finds a field by its name.
+ */
+static wasm_struct_field *wasm_struct_layout_find_field(wasm_struct_layout *layout, zend_string *name)
+{
+    for (uint32_t nth = 0; nth < layout->number_of_fields; ++nth) {
+        if (zend_string_equals(layout->fields[nth].name, name)) {
+            return &layout->fields[nth];
+        }
+    }
+
+    zend_throw_exception_ex(zend_ce_exception, 1, "The structure has no field named `%s`.", ZSTR_VAL(name));
+
+    return NULL;
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmStructView::__construct` method.
+ */
+ZEND_BEGIN_ARG_INFO_EX(arginfo_wasmstructview___construct, 0, ZEND_RETURN_VALUE, ARITY(2))
+    ZEND_ARG_OBJ_INFO(0, wasm_array_buffer, WasmArrayBuffer, NOT_NULLABLE)
+    ZEND_ARG_ARRAY_INFO(0, layout, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, offset, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, count, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, stride, IS_LONG, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmStructView::__construct` method.
+ *
+ * The layout is compiled once. Each field maps a name to a type name
+ * (packed right after the previous field), or to a pair of a type
+ * name and an offset inside the record. The stride, i.e. the size of
+ * a record, defaults to the end of the last field.
+ *
+ * # Usage
+ *
+ * ```php
+ * // struct point { int32_t x; int32_t y; double weight; }
+ * $buffer = new WasmArrayBuffer(256);
+ * $points = new WasmStructView(
+ *     $buffer,
+ *     ['x' => 'i32', 'y' => 'i32', 'weight' => ['f64', 8]],
+ *     $offset = 0,
+ *     $count = 4
+ * );
+ * ```
+ */
+PHP_METHOD(WasmStructView, __construct)
+{
+    zval *wasm_array_buffer;
+    HashTable *description;
+    zend_long offset = 0;
+    zend_long count = 1;
+    zend_long stride = 0;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 2, 5)
+        Z_PARAM_OBJECT_OF_CLASS(wasm_array_buffer, wasm_array_buffer_class_entry)
+        Z_PARAM_ARRAY_HT(description)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(offset)
+        Z_PARAM_LONG(count)
+        Z_PARAM_LONG(stride)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_struct_view_object *wasm_struct_view_object = WASM_STRUCT_VIEW_OBJECT_THIS();
+
+    if (wasm_struct_view_object->layout != NULL) {
+        zend_throw_exception(zend_ce_exception, "The struct view is already constructed.", 7);
+
+        return;
+    }
+
+    wasm_struct_layout *layout = wasm_struct_layout_compile(description, stride);
+
+    if (layout == NULL) {
+        return;
+    }
+
+    wasm_struct_view_bind(wasm_struct_view_object, Z_OBJ_P(wasm_array_buffer), layout, offset, count);
+    wasm_struct_layout_release(layout);
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmStructView::getOffset` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmstructview_get_offset, ZEND_RETURN_VALUE, ARITY(0), IS_LONG, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmStructView::getOffset` method.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmStructView($buffer, ['x' => 'i32'], 8);
+ * assert($view->getOffset() == 8);
+ * ```
+ */
+PHP_METHOD(WasmStructView, getOffset)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(WASM_STRUCT_VIEW_OBJECT_THIS()->offset);
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmStructView::getCount` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmstructview_get_count, ZEND_RETURN_VALUE, ARITY(0), IS_LONG, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmStructView::getCount` method.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmStructView($buffer, ['x' => 'i32'], 0, 3);
+ * assert($view->getCount() == 3);
+ * ```
+ */
+PHP_METHOD(WasmStructView, getCount)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(WASM_STRUCT_VIEW_OBJECT_THIS()->count);
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmStructView::getStride` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmstructview_get_stride, ZEND_RETURN_VALUE, ARITY(0), IS_LONG, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmStructView::getStride` method.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmStructView($buffer, ['x' => 'i32', 'y' => 'f64']);
+ * assert($view->getStride() == 12);
+ * ```
+ */
+PHP_METHOD(WasmStructView, getStride)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    wasm_struct_view_object *wasm_struct_view_object = WASM_STRUCT_VIEW_OBJECT_THIS();
+
+    RETURN_LONG(wasm_struct_view_object->layout == NULL ? 0 : wasm_struct_view_object->layout->stride);
+}
+
+/**
+ * Declare the parameter information for the `WasmStructView::read`
+ * method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmstructview_read, ZEND_RETURN_VALUE, ARITY(0), IS_ARRAY, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, index, IS_LONG, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmStructView::read` method.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmStructView($buffer, ['x' => 'i32', 'y' => 'i32'], 0, 4);
+ * ['x' => $x, 'y' => $y] = $view->read(2);
+ * ```
+ */
+PHP_METHOD(WasmStructView, read)
+{
+    zend_long index = 0;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(index)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_struct_view_object *wasm_struct_view_object = WASM_STRUCT_VIEW_OBJECT_THIS();
+    uint8_t *record = wasm_struct_view_record(wasm_struct_view_object, index, false);
+
+    if (record == NULL) {
+        return;
+    }
+
+    wasm_struct_view_read_record(wasm_struct_view_object->layout, record, return_value);
+}
+
+/**
+ * Declare the parameter information for the
+ * `WasmStructView::readAll` method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmstructview_read_all, ZEND_RETURN_VALUE, ARITY(0), IS_ARRAY, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmStructView::readAll` method.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmStructView($buffer, ['x' => 'i32', 'y' => 'i32'], 0, 4);
+ *
+ * foreach ($view->readAll() as ['x' => $x, 'y' => $y]) {
+ *     // …
+ * }
+ * ```
+ */
+PHP_METHOD(WasmStructView, readAll)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    wasm_struct_view_object *wasm_struct_view_object = WASM_STRUCT_VIEW_OBJECT_THIS();
+    size_t count = wasm_struct_view_object->count;
+
+    array_init_size(return_value, (uint32_t) count);
+
+    if (count == 0) {
+        return;
+    }
+
+    uint8_t *record = wasm_struct_view_record(wasm_struct_view_object, 0, false);
+
+    for (size_t nth = 0; nth < count; ++nth) {
+        zval item;
+
+        wasm_struct_view_read_record(wasm_struct_view_object->layout, record, &item);
+        zend_hash_next_index_insert_new(Z_ARRVAL_P(return_value), &item);
+
+        record += wasm_struct_view_object->layout->stride;
+    }
+}
+
+/**
+ * Declare the parameter information for the `WasmStructView::write`
+ * method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmstructview_write, ZEND_RETURN_VALUE, ARITY(2), IS_VOID, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, index, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_ARRAY_INFO(0, record, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmStructView::write` method.
+ *
+ * Only the fields present in the given record are written.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmStructView($buffer, ['x' => 'i32', 'y' => 'i32'], 0, 4);
+ * $view->write(2, ['x' => 7, 'y' => 42]);
+ * ```
+ */
+PHP_METHOD(WasmStructView, write)
+{
+    zend_long index;
+    HashTable *record_values;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 2, 2)
+        Z_PARAM_LONG(index)
+        Z_PARAM_ARRAY_HT(record_values)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_struct_view_object *wasm_struct_view_object = WASM_STRUCT_VIEW_OBJECT_THIS();
+    uint8_t *record = wasm_struct_view_record(wasm_struct_view_object, index, true);
+
+    if (record == NULL) {
+        return;
+    }
+
+    wasm_struct_layout *layout = wasm_struct_view_object->layout;
+
+    for (uint32_t nth = 0; nth < layout->number_of_fields; ++nth) {
+        wasm_struct_field *field = &layout->fields[nth];
+        zval *value = zend_hash_find(record_values, field->name);
+
+        if (value != NULL) {
+            ZVAL_DEREF(value);
+            wasm_scalar_store(record + field->offset, field->kind, true, value);
+        }
+    }
+}
+
+/**
+ * Declare the parameter information for the `WasmStructView::get`
+ * method.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmstructview_get, ZEND_RETURN_VALUE, ARITY(2), _IS_NUMBER, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, index, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, field, IS_STRING, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
+
+/**
+ * Declare the `WasmStructView::get` method.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmStructView($buffer, ['x' => 'i32', 'y' => 'i32'], 0, 4);
+ * $y = $view->get(2, 'y');
+ * ```
+ */
+PHP_METHOD(WasmStructView, get)
+{
+    zend_long index;
+    zend_string *name;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 2, 2)
+        Z_PARAM_LONG(index)
+        Z_PARAM_STR(name)
+    ZEND_PARSE_PARAMETERS_END();
+
+    wasm_struct_view_object *wasm_struct_view_object = WASM_STRUCT_VIEW_OBJECT_THIS();
+    uint8_t *record = wasm_struct_view_record(wasm_struct_view_object, index, false);
+
+    if (record == NULL) {
+        return;
+    }
+
+    wasm_struct_field *field = wasm_struct_layout_find_field(wasm_struct_view_object->layout, name);
+
+    if (field == NULL) {
+        return;
+    }
+
+    wasm_scalar_load(record + field->offset, field->kind, true, return_value);
 }
 
 /**
- * Declare the parameter information for the
- * `wasm_get_memory_buffer` function.
+ * Declare the parameter information for the `WasmStructView::set`
+ * method.
  */
-ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(arginfo_wasm_get_memory_buffer, ZEND_RETURN_REFERENCE, ARITY(1), WasmArrayBuffer, NULLABLE)
-    ZEND_ARG_TYPE_INFO(0, wasm_instance, IS_RESOURCE, NOT_NULLABLE)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmstructview_set, ZEND_RETURN_VALUE, ARITY(3), IS_VOID, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, index, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, field, IS_STRING, NOT_NULLABLE)
+    ZEND_ARG_INFO(0, value)
 ZEND_END_ARG_INFO()
 
 /**
- * Declare the `wasm_get_memory_buffer` function.
+ * Declare the `WasmStructView::set` method.
  *
  * # Usage
  *
  * ```php
- * $bytes = wasm_fetch_bytes('my_program.wasm');
- * $instance = wasm_new_instance($bytes);
- * $memory = wasm_get_memory_buffer($instance);
- * $view = new WasmUint8Array($memory);
- * // enjoy!
+ * $view = new WasmStructView($buffer, ['x' => 'i32', 'y' => 'i32'], 0, 4);
+ * $view->set(2, 'y', 42);
  * ```
  */
-PHP_FUNCTION(wasm_get_memory_buffer)
+PHP_METHOD(WasmStructView, set)
 {
-    zval *wasm_instance_resource;
+    zend_long index;
+    zend_string *name;
+    zval *value;
 
-    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
-        Z_PARAM_RESOURCE(wasm_instance_resource)
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 3, 3)
+        Z_PARAM_LONG(index)
+        Z_PARAM_STR(name)
+        Z_PARAM_ZVAL(value)
     ZEND_PARSE_PARAMETERS_END();
 
-    // Extract the Wasm instance from the resource.
-    wasmer_instance_t *wasm_instance = wasm_instance_from_resource(Z_RES_P(wasm_instance_resource));
-
-    if (NULL == wasm_instance) {
-        RETURN_NULL();
-    }
-
-    // Read all the export definitions (of all kinds).
-    wasmer_exports_t *wasm_exports = NULL;
-    wasmer_instance_exports(wasm_instance, &wasm_exports);
-
-    int number_of_exports = wasmer_exports_len(wasm_exports);
-
-    // There is no export definition.
-    if (number_of_exports == 0) {
-        wasmer_exports_destroy(wasm_exports);
-
-        RETURN_NULL();
-    }
-
-    // Look for a memory in the export definitions.
-    wasmer_memory_t *wasm_memory = NULL;
-
-    for (uint32_t nth = 0; nth < number_of_exports; ++nth) {
-        wasmer_export_t *wasm_export = wasmer_exports_get(wasm_exports, nth);
-        wasmer_import_export_kind wasm_export_kind = wasmer_export_kind(wasm_export);
-
-        // Not a memory definition, let's continue.
-        if (wasm_export_kind != wasmer_import_export_kind::WASM_MEMORY) {
-            continue;
-        }
+    wasm_struct_view_object *wasm_struct_view_object = WASM_STRUCT_VIEW_OBJECT_THIS();
+    uint8_t *record = wasm_struct_view_record(wasm_struct_view_object, index, true);
 
-        // Get the memory instance from the export.
-        if (wasmer_export_to_memory(wasm_export, &wasm_memory) == wasmer_result_t::WASMER_OK) {
-            break;
-        }
+    if (record == NULL) {
+        return;
     }
 
-    wasmer_exports_destroy(wasm_exports);
+    wasm_struct_field *field = wasm_struct_layout_find_field(wasm_struct_view_object->layout, name);
 
-    // Gotcha?
-    if (wasm_memory == NULL) {
-        RETURN_NULL();
+    if (field == NULL) {
+        return;
     }
 
-    // Get the memory data and its length.
-    uint8_t *wasm_memory_data = wasmer_memory_data(wasm_memory);
-    uint32_t wasm_memory_data_length = wasmer_memory_data_length(wasm_memory);
-
-    // Create a `WasmArrayBuffer` object.
-    zend_object *wasm_array_buffer = create_wasm_array_buffer_object(wasm_array_buffer_class_entry);
-    wasm_array_buffer_object *wasm_array_buffer_object = wasm_array_buffer_object_from_zend_object(wasm_array_buffer);
-
-    // Set the internal buffer of `WasmArrayBuffer`.
-    wasm_array_buffer_object->buffer = (int8_t *) wasm_memory_data;
-    wasm_array_buffer_object->buffer_length = (size_t) wasm_memory_data_length;
-
-    // Do not free the buffer, it's not allocated by PHP.
-    wasm_array_buffer_object->allocated_buffer = false;
-
-    // Return the `WasmArrayBuffer` instance.
-    ZVAL_OBJ(return_value, &wasm_array_buffer_object->instance);
+    wasm_scalar_store(record + field->offset, field->kind, true, value);
 }
 
 /**
- * Declare the parameter information for the `wasm_get_last_error`
- * function.
+ * Declare the parameter information for the `WasmStructView::at`
+ * method.
  */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasm_get_last_error, ZEND_RETURN_VALUE, ARITY(0), IS_STRING, NULLABLE)
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(arginfo_wasmstructview_at, ZEND_RETURN_VALUE, ARITY(1), WasmStructView, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, offset, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, count, IS_LONG, NOT_NULLABLE)
 ZEND_END_ARG_INFO()
 
 /**
- * Declare the `wasm_get_last_error` function.
+ * Declare the `WasmStructView::at` method.
+ *
+ * Creates a new view with the same, already compiled, layout over the
+ * same buffer, but at another offset. It is handy to read structures
+ * returned by several calls to a guest.
  *
  * # Usage
  *
  * ```php
- * $error = wasm_get_last_error();
+ * $points = new WasmStructView($memory, ['x' => 'i32', 'y' => 'i32'], 0, 0);
+ *
+ * $triangle = $points->at($instance->get_triangle(), 3);
+ * $square = $points->at($instance->get_square(), 4);
  * ```
  */
-PHP_FUNCTION(wasm_get_last_error)
+PHP_METHOD(WasmStructView, at)
 {
-    ZEND_PARSE_PARAMETERS_NONE();
+    zend_long offset;
+    zend_long count = 1;
 
-    int error_message_length = wasmer_last_error_length();
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 2)
+        Z_PARAM_LONG(offset)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(count)
+    ZEND_PARSE_PARAMETERS_END();
 
-    if (error_message_length == 0) {
-        RETURN_NULL();
-    }
+    wasm_struct_view_object *wasm_struct_view_object = WASM_STRUCT_VIEW_OBJECT_THIS();
 
-    char *error_message = (char *) emalloc(error_message_length);
-    wasmer_last_error_message(error_message, error_message_length);
+    if (wasm_struct_view_object->layout == NULL) {
+        zend_throw_exception(zend_ce_exception, "The struct view is not constructed.", 7);
 
-    ZVAL_STRINGL(return_value, error_message, error_message_length - 1);
+        return;
+    }
+
+    object_init_ex(return_value, Z_OBJCE_P(getThis()));
+
+    if (!wasm_struct_view_bind(
+        wasm_struct_view_object_from_zend_object(Z_OBJ_P(return_value)),
+        wasm_struct_view_object->wasm_array_buffer,
+        wasm_struct_view_object->layout,
+        offset,
+        count
+    )) {
+        zval_ptr_dtor(return_value);
+        ZVAL_UNDEF(return_value);
+    }
 }
 
-// Declare the functions with their information.
-static const zend_function_entry wasm_functions[] = {
-    PHP_FE(wasm_fetch_bytes,							arginfo_wasm_fetch_bytes)
-    PHP_FE(wasm_validate,								arginfo_wasm_validate)
-    PHP_FE(wasm_compile,								arginfo_wasm_compile)
-    PHP_FE(wasm_module_clean_up_persistent_resources,	arginfo_wasm_module_clean_up_persistent_resources)
-    PHP_FE(wasm_module_new_instance,					arginfo_wasm_module_new_instance)
-    PHP_FE(wasm_module_serialize,						arginfo_wasm_module_serialize)
-    PHP_FE(wasm_module_deserialize,						arginfo_wasm_module_deserialize)
-    PHP_FE(wasm_new_instance,							arginfo_wasm_new_instance)
-    PHP_FE(wasm_value,									arginfo_wasm_value)
-    PHP_FE(wasm_invoke_function,						arginfo_wasm_invoke_function)
-    PHP_FE(wasm_get_memory_buffer,						arginfo_wasm_get_memory_buffer)
-    PHP_FE(wasm_get_last_error,							arginfo_wasm_get_last_error)
+// Declare the methods of the `WasmStructView` class with their information.
+static const zend_function_entry wasm_struct_view_methods[] = {
+    PHP_ME(WasmStructView, __construct,	arginfo_wasmstructview___construct, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmStructView, getOffset,	arginfo_wasmstructview_get_offset, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmStructView, getCount,	arginfo_wasmstructview_get_count, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmStructView, getStride,	arginfo_wasmstructview_get_stride, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmStructView, read,		arginfo_wasmstructview_read, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmStructView, readAll,		arginfo_wasmstructview_read_all, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmStructView, write,		arginfo_wasmstructview_write, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmStructView, get,			arginfo_wasmstructview_get, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmStructView, set,			arginfo_wasmstructview_set, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmStructView, at,			arginfo_wasmstructview_at, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
 
 /**
- * Gets the `wasm_typed_array_object` pointer from a `zend_object` pointer.
+ * Gets the `wasm_data_view_object` pointer from a `zend_object` pointer.
  */
-static inline wasm_typed_array_object *wasm_typed_array_object_from_zend_object(zend_object *object)
+static inline wasm_data_view_object *wasm_data_view_object_from_zend_object(zend_object *object)
 {
-	return (wasm_typed_array_object *) ((char *)(object) - XtOffsetOf(wasm_typed_array_object, instance));
+	return (wasm_data_view_object *) ((char *)(object) - XtOffsetOf(wasm_data_view_object, instance));
 }
 
 /**
- * Function for a `zend_class_entry` to create one of the `WasmTypedArray` objects.
+ * Function for a `zend_class_entry` to create a `WasmDataView` object.
  */
-static zend_object *create_wasm_typed_array_object(zend_class_entry *class_entry)
+static zend_object *create_wasm_data_view_object(zend_class_entry *class_entry)
 {
-    wasm_typed_array_object *wasm_typed_array = (wasm_typed_array_object *) ecalloc(
+    wasm_data_view_object *wasm_data_view = (wasm_data_view_object *) ecalloc(
         1,
-        sizeof(wasm_typed_array_object) + zend_object_properties_size(class_entry)
+        sizeof(wasm_data_view_object) + zend_object_properties_size(class_entry)
     );
-    wasm_typed_array->wasm_array_buffer = NULL;
-    wasm_typed_array->offset = 0;
-    wasm_typed_array->length = 0;
-
-    zend_object_std_init(&wasm_typed_array->instance, class_entry);
-    object_properties_init(&wasm_typed_array->instance, class_entry);
-
-    {
-        zend_class_entry *base_class_entry = class_entry;
-
-        while (base_class_entry->parent) {
-            base_class_entry = base_class_entry->parent;
-        }
+    wasm_data_view->wasm_array_buffer = NULL;
+    wasm_data_view->offset = 0;
+    wasm_data_view->length = 0;
 
-        if (base_class_entry == wasm_typed_array_int8_class_entry) {
-            wasm_typed_array->kind = wasm_typed_array_kind::INT8;
-        } else if (base_class_entry == wasm_typed_array_uint8_class_entry) {
-            wasm_typed_array->kind = wasm_typed_array_kind::UINT8;
-        } else if (base_class_entry == wasm_typed_array_int16_class_entry) {
-            wasm_typed_array->kind = wasm_typed_array_kind::INT16;
-        } else if (base_class_entry == wasm_typed_array_uint16_class_entry) {
-            wasm_typed_array->kind = wasm_typed_array_kind::UINT16;
-        } else if (base_class_entry == wasm_typed_array_int32_class_entry) {
-            wasm_typed_array->kind = wasm_typed_array_kind::INT32;
-        } else if (base_class_entry == wasm_typed_array_uint32_class_entry) {
-            wasm_typed_array->kind = wasm_typed_array_kind::UINT32;
-        } else {
-            zend_error(E_ERROR, "WebAssembly buffer view has an unknown type.");
-        }
-    }
+    zend_object_std_init(&wasm_data_view->instance, class_entry);
+    object_properties_init(&wasm_data_view->instance, class_entry);
 
-    wasm_typed_array->instance.handlers = &wasm_typed_array_class_entry_handlers;
+    wasm_data_view->instance.handlers = &wasm_data_view_class_entry_handlers;
 
-    return &wasm_typed_array->instance;
+    return &wasm_data_view->instance;
 }
 
 /**
- * Handler for a `zend_class_entry` to destroy (i.e. call the
- * destructor on the userland) of one of the `WasmTypedArray` objects.
+ * Handler for a `zend_class_entry` to free a `WasmDataView` object.
  */
-static void destroy_wasm_typed_array_object(zend_object *object)
+static void free_wasm_data_view_object(zend_object *object)
 {
-    zend_objects_destroy_object(object);
+    wasm_data_view_object *wasm_data_view_object = wasm_data_view_object_from_zend_object(object);
+
+    if (wasm_data_view_object->wasm_array_buffer != NULL) {
+        OBJ_RELEASE(wasm_data_view_object->wasm_array_buffer);
+    }
+
+    zend_object_std_dtor(object);
 }
 
 /**
- * Handler for a `zend_class_entry` to free one of the `WasmTypedArray` objects.
+ * Gets the address of `size` bytes at `byte_offset` in the view, or
+ * throws and returns `NULL` if they are outside the view.
  */
-static void free_wasm_typed_array_object(zend_object *object)
+static inline uint8_t *wasm_data_view_address(wasm_data_view_object *wasm_data_view_object, zend_long byte_offset, size_t size, bool writable)
 {
-    wasm_typed_array_object *wasm_typed_array_object = wasm_typed_array_object_from_zend_object(object);
+    if (wasm_data_view_object->wasm_array_buffer == NULL) {
+        zend_throw_exception(zend_ce_exception, "The data view is not constructed.", 1);
 
-    if (wasm_typed_array_object->wasm_array_buffer != NULL) {
-        zval_ptr_dtor(wasm_typed_array_object->wasm_array_buffer);
+        return NULL;
     }
 
-    zend_object_std_dtor(object);
+    if (byte_offset < 0 || size > wasm_data_view_object->length || (size_t) byte_offset > wasm_data_view_object->length - size) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            0,
+            "Offset is outside the view range; given %lld for %zu byte(s), view length is %zu.",
+            byte_offset,
+            size,
+            wasm_data_view_object->length
+        );
+
+        return NULL;
+    }
+
+    wasm_array_buffer_object *wasm_array_buffer_object = wasm_array_buffer_object_from_zend_object(wasm_data_view_object->wasm_array_buffer);
+
+    if (writable) {
+        wasm_array_buffer_detach(wasm_array_buffer_object);
+    }
+
+    return (uint8_t *) wasm_array_buffer_object->buffer + wasm_data_view_object->offset + byte_offset;
 }
 
 /**
  * Declare the parameter information for the
- * `WasmTypedArray::__construct` method.
+ * `WasmDataView::__construct` method.
  */
-ZEND_BEGIN_ARG_INFO_EX(arginfo_wasmtypedarray___construct, 0, ZEND_RETURN_VALUE, ARITY(1))
+ZEND_BEGIN_ARG_INFO_EX(arginfo_wasmdataview___construct, 0, ZEND_RETURN_VALUE, ARITY(1))
     ZEND_ARG_OBJ_INFO(0, wasm_array_buffer, WasmArrayBuffer, NOT_NULLABLE)
-    ZEND_ARG_TYPE_INFO(0, offset, IS_LONG, NOT_NULLABLE)
-    ZEND_ARG_TYPE_INFO(0, length, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, byte_offset, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, byte_length, IS_LONG, NOT_NULLABLE)
 ZEND_END_ARG_INFO()
 
 /**
- * Declare the `WasmTypedArray::__construct` method.
+ * Declare the `WasmDataView::__construct` method.
  *
  * # Usage
  *
  * ```php
  * $buffer = new WasmArrayBuffer(256);
- * $offset = 1;
- * $length = 7;
- * $uint8 = new WasmUint8Array($buffer, $offset, $length);
+ * $view = new WasmDataView($buffer, 3, 16);
  * ```
  */
-PHP_FUNCTION(WasmTypedArray___construct)
+PHP_METHOD(WasmDataView, __construct)
 {
     zval *wasm_array_buffer;
-    zend_long offset = 0;
-    zend_long length = 0;
+    zend_long byte_offset = 0;
+    zend_long byte_length = 0;
 
     ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 3)
-        Z_PARAM_OBJECT_OF_CLASS(wasm_array_buffer, wasm_array_buffer_class_entry);
+        Z_PARAM_OBJECT_OF_CLASS(wasm_array_buffer, wasm_array_buffer_class_entry)
         Z_PARAM_OPTIONAL
-        Z_PARAM_LONG(offset)
-        Z_PARAM_LONG(length)
+        Z_PARAM_LONG(byte_offset)
+        Z_PARAM_LONG(byte_length)
     ZEND_PARSE_PARAMETERS_END();
 
-    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+    wasm_data_view_object *wasm_data_view_object = WASM_DATA_VIEW_OBJECT_THIS();
     wasm_array_buffer_object *wasm_array_buffer_object = wasm_array_buffer_object_from_zend_object(Z_OBJ_P(wasm_array_buffer));
 
-    if (offset < 0) {
-        zend_throw_exception_ex(zend_ce_exception, 0, "Offset must be non-negative; given %lld.", offset);
+    if (wasm_data_view_object->wasm_array_buffer != NULL) {
+        zend_throw_exception(zend_ce_exception, "The data view is already constructed.", 3);
 
         return;
     }
 
-    if (offset > wasm_array_buffer_object->buffer_length) {
+    if (byte_offset < 0 || byte_offset > wasm_array_buffer_object->buffer_length) {
         zend_throw_exception_ex(
             zend_ce_exception,
-            1,
-            "Offset must be smaller than the array buffer length; given %lld, buffer length is %zu.",
-            offset,
-            wasm_array_buffer_object->buffer_length
+            0,
+            "Offset is outside the buffer range [0; %zu]; given %lld.",
+            wasm_array_buffer_object->buffer_length,
+            byte_offset
         );
 
         return;
     }
 
-    if (length < 0) {
-        zend_throw_exception_ex(zend_ce_exception, 2, "Length must be non-negative; given %lld.", length);
-
-        return;
-    }
-
-    // Assign the `WasmArrayBuffer` in the `WasmTypedArray`.
-    wasm_typed_array_object->wasm_array_buffer = wasm_array_buffer;
-    Z_ADDREF_P(wasm_array_buffer);
-
-    // Assign the offset.
-    wasm_typed_array_object->offset = (size_t) offset;
-
-    // Assign the length.
-    {
-        size_t bytes_per_buffer_item;
-
-        switch (wasm_typed_array_object->kind) {
-            case wasm_typed_array_kind::INT8:
-            case wasm_typed_array_kind::UINT8:
-                bytes_per_buffer_item = 1;
-
-                break;
-
-            case wasm_typed_array_kind::INT16:
-            case wasm_typed_array_kind::UINT16:
-                bytes_per_buffer_item = 2;
-
-                break;
-
-            case wasm_typed_array_kind::INT32:
-            case wasm_typed_array_kind::UINT32:
-                bytes_per_buffer_item = 4;
-
-                break;
-
-            default:
-                zend_throw_exception(zend_ce_exception, "Invalid WebAssembly typed array type.", 3);
-
-                return;
-        }
-
-        size_t maximum_length = (wasm_array_buffer_object->buffer_length - offset) / bytes_per_buffer_item;
-
-        if (length == 0) {
-            wasm_typed_array_object->length = maximum_length;
-        } else if (length > maximum_length) {
-            zend_throw_exception_ex(
-                zend_ce_exception,
-                4,
-                "Length must not be greater than the buffer length; given %lld, maximum length is %zu.",
-                length,
-                maximum_length
-            );
-
-            return;
-        } else {
-            wasm_typed_array_object->length = (size_t) length;
-        }
-    }
-
-    // Set the view at the specific offset.
-    wasm_typed_array_object->view.as_int8 = wasm_array_buffer_object->buffer;
-    wasm_typed_array_object->view.as_int8 += offset;
-}
-
-/**
- * Declare the parameter information for the
- * `WasmTypedArray::getOffset` method.
- */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_get_offset, ZEND_RETURN_VALUE, ARITY(0), IS_LONG, NOT_NULLABLE)
-ZEND_END_ARG_INFO()
+    size_t maximum_length = wasm_array_buffer_object->buffer_length - byte_offset;
 
-/**
- * Declare the `WasmTypedArray::getOffset` method.
- *
- * # Usage
- *
- * ```php
- * $buffer = new WasmArrayBuffer(42);
- * $view = new WasmUint8Array($buffer, 3, 5);
- * assert($view->getOffset() == 3);
- * ```
- */
-PHP_FUNCTION(WasmTypedArray_get_offset)
-{
-    ZEND_PARSE_PARAMETERS_NONE();
+    if (byte_length < 0 || byte_length > maximum_length) {
+        zend_throw_exception_ex(
+            zend_ce_exception,
+            2,
+            "Length must be in the range [0; %zu]; given %lld.",
+            maximum_length,
+            byte_length
+        );
 
-    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+        return;
+    }
 
-    RETURN_LONG(wasm_typed_array_object->offset);
+    wasm_data_view_object->wasm_array_buffer = Z_OBJ_P(wasm_array_buffer);
+    GC_ADDREF(wasm_data_view_object->wasm_array_buffer);
+
+    wasm_data_view_object->offset = (size_t) byte_offset;
+    wasm_data_view_object->length = byte_length == 0 ? maximum_length : (size_t) byte_length;
 }
 
 /**
  * Declare the parameter information for the
- * `WasmTypedArray::getLength` method.
+ * `WasmDataView::getByteOffset` method.
  */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_get_length, ZEND_RETURN_VALUE, ARITY(0), IS_LONG, NOT_NULLABLE)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmdataview_get_byte_offset, ZEND_RETURN_VALUE, ARITY(0), IS_LONG, NOT_NULLABLE)
 ZEND_END_ARG_INFO()
 
 /**
- * Declare the `WasmTypedArray::getLength` method.
+ * Declare the `WasmDataView::getByteOffset` method.
  *
  * # Usage
  *
  * ```php
- * $buffer = new WasmArrayBuffer(42);
- * $view = new WasmUint8Array($buffer, 3, 5);
- * assert($view->getLength() == 5);
+ * $view = new WasmDataView(new WasmArrayBuffer(42), 3, 5);
+ * assert($view->getByteOffset() == 3);
  * ```
  */
-PHP_FUNCTION(WasmTypedArray_get_length)
+PHP_METHOD(WasmDataView, getByteOffset)
 {
     ZEND_PARSE_PARAMETERS_NONE();
 
-    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
-
-    RETURN_LONG(wasm_typed_array_object->length);
+    RETURN_LONG(WASM_DATA_VIEW_OBJECT_THIS()->offset);
 }
 
 /**
  * Declare the parameter information for the
- * `WasmTypedArray::offsetGet` method.
+ * `WasmDataView::getByteLength` method.
  */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_offset_get, ZEND_RETURN_VALUE, ARITY(1), _IS_NUMBER, NOT_NULLABLE)
-    ZEND_ARG_INFO(0, offset)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmdataview_get_byte_length, ZEND_RETURN_VALUE, ARITY(0), IS_LONG, NOT_NULLABLE)
 ZEND_END_ARG_INFO()
 
 /**
- * Declare the `WasmTypedArray::offsetGet` method.
+ * Declare the `WasmDataView::getByteLength` method.
  *
  * # Usage
  *
  * ```php
- * $buffer = new WasmArrayBuffer(42);
- * $view = new WasmUint8Array($buffer, 3, 5);
- * assert($view[1] == 0);
+ * $view = new WasmDataView(new WasmArrayBuffer(42), 3, 5);
+ * assert($view->getByteLength() == 5);
  * ```
  */
-PHP_FUNCTION(WasmTypedArray_offset_get)
+PHP_METHOD(WasmDataView, getByteLength)
 {
-    zend_long offset;
+    ZEND_PARSE_PARAMETERS_NONE();
 
-    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
-        Z_PARAM_LONG(offset)
-    ZEND_PARSE_PARAMETERS_END();
+    RETURN_LONG(WASM_DATA_VIEW_OBJECT_THIS()->length);
+}
 
-    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+/**
+ * Reads one scalar of the given kind; shared by all the
+ * `WasmDataView::get*` methods.
+ */
+static void wasm_data_view_get(INTERNAL_FUNCTION_PARAMETERS, wasm_scalar_kind kind)
+{
+    zend_long byte_offset;
+    zend_bool little_endian = 0;
 
-    if (offset < 0 || offset >= wasm_typed_array_object->length) {
-        zend_throw_exception_ex(
-            zend_ce_exception,
-            0,
-            "Offset is outside the view range [0; %zu]; given %lld.",
-            wasm_typed_array_object->length,
-            offset
-        );
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 2)
+        Z_PARAM_LONG(byte_offset)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(little_endian)
+    ZEND_PARSE_PARAMETERS_END();
 
+    uint8_t *address = wasm_data_view_address(WASM_DATA_VIEW_OBJECT_THIS(), byte_offset, wasm_scalar_kind_size(kind), false);
+
+    if (address == NULL) {
         return;
     }
 
-    switch (wasm_typed_array_object->kind) {
-        case wasm_typed_array_kind::INT8:
-            RETURN_LONG(wasm_typed_array_object->view.as_int8[offset]);
-
-            break;
-
-        case wasm_typed_array_kind::UINT8:
-            RETURN_LONG(wasm_typed_array_object->view.as_uint8[offset]);
-
-            break;
+    wasm_scalar_load(address, kind, little_endian, return_value);
+}
 
-        case wasm_typed_array_kind::INT16:
-            RETURN_LONG(wasm_typed_array_object->view.as_int16[offset]);
+/**
+ * Writes one scalar of the given kind; shared by all the
+ * `WasmDataView::set*` methods.
+ */
+static void wasm_data_view_set(INTERNAL_FUNCTION_PARAMETERS, wasm_scalar_kind kind)
+{
+    zend_long byte_offset;
+    zval *value;
+    zend_bool little_endian = 0;
 
-            break;
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 2, 3)
+        Z_PARAM_LONG(byte_offset)
+        Z_PARAM_ZVAL(value)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(little_endian)
+    ZEND_PARSE_PARAMETERS_END();
 
-        case wasm_typed_array_kind::UINT16:
-            RETURN_LONG(wasm_typed_array_object->view.as_uint16[offset]);
+    uint8_t *address = wasm_data_view_address(WASM_DATA_VIEW_OBJECT_THIS(), byte_offset, wasm_scalar_kind_size(kind), true);
 
-            break;
+    if (address == NULL) {
+        return;
+    }
 
-        case wasm_typed_array_kind::INT32:
-            RETURN_LONG(wasm_typed_array_object->view.as_int32[offset]);
+    wasm_scalar_store(address, kind, little_endian, value);
+}
 
-            break;
+/**
+ * Declare the parameter information for the `WasmDataView::get*`
+ * methods.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmdataview_get, ZEND_RETURN_VALUE, ARITY(1), _IS_NUMBER, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, byte_offset, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, little_endian, _IS_BOOL, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
 
-        case wasm_typed_array_kind::UINT32:
-            RETURN_LONG(wasm_typed_array_object->view.as_uint32[offset]);
+/**
+ * Declare the parameter information for the `WasmDataView::set*`
+ * methods.
+ */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmdataview_set, ZEND_RETURN_VALUE, ARITY(2), IS_VOID, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, byte_offset, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_INFO(0, value)
+    ZEND_ARG_TYPE_INFO(0, little_endian, _IS_BOOL, NOT_NULLABLE)
+ZEND_END_ARG_INFO()
 
-            break;
+/**
+ * Declare the `WasmDataView::get*` and `WasmDataView::set*` methods,
+ * for all scalar kinds. Like in JavaScript, values are read and
+ * written in big-endian unless `$little_endian` is `true`.
+ *
+ * # Usage
+ *
+ * ```php
+ * $view = new WasmDataView(new WasmArrayBuffer(42));
+ * $view->setInt32(1, -7, true);
+ * assert($view->getInt32(1, true) == -7);
+ * assert($view->getUint8(1) == 0xf9);
+ * ```
+ */
+#define DECLARE_WASM_DATA_VIEW_ACCESSORS(name, kind) \
+    PHP_METHOD(WasmDataView, get##name) \
+    { \
+        wasm_data_view_get(INTERNAL_FUNCTION_PARAM_PASSTHRU, kind); \
+    } \
+    \
+    PHP_METHOD(WasmDataView, set##name) \
+    { \
+        wasm_data_view_set(INTERNAL_FUNCTION_PARAM_PASSTHRU, kind); \
+    }
 
-        default:
-            zend_throw_exception(zend_ce_exception, "Invalid WebAssembly typed array type.", 1);
+DECLARE_WASM_DATA_VIEW_ACCESSORS(Int8, wasm_scalar_kind::INT8)
+DECLARE_WASM_DATA_VIEW_ACCESSORS(Uint8, wasm_scalar_kind::UINT8)
+DECLARE_WASM_DATA_VIEW_ACCESSORS(Int16, wasm_scalar_kind::INT16)
+DECLARE_WASM_DATA_VIEW_ACCESSORS(Uint16, wasm_scalar_kind::UINT16)
+DECLARE_WASM_DATA_VIEW_ACCESSORS(Int32, wasm_scalar_kind::INT32)
+DECLARE_WASM_DATA_VIEW_ACCESSORS(Uint32, wasm_scalar_kind::UINT32)
+DECLARE_WASM_DATA_VIEW_ACCESSORS(Int64, wasm_scalar_kind::INT64)
+DECLARE_WASM_DATA_VIEW_ACCESSORS(Float32, wasm_scalar_kind::FLOAT32)
+DECLARE_WASM_DATA_VIEW_ACCESSORS(Float64, wasm_scalar_kind::FLOAT64)
 
-            return;
-    }
-}
+#undef DECLARE_WASM_DATA_VIEW_ACCESSORS
 
 /**
  * Declare the parameter information for the
- * `WasmTypedArray::offsetSet` method.
+ * `WasmDataView::getValues` method.
  */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_offset_set, ZEND_RETURN_VALUE, ARITY(2), IS_VOID, NOT_NULLABLE)
-    ZEND_ARG_INFO(0, offset)
-    ZEND_ARG_INFO(0, value)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmdataview_get_values, ZEND_RETURN_VALUE, ARITY(3), IS_ARRAY, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, type, IS_STRING, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, byte_offset, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, count, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, little_endian, _IS_BOOL, NOT_NULLABLE)
 ZEND_END_ARG_INFO()
 
 /**
- * Declare the `WasmTypedArray::offsetSet` method.
+ * Declare the `WasmDataView::getValues` method.
+ *
+ * Reads `$count` consecutive scalars of the given Wasm type (`i8`,
+ * `u8`, `i16`, `u16`, `i32`, `u32`, `i64`, `f32`, or `f64`). The
+ * whole range is bound-checked once.
  *
  * # Usage
  *
  * ```php
- * $buffer = new WasmArrayBuffer(42);
- * $view = new WasmUint8Array($buffer, 3, 5);
- * $view[0] = 153;
- * assert($view[0] == 153);
+ * $view = new WasmDataView($buffer);
+ * [$x, $y, $z] = $view->getValues('f32', 16, 3, true);
  * ```
  */
-PHP_FUNCTION(WasmTypedArray_offset_set)
+PHP_METHOD(WasmDataView, getValues)
 {
-    zend_long offset;
-    zval *value;
-
-    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 2, 2)
-        Z_PARAM_LONG(offset)
-        Z_PARAM_ZVAL(value)
+    zend_string *type;
+    zend_long byte_offset;
+    zend_long count;
+    zend_bool little_endian = 0;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 3, 4)
+        Z_PARAM_STR(type)
+        Z_PARAM_LONG(byte_offset)
+        Z_PARAM_LONG(count)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(little_endian)
     ZEND_PARSE_PARAMETERS_END();
 
-    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+    wasm_scalar_kind kind;
 
-    if (offset < 0 || offset >= wasm_typed_array_object->length) {
+    if (!wasm_scalar_kind_from_name(ZSTR_VAL(type), ZSTR_LEN(type), &kind)) {
         zend_throw_exception_ex(
             zend_ce_exception,
-            0,
-            "Offset is outside the view range [0; %zu]; given %lld.",
-            wasm_typed_array_object->length,
-            offset
+            2,
+            "Unknown type `%s`; expect one of i8, u8, i16, u16, i32, u32, i64, f32, or f64.",
+            ZSTR_VAL(type)
         );
 
         return;
     }
 
-    convert_to_long_ex(value);
-
-    switch (wasm_typed_array_object->kind) {
-        case wasm_typed_array_kind::INT8:
-            wasm_typed_array_object->view.as_int8[offset] = Z_LVAL_P(value);
-
-            break;
-
-        case wasm_typed_array_kind::UINT8:
-            wasm_typed_array_object->view.as_uint8[offset] = Z_LVAL_P(value);
-
-            break;
-
-        case wasm_typed_array_kind::INT16:
-            wasm_typed_array_object->view.as_int16[offset] = Z_LVAL_P(value);
-
-            break;
-
-        case wasm_typed_array_kind::UINT16:
-            wasm_typed_array_object->view.as_uint16[offset] = Z_LVAL_P(value);
-
-            break;
-
-        case wasm_typed_array_kind::INT32:
-            wasm_typed_array_object->view.as_int32[offset] = Z_LVAL_P(value);
-
-            break;
+    wasm_data_view_object *wasm_data_view_object = WASM_DATA_VIEW_OBJECT_THIS();
+    size_t size = wasm_scalar_kind_size(kind);
 
-        case wasm_typed_array_kind::UINT32:
-            wasm_typed_array_object->view.as_uint32[offset] = Z_LVAL_P(value);
+    if (count < 0 || count > wasm_data_view_object->length / size) {
+        zend_throw_exception_ex(zend_ce_exception, 3, "Count must be in the range [0; %zu]; given %lld.", wasm_data_view_object->length / size, count);
 
-            break;
+        return;
+    }
 
-        default:
-            zend_throw_exception(zend_ce_exception, "Invalid WebAssembly typed array type.", 1);
+    array_init_size(return_value, (uint32_t) count);
 
-            return;
+    if (count == 0) {
+        return;
     }
 
-    zval_ptr_dtor(value);
-}
-
-/**
- * Declare the parameter information for the
- * `WasmTypedArray::offsetExists` method.
- */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_offset_exists, ZEND_RETURN_VALUE, ARITY(1), _IS_BOOL, NOT_NULLABLE)
-    ZEND_ARG_INFO(0, offset)
-ZEND_END_ARG_INFO()
+    uint8_t *address = wasm_data_view_address(wasm_data_view_object, byte_offset, size * count, false);
 
-/**
- * Declare the `WasmTypedArray::offsetExists` method.
- *
- * # Usage
- *
- * ```php
- * $buffer = new WasmArrayBuffer(42);
- * $view = new WasmUint8Array($buffer, 3, 5);
- * assert($view[0]);
- * ```
- */
-PHP_FUNCTION(WasmTypedArray_offset_exists)
-{
-    zend_long offset;
+    if (address == NULL) {
+        return;
+    }
 
-    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
-        Z_PARAM_LONG(offset)
-    ZEND_PARSE_PARAMETERS_END();
+    for (zend_long nth = 0; nth < count; ++nth) {
+        zval value;
 
-    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+        wasm_scalar_load(address, kind, little_endian, &value);
+        zend_hash_next_index_insert_new(Z_ARRVAL_P(return_value), &value);
 
-    if (offset < 0 || offset >= wasm_typed_array_object->length) {
-        RETURN_FALSE;
-    } else {
-        RETURN_TRUE;
+        address += size;
     }
 }
 
 /**
  * Declare the parameter information for the
- * `WasmTypedArray::offsetUnset` method.
+ * `WasmDataView::setValues` method.
  */
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmtypedarray_offset_unset, ZEND_RETURN_VALUE, ARITY(1), IS_VOID, NOT_NULLABLE)
-    ZEND_ARG_INFO(0, offset)
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_wasmdataview_set_values, ZEND_RETURN_VALUE, ARITY(3), IS_VOID, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, type, IS_STRING, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, byte_offset, IS_LONG, NOT_NULLABLE)
+    ZEND_ARG_ARRAY_INFO(0, values, NOT_NULLABLE)
+    ZEND_ARG_TYPE_INFO(0, little_endian, _IS_BOOL, NOT_NULLABLE)
 ZEND_END_ARG_INFO()
 
 /**
- * Declare the `WasmTypedArray::offsetUnset` method.
+ * Declare the `WasmDataView::setValues` method.
+ *
+ * Writes consecutive scalars of the given Wasm type. The whole range
+ * is bound-checked once.
  *
  * # Usage
  *
  * ```php
- * $buffer = new WasmArrayBuffer(42);
- * $view = new WasmUint8Array($buffer, 3, 5);
- * $view[0] = 1;
- * unset($view[0]);
- * assert($view[0] == 0);
+ * $view = new WasmDataView($buffer);
+ * $view->setValues('f32', 16, [1.0, 2.0, 3.0], true);
  * ```
  */
-PHP_FUNCTION(WasmTypedArray_offset_unset)
+PHP_METHOD(WasmDataView, setValues)
 {
-    zend_long offset;
-
-    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
-        Z_PARAM_LONG(offset)
+    zend_string *type;
+    zend_long byte_offset;
+    HashTable *values;
+    zend_bool little_endian = 0;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 3, 4)
+        Z_PARAM_STR(type)
+        Z_PARAM_LONG(byte_offset)
+        Z_PARAM_ARRAY_HT(values)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(little_endian)
     ZEND_PARSE_PARAMETERS_END();
 
-    wasm_typed_array_object *wasm_typed_array_object = WASM_TYPED_ARRAY_OBJECT_THIS();
+    wasm_scalar_kind kind;
 
-    if (offset < 0 || offset >= wasm_typed_array_object->length) {
+    if (!wasm_scalar_kind_from_name(ZSTR_VAL(type), ZSTR_LEN(type), &kind)) {
         zend_throw_exception_ex(
             zend_ce_exception,
-            0,
-            "Offset is outside the view range [0; %zu]; given %lld.",
-            wasm_typed_array_object->length,
-            offset
+            2,
+            "Unknown type `%s`; expect one of i8, u8, i16, u16, i32, u32, i64, f32, or f64.",
+            ZSTR_VAL(type)
         );
 
         return;
     }
 
-    switch (wasm_typed_array_object->kind) {
-        case wasm_typed_array_kind::INT8:
-            wasm_typed_array_object->view.as_int8[offset] = 0;
-
-            break;
-
-        case wasm_typed_array_kind::UINT8:
-            wasm_typed_array_object->view.as_uint8[offset] = 0;
-
-            break;
+    uint32_t count = zend_hash_num_elements(values);
 
-        case wasm_typed_array_kind::INT16:
-            wasm_typed_array_object->view.as_int16[offset] = 0;
+    if (count == 0) {
+        return;
+    }
 
-            break;
+    size_t size = wasm_scalar_kind_size(kind);
+    uint8_t *address = wasm_data_view_address(WASM_DATA_VIEW_OBJECT_THIS(), byte_offset, size * count, true);
 
-        case wasm_typed_array_kind::UINT16:
-            wasm_typed_array_object->view.as_uint16[offset] = 0;
+    if (address == NULL) {
+        return;
+    }
 
-            break;
+    zval *value;
 
-        case wasm_typed_array_kind::INT32:
-            wasm_typed_array_object->view.as_int32[offset] = 0;
+    ZEND_HASH_FOREACH_VAL(values, value)
+        ZVAL_DEREF(value);
+        wasm_scalar_store(address, kind, little_endian, value);
 
-            break;
+        address += size;
+    ZEND_HASH_FOREACH_END();
+}
 
-        case wasm_typed_array_kind::UINT32:
-            wasm_typed_array_object->view.as_uint32[offset] = 0;
+// Declare the methods of the `WasmDataView` class with their information.
+static const zend_function_entry wasm_data_view_methods[] = {
+    PHP_ME(WasmDataView, __construct,	arginfo_wasmdataview___construct, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, getByteOffset,	arginfo_wasmdataview_get_byte_offset, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, getByteLength,	arginfo_wasmdataview_get_byte_length, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, getInt8,		arginfo_wasmdataview_get, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, setInt8,		arginfo_wasmdataview_set, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, getUint8,		arginfo_wasmdataview_get, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, setUint8,		arginfo_wasmdataview_set, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, getInt16,		arginfo_wasmdataview_get, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, setInt16,		arginfo_wasmdataview_set, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, getUint16,		arginfo_wasmdataview_get, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, setUint16,		arginfo_wasmdataview_set, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, getInt32,		arginfo_wasmdataview_get, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, setInt32,		arginfo_wasmdataview_set, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, getUint32,		arginfo_wasmdataview_get, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, setUint32,		arginfo_wasmdataview_set, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, getInt64,		arginfo_wasmdataview_get, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, setInt64,		arginfo_wasmdataview_set, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, getFloat32,	arginfo_wasmdataview_get, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, setFloat32,	arginfo_wasmdataview_set, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, getFloat64,	arginfo_wasmdataview_get, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, setFloat64,	arginfo_wasmdataview_set, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, getValues,		arginfo_wasmdataview_get_values, ZEND_ACC_PUBLIC)
+    PHP_ME(WasmDataView, setValues,		arginfo_wasmdataview_set_values, ZEND_ACC_PUBLIC)
+    PHP_FE_END
+};
 
-            break;
+// Module globals initialization event.
+static PHP_GINIT_FUNCTION(wasm)
+{
+#if defined(ZTS) && defined(COMPILE_DL_WASM)
+    ZEND_TSRMLS_CACHE_UPDATE();
+#endif
 
-        default:
-            zend_throw_exception(zend_ce_exception, "Invalid WebAssembly typed array type.", 1);
+    wasm_globals->array_buffer_arena_size = 0;
+    wasm_globals->array_buffer_arena = NULL;
+    wasm_globals->output_chunk_size = 8192;
+    wasm_globals->host_key_value_store = NULL;
+    wasm_globals->host_key_value_store_size = 0;
+    wasm_globals->kv_store_max_size = 16 * 1024 * 1024;
+}
 
-            return;
+// Module globals shutdown event.
+static PHP_GSHUTDOWN_FUNCTION(wasm)
+{
+    // Free the key-value store of the host functions, if any.
+    if (wasm_globals->host_key_value_store != NULL) {
+        zend_hash_destroy(wasm_globals->host_key_value_store);
+        pefree(wasm_globals->host_key_value_store, 1);
+        wasm_globals->host_key_value_store = NULL;
+        wasm_globals->host_key_value_store_size = 0;
     }
 }
 
-// Declare the methods of the `WasmTypedArray` classes with their information.
-static const zend_function_entry wasm_typed_array_methods[] = {
-    PHP_ME_MAPPING(__construct,		WasmTypedArray___construct,		arginfo_wasmtypedarray___construct, ZEND_ACC_PUBLIC)
-    PHP_ME_MAPPING(getOffset,		WasmTypedArray_get_offset,		arginfo_wasmtypedarray_get_offset, ZEND_ACC_PUBLIC)
-    PHP_ME_MAPPING(getLength,		WasmTypedArray_get_length,		arginfo_wasmtypedarray_get_length, ZEND_ACC_PUBLIC)
-    PHP_ME_MAPPING(offsetGet,		WasmTypedArray_offset_get,		arginfo_wasmtypedarray_offset_get, ZEND_ACC_PUBLIC)
-    PHP_ME_MAPPING(offsetSet,		WasmTypedArray_offset_set,		arginfo_wasmtypedarray_offset_set, ZEND_ACC_PUBLIC)
-    PHP_ME_MAPPING(offsetExists,	WasmTypedArray_offset_exists,	arginfo_wasmtypedarray_offset_exists, ZEND_ACC_PUBLIC)
-    PHP_ME_MAPPING(offsetUnset,		WasmTypedArray_offset_unset,	arginfo_wasmtypedarray_offset_unset, ZEND_ACC_PUBLIC)
-    PHP_FE_END
-};
-
 // Module initialization event.
 PHP_MINIT_FUNCTION(wasm)
 {
+    REGISTER_INI_ENTRIES();
+
+#if defined(WASM_BULK_X86_64)
+    // Select the kernels of the bulk operations on typed arrays.
+    __builtin_cpu_init();
+    wasm_bulk_has_avx2 = __builtin_cpu_supports("avx2");
+    wasm_crc32c_has_sse42 = __builtin_cpu_supports("sse4.2");
+#endif
+
+    // Compute the lookup tables of the CRC-32C.
+    wasm_crc32c_initialize();
+
+    // Create the imports of the host functions.
+    wasm_host_imports_initialize();
+
     // Declare the constants.
     REGISTER_LONG_CONSTANT("WASM_TYPE_I32", (zend_long) wasmer_value_tag::WASM_I32, CONST_CS | CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("WASM_TYPE_I64", (zend_long) wasmer_value_tag::WASM_I64, CONST_CS | CONST_PERSISTENT);
@@ -2022,7 +9233,8 @@ PHP_MINIT_FUNCTION(wasm)
     wasm_typed_array_##type##_class_entry = zend_register_internal_class(&class_entry TSRMLS_CC); \
     wasm_typed_array_##type##_class_entry->create_object = create_wasm_typed_array_object; \
     wasm_typed_array_##type##_class_entry->ce_flags |= ZEND_ACC_IMMUTABLE; \
-    zend_class_implements(wasm_typed_array_##type##_class_entry TSRMLS_CC, 1, zend_ce_arrayaccess); \
+    wasm_typed_array_##type##_class_entry->get_iterator = wasm_typed_array_get_iterator; \
+    zend_class_implements(wasm_typed_array_##type##_class_entry TSRMLS_CC, 3, zend_ce_arrayaccess, zend_ce_traversable, zend_ce_countable); \
 	zend_declare_class_constant_long(wasm_typed_array_##type##_class_entry, "BYTES_PER_ELEMENT", sizeof("BYTES_PER_ELEMENT")-1, (zend_long) bytes_per_element);
 
     DECLARE_WASM_TYPED_ARRAY(WasmInt8Array, int8, 1);
@@ -2039,6 +9251,31 @@ PHP_MINIT_FUNCTION(wasm)
     wasm_typed_array_class_entry_handlers.dtor_obj = destroy_wasm_typed_array_object;
     wasm_typed_array_class_entry_handlers.free_obj = free_wasm_typed_array_object;
     wasm_typed_array_class_entry_handlers.clone_obj = NULL;
+    wasm_typed_array_class_entry_handlers.count_elements = count_wasm_typed_array_elements;
+    wasm_typed_array_class_entry_handlers.read_dimension = read_wasm_typed_array_dimension;
+    wasm_typed_array_class_entry_handlers.write_dimension = write_wasm_typed_array_dimension;
+    wasm_typed_array_class_entry_handlers.has_dimension = has_wasm_typed_array_dimension;
+    wasm_typed_array_class_entry_handlers.unset_dimension = unset_wasm_typed_array_dimension;
+
+    // Declare the `WasmStructView` class.
+    INIT_CLASS_ENTRY(class_entry, "WasmStructView", wasm_struct_view_methods);
+    wasm_struct_view_class_entry = zend_register_internal_class(&class_entry TSRMLS_CC);
+    wasm_struct_view_class_entry->create_object = create_wasm_struct_view_object;
+
+    memcpy(&wasm_struct_view_class_entry_handlers, zend_get_std_object_handlers(), sizeof(wasm_struct_view_class_entry_handlers));
+    wasm_struct_view_class_entry_handlers.offset = XtOffsetOf(wasm_struct_view_object, instance);
+    wasm_struct_view_class_entry_handlers.free_obj = free_wasm_struct_view_object;
+    wasm_struct_view_class_entry_handlers.clone_obj = NULL;
+
+    // Declare the `WasmDataView` class.
+    INIT_CLASS_ENTRY(class_entry, "WasmDataView", wasm_data_view_methods);
+    wasm_data_view_class_entry = zend_register_internal_class(&class_entry TSRMLS_CC);
+    wasm_data_view_class_entry->create_object = create_wasm_data_view_object;
+
+    memcpy(&wasm_data_view_class_entry_handlers, zend_get_std_object_handlers(), sizeof(wasm_data_view_class_entry_handlers));
+    wasm_data_view_class_entry_handlers.offset = XtOffsetOf(wasm_data_view_object, instance);
+    wasm_data_view_class_entry_handlers.free_obj = free_wasm_data_view_object;
+    wasm_data_view_class_entry_handlers.clone_obj = NULL;
 
     return SUCCESS;
 }
@@ -2049,6 +9286,8 @@ PHP_MINFO_FUNCTION(wasm)
     php_info_print_table_start();
     php_info_print_table_header(2, "wasm support", "enabled");
     php_info_print_table_end();
+
+    DISPLAY_INI_ENTRIES();
 }
 
 // Request initialization event.
@@ -2064,6 +9303,9 @@ PHP_RINIT_FUNCTION(wasm)
 // Request shutdown event.
 PHP_RSHUTDOWN_FUNCTION(wasm)
 {
+    // Free the request arena of `WasmArrayBuffer`, if any.
+    wasm_array_buffer_arena_release();
+
 	return SUCCESS;
 }
 
@@ -2073,6 +9315,11 @@ PHP_MSHUTDOWN_FUNCTION(wasm)
     // Clean up persistent resources.
     php_wasm_module_clean_up_persistent_resources();
 
+    // Destroy the imports of the host functions.
+    wasm_host_imports_destroy();
+
+    UNREGISTER_INI_ENTRIES();
+
     return SUCCESS;
 }
 
@@ -2087,7 +9334,11 @@ zend_module_entry wasm_module_entry = {
     PHP_RSHUTDOWN(wasm),	/* PHP_RSHUTDOWN - Request shutdown */
     PHP_MINFO(wasm),		/* PHP_MINFO - Module info */
     PHP_WASM_VERSION,		/* Version */
-    STANDARD_MODULE_PROPERTIES
+    PHP_MODULE_GLOBALS(wasm),	/* Module globals */
+    PHP_GINIT(wasm),		/* PHP_GINIT - Globals initialization */
+    PHP_GSHUTDOWN(wasm),	/* PHP_GSHUTDOWN - Globals shutdown */
+    NULL,					/* Post deactivation */
+    STANDARD_MODULE_PROPERTIES_EX
 };
 
 #ifdef COMPILE_DL_WASM
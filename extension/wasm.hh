@@ -22,10 +22,22 @@
 
 #include "php.h"
 #include "ext/standard/info.h"
+#include "ext/standard/base64.h"
+#include "ext/standard/php_random.h"
 #include "zend_exceptions.h"
+#include "zend_smart_str.h"
 #include "Zend/zend_interfaces.h"
+#include "SAPI.h"
 #include "php_wasm.h"
 #include "wasmer.hh"
+#include "wasm_invoke.hh"
+#include "wasm_trace.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 
 #if defined(PHP_WIN32)
 #  include "win32/php_stdint.h"
@@ -59,9 +71,16 @@ typedef struct {
     // The internal buffer length.
     size_t buffer_length;
 
-    // A flag to indicate whether the buffer has been allocated or not.
+    // A flag to indicate whether the buffer is owned by this object,
+    // i.e. must be freed with it. Buffers from the Wasm memory or from
+    // the request arena are not.
     bool allocated_buffer;
 
+    // The PHP string the buffer borrows its bytes from, `NULL` if
+    // none. The buffer holds a reference to it, and detaches from it
+    // before the first write. Set by the `fromString` method.
+    zend_string *string;
+
     // The class instance, i.e. the object. It must be the last item
     // of the structure.
     zend_object instance;
@@ -72,6 +91,43 @@ typedef struct {
  */
 static inline wasm_array_buffer_object *wasm_array_buffer_object_from_zend_object(zend_object *object);
 
+/**
+ * A chunk of the request arena. `WasmArrayBuffer` storages are carved
+ * out of it with a bump pointer; chunks are chained and freed in bulk
+ * at the end of the request.
+ */
+typedef struct wasm_array_buffer_arena_chunk {
+    // The previously filled chunk, `NULL` if none.
+    struct wasm_array_buffer_arena_chunk *previous;
+
+    // The number of bytes available after the header.
+    size_t size;
+
+    // The number of bytes already handed out.
+    size_t used;
+} wasm_array_buffer_arena_chunk;
+
+// Size of the header of an arena chunk, rounded so that the buffers
+// that follow it are 16-byte aligned.
+#define WASM_ARRAY_BUFFER_ARENA_CHUNK_HEADER_SIZE ZEND_MM_ALIGNED_SIZE_EX(sizeof(wasm_array_buffer_arena_chunk), 16)
+
+/**
+ * Allocates a zero-initialized storage of `byte_length` bytes for a
+ * `WasmArrayBuffer`, and tells whether the object owns it.
+ */
+static int8_t *wasm_array_buffer_allocate(size_t byte_length, bool *allocated_buffer);
+
+/**
+ * Frees all the chunks of the request arena.
+ */
+static void wasm_array_buffer_arena_release();
+
+/**
+ * Makes the storage of a `WasmArrayBuffer` writable, i.e. detaches it
+ * from the PHP string it borrows its bytes from, if any.
+ */
+static inline void wasm_array_buffer_detach(wasm_array_buffer_object *wasm_array_buffer_object);
+
 /**
  * Function for a `zend_class_entry` to create a `WasmArrayBuffer` object.
  */
@@ -91,6 +147,87 @@ static void free_wasm_array_buffer_object(zend_object *object);
 // Shortcut to get `$this` in a `WasmArrayBuffer` method.
 #define WASM_ARRAY_BUFFER_OBJECT_THIS() wasm_array_buffer_object_from_zend_object(Z_OBJ_P(getThis()))
 
+// The type of the byte counts returned by the `read` and `write`
+// stream operations, which became signed in PHP 7.4.
+#if PHP_VERSION_ID >= 70400
+typedef ssize_t wasm_stream_size_t;
+#else
+typedef size_t wasm_stream_size_t;
+#endif
+
+/**
+ * The state of a stream opened over a region of a `WasmArrayBuffer`
+ * by `WasmArrayBuffer::openStream`.
+ */
+typedef struct {
+    // The `WasmArrayBuffer` object the stream reads from and writes
+    // to. The stream holds a reference to it.
+    zend_object *wasm_array_buffer;
+
+    // The offset of the region in the buffer, in bytes.
+    size_t offset;
+
+    // The length of the region, in bytes.
+    size_t length;
+
+    // The position of the stream in the region.
+    size_t position;
+} wasm_array_buffer_stream;
+
+/**
+ * Stream operations over a region of a `WasmArrayBuffer`. Bytes are
+ * copied directly between the buffer and the stream consumer.
+ */
+static wasm_stream_size_t wasm_array_buffer_stream_write(php_stream *stream, const char *buffer, size_t count);
+static wasm_stream_size_t wasm_array_buffer_stream_read(php_stream *stream, char *buffer, size_t count);
+static int wasm_array_buffer_stream_close(php_stream *stream, int close_handle);
+static int wasm_array_buffer_stream_flush(php_stream *stream);
+static int wasm_array_buffer_stream_seek(php_stream *stream, zend_off_t offset, int whence, zend_off_t *new_offset);
+static int wasm_array_buffer_stream_stat(php_stream *stream, php_stream_statbuf *stat_buffer);
+
+// Maximum nesting of arrays when encoding or decoding MessagePack.
+#define WASM_MESSAGE_PACK_MAXIMUM_DEPTH 512
+
+/**
+ * Errors that can happen while encoding or decoding MessagePack.
+ */
+enum class wasm_message_pack_error {
+    NONE,
+    BUFFER_TOO_SMALL,
+    UNSUPPORTED_TYPE,
+    UNSUPPORTED_KEY,
+    TOO_DEEP,
+    TRUNCATED
+};
+
+/**
+ * Cursor to write MessagePack bytes directly into a buffer.
+ */
+typedef struct {
+    // Where to write the next byte.
+    uint8_t *cursor;
+
+    // The end of the writable region (excluded).
+    uint8_t *end;
+
+    // The reason of the last failure.
+    wasm_message_pack_error error;
+} wasm_message_pack_writer;
+
+/**
+ * Cursor to read MessagePack bytes directly from a buffer.
+ */
+typedef struct {
+    // Where to read the next byte.
+    const uint8_t *cursor;
+
+    // The end of the readable region (excluded).
+    const uint8_t *end;
+
+    // The reason of the last failure.
+    wasm_message_pack_error error;
+} wasm_message_pack_reader;
+
 /**
  * Utils.
  */
@@ -146,16 +283,368 @@ static void php_wasm_module_clean_up_persistent_resources();
 const char* wasm_instance_resource_name;
 int wasm_instance_resource_number;
 
+/**
+ * Status of the asynchronous call of an instance, see `php_await`.
+ */
+typedef enum {
+    // There is no asynchronous call.
+    WASM_ASYNC_NONE,
+
+    // The asynchronous call is running.
+    WASM_ASYNC_RUNNING,
+
+    // The guest unwinds its stack to suspend the call.
+    WASM_ASYNC_UNWINDING,
+
+    // The call is suspended, the guest awaits a response.
+    WASM_ASYNC_SUSPENDED,
+
+    // The guest rewinds its stack to resume the call.
+    WASM_ASYNC_REWINDING
+} wasm_async_status;
+
+/**
+ * Maximum number of functions an instance can import from linked
+ * instances, see `wasm_module_new_linked_instance`.
+ */
+#define WASM_LINK_MAXIMUM_FUNCTIONS 16
+
+/**
+ * Maximum number of parameters of a function imported from a linked
+ * instance.
+ */
+#define WASM_LINK_MAXIMUM_ARITY 4
+
+/**
+ * A function exported by a linked instance, and imported by another
+ * instance.
+ */
+typedef struct {
+    // The exported function.
+    const wasmer_export_func_t *function;
+
+    // The number of results of the function, 0 or 1.
+    uint32_t results_length;
+} wasm_linked_function;
+
+/**
+ * Data structure inside the `wasm_instance` resource. It is also the
+ * data of the Wasmer instance context, so that host functions can
+ * reach it.
+ */
+typedef struct {
+    // The Wasmer instance.
+    wasmer_instance_t *instance;
+
+    // The memory exported by the instance, `NULL` until it is looked
+    // up, see `wasm_instance_memory`.
+    wasmer_memory_t *memory;
+
+    // The stream receiving the guest output. It is undefined when the
+    // guest output goes to the PHP output layer.
+    zval output_stream;
+
+    // Number of bytes written by the guest since the last flush.
+    size_t unflushed_output_length;
+
+    // The stream the guest reads its input from. It is undefined when
+    // the guest has no input.
+    zval input_stream;
+
+    // The call queue registered by the guest with the
+    // `php_queue_register` host function: the address of its header
+    // in the memory, and the capacity of its records in bytes. The
+    // capacity is zero when there is no call queue.
+    uint32_t call_queue_pointer;
+    uint32_t call_queue_capacity;
+
+    // The memory of the guest holding the call queue, exported or
+    // not. It is borrowed from the instance context, and it is `NULL`
+    // until the guest registers a call queue.
+    wasmer_memory_t *call_queue_memory;
+
+    // The handler receiving the batches of records of the call queue.
+    // It is undefined when there is none.
+    zval call_queue_handler;
+
+    // Whether the handler has bailed out, e.g. on a fatal error, while
+    // the guest was flushing its call queue. The bailout is resumed
+    // once the guest has returned, see `wasm_host_php_queue_flush`.
+    bool call_queue_bailout;
+
+    // The asyncify data registered by the guest with the
+    // `php_async_register` host function: its address in the memory
+    // and its length. The length is zero when there is none.
+    uint32_t async_data_pointer;
+    uint32_t async_data_length;
+
+    // The asynchronous call: its status, the called function and its
+    // inputs, the request and the response of the awaited operation,
+    // and the result of the last completed call.
+    wasm_async_status async_status;
+    zend_string *async_function_name;
+    zval async_inputs;
+    zend_string *async_request;
+    zend_string *async_response;
+    zval async_result;
+
+    // The instances this instance is linked to, indexed by the
+    // namespace of their imports. It holds them alive while this
+    // instance calls them. It is undefined when there is none.
+    zval linked_instances;
+
+    // The exports of the linked instances, owning the linked
+    // functions.
+    wasmer_exports_t **linked_exports;
+    uint32_t linked_exports_length;
+
+    // The imported functions of the linked instances, indexed by the
+    // slot of their trampoline, see `wasm_link_call`.
+    wasm_linked_function linked_functions[WASM_LINK_MAXIMUM_FUNCTIONS];
+    uint32_t linked_functions_length;
+
+    // The memory imported from a linked instance, which the instance
+    // owns, `NULL` if there is none.
+    wasmer_memory_t *linked_memory;
+
+    // The stream receiving the trace of the calls, see
+    // `wasm_instance_set_trace_stream`. It is undefined when the calls
+    // are not recorded.
+    zval trace_stream;
+
+    // A copy of the memory after the last recorded call, to find the
+    // regions the host writes before the next one. It is `NULL` before
+    // the first recorded call.
+    uint8_t *trace_shadow;
+    size_t trace_shadow_length;
+} wasm_instance_state;
+
 /**
  * Extract the data structure inside the `wasm_instance` resource.
  */
-wasmer_instance_t *wasm_instance_from_resource(zend_resource *wasm_instance_resource);
+wasm_instance_state *wasm_instance_from_resource(zend_resource *wasm_instance_resource);
+
+/**
+ * Get the memory exported by the instance, `NULL` if there is none.
+ */
+static wasmer_memory_t *wasm_instance_memory(wasm_instance_state *instance_state);
+
+/**
+ * Invoke an exported function of the instance.
+ */
+static void wasm_instance_invoke_function(wasm_instance_state *instance_state, const char *function_name, size_t function_name_length, HashTable *inputs, zval *return_value);
+
+/**
+ * Call an asyncify function exported by the guest, with an optional
+ * `i32` argument.
+ */
+static bool wasm_async_call_export(wasm_instance_state *instance_state, const char *function_name, const int32_t *argument);
+
+/**
+ * Run, or resume, the asynchronous call of the instance.
+ */
+static void wasm_async_run(wasm_instance_state *instance_state, zval *return_value);
+
+/**
+ * Forget the asynchronous call of the instance.
+ */
+static void wasm_async_reset(wasm_instance_state *instance_state);
+
+/**
+ * Attach a new Wasmer instance to a new `wasm_instance` resource.
+ */
+static zend_resource *wasm_instance_register_resource(wasmer_instance_t *wasm_instance);
 
 /**
  * Destructor for the `wasm_instance` resource.
  */
 static void wasm_instance_destructor(zend_resource *resource);
 
+/**
+ * Maximum number of parameters of a host function.
+ */
+#define WASM_HOST_FUNCTION_MAXIMUM_ARITY 6
+
+/**
+ * A host function, i.e. a function implemented by the extension that
+ * a guest can import from the `env` namespace. The native function
+ * receives the Wasmer instance context first, then the Wasm
+ * arguments.
+ */
+typedef struct {
+    // The import name.
+    const char *name;
+
+    // The native function.
+    void (*function)(void *);
+
+    // The parameter types.
+    wasmer_value_tag parameters[WASM_HOST_FUNCTION_MAXIMUM_ARITY];
+    int parameters_length;
+
+    // The result types.
+    wasmer_value_tag results[1];
+    int results_length;
+} wasm_host_function;
+
+/**
+ * Create the imports of all the host functions.
+ */
+static void wasm_host_imports_initialize();
+
+/**
+ * Destroy the imports of all the host functions.
+ */
+static void wasm_host_imports_destroy();
+
+/**
+ * Get the region `[pointer, pointer + length)` of the memory of the
+ * instance owning the given context, `NULL` if it is out of bounds.
+ */
+static inline uint8_t *wasm_host_memory_region(wasmer_instance_context_t *context, uint32_t pointer, uint32_t length);
+
+/**
+ * The `env.php_write(pointer: i32, length: i32) -> i32` host function.
+ */
+static int32_t wasm_host_php_write(wasmer_instance_context_t *context, int32_t pointer, int32_t length);
+
+/**
+ * The `env.php_read(pointer: i32, capacity: i32) -> i32` host function.
+ */
+static int32_t wasm_host_php_read(wasmer_instance_context_t *context, int32_t pointer, int32_t capacity);
+
+/**
+ * Get the stream held by the given zval, `NULL` if there is none or
+ * if it has been closed.
+ */
+static inline php_stream *wasm_host_stream(zval *stream_resource);
+
+/**
+ * The `env.php_clock_ns() -> i64` host function.
+ */
+static int64_t wasm_host_php_clock_ns(wasmer_instance_context_t *context);
+
+/**
+ * The `env.php_random_fill(pointer: i32, length: i32) -> i32` host
+ * function.
+ */
+static int32_t wasm_host_php_random_fill(wasmer_instance_context_t *context, int32_t pointer, int32_t length);
+
+/**
+ * The `env.php_sha256(pointer: i32, length: i32, digest_pointer: i32)
+ * -> i32` host function.
+ */
+static int32_t wasm_host_php_sha256(wasmer_instance_context_t *context, int32_t pointer, int32_t length, int32_t digest_pointer);
+
+/**
+ * The `env.php_xxh3(pointer: i32, length: i32) -> i64` host function.
+ */
+static int64_t wasm_host_php_xxh3(wasmer_instance_context_t *context, int32_t pointer, int32_t length);
+
+/**
+ * Get the key-value store of the `php_kv_*` host functions, and
+ * create it if needed.
+ */
+static HashTable *wasm_host_key_value_store();
+
+/**
+ * Destructor of the values of the key-value store.
+ */
+static void wasm_host_key_value_store_value_destructor(zval *value);
+
+/**
+ * The `env.php_kv_get(key_pointer: i32, key_length: i32,
+ * value_pointer: i32, value_capacity: i32) -> i32` host function.
+ */
+static int32_t wasm_host_php_kv_get(wasmer_instance_context_t *context, int32_t key_pointer, int32_t key_length, int32_t value_pointer, int32_t value_capacity);
+
+/**
+ * The `env.php_kv_set(key_pointer: i32, key_length: i32,
+ * value_pointer: i32, value_length: i32) -> i32` host function.
+ */
+static int32_t wasm_host_php_kv_set(wasmer_instance_context_t *context, int32_t key_pointer, int32_t key_length, int32_t value_pointer, int32_t value_length);
+
+/**
+ * The `env.php_kv_delete(key_pointer: i32, key_length: i32) -> i32`
+ * host function.
+ */
+static int32_t wasm_host_php_kv_delete(wasmer_instance_context_t *context, int32_t key_pointer, int32_t key_length);
+
+/**
+ * Drain the call queue of the instance, i.e. dispatch its records to
+ * the handler in one batch, and empty it.
+ */
+static int32_t wasm_call_queue_drain(wasm_instance_state *instance_state, wasmer_memory_t *wasm_memory);
+
+/**
+ * The `env.php_queue_register(pointer: i32, capacity: i32) -> i32`
+ * host function.
+ */
+static int32_t wasm_host_php_queue_register(wasmer_instance_context_t *context, int32_t pointer, int32_t capacity);
+
+/**
+ * The `env.php_queue_flush() -> i32` host function.
+ */
+static int32_t wasm_host_php_queue_flush(wasmer_instance_context_t *context);
+
+/**
+ * The `env.php_async_register(pointer: i32, length: i32) -> i32` host
+ * function.
+ */
+static int32_t wasm_host_php_async_register(wasmer_instance_context_t *context, int32_t pointer, int32_t length);
+
+/**
+ * The `env.php_await(request_pointer: i32, request_length: i32,
+ * response_pointer: i32, response_capacity: i32) -> i32` host
+ * function.
+ */
+static int32_t wasm_host_php_await(wasmer_instance_context_t *context, int32_t request_pointer, int32_t request_length, int32_t response_pointer, int32_t response_capacity);
+
+/**
+ * Call the function of a linked instance imported in the given slot.
+ */
+static int32_t wasm_link_call(wasmer_instance_context_t *context, size_t slot, const int32_t *arguments, uint32_t arguments_length);
+
+/**
+ * The imports of an instance that is linked to other instances, being
+ * resolved, see `wasm_link_resolve`.
+ */
+typedef struct {
+    // The import descriptors of the module, owning the names of the
+    // imports.
+    wasmer_import_descriptors_t *import_descriptors;
+
+    // The host imports, followed by the imports resolved from the
+    // linked instances.
+    wasmer_import_t *imports;
+    uint32_t imports_length;
+
+    // The exports of the linked instances.
+    wasmer_exports_t **exports;
+    uint32_t exports_length;
+
+    // The imported functions, and the imported memory, if any.
+    wasm_linked_function functions[WASM_LINK_MAXIMUM_FUNCTIONS];
+    uint32_t functions_length;
+    wasmer_memory_t *memory;
+} wasm_link;
+
+/**
+ * Resolve the imports of a module from the linked instances.
+ */
+static bool wasm_link_resolve(wasm_link *link, const wasmer_module_t *wasm_module, HashTable *linked_instances);
+
+/**
+ * Release the imports of a link, once the instance is created.
+ */
+static void wasm_link_release_imports(wasm_link *link);
+
+/**
+ * Release the exports and the memory of a link, when the instance
+ * cannot be created.
+ */
+static void wasm_link_release_exports(wasm_link *link);
+
 /**
  * Information for the `wasm_value` resource.
  */
@@ -196,6 +685,18 @@ typedef enum {
     UINT32
 } wasm_typed_array_kind;
 
+/**
+ * The items of a `WasmTypedArray`, typed after its kind.
+ */
+typedef union {
+    int8_t *as_int8;
+    uint8_t *as_uint8;
+    int16_t *as_int16;
+    uint16_t *as_uint16;
+    int32_t *as_int32;
+    uint32_t *as_uint32;
+} wasm_typed_array_view;
+
 /**
  * Custom object for the `WasmTypedArray` classes. `WasmTypedArray` is
  * a generic name used here to represent all classes like
@@ -207,28 +708,31 @@ typedef struct {
     // entry item.
     wasm_typed_array_kind kind;
 
-    // The internal `WasmArrayBuffer`. Set by the `__construct`
-    // method.
-    zval *wasm_array_buffer;
+    // The size of one item, in bytes. Set by the `create_object`
+    // class entry item.
+    size_t bytes_per_element;
+
+    // The internal `WasmArrayBuffer`, which the view holds a
+    // reference to. Set by the `__construct` and `subarray` methods.
+    zend_object *wasm_array_buffer;
 
     // The offset over the buffer, i.e. start reading the internal
-    // buffer at this offset. Set by the `__construct` method.
+    // buffer at this offset. Set by the `__construct` and `subarray`
+    // methods.
     size_t offset;
 
     // The length of the view, i.e. read the internal buffer from the
     // offset to this length. Set by the `__construct` method.
     size_t length;
 
-    // The buffer view over this `wasm_array_buffer`. Set by the
-    // `__construct` method.
-    union {
-        int8_t *as_int8;
-        uint8_t *as_uint8;
-        int16_t *as_int16;
-        uint16_t *as_uint16;
-        int32_t *as_int32;
-        uint32_t *as_uint32;
-    } view;
+    // Whether a userland subclass overrides the `offsetGet`,
+    // `offsetSet`, `offsetExists` or `offsetUnset` methods, in which
+    // case the dimension handlers call them instead of reading the
+    // buffer. Set by the `create_object` class entry item.
+    bool overrides_offset_get;
+    bool overrides_offset_set;
+    bool overrides_offset_exists;
+    bool overrides_offset_unset;
 
     // The class instance, i.e. the object. It must be the last item
     // of the structure.
@@ -240,6 +744,14 @@ typedef struct {
  */
 static inline wasm_typed_array_object *wasm_typed_array_object_from_zend_object(zend_object *object);
 
+/**
+ * Gets the items of one of the `WasmTypedArray` objects, for reading
+ * or for writing. The address is resolved through the buffer each
+ * time, because a buffer detaching from a PHP string moves its bytes.
+ */
+static inline wasm_typed_array_view wasm_typed_array_read_view(wasm_typed_array_object *wasm_typed_array_object);
+static inline wasm_typed_array_view wasm_typed_array_write_view(wasm_typed_array_object *wasm_typed_array_object);
+
 /**
  * Function for a `zend_class_entry` to create one of the `WasmTypedArray` objects.
  */
@@ -256,9 +768,276 @@ static void destroy_wasm_typed_array_object(zend_object *object);
  */
 static void free_wasm_typed_array_object(zend_object *object);
 
+/**
+ * Gets the size of one item of a typed array kind, in bytes.
+ */
+static inline size_t wasm_typed_array_bytes_per_element(wasm_typed_array_kind kind);
+
 // Shortcut to get `$this` in a `WasmTypedArray` method.
 #define WASM_TYPED_ARRAY_OBJECT_THIS() wasm_typed_array_object_from_zend_object(Z_OBJ_P(getThis()))
 
+/**
+ * Iterator over one of the `WasmTypedArray` objects, used by
+ * `foreach`. The iterated object is held by `iterator.data`.
+ */
+typedef struct {
+    // The Zend iterator. It must be the first item of the structure.
+    zend_object_iterator iterator;
+
+    // The index of the current item.
+    size_t index;
+
+    // The current item, returned by `get_current_data`.
+    zval current;
+} wasm_typed_array_iterator;
+
+/**
+ * Handler for a `zend_class_entry` to iterate over one of the
+ * `WasmTypedArray` objects.
+ */
+static zend_object_iterator *wasm_typed_array_get_iterator(zend_class_entry *class_entry, zval *object, int by_reference);
+
+/**
+ * Handler for a `zend_class_entry` to count the items of one of the
+ * `WasmTypedArray` objects.
+ */
+static int count_wasm_typed_array_elements(zval *object, zend_long *count);
+
+/**
+ * Handlers for a `zend_class_entry` to read, write, check and unset
+ * the items of one of the `WasmTypedArray` objects with the `[]`
+ * syntax, without going through the `ArrayAccess` methods.
+ */
+static zval *read_wasm_typed_array_dimension(zval *object, zval *offset, int type, zval *rv);
+static void write_wasm_typed_array_dimension(zval *object, zval *offset, zval *value);
+static int has_wasm_typed_array_dimension(zval *object, zval *offset, int check_empty);
+static void unset_wasm_typed_array_dimension(zval *object, zval *offset);
+
+// Bulk operations on typed arrays use SSE2, which is part of the
+// x86-64 baseline, or AVX2 when the CPU supports it. Other
+// architectures use scalar loops.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#  define WASM_BULK_X86_64 1
+#  include <immintrin.h>
+
+// Compiles a function for AVX2, whatever the compiler flags are.
+#  define WASM_TARGET_AVX2 __attribute__((target("avx2")))
+
+// Compiles a function for SSE 4.2, whatever the compiler flags are.
+#  define WASM_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+
+/**
+ * Whether the AVX2 kernels of the bulk operations can be used. Set
+ * once by `MINIT`.
+ */
+static bool wasm_bulk_has_avx2 = false;
+
+// Whether the host stores integers in little-endian, like Wasm does.
+#ifdef WORDS_BIGENDIAN
+# define WASM_HOST_IS_LITTLE_ENDIAN false
+#else
+# define WASM_HOST_IS_LITTLE_ENDIAN true
+#endif
+
+/**
+ * Reverses the bytes of a 16-bit integer.
+ */
+static inline uint16_t wasm_byte_swap_16(uint16_t value);
+
+/**
+ * Reverses the bytes of a 32-bit integer.
+ */
+static inline uint32_t wasm_byte_swap_32(uint32_t value);
+
+/**
+ * Reverses the bytes of a 64-bit integer.
+ */
+static inline uint64_t wasm_byte_swap_64(uint64_t value);
+
+/**
+ * Encodes `length` bytes in lowercase hexadecimal into a new string.
+ */
+static zend_string *wasm_hexadecimal_encode(const uint8_t *data, size_t length);
+
+/**
+ * Computes the CRC-32C (Castagnoli) of `length` bytes.
+ */
+static uint32_t wasm_crc32c(const uint8_t *data, size_t length);
+
+/**
+ * Computes the 64-bit XXH3 hash of `length` bytes, with the default
+ * secret and a seed of 0.
+ */
+static uint64_t wasm_xxh3_64(const uint8_t *data, size_t length);
+
+/**
+ * Computes the 32-byte SHA-256 digest of `length` bytes.
+ */
+static void wasm_sha256(const uint8_t *data, size_t length, uint8_t *digest);
+
+/**
+ * All scalar types that can be read from or written to a buffer at
+ * an arbitrary byte offset. They are named after the Wasm types in
+ * userland, e.g. `i8`, `u16`, `f64` etc.
+ */
+enum class wasm_scalar_kind {
+    INT8,
+    UINT8,
+    INT16,
+    UINT16,
+    INT32,
+    UINT32,
+    INT64,
+    FLOAT32,
+    FLOAT64
+};
+
+/**
+ * Reads the scalar kind from its userland name. Returns `false` if
+ * the name is unknown.
+ */
+static bool wasm_scalar_kind_from_name(const char *name, size_t name_length, wasm_scalar_kind *kind);
+
+/**
+ * Gets the size in bytes of a scalar kind.
+ */
+static inline size_t wasm_scalar_kind_size(wasm_scalar_kind kind);
+
+/**
+ * Reads a scalar at an arbitrary byte address into a PHP value.
+ */
+static inline void wasm_scalar_load(const uint8_t *source, wasm_scalar_kind kind, bool little_endian, zval *value);
+
+/**
+ * Writes a PHP value as a scalar at an arbitrary byte address.
+ */
+static inline void wasm_scalar_store(uint8_t *destination, wasm_scalar_kind kind, bool little_endian, zval *value);
+
+/**
+ * Class entry for the `WasmStructView` class.
+ */
+zend_class_entry *wasm_struct_view_class_entry;
+zend_object_handlers wasm_struct_view_class_entry_handlers;
+
+/**
+ * A field of a structure, i.e. a named scalar at a given offset
+ * inside a record.
+ */
+typedef struct {
+    // The name of the field.
+    zend_string *name;
+
+    // The type of the field.
+    wasm_scalar_kind kind;
+
+    // The offset of the field from the start of the record.
+    size_t offset;
+} wasm_struct_field;
+
+/**
+ * A compiled structure layout. It is validated once, and then shared
+ * by all the `WasmStructView` objects derived from the same view.
+ */
+typedef struct {
+    // The number of `WasmStructView` objects using this layout.
+    uint32_t reference_count;
+
+    // The fields of the structure.
+    wasm_struct_field *fields;
+    uint32_t number_of_fields;
+
+    // The size in bytes of one record, padding included.
+    size_t stride;
+} wasm_struct_layout;
+
+/**
+ * Custom object for the `WasmStructView` class.
+ */
+typedef struct {
+    // The `WasmArrayBuffer` object the records are read from. Set by
+    // the `__construct` method.
+    zend_object *wasm_array_buffer;
+
+    // The compiled layout of a record. Set by the `__construct`
+    // method.
+    wasm_struct_layout *layout;
+
+    // The offset of the first record in the buffer. Set by the
+    // `__construct` method.
+    size_t offset;
+
+    // The number of records. Set by the `__construct` method.
+    size_t count;
+
+    // The class instance, i.e. the object. It must be the last item
+    // of the structure.
+    zend_object instance;
+} wasm_struct_view_object;
+
+/**
+ * Gets the `wasm_struct_view_object` pointer from a `zend_object` pointer.
+ */
+static inline wasm_struct_view_object *wasm_struct_view_object_from_zend_object(zend_object *object);
+
+/**
+ * Function for a `zend_class_entry` to create a `WasmStructView` object.
+ */
+static zend_object *create_wasm_struct_view_object(zend_class_entry *class_entry);
+
+/**
+ * Handler for a `zend_class_entry` to free a `WasmStructView` object.
+ */
+static void free_wasm_struct_view_object(zend_object *object);
+
+// Shortcut to get `$this` in a `WasmStructView` method.
+#define WASM_STRUCT_VIEW_OBJECT_THIS() wasm_struct_view_object_from_zend_object(Z_OBJ_P(getThis()))
+
+/**
+ * Class entry for the `WasmDataView` class.
+ */
+zend_class_entry *wasm_data_view_class_entry;
+zend_object_handlers wasm_data_view_class_entry_handlers;
+
+/**
+ * Custom object for the `WasmDataView` class.
+ */
+typedef struct {
+    // The `WasmArrayBuffer` object to read from and write to. Set by
+    // the `__construct` method.
+    zend_object *wasm_array_buffer;
+
+    // The offset of the view over the buffer, in bytes. Set by the
+    // `__construct` method.
+    size_t offset;
+
+    // The length of the view, in bytes. Set by the `__construct`
+    // method.
+    size_t length;
+
+    // The class instance, i.e. the object. It must be the last item
+    // of the structure.
+    zend_object instance;
+} wasm_data_view_object;
+
+/**
+ * Gets the `wasm_data_view_object` pointer from a `zend_object` pointer.
+ */
+static inline wasm_data_view_object *wasm_data_view_object_from_zend_object(zend_object *object);
+
+/**
+ * Function for a `zend_class_entry` to create a `WasmDataView` object.
+ */
+static zend_object *create_wasm_data_view_object(zend_class_entry *class_entry);
+
+/**
+ * Handler for a `zend_class_entry` to free a `WasmDataView` object.
+ */
+static void free_wasm_data_view_object(zend_object *object);
+
+// Shortcut to get `$this` in a `WasmDataView` method.
+#define WASM_DATA_VIEW_OBJECT_THIS() wasm_data_view_object_from_zend_object(Z_OBJ_P(getThis()))
+
 /*
  * Local variables:
  * tab-width: 4
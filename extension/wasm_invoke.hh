@@ -0,0 +1,137 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2019 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Ivan Enderlin                                                |
+  +----------------------------------------------------------------------+
+*/
+
+// The parts of the invocation of an exported function that depend on
+// Wasmer only: the export lookup, and the conversion of the values.
+// They do not depend on PHP, so that `microbench.cc` can measure them
+// without an interpreter.
+
+#ifndef WASM_INVOKE_HH
+#define WASM_INVOKE_HH
+
+#include "wasmer.hh"
+
+#include <cstring>
+
+/**
+ * Find the exported function of the given name, `NULL` if there is
+ * none. The function is owned by the exports.
+ */
+static inline const wasmer_export_func_t *wasm_exports_find_function(wasmer_exports_t *wasm_exports, const char *function_name, size_t function_name_length)
+{
+    int number_of_exports = wasmer_exports_len(wasm_exports);
+
+    for (int nth = 0; nth < number_of_exports; ++nth) {
+        wasmer_export_t *wasm_export = wasmer_exports_get(wasm_exports, nth);
+
+        // Not a function definition, let's continue.
+        if (wasmer_export_kind(wasm_export) != wasmer_import_export_kind::WASM_FUNCTION) {
+            continue;
+        }
+
+        // Read the export name.
+        wasmer_byte_array wasm_export_name = wasmer_export_name(wasm_export);
+
+        if (wasm_export_name.bytes_len != function_name_length) {
+            continue;
+        }
+
+        // Gotcha?
+        if (strncmp(function_name, (const char *) wasm_export_name.bytes, wasm_export_name.bytes_len) == 0) {
+            return wasmer_export_to_func(wasm_export);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Convert an integer to a Wasm value of the given type. It returns
+ * `false` if the type is not `i32` or `i64`.
+ */
+static inline bool wasm_value_from_integer(wasmer_value_tag type, int64_t integer, wasmer_value_t *value)
+{
+    if (type == wasmer_value_tag::WASM_I32) {
+        value->tag = type;
+        value->value.I32 = (int32_t) integer;
+
+        return true;
+    } else if (type == wasmer_value_tag::WASM_I64) {
+        value->tag = type;
+        value->value.I64 = integer;
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Convert a float to a Wasm value of the given type. It returns
+ * `false` if the type is not `f32` or `f64`.
+ */
+static inline bool wasm_value_from_float(wasmer_value_tag type, double number, wasmer_value_t *value)
+{
+    if (type == wasmer_value_tag::WASM_F32) {
+        value->tag = type;
+        value->value.F32 = (float) number;
+
+        return true;
+    } else if (type == wasmer_value_tag::WASM_F64) {
+        value->tag = type;
+        value->value.F64 = number;
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Check whether a Wasm value is an `i32` or an `i64`.
+ */
+static inline bool wasm_value_is_integer(const wasmer_value_t *value)
+{
+    return value->tag == wasmer_value_tag::WASM_I32 || value->tag == wasmer_value_tag::WASM_I64;
+}
+
+/**
+ * Check whether a Wasm value is an `f32` or an `f64`.
+ */
+static inline bool wasm_value_is_float(const wasmer_value_t *value)
+{
+    return value->tag == wasmer_value_tag::WASM_F32 || value->tag == wasmer_value_tag::WASM_F64;
+}
+
+/**
+ * Convert an `i32` or an `i64` Wasm value to an integer.
+ */
+static inline int64_t wasm_value_to_integer(const wasmer_value_t *value)
+{
+    return value->tag == wasmer_value_tag::WASM_I32 ? (int64_t) value->value.I32 : value->value.I64;
+}
+
+/**
+ * Convert an `f32` or an `f64` Wasm value to a float.
+ */
+static inline double wasm_value_to_float(const wasmer_value_t *value)
+{
+    return value->tag == wasmer_value_tag::WASM_F32 ? (double) value->value.F32 : value->value.F64;
+}
+
+#endif
@@ -0,0 +1,176 @@
+/*
+  +----------------------------------------------------------------------+
+  | PHP Version 7                                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 1997-2019 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+  | Author: Ivan Enderlin                                                |
+  +----------------------------------------------------------------------+
+*/
+
+// The binary format of the traces of `wasm_instance_set_trace_stream`,
+// read back by `replay.cc`. It does not depend on PHP.
+//
+// A trace starts with the `WTRC` magic and a `u32` version, followed
+// by one record per call. All integers are little-endian.
+//
+//   u32 name length, name bytes
+//   u8  number of inputs, per input: u8 type, u64 bits
+//   u32 number of regions, per region: u32 offset, u32 length, bytes
+//   u8  status, see `wasm_trace_status`
+//   if the status is `WASM_TRACE_RESULT`: u8 type, u64 bits
+//
+// The regions are the blocks of the memory written by the host since
+// the previous call, see `WASM_TRACE_BLOCK_SIZE`; the first call has
+// all the blocks of the memory. Replaying a trace on
+// a new instance of the same module writes them before each call, so
+// that the guest reads the same memory.
+
+#ifndef WASM_TRACE_HH
+#define WASM_TRACE_HH
+
+#include "wasmer.hh"
+
+#include <cstring>
+
+#define WASM_TRACE_MAGIC "WTRC"
+#define WASM_TRACE_MAGIC_LENGTH 4
+#define WASM_TRACE_VERSION 1
+
+/**
+ * The memory is compared by blocks of this size to find the regions
+ * written by the host. It divides the size of a Wasm page.
+ */
+#define WASM_TRACE_BLOCK_SIZE 4096
+
+/**
+ * The status of a recorded call.
+ */
+typedef enum {
+    // The call has failed.
+    WASM_TRACE_FAILED = 0,
+
+    // The call has succeeded without a result.
+    WASM_TRACE_VOID = 1,
+
+    // The call has succeeded with a result.
+    WASM_TRACE_RESULT = 2
+} wasm_trace_status;
+
+static inline void wasm_trace_encode_u32(uint32_t value, uint8_t *bytes)
+{
+    for (size_t nth = 0; nth < 4; ++nth) {
+        bytes[nth] = (uint8_t) (value >> (8 * nth));
+    }
+}
+
+static inline void wasm_trace_encode_u64(uint64_t value, uint8_t *bytes)
+{
+    for (size_t nth = 0; nth < 8; ++nth) {
+        bytes[nth] = (uint8_t) (value >> (8 * nth));
+    }
+}
+
+static inline uint32_t wasm_trace_decode_u32(const uint8_t *bytes)
+{
+    uint32_t value = 0;
+
+    for (size_t nth = 0; nth < 4; ++nth) {
+        value |= (uint32_t) bytes[nth] << (8 * nth);
+    }
+
+    return value;
+}
+
+static inline uint64_t wasm_trace_decode_u64(const uint8_t *bytes)
+{
+    uint64_t value = 0;
+
+    for (size_t nth = 0; nth < 8; ++nth) {
+        value |= (uint64_t) bytes[nth] << (8 * nth);
+    }
+
+    return value;
+}
+
+/**
+ * Get the bits of a Wasm value, zero-extended to 64 bits.
+ */
+static inline uint64_t wasm_trace_value_to_bits(const wasmer_value_t *value)
+{
+    uint64_t bits = 0;
+
+    switch (value->tag) {
+        case wasmer_value_tag::WASM_I32:
+            bits = (uint32_t) value->value.I32;
+
+            break;
+
+        case wasmer_value_tag::WASM_I64:
+            bits = (uint64_t) value->value.I64;
+
+            break;
+
+        case wasmer_value_tag::WASM_F32: {
+            uint32_t float_bits;
+            memcpy(&float_bits, &value->value.F32, sizeof(float_bits));
+            bits = float_bits;
+
+            break;
+        }
+
+        case wasmer_value_tag::WASM_F64:
+            memcpy(&bits, &value->value.F64, sizeof(bits));
+
+            break;
+    }
+
+    return bits;
+}
+
+/**
+ * Build a Wasm value from its type and its bits. It returns `false` if
+ * the type is unknown.
+ */
+static inline bool wasm_trace_value_from_bits(uint8_t type, uint64_t bits, wasmer_value_t *value)
+{
+    switch ((wasmer_value_tag) type) {
+        case wasmer_value_tag::WASM_I32:
+            value->tag = wasmer_value_tag::WASM_I32;
+            value->value.I32 = (int32_t) (uint32_t) bits;
+
+            return true;
+
+        case wasmer_value_tag::WASM_I64:
+            value->tag = wasmer_value_tag::WASM_I64;
+            value->value.I64 = (int64_t) bits;
+
+            return true;
+
+        case wasmer_value_tag::WASM_F32: {
+            uint32_t float_bits = (uint32_t) bits;
+            value->tag = wasmer_value_tag::WASM_F32;
+            memcpy(&value->value.F32, &float_bits, sizeof(float_bits));
+
+            return true;
+        }
+
+        case wasmer_value_tag::WASM_F64:
+            value->tag = wasmer_value_tag::WASM_F64;
+            memcpy(&value->value.F64, &bits, sizeof(bits));
+
+            return true;
+    }
+
+    return false;
+}
+
+#endif
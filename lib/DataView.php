@@ -0,0 +1,30 @@
+<?php
+
+declare(strict_types = 1);
+
+namespace Wasm;
+
+use WasmDataView;
+
+/**
+ * Reads and writes scalars of any Wasm type at any byte offset of a
+ * `WasmArrayBuffer`, aligned or not, in big-endian (the default, like
+ * JavaScript's `DataView`) or little-endian.
+ *
+ * Wasm linear memory is little-endian, so pass `true` as the last
+ * argument when reading or writing data shared with a Wasm program.
+ *
+ * # Examples
+ *
+ * ```php,ignore
+ * $instance = new Wasm\Instance('my_program.wasm');
+ * $view = new Wasm\DataView($instance->getMemoryBuffer());
+ *
+ * $header = $instance->get_header();
+ * $magic = $view->getUint32($header, true);
+ * [$x, $y, $z] = $view->getValues('f32', $header + 4, 3, true);
+ * ```
+ */
+class DataView extends WasmDataView
+{
+}
@@ -76,15 +76,37 @@ class Instance
      * $instance = Wasm\Instance::fromModule($module);
      * $result = $instance->sum(1, 2);
      * ```
+     *
+     * The imports of the module can be resolved from the exports of
+     * other instances, indexed by the namespace of the imports, see
+     * `wasm_module_new_linked_instance`:
+     *
+     * ```php,ignore
+     * $library = new Wasm\Instance('library.wasm');
+     * $module = new Wasm\Module('my_program.wasm');
+     * $instance = Wasm\Instance::fromModule($module, ['library' => $library]);
+     * ```
      */
-    public static function fromModule(Module $module): self
+    public static function fromModule(Module $module, array $linkedInstances = []): self
     {
         // Using an anonymous class allows to overwrite the constructor,
         // and to inject the `wasm_instance` resource and the file path.
         // From a type point of view, there is no difference.
-        return new class($module) extends Instance {
-            public function __construct(Module $module) {
-                $this->wasmInstance = wasm_module_new_instance($module->intoResource());
+        return new class($module, $linkedInstances) extends Instance {
+            public function __construct(Module $module, array $linkedInstances) {
+                if (empty($linkedInstances)) {
+                    $this->wasmInstance = wasm_module_new_instance($module->intoResource());
+                } else {
+                    $this->wasmInstance = wasm_module_new_linked_instance(
+                        $module->intoResource(),
+                        array_map(
+                            function (Instance $linkedInstance) {
+                                return $linkedInstance->wasmInstance;
+                            },
+                            $linkedInstances
+                        )
+                    );
+                }
 
                 if (null === $this->wasmInstance) {
                     throw new RuntimeException(
@@ -116,6 +138,69 @@ class Instance
         return wasm_get_memory_buffer($this->wasmInstance);
     }
 
+    /**
+     * Sets the stream receiving the bytes the instance writes with the
+     * `env.php_write` host function.
+     *
+     * By default, or when the stream is `null`, the bytes go to the PHP
+     * output layer. The output is flushed every `wasm.output_chunk_size`
+     * bytes.
+     *
+     * # Examples
+     *
+     * ```php,ignore
+     * $instance = new Wasm\Instance('my_program.wasm');
+     * $stream = fopen('php://temp', 'w+');
+     * $instance->setOutputStream($stream);
+     * $instance->render();
+     * ```
+     */
+    public function setOutputStream($stream = null): void
+    {
+        wasm_instance_set_output_stream($this->wasmInstance, $stream);
+    }
+
+    /**
+     * Sets the stream the instance reads with the `env.php_read` host
+     * function.
+     *
+     * By default, or when the stream is `null`, the instance has no input.
+     *
+     * # Examples
+     *
+     * ```php,ignore
+     * $instance = new Wasm\Instance('my_program.wasm');
+     * $instance->setInputStream(fopen('php://input', 'r'));
+     * $instance->parse();
+     * ```
+     */
+    public function setInputStream($stream = null): void
+    {
+        wasm_instance_set_input_stream($this->wasmInstance, $stream);
+    }
+
+    /**
+     * Sets the stream recording the calls to the exported functions, so
+     * that they can be replayed offline with the `replay` tool of the
+     * extension.
+     *
+     * By default, or when the stream is `null`, the calls are not
+     * recorded. Recording copies the memory after each call, so it
+     * costs as much memory as the instance.
+     *
+     * # Examples
+     *
+     * ```php,ignore
+     * $instance = new Wasm\Instance('my_program.wasm');
+     * $instance->setTraceStream(fopen('my_program.trace', 'wb'));
+     * $instance->run(42);
+     * ```
+     */
+    public function setTraceStream($stream = null): void
+    {
+        wasm_instance_set_trace_stream($this->wasmInstance, $stream);
+    }
+
     /**
      * Calls an exported function.
      *
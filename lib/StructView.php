@@ -0,0 +1,37 @@
+<?php
+
+declare(strict_types = 1);
+
+namespace Wasm;
+
+use WasmStructView;
+
+/**
+ * Represents an array of C-like structures stored in a `WasmArrayBuffer`.
+ *
+ * The layout of a structure is described once, as a map from field names to
+ * Wasm type names (`i8`, `u8`, `i16`, `u16`, `i32`, `u32`, `i64`, `f32`, or
+ * `f64`), optionally paired with an offset inside the record. Records are
+ * then read and written natively, field by field, with a single bound check
+ * per record.
+ *
+ * # Examples
+ *
+ * ```php,ignore
+ * // struct point { int32_t x; int32_t y; };
+ * $instance = new Wasm\Instance('my_program.wasm');
+ * $points = new Wasm\StructView(
+ *     $instance->getMemoryBuffer(),
+ *     ['x' => 'i32', 'y' => 'i32'],
+ *     $instance->get_points(),
+ *     $instance->get_number_of_points()
+ * );
+ *
+ * foreach ($points->readAll() as ['x' => $x, 'y' => $y]) {
+ *     // …
+ * }
+ * ```
+ */
+class StructView extends WasmStructView
+{
+}
@@ -0,0 +1,145 @@
+<?php
+
+declare(strict_types = 1);
+
+namespace Wasm\Tests\Units;
+
+use Exception;
+use Wasm as LUT;
+use WasmArrayBuffer;
+use WasmDataView;
+use WasmUint8Array;
+use Wasm\Tests\Suite;
+
+class DataView extends Suite
+{
+    public function test_constructor()
+    {
+        $this
+            ->given($wasmArrayBuffer = new WasmArrayBuffer(64))
+            ->when($result = new LUT\DataView($wasmArrayBuffer, 3, 16))
+            ->then
+                ->object($result)
+                    ->isInstanceOf(WasmDataView::class)
+                ->integer($result->getByteOffset())
+                    ->isEqualTo(3)
+                ->integer($result->getByteLength())
+                    ->isEqualTo(16);
+    }
+
+    public function test_constructor_defaults_to_the_rest_of_the_buffer()
+    {
+        $this
+            ->given($wasmArrayBuffer = new WasmArrayBuffer(64))
+            ->when($result = new LUT\DataView($wasmArrayBuffer, 10))
+            ->then
+                ->integer($result->getByteLength())
+                    ->isEqualTo(54);
+    }
+
+    public function test_constructor_with_an_invalid_length()
+    {
+        $this
+            ->exception(
+                function() {
+                    new LUT\DataView(new WasmArrayBuffer(8), 4, 5);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Length must be in the range [0; 4]; given 5.')
+                ->hasCode(2);
+    }
+
+    public function test_big_endian_by_default()
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(8),
+                $uint8 = new WasmUint8Array($wasmArrayBuffer),
+                $view = new LUT\DataView($wasmArrayBuffer, 1)
+            )
+            ->when($view->setUint32(0, 0x01020304))
+            ->then
+                ->integer($uint8[1])
+                    ->isEqualTo(0x01)
+                ->integer($uint8[4])
+                    ->isEqualTo(0x04)
+                ->integer($view->getUint32(0))
+                    ->isEqualTo(0x01020304)
+                ->integer($view->getUint32(0, true))
+                    ->isEqualTo(0x04030201);
+    }
+
+    public function test_unaligned_accessors()
+    {
+        $this
+            ->given($view = new LUT\DataView(new WasmArrayBuffer(32)))
+            ->when(
+                $view->setInt8(0, -1),
+                $view->setInt16(1, -2, true),
+                $view->setInt32(3, -3, true),
+                $view->setInt64(7, -4, true),
+                $view->setFloat32(15, 1.5, true),
+                $view->setFloat64(19, -2.25)
+            )
+            ->then
+                ->integer($view->getInt8(0))
+                    ->isEqualTo(-1)
+                ->integer($view->getUint8(0))
+                    ->isEqualTo(0xff)
+                ->integer($view->getInt16(1, true))
+                    ->isEqualTo(-2)
+                ->integer($view->getUint16(1, true))
+                    ->isEqualTo(0xfffe)
+                ->integer($view->getInt32(3, true))
+                    ->isEqualTo(-3)
+                ->integer($view->getUint32(3, true))
+                    ->isEqualTo(0xfffffffd)
+                ->integer($view->getInt64(7, true))
+                    ->isEqualTo(-4)
+                ->float($view->getFloat32(15, true))
+                    ->isEqualTo(1.5)
+                ->float($view->getFloat64(19))
+                    ->isEqualTo(-2.25);
+    }
+
+    public function test_values()
+    {
+        $this
+            ->given($view = new LUT\DataView(new WasmArrayBuffer(32)))
+            ->when($view->setValues('f32', 1, [1.0, 2.5, -3.0], true))
+            ->then
+                ->array($view->getValues('f32', 1, 3, true))
+                    ->isIdenticalTo([1.0, 2.5, -3.0])
+                ->array($view->getValues('u8', 0, 0))
+                    ->isEmpty();
+    }
+
+    public function test_offset_outside_the_view()
+    {
+        $this
+            ->given($view = new LUT\DataView(new WasmArrayBuffer(16), 8, 4))
+            ->exception(
+                function() use ($view) {
+                    $view->getUint32(1);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Offset is outside the view range; given 1 for 4 byte(s), view length is 4.')
+                ->hasCode(0);
+    }
+
+    public function test_values_with_an_unknown_type()
+    {
+        $this
+            ->given($view = new LUT\DataView(new WasmArrayBuffer(16)))
+            ->exception(
+                function() use ($view) {
+                    $view->getValues('i128', 0, 1);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Unknown type `i128`; expect one of i8, u8, i16, u16, i32, u32, i64, f32, or f64.')
+                ->hasCode(2);
+    }
+}
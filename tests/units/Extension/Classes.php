@@ -5,11 +5,13 @@ declare(strict_types = 1);
 namespace Wasm\Tests\Units\Extension;
 
 use ArrayAccess;
+use Countable;
 use Exception;
 use ReflectionClass;
 use ReflectionExtension;
 use ReflectionMethod;
 use StdClass;
+use Traversable;
 use WasmArrayBuffer;
 use WasmInt16Array;
 use WasmInt32Array;
@@ -38,14 +40,56 @@ class Classes extends Suite
             ->when($result = $reflection->getClasses())
             ->then
                 ->array($result)
-                    ->hasSize(7)
+                    ->hasSize(9)
                     ->object['WasmArrayBuffer']->isInstanceOf(ReflectionClass::class)
                     ->object['WasmInt8Array']->isInstanceOf(ReflectionClass::class)
                     ->object['WasmUint8Array']->isInstanceOf(ReflectionClass::class)
                     ->object['WasmInt16Array']->isInstanceOf(ReflectionClass::class)
                     ->object['WasmUint16Array']->isInstanceOf(ReflectionClass::class)
                     ->object['WasmInt32Array']->isInstanceOf(ReflectionClass::class)
-                    ->object['WasmUint32Array']->isInstanceOf(ReflectionClass::class);
+                    ->object['WasmUint32Array']->isInstanceOf(ReflectionClass::class)
+                    ->object['WasmStructView']->isInstanceOf(ReflectionClass::class)
+                    ->object['WasmDataView']->isInstanceOf(ReflectionClass::class);
+    }
+
+    public function test_reflection_wasm_struct_view()
+    {
+        $this
+            ->given($reflection = new ReflectionExtension('wasm'))
+            ->when($result = $reflection->getClasses()['WasmStructView'])
+            ->then
+                ->array($result->getConstants())
+                    ->isEmpty()
+                ->array(array_map(function ($method) { return $method->getName(); }, $result->getMethods()))
+                    ->isEqualTo(['__construct', 'getOffset', 'getCount', 'getStride', 'read', 'readAll', 'write', 'get', 'set', 'at'])
+                ->boolean($result->getParentClass())
+                    ->isFalse()
+                ->boolean($result->isCloneable())
+                    ->isFalse()
+                ->boolean($result->isFinal())
+                    ->isFalse()
+                ->boolean($result->isInternal())
+                    ->isTrue();
+    }
+
+    public function test_reflection_wasm_data_view()
+    {
+        $this
+            ->given($reflection = new ReflectionExtension('wasm'))
+            ->when($result = $reflection->getClasses()['WasmDataView'])
+            ->then
+                ->array($result->getConstants())
+                    ->isEmpty()
+                ->array($result->getMethods())
+                    ->hasSize(23)
+                ->boolean($result->getParentClass())
+                    ->isFalse()
+                ->boolean($result->isCloneable())
+                    ->isFalse()
+                ->boolean($result->isFinal())
+                    ->isFalse()
+                ->boolean($result->isInternal())
+                    ->isTrue();
     }
 
     public function test_reflection_wasm_array_buffer()
@@ -60,7 +104,7 @@ class Classes extends Suite
                 ->let($methods = $result->getMethods())
 
                 ->array($methods)
-                    ->hasSize(2)
+                    ->hasSize(8)
 
                 ->string($methods[0]->getName())
                     ->isEqualTo('__construct')
@@ -94,6 +138,85 @@ class Classes extends Suite
                 ->boolean($return_type->allowsNull())
                     ->isFalse()
 
+                ->string($methods[2]->getName())
+                    ->isEqualTo('writeMessagePack')
+                ->boolean($methods[2]->isPublic())
+                    ->isTrue()
+                ->integer($methods[2]->getNumberOfParameters())
+                    ->isEqualTo(2)
+                    ->isEqualTo($methods[2]->getNumberOfRequiredParameters())
+
+                ->let($return_type = $methods[2]->getReturnType())
+
+                ->string($return_type . '')
+                    ->isEqualTo('int')
+                ->boolean($return_type->allowsNull())
+                    ->isFalse()
+
+                ->string($methods[3]->getName())
+                    ->isEqualTo('readMessagePack')
+                ->boolean($methods[3]->isPublic())
+                    ->isTrue()
+                ->integer($methods[3]->getNumberOfParameters())
+                    ->isEqualTo(2)
+                ->integer($methods[3]->getNumberOfRequiredParameters())
+                    ->isEqualTo(1)
+
+                ->string($methods[4]->getName())
+                    ->isEqualTo('hash')
+                ->boolean($methods[4]->isPublic())
+                    ->isTrue()
+                ->integer($methods[4]->getNumberOfParameters())
+                    ->isEqualTo(3)
+                ->integer($methods[4]->getNumberOfRequiredParameters())
+                    ->isEqualTo(1)
+
+                ->let($return_type = $methods[4]->getReturnType())
+
+                ->string($return_type . '')
+                    ->isEqualTo('string')
+                ->boolean($return_type->allowsNull())
+                    ->isFalse()
+
+                ->string($methods[5]->getName())
+                    ->isEqualTo('fromString')
+                ->boolean($methods[5]->isPublic())
+                    ->isTrue()
+                ->boolean($methods[5]->isStatic())
+                    ->isTrue()
+                ->integer($methods[5]->getNumberOfParameters())
+                    ->isEqualTo(1)
+                    ->isEqualTo($methods[5]->getNumberOfRequiredParameters())
+
+                ->let($return_type = $methods[5]->getReturnType())
+
+                ->string($return_type . '')
+                    ->isEqualTo(WasmArrayBuffer::class)
+                ->boolean($return_type->allowsNull())
+                    ->isFalse()
+
+                ->string($methods[6]->getName())
+                    ->isEqualTo('copyTo')
+                ->boolean($methods[6]->isPublic())
+                    ->isTrue()
+                ->integer($methods[6]->getNumberOfParameters())
+                    ->isEqualTo(4)
+                    ->isEqualTo($methods[6]->getNumberOfRequiredParameters())
+
+                ->let($return_type = $methods[6]->getReturnType())
+
+                ->string($return_type . '')
+                    ->isEqualTo('void')
+
+                ->string($methods[7]->getName())
+                    ->isEqualTo('openStream')
+                ->boolean($methods[7]->isPublic())
+                    ->isTrue()
+                ->integer($methods[7]->getNumberOfParameters())
+                    ->isEqualTo(2)
+                ->integer($methods[7]->getNumberOfRequiredParameters())
+                    ->isEqualTo(0)
+
                 ->boolean($result->getParentClass())
                     ->isFalse()
                 ->array($result->getProperties())
@@ -146,7 +269,9 @@ class Classes extends Suite
                 ->let($methods = $result->getMethods())
 
                 ->array($methods)
-                    ->hasSize(7)
+                    ->hasSize(18)
+                ->array(array_map(function ($method) { return $method->getName(); }, array_slice($methods, 7)))
+                    ->isEqualTo(['fill', 'copyWithin', 'indexOf', 'sum', 'min', 'max', 'compare', 'toBase64', 'toHex', 'count', 'subarray'])
 
                 ->string($methods[0]->getName())
                     ->isEqualTo('__construct')
@@ -161,9 +286,7 @@ class Classes extends Suite
 
                 ->string($parameters[0]->getName())
                     ->isEqualTo('wasm_array_buffer')
-                ->string($parameters[0]->getType() . '')
-                    ->isEqualTo(WasmArrayBuffer::class)
-                ->boolean($parameters[0]->getType()->allowsNull())
+                ->boolean($parameters[0]->hasType())
                     ->isFalse()
                 ->boolean($parameters[0]->isOptional())
                     ->isFalse()
@@ -311,6 +434,10 @@ class Classes extends Suite
 
                 ->boolean($result->implementsInterface(ArrayAccess::class))
                     ->isTrue()
+                ->boolean($result->implementsInterface(Traversable::class))
+                    ->isTrue()
+                ->boolean($result->implementsInterface(Countable::class))
+                    ->isTrue()
                 ->boolean($result->getParentClass())
                     ->isFalse()
                 ->array($result->getProperties())
@@ -370,216 +497,650 @@ class Classes extends Suite
                 ->hasCode(0);
     }
 
-    public function test_wasm_array_buffer_get_byte_length()
+    public function test_wasm_array_buffer_large_allocation()
     {
         $this
-            ->given(
-                $byteLength = 42,
-                $wasmArrayBuffer = new WasmArrayBuffer($byteLength)
-            )
-            ->when($result = $wasmArrayBuffer->getByteLength())
+            ->given($byteLength = 1 << 24)
+            ->when($result = new WasmArrayBuffer($byteLength))
             ->then
-                ->integer($result)
-                    ->isEqualTo($byteLength);
+                ->integer($result->getByteLength())
+                    ->isEqualTo($byteLength)
+                ->integer(memory_get_usage())
+                    ->isGreaterThan($byteLength)
+                ->integer((new WasmUint8Array($result))->sum())
+                    ->isEqualTo(0);
     }
 
-    /**
-     * @dataProvider wasm_typed_arrays
-     */
-    public function test_wasm_typed_array_constructor(string $wasmTypedArrayClassName)
+    public function test_wasm_array_buffer_in_the_request_arena()
     {
         $this
             ->given(
-                $bufferLength = 256,
-                $wasmArrayBuffer = new WasmArrayBuffer($bufferLength)
+                $previousArenaSize = ini_set('wasm.array_buffer_arena_size', '64'),
+                $wasmArrayBuffers = [],
+                $wasmTypedArrays = []
             )
-            ->when($result = new $wasmTypedArrayClassName($wasmArrayBuffer))
-            ->then
-                ->integer($result->getOffset())
-                    ->isZero()
-                ->integer($result->getLength())
-                    ->isEqualTo($bufferLength / $result::BYTES_PER_ELEMENT)
-                ->when(
-                    function () use ($result) {
-                        for ($i = 0; $i < $result->getLength(); ++$i) {
-                            $this
-                                ->integer($result[$i])
-                                    ->isEqualTo(0);
-                        }
+            ->when(
+                function () use (&$wasmArrayBuffers, &$wasmTypedArrays) {
+                    for ($i = 0; $i < 8; ++$i) {
+                        $wasmArrayBuffers[$i] = new WasmArrayBuffer(24);
+                        $wasmTypedArrays[$i] = new WasmUint8Array($wasmArrayBuffers[$i]);
+                        $wasmTypedArrays[$i]->fill($i + 1);
                     }
-                );
+
+                    // Larger than the arena chunks.
+                    $wasmArrayBuffers[8] = new WasmArrayBuffer(128);
+                    $wasmTypedArrays[8] = new WasmUint8Array($wasmArrayBuffers[8]);
+                }
+            )
+            ->then
+                ->integer($wasmTypedArrays[0]->sum())
+                    ->isEqualTo(24)
+                ->integer($wasmTypedArrays[7]->sum())
+                    ->isEqualTo(8 * 24)
+                ->integer($wasmTypedArrays[8]->sum())
+                    ->isEqualTo(0)
+                ->variable(ini_set('wasm.array_buffer_arena_size', $previousArenaSize))
+                    ->isEqualTo('64');
     }
 
-    /**
-     * @dataProvider wasm_typed_arrays
-     */
-    public function test_wasm_typed_array_constructor_with_an_offset(string $wasmTypedArrayClassName)
+    public function test_wasm_array_buffer_from_string()
     {
         $this
-            ->given(
-                $bufferLength = 256,
-                $offset = 3,
-                $wasmArrayBuffer = new WasmArrayBuffer($bufferLength)
-            )
-            ->when($result = new $wasmTypedArrayClassName($wasmArrayBuffer, $offset))
+            ->given($string = str_repeat("\x01\x02", 4))
+            ->when($result = WasmArrayBuffer::fromString($string))
             ->then
-                ->integer($result->getOffset())
-                    ->isEqualTo($offset)
-                ->integer($result->getLength())
-                    ->isEqualTo((int) (($bufferLength - $offset) / $result::BYTES_PER_ELEMENT));
+                ->object($result)
+                    ->isInstanceOf(WasmArrayBuffer::class)
+                ->integer($result->getByteLength())
+                    ->isEqualTo(8)
+                ->integer((new WasmUint16Array($result))[3])
+                    ->isEqualTo(0x0201)
+                ->string((new WasmUint8Array($result))->toHex())
+                    ->isEqualTo('0102010201020102');
     }
 
-    /**
-     * @dataProvider wasm_typed_arrays
-     */
-    public function test_wasm_typed_array_constructor_with_an_offset_and_a_length(string $wasmTypedArrayClassName)
+    public function test_wasm_array_buffer_from_string_copies_on_write()
     {
         $this
             ->given(
-                $bufferLength = 256,
-                $offset = 3,
-                $length = 12,
-                $wasmArrayBuffer = new WasmArrayBuffer($bufferLength)
+                $string = str_repeat("\x00", 8),
+                $wasmArrayBuffer = WasmArrayBuffer::fromString($string),
+                $wasmUint8Array = new WasmUint8Array($wasmArrayBuffer),
+                $otherWasmUint8Array = new WasmUint8Array($wasmArrayBuffer, 4)
+            )
+            ->when(
+                $wasmUint8Array[4] = 42,
+                $wasmUint8Array->fill(7, 0, 2)
             )
-            ->when($result = new $wasmTypedArrayClassName($wasmArrayBuffer, $offset, $length))
             ->then
-                ->integer($result->getOffset())
-                    ->isEqualTo($offset)
-                ->integer($result->getLength())
-                    ->isEqualTo($length);
+                ->string($string)
+                    ->isEqualTo(str_repeat("\x00", 8))
+                ->integer($otherWasmUint8Array[0])
+                    ->isEqualTo(42)
+                ->string($wasmUint8Array->toHex())
+                    ->isEqualTo('070700002a000000');
     }
 
-    /**
-     * @dataProvider wasm_typed_arrays
-     */
-    public function test_wasm_typed_array_constructor_with_a_negative_offset(string $wasmTypedArrayClassName)
+    public function test_wasm_array_buffer_from_an_empty_string()
     {
         $this
-            ->given($wasmArrayBuffer = new WasmArrayBuffer(256))
             ->exception(
-                function () use ($wasmArrayBuffer, $wasmTypedArrayClassName) {
-                    new $wasmTypedArrayClassName($wasmArrayBuffer, -1);
+                function () {
+                    WasmArrayBuffer::fromString('');
                 }
             )
                 ->isInstanceOf(Exception::class)
-                ->hasMessage('Offset must be non-negative; given -1.');
+                ->hasMessage('Buffer length must be positive; given 0.')
+                ->hasCode(0);
     }
 
-    /**
-     * @dataProvider wasm_typed_arrays
-     */
-    public function test_wasm_typed_array_constructor_with_a_too_large_offset(string $wasmTypedArrayClassName)
+    public function test_wasm_array_buffer_copy_to()
     {
         $this
-            ->given($wasmArrayBuffer = new WasmArrayBuffer(256))
-            ->exception(
-                function () use ($wasmArrayBuffer, $wasmTypedArrayClassName) {
-                    new $wasmTypedArrayClassName($wasmArrayBuffer, 257);
-                }
+            ->given(
+                $source = WasmArrayBuffer::fromString('abcdefgh'),
+                $destination = new WasmArrayBuffer(8)
             )
-                ->isInstanceOf(Exception::class)
-                ->hasMessage('Offset must be smaller than the array buffer length; given 257, buffer length is 256.');
+            ->when($source->copyTo($destination, 2, 4, 4))
+            ->then
+                ->string((new WasmUint8Array($destination))->toHex())
+                    ->isEqualTo('0000000063646566');
     }
 
-    /**
-     * @dataProvider wasm_typed_arrays
-     */
-    public function test_wasm_typed_array_constructor_with_a_negative_length(string $wasmTypedArrayClassName)
+    public function test_wasm_array_buffer_copy_to_with_an_overlap()
     {
         $this
-            ->given($wasmArrayBuffer = new WasmArrayBuffer(256))
-            ->exception(
-                function () use ($wasmArrayBuffer, $wasmTypedArrayClassName) {
-                    new $wasmTypedArrayClassName($wasmArrayBuffer, 2, -1);
-                }
+            ->given(
+                $wasmArrayBuffer = WasmArrayBuffer::fromString('abcdefgh'),
+                $wasmUint8Array = new WasmUint8Array($wasmArrayBuffer)
             )
-                ->isInstanceOf(Exception::class)
-                ->hasMessage('Length must be non-negative; given -1.');
+            ->when($wasmArrayBuffer->copyTo($wasmArrayBuffer, 0, 2, 6))
+            ->then
+                ->string($wasmUint8Array->toHex())
+                    ->isEqualTo(bin2hex('ababcdef'))
+
+            ->when($wasmArrayBuffer->copyTo($wasmArrayBuffer, 2, 0, 6))
+            ->then
+                ->string($wasmUint8Array->toHex())
+                    ->isEqualTo(bin2hex('abcdefef'));
     }
 
-    /**
-     * @dataProvider wasm_typed_arrays
-     */
-    public function test_wasm_typed_array_constructor_with_a_too_large_length(string $wasmTypedArrayClassName)
+    public function test_wasm_array_buffer_copy_to_out_of_range()
     {
         $this
             ->given(
-                $wasmArrayBuffer = new WasmArrayBuffer(256),
-                $maximumLength = 256 / $wasmTypedArrayClassName::BYTES_PER_ELEMENT
+                $source = new WasmArrayBuffer(8),
+                $destination = new WasmArrayBuffer(4)
             )
             ->exception(
-                function () use ($wasmArrayBuffer, $wasmTypedArrayClassName) {
-                    new $wasmTypedArrayClassName($wasmArrayBuffer, 0, 257);
+                function () use ($source, $destination) {
+                    $source->copyTo($destination, 6, 0, 4);
                 }
             )
                 ->isInstanceOf(Exception::class)
-                ->hasMessage("Length must not be greater than the buffer length; given 257, maximum length is $maximumLength.");
+                ->hasMessage('Source range must be within the buffer range [0; 8]; given [6; 10[.')
+                ->hasCode(0)
+
+            ->exception(
+                function () use ($source, $destination) {
+                    $source->copyTo($destination, 0, 1, 4);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Destination range must be within the buffer range [0; 4]; given [1; 5[.')
+                ->hasCode(1)
+
+            ->exception(
+                function () use ($source, $destination) {
+                    $source->copyTo($destination, 0, 0, -1);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Length must be non-negative; given -1.')
+                ->hasCode(2);
     }
 
-    /**
-     * @dataProvider wasm_typed_arrays
-     */
-    public function test_wasm_typed_array_set_get(string $wasmTypedArrayClassName)
+    public function test_wasm_array_buffer_open_stream()
     {
         $this
-            ->given(
-                $wasmArrayBuffer = new WasmArrayBuffer($wasmTypedArrayClassName::BYTES_PER_ELEMENT),
-                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer),
-                $wasmTypedArray[0] = 42
+            ->given($wasmArrayBuffer = WasmArrayBuffer::fromString('Hello, World!'))
+            ->when($result = $wasmArrayBuffer->openStream(7, 5))
+            ->then
+                ->resource($result)
+                    ->isStream()
+                ->string(stream_get_contents($result))
+                    ->isEqualTo('World')
+                ->boolean(feof($result))
+                    ->isTrue()
+                ->integer(fstat($result)['size'])
+                    ->isEqualTo(5)
+
+            ->when(
+                rewind($result),
+                $written = fwrite($result, 'PHP and more')
             )
-            ->when($result = $wasmTypedArray[0])
             ->then
-                ->integer($result)
-                    ->isEqualTo(42);
+                ->integer($written)
+                    ->isEqualTo(5)
+                ->string((new WasmUint8Array($wasmArrayBuffer))->toHex())
+                    ->isEqualTo(bin2hex('Hello, PHP a!'));
     }
 
-    /**
-     * @dataProvider wasm_typed_arrays
-     */
-    public function test_wasm_typed_array_get_out_of_range(string $wasmTypedArrayClassName)
+    public function test_wasm_array_buffer_open_stream_is_seekable()
     {
         $this
             ->given(
-                $wasmArrayBuffer = new WasmArrayBuffer($wasmTypedArrayClassName::BYTES_PER_ELEMENT),
-                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer)
+                $wasmArrayBuffer = WasmArrayBuffer::fromString('abcdefgh'),
+                $stream = $wasmArrayBuffer->openStream()
             )
+            ->when(fseek($stream, -3, SEEK_END))
+            ->then
+                ->string(fread($stream, 8))
+                    ->isEqualTo('fgh')
+                ->integer(fseek($stream, 9))
+                    ->isEqualTo(-1)
+                ->integer(fseek($stream, 2))
+                    ->isEqualTo(0)
+                ->integer(ftell($stream))
+                    ->isEqualTo(2);
+    }
+
+    public function test_wasm_array_buffer_open_stream_out_of_range()
+    {
+        $this
+            ->given($wasmArrayBuffer = new WasmArrayBuffer(8))
             ->exception(
-                function () use ($wasmTypedArray) {
-                    return $wasmTypedArray[1];
+                function () use ($wasmArrayBuffer) {
+                    $wasmArrayBuffer->openStream(9);
                 }
             )
-                ->isInstanceOf(Exception::class);
-    }
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Offset is outside the buffer range [0; 8]; given 9.')
+                ->hasCode(0)
+
+            ->exception(
+                function () use ($wasmArrayBuffer) {
+                    $wasmArrayBuffer->openStream(4, 5);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Length must be in the range [0; 4]; given 5.')
+                ->hasCode(1);
+    }
+
+    public function test_wasm_array_buffer_get_byte_length()
+    {
+        $this
+            ->given(
+                $byteLength = 42,
+                $wasmArrayBuffer = new WasmArrayBuffer($byteLength)
+            )
+            ->when($result = $wasmArrayBuffer->getByteLength())
+            ->then
+                ->integer($result)
+                    ->isEqualTo($byteLength);
+    }
+
+    /**
+     * @dataProvider message_pack_values
+     */
+    public function test_wasm_array_buffer_message_pack_round_trip($value)
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(512),
+                $length = $wasmArrayBuffer->writeMessagePack(3, $value)
+            )
+            ->when($result = $wasmArrayBuffer->readMessagePack(3, $length))
+            ->then
+                ->variable($result)
+                    ->isIdenticalTo($value);
+    }
+
+    public function test_wasm_array_buffer_write_message_pack_bytes()
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(16),
+                $uint8 = new WasmUint8Array($wasmArrayBuffer)
+            )
+            ->when($result = $wasmArrayBuffer->writeMessagePack(0, ['a' => [1, -1], 'b' => null]))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(9)
+                ->array(array_map(function ($nth) use ($uint8) { return $uint8[$nth]; }, range(0, 8)))
+                    ->isEqualTo([0x82, 0xa1, 0x61, 0x92, 0x01, 0xff, 0xa1, 0x62, 0xc0]);
+    }
+
+    public function test_wasm_array_buffer_write_message_pack_buffer_too_small()
+    {
+        $this
+            ->given($wasmArrayBuffer = new WasmArrayBuffer(4))
+            ->exception(
+                function () use ($wasmArrayBuffer) {
+                    $wasmArrayBuffer->writeMessagePack(0, 'hello');
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('The buffer is too small to hold the encoded value.')
+                ->hasCode(1);
+    }
+
+    public function test_wasm_array_buffer_write_message_pack_unsupported_type()
+    {
+        $this
+            ->given($wasmArrayBuffer = new WasmArrayBuffer(4))
+            ->exception(
+                function () use ($wasmArrayBuffer) {
+                    $wasmArrayBuffer->writeMessagePack(0, new StdClass());
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('The value has a type that cannot be encoded or decoded.')
+                ->hasCode(1);
+    }
+
+    public function test_wasm_array_buffer_read_message_pack_truncated()
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(8),
+                $wasmArrayBuffer->writeMessagePack(0, 'hello')
+            )
+            ->exception(
+                function () use ($wasmArrayBuffer) {
+                    $wasmArrayBuffer->readMessagePack(0, 3);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('The encoded value is truncated.')
+                ->hasCode(2);
+    }
+
+    /**
+     * @dataProvider hashes
+     */
+    public function test_wasm_array_buffer_hash(string $algorithm, string $digest)
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(16),
+                $uint8 = new WasmUint8Array($wasmArrayBuffer, 3, 9)
+            )
+            ->when(
+                function () use ($uint8) {
+                    foreach (str_split('123456789') as $nth => $character) {
+                        $uint8[$nth] = ord($character);
+                    }
+                }
+            )
+            ->then
+                ->string($wasmArrayBuffer->hash($algorithm, 3, 9))
+                    ->isEqualTo($digest);
+    }
+
+    public function test_wasm_array_buffer_hash_up_to_the_end()
+    {
+        $this
+            ->given($wasmArrayBuffer = new WasmArrayBuffer(300))
+            ->then
+                ->string($wasmArrayBuffer->hash('xxh3', 3))
+                    ->isEqualTo('7fb8b84adf3307ec')
+                ->string($wasmArrayBuffer->hash('sha256', 3))
+                    ->isEqualTo('d99258f5d81067df4e95825381104fe6c90d04d01bdd2915954dd06f75d07c10');
+    }
+
+    public function test_wasm_array_buffer_hash_with_an_unknown_algorithm()
+    {
+        $this
+            ->given($wasmArrayBuffer = new WasmArrayBuffer(8))
+            ->exception(
+                function () use ($wasmArrayBuffer) {
+                    $wasmArrayBuffer->hash('md5');
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Unknown hash algorithm `md5`; expect one of crc32c, xxh3, or sha256.')
+                ->hasCode(2);
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_constructor(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $bufferLength = 256,
+                $wasmArrayBuffer = new WasmArrayBuffer($bufferLength)
+            )
+            ->when($result = new $wasmTypedArrayClassName($wasmArrayBuffer))
+            ->then
+                ->integer($result->getOffset())
+                    ->isZero()
+                ->integer($result->getLength())
+                    ->isEqualTo($bufferLength / $result::BYTES_PER_ELEMENT)
+                ->when(
+                    function () use ($result) {
+                        for ($i = 0; $i < $result->getLength(); ++$i) {
+                            $this
+                                ->integer($result[$i])
+                                    ->isEqualTo(0);
+                        }
+                    }
+                );
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_constructor_with_an_offset(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $bufferLength = 256,
+                $offset = 3,
+                $wasmArrayBuffer = new WasmArrayBuffer($bufferLength)
+            )
+            ->when($result = new $wasmTypedArrayClassName($wasmArrayBuffer, $offset))
+            ->then
+                ->integer($result->getOffset())
+                    ->isEqualTo($offset)
+                ->integer($result->getLength())
+                    ->isEqualTo((int) (($bufferLength - $offset) / $result::BYTES_PER_ELEMENT));
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_constructor_with_an_offset_and_a_length(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $bufferLength = 256,
+                $offset = 3,
+                $length = 12,
+                $wasmArrayBuffer = new WasmArrayBuffer($bufferLength)
+            )
+            ->when($result = new $wasmTypedArrayClassName($wasmArrayBuffer, $offset, $length))
+            ->then
+                ->integer($result->getOffset())
+                    ->isEqualTo($offset)
+                ->integer($result->getLength())
+                    ->isEqualTo($length);
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_constructor_with_a_negative_offset(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given($wasmArrayBuffer = new WasmArrayBuffer(256))
+            ->exception(
+                function () use ($wasmArrayBuffer, $wasmTypedArrayClassName) {
+                    new $wasmTypedArrayClassName($wasmArrayBuffer, -1);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Offset must be non-negative; given -1.');
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_constructor_with_a_too_large_offset(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given($wasmArrayBuffer = new WasmArrayBuffer(256))
+            ->exception(
+                function () use ($wasmArrayBuffer, $wasmTypedArrayClassName) {
+                    new $wasmTypedArrayClassName($wasmArrayBuffer, 257);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Offset must be smaller than the array buffer length; given 257, buffer length is 256.');
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_constructor_with_a_negative_length(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given($wasmArrayBuffer = new WasmArrayBuffer(256))
+            ->exception(
+                function () use ($wasmArrayBuffer, $wasmTypedArrayClassName) {
+                    new $wasmTypedArrayClassName($wasmArrayBuffer, 2, -1);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Length must be non-negative; given -1.');
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_constructor_with_a_too_large_length(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(256),
+                $maximumLength = 256 / $wasmTypedArrayClassName::BYTES_PER_ELEMENT
+            )
+            ->exception(
+                function () use ($wasmArrayBuffer, $wasmTypedArrayClassName) {
+                    new $wasmTypedArrayClassName($wasmArrayBuffer, 0, 257);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage("Length must not be greater than the buffer length; given 257, maximum length is $maximumLength.");
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_set_get(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer($wasmTypedArrayClassName::BYTES_PER_ELEMENT),
+                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer),
+                $wasmTypedArray[0] = 42
+            )
+            ->when($result = $wasmTypedArray[0])
+            ->then
+                ->integer($result)
+                    ->isEqualTo(42);
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_get_out_of_range(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer($wasmTypedArrayClassName::BYTES_PER_ELEMENT),
+                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer)
+            )
+            ->exception(
+                function () use ($wasmTypedArray) {
+                    return $wasmTypedArray[1];
+                }
+            )
+                ->isInstanceOf(Exception::class);
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_set_out_of_range(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer($wasmTypedArrayClassName::BYTES_PER_ELEMENT),
+                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer)
+            )
+            ->exception(
+                function () use ($wasmTypedArray) {
+                    $wasmTypedArray[1] = 42;
+                }
+            )
+                ->isInstanceOf(Exception::class);
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_exists(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer($wasmTypedArrayClassName::BYTES_PER_ELEMENT),
+                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer)
+            )
+            ->when($result = isset($wasmTypedArray[0]))
+            ->then
+                ->boolean($result)
+                    ->isTrue();
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_does_not_exist(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer($wasmTypedArrayClassName::BYTES_PER_ELEMENT),
+                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer)
+            )
+            ->when($result = isset($wasmTypedArray[1]))
+            ->then
+                ->boolean($result)
+                    ->isFalse()
+
+            ->when($result = isset($wasmTypedArray[-1]))
+            ->then
+                ->boolean($result)
+                    ->isFalse();
+    }
 
     /**
      * @dataProvider wasm_typed_arrays
      */
-    public function test_wasm_typed_array_set_out_of_range(string $wasmTypedArrayClassName)
+    public function test_wasm_typed_array_null_coalescing(string $wasmTypedArrayClassName)
     {
         $this
             ->given(
                 $wasmArrayBuffer = new WasmArrayBuffer($wasmTypedArrayClassName::BYTES_PER_ELEMENT),
-                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer)
-            )
-            ->exception(
-                function () use ($wasmTypedArray) {
-                    $wasmTypedArray[1] = 42;
-                }
+                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer),
+                $wasmTypedArray[0] = 42
             )
-                ->isInstanceOf(Exception::class);
+            ->when($result = $wasmTypedArray[0] ?? 7)
+            ->then
+                ->integer($result)
+                    ->isEqualTo(42)
+
+            ->when($result = $wasmTypedArray[1] ?? 7)
+            ->then
+                ->integer($result)
+                    ->isEqualTo(7)
+
+            ->when($result = $wasmTypedArray[-1] ?? 7)
+            ->then
+                ->integer($result)
+                    ->isEqualTo(7)
+
+            ->when($result = isset($wasmTypedArray[1][0]))
+            ->then
+                ->boolean($result)
+                    ->isFalse();
     }
 
     /**
      * @dataProvider wasm_typed_arrays
      */
-    public function test_wasm_typed_array_exists(string $wasmTypedArrayClassName)
+    public function test_wasm_typed_array_empty(string $wasmTypedArrayClassName)
     {
         $this
             ->given(
-                $wasmArrayBuffer = new WasmArrayBuffer($wasmTypedArrayClassName::BYTES_PER_ELEMENT),
-                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer)
+                $wasmArrayBuffer = new WasmArrayBuffer(2 * $wasmTypedArrayClassName::BYTES_PER_ELEMENT),
+                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer),
+                $wasmTypedArray[1] = 7
             )
-            ->when($result = isset($wasmTypedArray[0]))
+            ->when($result = empty($wasmTypedArray[0]))
+            ->then
+                ->boolean($result)
+                    ->isTrue()
+
+            ->when($result = empty($wasmTypedArray[1]))
+            ->then
+                ->boolean($result)
+                    ->isFalse()
+
+            ->when($result = empty($wasmTypedArray[2]))
             ->then
                 ->boolean($result)
                     ->isTrue();
@@ -588,22 +1149,58 @@ class Classes extends Suite
     /**
      * @dataProvider wasm_typed_arrays
      */
-    public function test_wasm_typed_array_does_not_exist(string $wasmTypedArrayClassName)
+    public function test_wasm_typed_array_numeric_string_offset(string $wasmTypedArrayClassName)
     {
         $this
             ->given(
-                $wasmArrayBuffer = new WasmArrayBuffer($wasmTypedArrayClassName::BYTES_PER_ELEMENT),
-                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer)
+                $wasmArrayBuffer = new WasmArrayBuffer(2 * $wasmTypedArrayClassName::BYTES_PER_ELEMENT),
+                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer),
+                $wasmTypedArray['1'] = 42
             )
-            ->when($result = isset($wasmTypedArray[1]))
+            ->when($result = $wasmTypedArray[1])
             ->then
-                ->boolean($result)
-                    ->isFalse()
+                ->integer($result)
+                    ->isEqualTo(42)
+                ->integer($wasmTypedArray['1'])
+                    ->isEqualTo(42)
+                ->boolean(isset($wasmTypedArray['1']))
+                    ->isTrue();
+    }
 
-            ->when($result = isset($wasmTypedArray[-1]))
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_compound_assignment(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer($wasmTypedArrayClassName::BYTES_PER_ELEMENT),
+                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer),
+                $wasmTypedArray[0] = 40
+            )
+            ->when($wasmTypedArray[0] += 2)
             ->then
-                ->boolean($result)
-                    ->isFalse();
+                ->integer($wasmTypedArray[0])
+                    ->isEqualTo(42);
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_append(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer($wasmTypedArrayClassName::BYTES_PER_ELEMENT),
+                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer)
+            )
+            ->exception(
+                function () use ($wasmTypedArray) {
+                    $wasmTypedArray[] = 42;
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Items cannot be appended to a WebAssembly typed array.');
     }
 
     /**
@@ -651,6 +1248,334 @@ class Classes extends Suite
                 ->isInstanceOf(Exception::class);
     }
 
+    public function test_wasm_typed_array_subclass_overriding_array_access()
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(2),
+                $wasmTypedArray = new class($wasmArrayBuffer) extends WasmUint8Array {
+                    public $unset = [];
+
+                    public function offsetSet($offset, $value): void
+                    {
+                        parent::offsetSet($offset, $value * 2);
+                    }
+
+                    public function offsetExists($offset): bool
+                    {
+                        return 1 === $offset;
+                    }
+
+                    public function offsetUnset($offset): void
+                    {
+                        $this->unset[] = $offset;
+                    }
+                },
+                $wasmTypedArray[0] = 21
+            )
+            ->when($result = $wasmTypedArray[0])
+            ->then
+                ->integer($result)
+                    ->isEqualTo(42)
+                ->boolean(isset($wasmTypedArray[0]))
+                    ->isFalse()
+                ->boolean(isset($wasmTypedArray[1]))
+                    ->isTrue()
+
+            ->when(
+                function () use ($wasmTypedArray) {
+                    unset($wasmTypedArray[0]);
+                }
+            )
+            ->then
+                ->array($wasmTypedArray->unset)
+                    ->isEqualTo([0])
+                ->integer($wasmTypedArray[0])
+                    ->isEqualTo(42);
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_fill_sum(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(100 * $wasmTypedArrayClassName::BYTES_PER_ELEMENT),
+                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer)
+            )
+            ->when(
+                $wasmTypedArray->fill(3),
+                $wasmTypedArray->fill(5, 10, 20)
+            )
+            ->then
+                ->integer($wasmTypedArray->sum())
+                    ->isEqualTo(320)
+                ->integer($wasmTypedArray->sum(10, 20))
+                    ->isEqualTo(50)
+                ->integer($wasmTypedArray[9])
+                    ->isEqualTo(3)
+                ->integer($wasmTypedArray[10])
+                    ->isEqualTo(5)
+                ->integer($wasmTypedArray[20])
+                    ->isEqualTo(3);
+    }
+
+    public function test_wasm_typed_array_sum_of_negative_items()
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(400),
+                $int8 = new WasmInt8Array($wasmArrayBuffer),
+                $int16 = new WasmInt16Array($wasmArrayBuffer),
+                $int32 = new WasmInt32Array($wasmArrayBuffer),
+                $uint32 = new WasmUint32Array($wasmArrayBuffer)
+            )
+            ->when($int8->fill(-1))
+            ->then
+                ->integer($int8->sum())
+                    ->isEqualTo(-400)
+                ->integer($int16->sum())
+                    ->isEqualTo(-200)
+                ->integer($int32->sum())
+                    ->isEqualTo(-100)
+                ->integer($uint32->sum())
+                    ->isEqualTo(100 * 0xffffffff);
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_index_of(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(100 * $wasmTypedArrayClassName::BYTES_PER_ELEMENT),
+                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer),
+                $wasmTypedArray[70] = 42,
+                $wasmTypedArray[99] = 42
+            )
+            ->then
+                ->integer($wasmTypedArray->indexOf(42))
+                    ->isEqualTo(70)
+                ->integer($wasmTypedArray->indexOf(42, 71))
+                    ->isEqualTo(99)
+                ->integer($wasmTypedArray->indexOf(7))
+                    ->isEqualTo(-1)
+                ->integer($wasmTypedArray->indexOf(PHP_INT_MAX))
+                    ->isEqualTo(-1);
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_min_max(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(100 * $wasmTypedArrayClassName::BYTES_PER_ELEMENT),
+                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer),
+                $wasmTypedArray->fill(7),
+                $wasmTypedArray[33] = 2,
+                $wasmTypedArray[66] = 99
+            )
+            ->then
+                ->integer($wasmTypedArray->min())
+                    ->isEqualTo(2)
+                ->integer($wasmTypedArray->max())
+                    ->isEqualTo(99)
+                ->integer($wasmTypedArray->max(0, 66))
+                    ->isEqualTo(7)
+                ->variable($wasmTypedArray->min(5, 5))
+                    ->isNull();
+    }
+
+    public function test_wasm_typed_array_copy_within()
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(7),
+                $uint8 = new WasmUint8Array($wasmArrayBuffer),
+                $uint8[0] = 1,
+                $uint8[1] = 2,
+                $uint8[2] = 3,
+                $uint8[3] = 4,
+                $uint8[4] = 5
+            )
+            ->when($uint8->copyWithin(2, 0, 5))
+            ->then
+                ->array(array_map(function ($nth) use ($uint8) { return $uint8[$nth]; }, range(0, 6)))
+                    ->isEqualTo([1, 2, 1, 2, 3, 4, 5]);
+    }
+
+    public function test_wasm_typed_array_compare()
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(64),
+                $left = new WasmUint8Array($wasmArrayBuffer, 0, 16),
+                $right = new WasmUint32Array($wasmArrayBuffer, 16, 4),
+                $shorter = new WasmUint8Array($wasmArrayBuffer, 32, 8)
+            )
+            ->then
+                ->integer($left->compare($right))
+                    ->isEqualTo(0)
+                ->integer($left->compare($shorter))
+                    ->isEqualTo(1)
+
+            ->when($right[3] = 1)
+            ->then
+                ->integer($left->compare($right))
+                    ->isEqualTo(-1)
+                ->integer($right->compare($left))
+                    ->isEqualTo(1);
+    }
+
+    public function test_wasm_typed_array_to_base64_to_hex()
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(8),
+                $uint8 = new WasmUint8Array($wasmArrayBuffer),
+                $uint16 = new WasmUint16Array($wasmArrayBuffer),
+                $uint8[1] = 0xde,
+                $uint8[2] = 0xad,
+                $uint8[3] = 0xbe,
+                $uint8[4] = 0xef
+            )
+            ->then
+                ->string($uint8->toHex(1, 5))
+                    ->isEqualTo('deadbeef')
+                ->string($uint8->toBase64(1, 5))
+                    ->isEqualTo(base64_encode("\xde\xad\xbe\xef"))
+                ->string($uint8->toBase64())
+                    ->isEqualTo(base64_encode("\x00\xde\xad\xbe\xef\x00\x00\x00"))
+                ->string($uint16->toHex(0, 2))
+                    ->isEqualTo('00deadbe')
+                ->string($uint8->toHex(3, 3))
+                    ->isEmpty();
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_foreach_count(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(5 * $wasmTypedArrayClassName::BYTES_PER_ELEMENT),
+                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer),
+                $wasmTypedArray[1] = 7,
+                $wasmTypedArray[4] = 42
+            )
+            ->then
+                ->integer(count($wasmTypedArray))
+                    ->isEqualTo(5)
+                ->integer($wasmTypedArray->count())
+                    ->isEqualTo(5)
+                ->array(iterator_to_array($wasmTypedArray))
+                    ->isEqualTo([0, 7, 0, 0, 42]);
+    }
+
+    public function test_wasm_typed_array_foreach_sees_writes()
+    {
+        $this
+            ->given(
+                $uint8 = new WasmUint8Array(new WasmArrayBuffer(4)),
+                $items = []
+            )
+            ->when(
+                function () use ($uint8, &$items) {
+                    foreach ($uint8 as $index => $item) {
+                        if ($index + 1 < count($uint8)) {
+                            $uint8[$index + 1] = $item + 1;
+                        }
+
+                        $items[] = $item;
+                    }
+                }
+            )
+            ->then
+                ->array($items)
+                    ->isEqualTo([0, 1, 2, 3]);
+    }
+
+    /**
+     * @dataProvider wasm_typed_arrays
+     */
+    public function test_wasm_typed_array_subarray(string $wasmTypedArrayClassName)
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(16 * $wasmTypedArrayClassName::BYTES_PER_ELEMENT),
+                $wasmTypedArray = new $wasmTypedArrayClassName($wasmArrayBuffer, $wasmTypedArrayClassName::BYTES_PER_ELEMENT),
+                $wasmTypedArray[3] = 42
+            )
+            ->when($result = $wasmTypedArray->subarray(3, 7))
+            ->then
+                ->object($result)
+                    ->isInstanceOf($wasmTypedArrayClassName)
+                ->integer($result->getOffset())
+                    ->isEqualTo(4 * $wasmTypedArrayClassName::BYTES_PER_ELEMENT)
+                ->integer($result->getLength())
+                    ->isEqualTo(4)
+                ->integer($result[0])
+                    ->isEqualTo(42)
+
+            ->when($result[1] = 7)
+            ->then
+                ->integer($wasmTypedArray[4])
+                    ->isEqualTo(7)
+                ->integer($wasmTypedArray->subarray(5)->getLength())
+                    ->isEqualTo(10);
+    }
+
+    public function test_wasm_typed_array_constructor_over_a_typed_array()
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(16),
+                $uint8 = new WasmUint8Array($wasmArrayBuffer, 4, 8),
+                $uint8[2] = 1,
+                $uint8[3] = 2
+            )
+            ->when($result = new WasmUint16Array($uint8, 2))
+            ->then
+                ->integer($result->getOffset())
+                    ->isEqualTo(6)
+                ->integer($result->getLength())
+                    ->isEqualTo(3)
+                ->integer($result[0])
+                    ->isEqualTo(0x0201);
+    }
+
+    public function test_wasm_typed_array_constructor_over_an_invalid_object()
+    {
+        $this
+            ->exception(
+                function () {
+                    new WasmUint8Array(new StdClass());
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('The view must be built over a WasmArrayBuffer or a WebAssembly typed array; given an instance of `stdClass`.')
+                ->hasCode(5);
+    }
+
+    public function test_wasm_typed_array_bulk_operation_out_of_range()
+    {
+        $this
+            ->given($uint8 = new WasmUint8Array(new WasmArrayBuffer(8)))
+            ->exception(
+                function () use ($uint8) {
+                    $uint8->sum(2, 9);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Range must be within the view range [0; 8]; given [2; 9[.')
+                ->hasCode(0);
+    }
+
     public function test_wasm_typed_array_share_the_same_buffer()
     {
         $this
@@ -710,6 +1635,34 @@ class Classes extends Suite
                     ->isEqualTo(0b00000000000000000000000000000001);
     }
 
+    protected function message_pack_values()
+    {
+        yield [null];
+        yield [true];
+        yield [false];
+        yield [0];
+        yield [127];
+        yield [-32];
+        yield [-33];
+        yield [65536];
+        yield [PHP_INT_MAX];
+        yield [PHP_INT_MIN];
+        yield [4.2];
+        yield [''];
+        yield [str_repeat('x', 300)];
+        yield [[]];
+        yield [[1, 2, 3]];
+        yield [[1 => 'a', 0 => 'b']];
+        yield [['foo' => ['bar' => [1.5, 'baz']], 7 => false]];
+    }
+
+    protected function hashes()
+    {
+        yield ['crc32c', 'e3069283'];
+        yield ['xxh3', '72dcb18b67a17dff'];
+        yield ['sha256', '15e2b0d3c33891ebb0f1ef609ec419420c20e320ce94c65fbc8c3312448eb225'];
+    }
+
     protected function wasm_typed_arrays()
     {
         yield [WasmInt8Array::class];
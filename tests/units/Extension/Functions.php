@@ -34,7 +34,7 @@ class Functions extends Suite
             ->when($result = $reflection->getFunctions())
             ->then
                 ->array($result)
-                    ->hasSize(12)
+                    ->hasSize(20)
                     ->object['wasm_fetch_bytes']->isInstanceOf(ReflectionFunction::class)
                     ->object['wasm_validate']->isInstanceOf(ReflectionFunction::class)
                     ->object['wasm_compile']->isInstanceOf(ReflectionFunction::class)
@@ -42,10 +42,18 @@ class Functions extends Suite
                     ->object['wasm_module_serialize']->isInstanceOf(ReflectionFunction::class)
                     ->object['wasm_module_deserialize']->isInstanceOf(ReflectionFunction::class)
                     ->object['wasm_module_new_instance']->isInstanceOf(ReflectionFunction::class)
+                    ->object['wasm_module_new_linked_instance']->isInstanceOf(ReflectionFunction::class)
                     ->object['wasm_new_instance']->isInstanceOf(ReflectionFunction::class)
                     ->object['wasm_value']->isInstanceOf(ReflectionFunction::class)
                     ->object['wasm_invoke_function']->isInstanceOf(ReflectionFunction::class)
+                    ->object['wasm_async_invoke_function']->isInstanceOf(ReflectionFunction::class)
+                    ->object['wasm_async_resume']->isInstanceOf(ReflectionFunction::class)
+                    ->object['wasm_async_get_result']->isInstanceOf(ReflectionFunction::class)
                     ->object['wasm_get_memory_buffer']->isInstanceOf(ReflectionFunction::class)
+                    ->object['wasm_instance_set_output_stream']->isInstanceOf(ReflectionFunction::class)
+                    ->object['wasm_instance_set_input_stream']->isInstanceOf(ReflectionFunction::class)
+                    ->object['wasm_instance_set_call_queue_handler']->isInstanceOf(ReflectionFunction::class)
+                    ->object['wasm_instance_set_trace_stream']->isInstanceOf(ReflectionFunction::class)
                     ->object['wasm_get_last_error']->isInstanceOf(ReflectionFunction::class)
 
             ->when($_result = $result['wasm_fetch_bytes'])
@@ -160,8 +168,9 @@ class Functions extends Suite
             ->when($_result = $result['wasm_module_deserialize'])
             ->then
                 ->integer($_result->getNumberOfParameters())
+                    ->isEqualTo(2)
+                ->integer($_result->getNumberOfRequiredParameters())
                     ->isEqualTo(1)
-                    ->isEqualTo($_result->getNumberOfRequiredParameters())
 
                 ->let($parameters = $_result->getParameters())
 
@@ -172,6 +181,13 @@ class Functions extends Suite
                 ->boolean($parameters[0]->getType()->allowsNull())
                     ->isFalse()
 
+                ->string($parameters[1]->getName())
+                    ->isEqualTo('wasm_module_unique_identifier')
+                ->string($parameters[1]->getType() . '')
+                    ->isEqualTo('string')
+                ->boolean($parameters[1]->getType()->allowsNull())
+                    ->isTrue()
+
                 ->let($return_type = $_result->getReturnType())
 
                 ->string($return_type . '')
@@ -201,6 +217,34 @@ class Functions extends Suite
                 ->boolean($return_type->allowsNull())
                     ->isTrue()
 
+            ->when($_result = $result['wasm_module_new_linked_instance'])
+            ->then
+                ->integer($_result->getNumberOfParameters())
+                    ->isEqualTo(2)
+                    ->isEqualTo($_result->getNumberOfRequiredParameters())
+
+                ->let($parameters = $_result->getParameters())
+
+                ->string($parameters[0]->getName())
+                    ->isEqualTo('wasm_module')
+                ->string($parameters[0]->getType() . '')
+                    ->isEqualTo('resource')
+                ->boolean($parameters[0]->getType()->allowsNull())
+                    ->isFalse()
+                ->string($parameters[1]->getName())
+                    ->isEqualTo('linked_instances')
+                ->string($parameters[1]->getType() . '')
+                    ->isEqualTo('array')
+                ->boolean($parameters[1]->getType()->allowsNull())
+                    ->isFalse()
+
+                ->let($return_type = $_result->getReturnType())
+
+                ->string($return_type . '')
+                    ->isEqualTo('resource')
+                ->boolean($return_type->allowsNull())
+                    ->isTrue()
+
             ->when($_result = $result['wasm_new_instance'])
             ->then
                 ->integer($_result->getNumberOfParameters())
@@ -308,6 +352,146 @@ class Functions extends Suite
                 ->boolean($return_type->allowsNull())
                     ->isTrue()
 
+            ->when($_result = $result['wasm_instance_set_output_stream'])
+            ->then
+                ->integer($_result->getNumberOfParameters())
+                    ->isEqualTo(2)
+                ->integer($_result->getNumberOfRequiredParameters())
+                    ->isEqualTo(1)
+
+                ->let($parameters = $_result->getParameters())
+
+                ->string($parameters[0]->getName())
+                    ->isEqualTo('wasm_instance')
+                ->string($parameters[0]->getType() . '')
+                    ->isEqualTo('resource')
+                ->boolean($parameters[0]->getType()->allowsNull())
+                    ->isFalse()
+                ->string($parameters[1]->getName())
+                    ->isEqualTo('stream')
+                ->string($parameters[1]->getType() . '')
+                    ->isEqualTo('resource')
+                ->boolean($parameters[1]->getType()->allowsNull())
+                    ->isTrue()
+
+                ->let($return_type = $_result->getReturnType())
+
+                ->string($return_type . '')
+                    ->isEqualTo('void')
+                ->boolean($return_type->allowsNull())
+                    ->isFalse()
+
+            ->when($_result = $result['wasm_instance_set_input_stream'])
+            ->then
+                ->integer($_result->getNumberOfParameters())
+                    ->isEqualTo(2)
+                ->integer($_result->getNumberOfRequiredParameters())
+                    ->isEqualTo(1)
+
+                ->let($parameters = $_result->getParameters())
+
+                ->string($parameters[0]->getName())
+                    ->isEqualTo('wasm_instance')
+                ->string($parameters[0]->getType() . '')
+                    ->isEqualTo('resource')
+                ->boolean($parameters[0]->getType()->allowsNull())
+                    ->isFalse()
+                ->string($parameters[1]->getName())
+                    ->isEqualTo('stream')
+                ->string($parameters[1]->getType() . '')
+                    ->isEqualTo('resource')
+                ->boolean($parameters[1]->getType()->allowsNull())
+                    ->isTrue()
+
+                ->let($return_type = $_result->getReturnType())
+
+                ->string($return_type . '')
+                    ->isEqualTo('void')
+                ->boolean($return_type->allowsNull())
+                    ->isFalse()
+
+            ->when($_result = $result['wasm_instance_set_call_queue_handler'])
+            ->then
+                ->integer($_result->getNumberOfParameters())
+                    ->isEqualTo(2)
+                ->integer($_result->getNumberOfRequiredParameters())
+                    ->isEqualTo(1)
+
+                ->let($parameters = $_result->getParameters())
+
+                ->string($parameters[0]->getName())
+                    ->isEqualTo('wasm_instance')
+                ->string($parameters[0]->getType() . '')
+                    ->isEqualTo('resource')
+                ->boolean($parameters[0]->getType()->allowsNull())
+                    ->isFalse()
+                ->string($parameters[1]->getName())
+                    ->isEqualTo('handler')
+                ->string($parameters[1]->getType() . '')
+                    ->isEqualTo('callable')
+                ->boolean($parameters[1]->getType()->allowsNull())
+                    ->isTrue()
+
+                ->let($return_type = $_result->getReturnType())
+
+                ->string($return_type . '')
+                    ->isEqualTo('void')
+                ->boolean($return_type->allowsNull())
+                    ->isFalse()
+
+            ->when($_result = $result['wasm_instance_set_trace_stream'])
+            ->then
+                ->integer($_result->getNumberOfParameters())
+                    ->isEqualTo(2)
+                ->integer($_result->getNumberOfRequiredParameters())
+                    ->isEqualTo(1)
+
+                ->let($parameters = $_result->getParameters())
+
+                ->string($parameters[0]->getName())
+                    ->isEqualTo('wasm_instance')
+                ->string($parameters[0]->getType() . '')
+                    ->isEqualTo('resource')
+                ->boolean($parameters[0]->getType()->allowsNull())
+                    ->isFalse()
+                ->string($parameters[1]->getName())
+                    ->isEqualTo('stream')
+                ->string($parameters[1]->getType() . '')
+                    ->isEqualTo('resource')
+                ->boolean($parameters[1]->getType()->allowsNull())
+                    ->isTrue()
+
+                ->let($return_type = $_result->getReturnType())
+
+                ->string($return_type . '')
+                    ->isEqualTo('void')
+                ->boolean($return_type->allowsNull())
+                    ->isFalse()
+
+            ->when($_result = $result['wasm_async_resume'])
+            ->then
+                ->integer($_result->getNumberOfParameters())
+                    ->isEqualTo(2)
+                    ->isEqualTo($_result->getNumberOfRequiredParameters())
+
+                ->let($parameters = $_result->getParameters())
+
+                ->string($parameters[0]->getName())
+                    ->isEqualTo('wasm_instance')
+                ->string($parameters[0]->getType() . '')
+                    ->isEqualTo('resource')
+                ->string($parameters[1]->getName())
+                    ->isEqualTo('response')
+                ->string($parameters[1]->getType() . '')
+                    ->isEqualTo('string')
+
+                ->let($return_type = $_result->getReturnType())
+
+                ->string($return_type . '')
+                    ->isEqualTo('string')
+                ->boolean($return_type->allowsNull())
+                    ->isTrue()
+
             ->when($_result = $result['wasm_get_last_error'])
             ->then
                 ->integer($_result->getNumberOfParameters())
@@ -448,6 +632,28 @@ class Functions extends Suite
                     ->isEqualTo(3);
     }
 
+    public function test_wasm_module_deserialize_with_an_unique_identifier()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(self::FILE_PATH),
+                $wasmModule = wasm_compile($wasmBytes),
+                $wasmSerializedModule = wasm_module_serialize($wasmModule),
+                $wasmModuleIdentifier = __METHOD__
+            )
+            ->when($result = wasm_module_deserialize($wasmSerializedModule, $wasmModuleIdentifier))
+            ->then
+                ->resource($result)
+                    ->isOfType('wasm_module')
+                ->string($result . '')
+                    ->isEqualTo('Resource id #-1')
+
+            ->when($result = wasm_module_deserialize('foobar', $wasmModuleIdentifier))
+            ->then
+                ->resource($result)
+                    ->isOfType('wasm_module');
+    }
+
     public function test_wasm_module_deserialize_failed()
     {
         $this
@@ -473,6 +679,72 @@ class Functions extends Suite
                     ->isOfType('wasm_instance');
     }
 
+    public function test_wasm_module_new_linked_instance()
+    {
+        $this
+            ->given(
+                $library = wasm_new_instance(wasm_fetch_bytes(self::FILE_PATH)),
+                $wasmModule = wasm_compile(wasm_fetch_bytes(dirname(__DIR__) . '/link.wasm'))
+            )
+            ->when($result = wasm_module_new_linked_instance($wasmModule, ['library' => $library]))
+            ->then
+                ->resource($result)
+                    ->isOfType('wasm_instance')
+                ->integer(wasm_invoke_function($result, 'add_twice', [1, 2]))
+                    ->isEqualTo(5);
+    }
+
+    public function test_wasm_module_new_linked_instance_shares_the_memory()
+    {
+        $this
+            ->given(
+                $library = wasm_new_instance(wasm_fetch_bytes(self::FILE_PATH)),
+                $pointer = wasm_invoke_function($library, 'string', []),
+                $wasmModule = wasm_compile(wasm_fetch_bytes(dirname(__DIR__) . '/link.wasm')),
+                $wasmInstance = wasm_module_new_linked_instance($wasmModule, ['library' => $library])
+            )
+            ->when($result = wasm_invoke_function($wasmInstance, 'read_shared', [$pointer]))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(ord('H'))
+
+            ->when(wasm_invoke_function($wasmInstance, 'write_shared', [$pointer, ord('J')]))
+            ->then
+                ->integer((new WasmUint8Array(wasm_get_memory_buffer($library), $pointer))[0])
+                    ->isEqualTo(ord('J'))
+                ->integer((new WasmUint8Array(wasm_get_memory_buffer($wasmInstance), $pointer))[0])
+                    ->isEqualTo(ord('J'));
+    }
+
+    public function test_wasm_module_new_linked_instance_with_a_missing_export()
+    {
+        $this
+            ->given(
+                $library = wasm_new_instance(wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm')),
+                $wasmModule = wasm_compile(wasm_fetch_bytes(dirname(__DIR__) . '/link.wasm'))
+            )
+            ->exception(
+                function () use ($wasmModule, $library) {
+                    wasm_module_new_linked_instance($wasmModule, ['library' => $library]);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('The import `library.sum` has no export of the same name and of the same kind in the linked instance.');
+    }
+
+    public function test_wasm_module_new_linked_instance_with_an_invalid_instance()
+    {
+        $this
+            ->given($wasmModule = wasm_compile(wasm_fetch_bytes(dirname(__DIR__) . '/link.wasm')))
+            ->exception(
+                function () use ($wasmModule) {
+                    wasm_module_new_linked_instance($wasmModule, ['library' => 42]);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('The linked instances must be `wasm_instance` resources indexed by the namespace of the imports they resolve.');
+    }
+
     public function test_wasm_new_instance()
     {
         $this
@@ -747,6 +1019,87 @@ class Functions extends Suite
         ];
     }
 
+    public function test_wasm_async_invoke_function()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm'),
+                $wasmInstance = wasm_new_instance($wasmBytes),
+                wasm_invoke_function($wasmInstance, 'async_open', [])
+            )
+            ->when($result = wasm_async_invoke_function($wasmInstance, 'await_twice', [10]))
+            ->then
+                ->string($result)
+                    ->isEqualTo('first')
+
+            ->when($result = wasm_async_resume($wasmInstance, 'abc'))
+            ->then
+                ->string($result)
+                    ->isEqualTo('second')
+
+            ->when($result = wasm_async_resume($wasmInstance, 'defgh'))
+            ->then
+                ->variable($result)
+                    ->isNull()
+                ->integer(wasm_async_get_result($wasmInstance))
+                    ->isEqualTo(18);
+    }
+
+    public function test_wasm_async_invoke_function_interleaved()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm'),
+                $wasmInstanceA = wasm_new_instance($wasmBytes),
+                $wasmInstanceB = wasm_new_instance($wasmBytes),
+                wasm_invoke_function($wasmInstanceA, 'async_open', []),
+                wasm_invoke_function($wasmInstanceB, 'async_open', [])
+            )
+            ->when(
+                wasm_async_invoke_function($wasmInstanceA, 'await_twice', [100]),
+                wasm_async_invoke_function($wasmInstanceB, 'await_twice', [200]),
+                wasm_async_resume($wasmInstanceB, 'b'),
+                wasm_async_resume($wasmInstanceA, 'a'),
+                wasm_async_resume($wasmInstanceA, 'aa'),
+                wasm_async_resume($wasmInstanceB, 'bbb')
+            )
+            ->then
+                ->integer(wasm_async_get_result($wasmInstanceA))
+                    ->isEqualTo(103)
+                ->integer(wasm_async_get_result($wasmInstanceB))
+                    ->isEqualTo(204);
+    }
+
+    public function test_wasm_invoke_function_cannot_await()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm'),
+                $wasmInstance = wasm_new_instance($wasmBytes),
+                wasm_invoke_function($wasmInstance, 'async_open', [])
+            )
+            ->when($result = wasm_invoke_function($wasmInstance, 'await_twice', [10]))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(8);
+    }
+
+    public function test_wasm_async_resume_without_suspended_call()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm'),
+                $wasmInstance = wasm_new_instance($wasmBytes)
+            )
+            ->exception(
+                function () use ($wasmInstance) {
+                    wasm_async_resume($wasmInstance, 'abc');
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('The instance has no suspended asynchronous call.');
+    }
+
     public function test_wasm_get_memory_buffer()
     {
         $this
@@ -796,6 +1149,353 @@ class Functions extends Suite
                     ->isNull();
     }
 
+    public function test_wasm_instance_set_output_stream()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm'),
+                $wasmInstance = wasm_new_instance($wasmBytes),
+                $stream = fopen('php://memory', 'w+')
+            )
+            ->when($result = wasm_instance_set_output_stream($wasmInstance, $stream))
+            ->then
+                ->variable($result)
+                    ->isNull()
+
+            ->when($result = wasm_invoke_function($wasmInstance, 'write_greetings', [1000]))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(13000)
+                ->string(stream_get_contents($stream, -1, 0))
+                    ->isEqualTo(str_repeat('Hello, World!', 1000));
+    }
+
+    public function test_wasm_instance_set_output_stream_to_the_output_layer()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm'),
+                $wasmInstance = wasm_new_instance($wasmBytes),
+                wasm_instance_set_output_stream($wasmInstance, fopen('php://memory', 'w+'))
+            )
+            ->when(
+                wasm_instance_set_output_stream($wasmInstance, null),
+                ob_start(),
+                $result = wasm_invoke_function($wasmInstance, 'write_greeting', []),
+                $output = ob_get_clean()
+            )
+            ->then
+                ->integer($result)
+                    ->isEqualTo(13)
+                ->string($output)
+                    ->isEqualTo('Hello, World!');
+    }
+
+    public function test_wasm_instance_set_output_stream_out_of_bounds()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm'),
+                $wasmInstance = wasm_new_instance($wasmBytes),
+                $stream = fopen('php://memory', 'w+'),
+                wasm_instance_set_output_stream($wasmInstance, $stream)
+            )
+            ->when($result = wasm_invoke_function($wasmInstance, 'write_out_of_bounds', []))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(-1)
+                ->string(stream_get_contents($stream, -1, 0))
+                    ->isEmpty();
+    }
+
+    public function test_wasm_instance_set_output_stream_not_a_stream()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm'),
+                $wasmInstance = wasm_new_instance($wasmBytes)
+            )
+            ->exception(
+                function () use ($wasmInstance, $wasmBytes) {
+                    wasm_instance_set_output_stream($wasmInstance, $wasmBytes);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('The output of an instance must be an open stream.');
+    }
+
+    public function test_wasm_instance_set_input_stream()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm'),
+                $wasmInstance = wasm_new_instance($wasmBytes),
+                $input = fopen('php://memory', 'w+'),
+                fwrite($input, str_repeat('abcdefghijklmnopqrstuvwxyz', 100)),
+                rewind($input),
+                $output = fopen('php://memory', 'w+'),
+                wasm_instance_set_output_stream($wasmInstance, $output)
+            )
+            ->when($result = wasm_instance_set_input_stream($wasmInstance, $input))
+            ->then
+                ->variable($result)
+                    ->isNull()
+
+            ->when($result = wasm_invoke_function($wasmInstance, 'copy_input_to_output', []))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(2600)
+                ->string(stream_get_contents($output, -1, 0))
+                    ->isEqualTo(str_repeat('abcdefghijklmnopqrstuvwxyz', 100));
+    }
+
+    public function test_wasm_instance_set_input_stream_without_input()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm'),
+                $wasmInstance = wasm_new_instance($wasmBytes)
+            )
+            ->when($result = wasm_invoke_function($wasmInstance, 'copy_input_to_output', []))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(-1);
+    }
+
+    public function test_wasm_instance_set_input_stream_out_of_bounds()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm'),
+                $wasmInstance = wasm_new_instance($wasmBytes),
+                $input = fopen('php://memory', 'w+'),
+                fwrite($input, 'abc'),
+                rewind($input),
+                wasm_instance_set_input_stream($wasmInstance, $input)
+            )
+            ->when($result = wasm_invoke_function($wasmInstance, 'read_out_of_bounds', []))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(-1)
+                ->integer(ftell($input))
+                    ->isEqualTo(0);
+    }
+
+    public function test_wasm_instance_set_input_stream_not_a_stream()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm'),
+                $wasmInstance = wasm_new_instance($wasmBytes)
+            )
+            ->exception(
+                function () use ($wasmInstance, $wasmBytes) {
+                    wasm_instance_set_input_stream($wasmInstance, $wasmBytes);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('The input of an instance must be an open stream.');
+    }
+
+    public function test_wasm_instance_set_call_queue_handler()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm'),
+                $wasmInstance = wasm_new_instance($wasmBytes),
+                $batches = []
+            )
+            ->when(
+                $result = wasm_instance_set_call_queue_handler(
+                    $wasmInstance,
+                    function (array $records) use (&$batches) {
+                        $batches[] = $records;
+                    }
+                )
+            )
+            ->then
+                ->variable($result)
+                    ->isNull()
+
+            ->when(
+                wasm_invoke_function($wasmInstance, 'queue_open', []),
+                $result = wasm_invoke_function($wasmInstance, 'log_greetings', [12])
+            )
+            ->then
+                ->integer($result)
+                    ->isEqualTo(12)
+                ->array($batches)
+                    ->hasSize(3)
+                ->array($batches[0])
+                    ->hasSize(5)
+                ->array($batches[2])
+                    ->isEqualTo([
+                        [1, 'Hello, World!'],
+                        [1, 'Hello, World!'],
+                    ]);
+    }
+
+    public function test_wasm_instance_set_call_queue_handler_throws()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm'),
+                $wasmInstance = wasm_new_instance($wasmBytes),
+                wasm_invoke_function($wasmInstance, 'queue_open', []),
+                wasm_instance_set_call_queue_handler(
+                    $wasmInstance,
+                    function (array $records) {
+                        throw new RuntimeException('Oops, ' . count($records) . ' records.');
+                    }
+                )
+            )
+            ->exception(
+                function () use ($wasmInstance) {
+                    wasm_invoke_function($wasmInstance, 'log_greetings', [2]);
+                }
+            )
+                ->isInstanceOf(RuntimeException::class)
+                ->hasMessage('Oops, 2 records.');
+    }
+
+    public function test_wasm_instance_set_call_queue_handler_not_callable()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(dirname(__DIR__) . '/host.wasm'),
+                $wasmInstance = wasm_new_instance($wasmBytes)
+            )
+            ->exception(
+                function () use ($wasmInstance) {
+                    wasm_instance_set_call_queue_handler($wasmInstance, 'undefined_function');
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('The call queue handler must be callable.');
+    }
+
+    public function test_wasm_instance_set_trace_stream()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(self::FILE_PATH),
+                $wasmInstance = wasm_new_instance($wasmBytes),
+                $stream = fopen('php://memory', 'w+')
+            )
+            ->when($result = wasm_instance_set_trace_stream($wasmInstance, $stream))
+            ->then
+                ->variable($result)
+                    ->isNull()
+                ->string(stream_get_contents($stream, -1, 0))
+                    ->isEqualTo("WTRC\x01\x00\x00\x00")
+
+            ->when(
+                wasm_invoke_function($wasmInstance, 'sum', [1, 2]),
+                $offset = ftell($stream),
+                $result = wasm_invoke_function($wasmInstance, 'sum', [3, 4])
+            )
+            ->then
+                ->integer($result)
+                    ->isEqualTo(7)
+                // The name, the 2 `i32` inputs, no region since the
+                // memory has not been written, and the `i32` result.
+                ->string(stream_get_contents($stream, -1, $offset))
+                    ->isEqualTo(
+                        pack('V', 3) . 'sum' .
+                        "\x02" . "\x00" . pack('P', 3) . "\x00" . pack('P', 4) .
+                        pack('V', 0) .
+                        "\x02" . "\x00" . pack('P', 7)
+                    );
+    }
+
+    public function test_wasm_instance_set_trace_stream_records_the_whole_initial_memory()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(self::FILE_PATH),
+                $wasmInstance = wasm_new_instance($wasmBytes),
+                $memoryLength = wasm_get_memory_buffer($wasmInstance)->getByteLength(),
+                $stream = fopen('php://memory', 'w+'),
+                wasm_instance_set_trace_stream($wasmInstance, $stream)
+            )
+            ->when(
+                wasm_invoke_function($wasmInstance, 'sum', [1, 2]),
+                $record = stream_get_contents($stream, -1, 8)
+            )
+            ->then
+                // One region, the whole memory, even its zeros.
+                ->array(unpack('Vregions/Voffset/Vlength', $record, 26))
+                    ->isEqualTo(['regions' => 1, 'offset' => 0, 'length' => $memoryLength])
+                ->integer(strlen($record))
+                    ->isEqualTo(38 + $memoryLength + 10);
+    }
+
+    public function test_wasm_instance_set_trace_stream_records_the_written_memory()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(self::FILE_PATH),
+                $wasmInstance = wasm_new_instance($wasmBytes),
+                $stream = fopen('php://memory', 'w+'),
+                wasm_instance_set_trace_stream($wasmInstance, $stream),
+                wasm_invoke_function($wasmInstance, 'sum', [1, 2]),
+                $offset = ftell($stream),
+                $memory = new WasmUint8Array(wasm_get_memory_buffer($wasmInstance)),
+                $memory[4096 + 100] = 42
+            )
+            ->when(
+                wasm_invoke_function($wasmInstance, 'sum', [3, 4]),
+                $record = stream_get_contents($stream, -1, $offset)
+            )
+            ->then
+                // One region, the block of 4096 bytes holding the
+                // written byte.
+                ->array(unpack('Vregions/Voffset/Vlength', $record, 26))
+                    ->isEqualTo(['regions' => 1, 'offset' => 4096, 'length' => 4096])
+                ->integer(ord($record[38 + 100]))
+                    ->isEqualTo(42)
+                ->integer(strlen($record))
+                    ->isEqualTo(38 + 4096 + 10);
+    }
+
+    public function test_wasm_instance_set_trace_stream_to_null()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(self::FILE_PATH),
+                $wasmInstance = wasm_new_instance($wasmBytes),
+                $stream = fopen('php://memory', 'w+'),
+                wasm_instance_set_trace_stream($wasmInstance, $stream),
+                wasm_invoke_function($wasmInstance, 'sum', [1, 2]),
+                $offset = ftell($stream)
+            )
+            ->when(
+                wasm_instance_set_trace_stream($wasmInstance, null),
+                $result = wasm_invoke_function($wasmInstance, 'sum', [3, 4])
+            )
+            ->then
+                ->integer($result)
+                    ->isEqualTo(7)
+                ->integer(ftell($stream))
+                    ->isEqualTo($offset);
+    }
+
+    public function test_wasm_instance_set_trace_stream_not_a_stream()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(self::FILE_PATH),
+                $wasmInstance = wasm_new_instance($wasmBytes)
+            )
+            ->exception(
+                function () use ($wasmInstance, $wasmBytes) {
+                    wasm_instance_set_trace_stream($wasmInstance, $wasmBytes);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('The trace of an instance must be an open stream.');
+    }
+
     public function test_wasm_get_last_error()
     {
         $this
@@ -0,0 +1,201 @@
+<?php
+
+declare(strict_types = 1);
+
+namespace Wasm\Tests\Units\Extension;
+
+use StdClass;
+use WasmUint8Array;
+use Wasm\Tests\Suite;
+
+class HostFunctions extends Suite
+{
+    const FILE_PATH = __DIR__ . '/../host.wasm';
+
+    public function getTestedClassName()
+    {
+        return StdClass::class;
+    }
+
+    public function getTestedClassNamespace()
+    {
+        return '\\';
+    }
+
+    public function test_php_clock_ns()
+    {
+        $this
+            ->given($wasmInstance = wasm_new_instance(wasm_fetch_bytes(self::FILE_PATH)))
+            ->when(
+                $first = wasm_invoke_function($wasmInstance, 'clock_ns', []),
+                $second = wasm_invoke_function($wasmInstance, 'clock_ns', [])
+            )
+            ->then
+                ->integer($first)
+                    ->isGreaterThan(0)
+                ->integer($second)
+                    ->isGreaterThanOrEqualTo($first);
+    }
+
+    public function test_php_random_fill()
+    {
+        $this
+            ->given(
+                $wasmInstance = wasm_new_instance(wasm_fetch_bytes(self::FILE_PATH)),
+                $scratch = wasm_invoke_function($wasmInstance, 'scratch', [])
+            )
+            ->when($result = wasm_invoke_function($wasmInstance, 'random_fill', [$scratch, 32]))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(0)
+                ->string($this->read($wasmInstance, $scratch, 32))
+                    ->isNotEqualTo(str_repeat("\0", 32))
+
+            ->when($result = wasm_invoke_function($wasmInstance, 'random_fill', [-16, 32]))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(-1);
+    }
+
+    public function test_php_sha256()
+    {
+        $this
+            ->given(
+                $wasmInstance = wasm_new_instance(wasm_fetch_bytes(self::FILE_PATH)),
+                $scratch = wasm_invoke_function($wasmInstance, 'scratch', []),
+                $this->write($wasmInstance, $scratch, 'Hello, World!')
+            )
+            ->when($result = wasm_invoke_function($wasmInstance, 'sha256', [$scratch, 13, $scratch + 64]))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(0)
+                ->string(bin2hex($this->read($wasmInstance, $scratch + 64, 32)))
+                    ->isEqualTo(hash('sha256', 'Hello, World!'))
+
+            ->when($result = wasm_invoke_function($wasmInstance, 'sha256', [$scratch, 13, -16]))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(-1);
+    }
+
+    public function test_php_xxh3()
+    {
+        $this
+            ->given(
+                $wasmInstance = wasm_new_instance(wasm_fetch_bytes(self::FILE_PATH)),
+                $scratch = wasm_invoke_function($wasmInstance, 'scratch', []),
+                $this->write($wasmInstance, $scratch, 'Hello, World!')
+            )
+            ->when($result = wasm_invoke_function($wasmInstance, 'xxh3', [$scratch, 13]))
+            ->then
+                ->string(sprintf('%016x', $result))
+                    ->isEqualTo(wasm_get_memory_buffer($wasmInstance)->hash('xxh3', $scratch, 13));
+    }
+
+    public function test_php_kv()
+    {
+        $this
+            ->given(
+                $wasmBytes = wasm_fetch_bytes(self::FILE_PATH),
+                $wasmInstanceA = wasm_new_instance($wasmBytes),
+                $scratchA = wasm_invoke_function($wasmInstanceA, 'scratch', []),
+                $this->write($wasmInstanceA, $scratchA, 'test_php_kv'),
+                $this->write($wasmInstanceA, $scratchA + 32, 'Hello, World!'),
+
+                $wasmInstanceB = wasm_new_instance($wasmBytes),
+                $scratchB = wasm_invoke_function($wasmInstanceB, 'scratch', []),
+                $this->write($wasmInstanceB, $scratchB, 'test_php_kv')
+            )
+            ->when($result = wasm_invoke_function($wasmInstanceA, 'kv_set', [$scratchA, 11, $scratchA + 32, 13]))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(0)
+
+            ->when($result = wasm_invoke_function($wasmInstanceB, 'kv_get', [$scratchB, 11, $scratchB + 32, 64]))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(13)
+                ->string($this->read($wasmInstanceB, $scratchB + 32, 13))
+                    ->isEqualTo('Hello, World!')
+
+            ->when($result = wasm_invoke_function($wasmInstanceB, 'kv_get', [$scratchB, 11, $scratchB + 128, 5]))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(13)
+                ->string($this->read($wasmInstanceB, $scratchB + 128, 6))
+                    ->isEqualTo("Hello\0")
+
+            ->when($result = wasm_invoke_function($wasmInstanceB, 'kv_delete', [$scratchB, 11]))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(1)
+
+            ->when($result = wasm_invoke_function($wasmInstanceA, 'kv_delete', [$scratchA, 11]))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(0)
+
+            ->when($result = wasm_invoke_function($wasmInstanceA, 'kv_get', [$scratchA, 11, $scratchA + 32, 64]))
+            ->then
+                ->integer($result)
+                    ->isEqualTo(-1);
+    }
+
+    public function test_php_kv_max_size()
+    {
+        // `wasm.kv_store_max_size` can only be set at startup, hence a
+        // new process.
+        $code = implode("\n", [
+            '$wasmInstance = wasm_new_instance(wasm_fetch_bytes($argv[1]));',
+            '$scratch = wasm_invoke_function($wasmInstance, \'scratch\', []);',
+            '$view = new WasmUint8Array(wasm_get_memory_buffer($wasmInstance), $scratch, 96);',
+            'foreach (str_split(str_pad(\'test_php_kv_max_size\', 32, "\\0") . str_repeat(\'x\', 64)) as $nth => $byte) {',
+            '    $view[$nth] = ord($byte);',
+            '}',
+            'echo json_encode([',
+            '    wasm_invoke_function($wasmInstance, \'kv_set\', [$scratch, 20, $scratch + 32, 44]),',
+            '    wasm_invoke_function($wasmInstance, \'kv_set\', [$scratch, 20, $scratch + 32, 45]),',
+            '    wasm_invoke_function($wasmInstance, \'kv_get\', [$scratch, 20, $scratch + 128, 64]),',
+            '    wasm_invoke_function($wasmInstance, \'kv_set\', [$scratch, 20, $scratch + 32, 10]),',
+            '    wasm_invoke_function($wasmInstance, \'kv_delete\', [$scratch, 20]),',
+            ']);',
+        ]);
+
+        $this
+            ->when(
+                $result = shell_exec(
+                    escapeshellarg(PHP_BINARY) .
+                    ' -d extension=wasm -d wasm.kv_store_max_size=64' .
+                    ' -r ' . escapeshellarg($code) .
+                    ' ' . escapeshellarg(self::FILE_PATH)
+                )
+            )
+            ->then
+                // The first value fits, the second one does not since the
+                // key and the value exceed 64 bytes, so the first value
+                // is kept; a smaller value fits again.
+                ->array(json_decode($result, true))
+                    ->isEqualTo([0, -1, 44, 0, 1]);
+    }
+
+    private function write($wasmInstance, int $pointer, string $bytes): void
+    {
+        $view = new WasmUint8Array(wasm_get_memory_buffer($wasmInstance), $pointer, strlen($bytes));
+
+        for ($nth = 0; $nth < strlen($bytes); ++$nth) {
+            $view[$nth] = ord($bytes[$nth]);
+        }
+    }
+
+    private function read($wasmInstance, int $pointer, int $length): string
+    {
+        $view = new WasmUint8Array(wasm_get_memory_buffer($wasmInstance), $pointer, $length);
+        $bytes = '';
+
+        for ($nth = 0; $nth < $length; ++$nth) {
+            $bytes .= chr($view[$nth]);
+        }
+
+        return $bytes;
+    }
+}
@@ -27,6 +27,21 @@ class IniEntries extends Suite
             ->when($result = $reflection->getINIEntries())
             ->then
                 ->array($result)
-                    ->isEmpty();
+                    ->isEqualTo([
+                        'wasm.array_buffer_arena_size' => '0',
+                        'wasm.output_chunk_size' => '8192',
+                        'wasm.kv_store_max_size' => '16M',
+                    ]);
+    }
+
+    public function test_kv_store_max_size_cannot_be_set_at_runtime()
+    {
+        $this
+            ->when($result = ini_set('wasm.kv_store_max_size', '1G'))
+            ->then
+                ->boolean($result)
+                    ->isFalse()
+                ->string(ini_get('wasm.kv_store_max_size'))
+                    ->isEqualTo('16M');
     }
 }
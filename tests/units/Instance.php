@@ -9,6 +9,7 @@ use Wasm as LUT;
 use WasmArrayBuffer;
 use Wasm\Instance as SUT;
 use Wasm\InvocationException;
+use Wasm\Module;
 use Wasm\Tests\Suite;
 
 class Instance extends Suite
@@ -114,6 +115,77 @@ class Instance extends Suite
                     ->isEqualTo('Hello, World!');
     }
 
+    public function test_set_output_stream()
+    {
+        $this
+            ->given(
+                $wasmInstance = new SUT(__DIR__ . '/host.wasm'),
+                $stream = fopen('php://memory', 'w+')
+            )
+            ->when(
+                $wasmInstance->setOutputStream($stream),
+                $result = $wasmInstance->write_greeting()
+            )
+            ->then
+                ->integer($result)
+                    ->isEqualTo(13)
+                ->string(stream_get_contents($stream, -1, 0))
+                    ->isEqualTo('Hello, World!');
+    }
+
+    public function test_set_input_stream()
+    {
+        $this
+            ->given(
+                $wasmInstance = new SUT(__DIR__ . '/host.wasm'),
+                $input = fopen('php://memory', 'w+'),
+                fwrite($input, 'Hello, World!'),
+                rewind($input),
+                $output = fopen('php://memory', 'w+')
+            )
+            ->when(
+                $wasmInstance->setInputStream($input),
+                $wasmInstance->setOutputStream($output),
+                $result = $wasmInstance->copy_input_to_output()
+            )
+            ->then
+                ->integer($result)
+                    ->isEqualTo(13)
+                ->string(stream_get_contents($output, -1, 0))
+                    ->isEqualTo('Hello, World!');
+    }
+
+    public function test_set_trace_stream()
+    {
+        $this
+            ->given(
+                $wasmInstance = new SUT(self::FILE_PATH),
+                $stream = fopen('php://memory', 'w+')
+            )
+            ->when(
+                $wasmInstance->setTraceStream($stream),
+                $result = $wasmInstance->sum(1, 2)
+            )
+            ->then
+                ->integer($result)
+                    ->isEqualTo(3)
+                ->string(stream_get_contents($stream, 11, 0))
+                    ->isEqualTo("WTRC\x01\x00\x00\x00" . pack('V', 3));
+    }
+
+    public function test_from_module_with_linked_instances()
+    {
+        $this
+            ->given(
+                $library = new SUT(self::FILE_PATH),
+                $module = new Module(__DIR__ . '/link.wasm')
+            )
+            ->when($wasmInstance = SUT::fromModule($module, ['library' => $library]))
+            ->then
+                ->integer($wasmInstance->add_twice(1, 2))
+                    ->isEqualTo(5);
+    }
+
     public function test_basic_sum()
     {
         $this
@@ -0,0 +1,149 @@
+<?php
+
+declare(strict_types = 1);
+
+namespace Wasm\Tests\Units;
+
+use Exception;
+use Wasm as LUT;
+use WasmArrayBuffer;
+use WasmStructView;
+use WasmUint8Array;
+use Wasm\Tests\Suite;
+
+class StructView extends Suite
+{
+    public function test_constructor()
+    {
+        $this
+            ->given($wasmArrayBuffer = new WasmArrayBuffer(64))
+            ->when($result = new LUT\StructView($wasmArrayBuffer, ['x' => 'i32', 'y' => ['f64', 8]], 16, 2))
+            ->then
+                ->object($result)
+                    ->isInstanceOf(WasmStructView::class)
+                ->integer($result->getOffset())
+                    ->isEqualTo(16)
+                ->integer($result->getCount())
+                    ->isEqualTo(2)
+                ->integer($result->getStride())
+                    ->isEqualTo(16);
+    }
+
+    public function test_packed_layout()
+    {
+        $this
+            ->given($wasmArrayBuffer = new WasmArrayBuffer(64))
+            ->when($result = new LUT\StructView($wasmArrayBuffer, ['a' => 'u8', 'b' => 'i32', 'c' => 'u16']))
+            ->then
+                ->integer($result->getStride())
+                    ->isEqualTo(7);
+    }
+
+    public function test_write_read()
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(64),
+                $view = new LUT\StructView($wasmArrayBuffer, ['x' => 'i32', 'y' => 'i16', 'z' => 'f64'], 0, 3, 16)
+            )
+            ->when(
+                $view->write(1, ['x' => -7, 'y' => 42, 'z' => 1.5]),
+                $view->set(2, 'y', -1)
+            )
+            ->then
+                ->array($view->read(1))
+                    ->isIdenticalTo(['x' => -7, 'y' => 42, 'z' => 1.5])
+                ->integer($view->get(2, 'y'))
+                    ->isEqualTo(-1)
+                ->array($view->readAll())
+                    ->isIdenticalTo([
+                        ['x' => 0, 'y' => 0, 'z' => 0.0],
+                        ['x' => -7, 'y' => 42, 'z' => 1.5],
+                        ['x' => 0, 'y' => -1, 'z' => 0.0],
+                    ]);
+    }
+
+    public function test_little_endian()
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(8),
+                $uint8 = new WasmUint8Array($wasmArrayBuffer),
+                $view = new LUT\StructView($wasmArrayBuffer, ['x' => ['u32', 1]])
+            )
+            ->when($view->set(0, 'x', 0x01020304))
+            ->then
+                ->integer($uint8[1])
+                    ->isEqualTo(0x04)
+                ->integer($uint8[4])
+                    ->isEqualTo(0x01);
+    }
+
+    public function test_at_shares_the_layout()
+    {
+        $this
+            ->given(
+                $wasmArrayBuffer = new WasmArrayBuffer(64),
+                $view = new LUT\StructView($wasmArrayBuffer, ['x' => 'i32', 'y' => 'i32'], 0, 0),
+                $view->at(8)->write(0, ['x' => 1, 'y' => 2])
+            )
+            ->when($result = $view->at(8, 2))
+            ->then
+                ->object($result)
+                    ->isInstanceOf(LUT\StructView::class)
+                ->integer($result->getCount())
+                    ->isEqualTo(2)
+                ->array($result->read(0))
+                    ->isIdenticalTo(['x' => 1, 'y' => 2]);
+    }
+
+    public function test_index_out_of_range()
+    {
+        $this
+            ->given($view = new LUT\StructView(new WasmArrayBuffer(8), ['x' => 'i32'], 0, 2))
+            ->exception(
+                function () use ($view) {
+                    $view->read(2);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Index is outside the view range [0; 2[; given 2.');
+    }
+
+    public function test_records_do_not_fit_in_the_buffer()
+    {
+        $this
+            ->exception(
+                function () {
+                    new LUT\StructView(new WasmArrayBuffer(8), ['x' => 'i32'], 4, 2);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Count must be in the range [0; 1]; given 2.');
+    }
+
+    public function test_unknown_type()
+    {
+        $this
+            ->exception(
+                function () {
+                    new LUT\StructView(new WasmArrayBuffer(8), ['x' => 'i128']);
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('Field `x` has an unknown type; expect one of i8, u8, i16, u16, i32, u32, i64, f32, or f64.');
+    }
+
+    public function test_unknown_field()
+    {
+        $this
+            ->given($view = new LUT\StructView(new WasmArrayBuffer(8), ['x' => 'i32']))
+            ->exception(
+                function () use ($view) {
+                    $view->get(0, 'y');
+                }
+            )
+                ->isInstanceOf(Exception::class)
+                ->hasMessage('The structure has no field named `y`.');
+    }
+}
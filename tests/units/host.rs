@@ -0,0 +1,182 @@
+// Host functions provided by the extension, see `wasm_host_functions`.
+//
+// `await_twice` is suspended by `php_await`, so this program must be
+// compiled with `just compile-async-wasm tests/units/host`.
+extern "C" {
+    fn php_write(pointer: *const u8, length: usize) -> i32;
+    fn php_read(pointer: *mut u8, capacity: usize) -> i32;
+    fn php_clock_ns() -> i64;
+    fn php_random_fill(pointer: *mut u8, length: usize) -> i32;
+    fn php_sha256(pointer: *const u8, length: usize, digest_pointer: *mut u8) -> i32;
+    fn php_xxh3(pointer: *const u8, length: usize) -> i64;
+    fn php_kv_get(key_pointer: *const u8, key_length: usize, value_pointer: *mut u8, value_capacity: usize) -> i32;
+    fn php_kv_set(key_pointer: *const u8, key_length: usize, value_pointer: *const u8, value_length: usize) -> i32;
+    fn php_kv_delete(key_pointer: *const u8, key_length: usize) -> i32;
+    fn php_queue_register(pointer: *mut u8, capacity: usize) -> i32;
+    fn php_queue_flush() -> i32;
+    fn php_async_register(pointer: *mut u8, length: usize) -> i32;
+    fn php_await(request_pointer: *const u8, request_length: usize, response_pointer: *mut u8, response_capacity: usize) -> i32;
+}
+
+static mut BUFFER: [u8; 16] = [0; 16];
+static mut SCRATCH: [u8; 256] = [0; 256];
+
+const QUEUE_CAPACITY: usize = 128;
+
+#[repr(C, align(4))]
+struct Queue {
+    length: u32,
+    records: [u8; QUEUE_CAPACITY],
+}
+
+static mut QUEUE: Queue = Queue { length: 0, records: [0; QUEUE_CAPACITY] };
+
+static mut ASYNC_DATA: [u32; 64] = [0; 64];
+static mut RESPONSE: [u8; 64] = [0; 64];
+
+#[no_mangle]
+pub extern fn write_greeting() -> i32 {
+    let greeting = b"Hello, World!";
+
+    unsafe { php_write(greeting.as_ptr(), greeting.len()) }
+}
+
+#[no_mangle]
+pub extern fn write_greetings(count: i32) -> i32 {
+    let mut total = 0;
+
+    for _ in 0..count {
+        let written = write_greeting();
+
+        if written < 0 {
+            return written;
+        }
+
+        total += written;
+    }
+
+    total
+}
+
+#[no_mangle]
+pub extern fn write_out_of_bounds() -> i32 {
+    unsafe { php_write(0xffff_fff0 as *const u8, 32) }
+}
+
+#[no_mangle]
+pub extern fn copy_input_to_output() -> i32 {
+    let mut total = 0;
+
+    loop {
+        let read = unsafe { php_read(BUFFER.as_mut_ptr(), BUFFER.len()) };
+
+        if read < 0 {
+            return read;
+        }
+
+        if read == 0 {
+            return total;
+        }
+
+        let written = unsafe { php_write(BUFFER.as_ptr(), read as usize) };
+
+        if written < 0 {
+            return written;
+        }
+
+        total += read;
+    }
+}
+
+#[no_mangle]
+pub extern fn read_out_of_bounds() -> i32 {
+    unsafe { php_read(0xffff_fff0 as *mut u8, 32) }
+}
+
+#[no_mangle]
+pub extern fn scratch() -> *mut u8 {
+    unsafe { SCRATCH.as_mut_ptr() }
+}
+
+#[no_mangle]
+pub extern fn clock_ns() -> i64 {
+    unsafe { php_clock_ns() }
+}
+
+#[no_mangle]
+pub extern fn random_fill(pointer: *mut u8, length: usize) -> i32 {
+    unsafe { php_random_fill(pointer, length) }
+}
+
+#[no_mangle]
+pub extern fn sha256(pointer: *const u8, length: usize, digest_pointer: *mut u8) -> i32 {
+    unsafe { php_sha256(pointer, length, digest_pointer) }
+}
+
+#[no_mangle]
+pub extern fn xxh3(pointer: *const u8, length: usize) -> i64 {
+    unsafe { php_xxh3(pointer, length) }
+}
+
+#[no_mangle]
+pub extern fn kv_get(key_pointer: *const u8, key_length: usize, value_pointer: *mut u8, value_capacity: usize) -> i32 {
+    unsafe { php_kv_get(key_pointer, key_length, value_pointer, value_capacity) }
+}
+
+#[no_mangle]
+pub extern fn kv_set(key_pointer: *const u8, key_length: usize, value_pointer: *const u8, value_length: usize) -> i32 {
+    unsafe { php_kv_set(key_pointer, key_length, value_pointer, value_length) }
+}
+
+#[no_mangle]
+pub extern fn kv_delete(key_pointer: *const u8, key_length: usize) -> i32 {
+    unsafe { php_kv_delete(key_pointer, key_length) }
+}
+
+#[no_mangle]
+pub extern fn queue_open() -> i32 {
+    unsafe { php_queue_register(&mut QUEUE as *mut Queue as *mut u8, QUEUE_CAPACITY) }
+}
+
+fn queue_push(tag: u32, payload: &[u8]) {
+    let size = 8 + (payload.len() + 3) / 4 * 4;
+
+    unsafe {
+        if QUEUE.length as usize + size > QUEUE_CAPACITY {
+            php_queue_flush();
+        }
+
+        let offset = QUEUE.length as usize;
+
+        QUEUE.records[offset..offset + 4].copy_from_slice(&tag.to_le_bytes());
+        QUEUE.records[offset + 4..offset + 8].copy_from_slice(&(payload.len() as u32).to_le_bytes());
+        QUEUE.records[offset + 8..offset + 8 + payload.len()].copy_from_slice(payload);
+        QUEUE.length += size as u32;
+    }
+}
+
+#[no_mangle]
+pub extern fn log_greetings(count: i32) -> i32 {
+    for _ in 0..count {
+        queue_push(1, b"Hello, World!");
+    }
+
+    count
+}
+
+#[no_mangle]
+pub extern fn async_open() -> i32 {
+    unsafe { php_async_register(ASYNC_DATA.as_mut_ptr() as *mut u8, 256) }
+}
+
+fn await_request(request: &[u8]) -> i32 {
+    unsafe { php_await(request.as_ptr(), request.len(), RESPONSE.as_mut_ptr(), RESPONSE.len()) }
+}
+
+#[no_mangle]
+pub extern fn await_twice(x: i32) -> i32 {
+    let first = await_request(b"first");
+    let second = await_request(b"second");
+
+    x + first + second
+}
@@ -0,0 +1,26 @@
+// A program linked to the `tests.wasm` instance, see
+// `wasm_module_new_linked_instance`: it imports the `sum` function and
+// the memory of the `library` namespace.
+//
+// The memory is imported from the `library` namespace with
+// `-C link-arg=--import-memory=library,memory`, see the
+// `compile-link-wasm` recipe of the `justfile`.
+#[link(wasm_import_module = "library")]
+extern "C" {
+    fn sum(x: i32, y: i32) -> i32;
+}
+
+#[no_mangle]
+pub extern fn add_twice(x: i32, y: i32) -> i32 {
+    unsafe { sum(sum(x, y), y) }
+}
+
+#[no_mangle]
+pub extern fn read_shared(pointer: *const u8) -> i32 {
+    unsafe { *pointer as i32 }
+}
+
+#[no_mangle]
+pub extern fn write_shared(pointer: *mut u8, value: u8) {
+    unsafe { *pointer = value; }
+}